@@ -12,84 +12,651 @@
 
 #include "buffer/buffer_pool_manager_instance.h"
 
+#include <algorithm>
+#include <memory>
+#include <chrono>  // NOLINT
+#include <thread>  // NOLINT
+#include <utility>
+#include <vector>
+
+#include "common/exception.h"
+#include "common/logger.h"
 #include "common/macros.h"
 
 namespace bustub {
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager)
-    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager) {}
+                                                     LogManager *log_manager, ReplacerType replacer_type)
+    : BufferPoolManagerInstance(pool_size, 1, 0, disk_manager, log_manager, replacer_type) {}
 
 BufferPoolManagerInstance::BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                                                     DiskManager *disk_manager, LogManager *log_manager)
+                                                     DiskManager *disk_manager, LogManager *log_manager,
+                                                     ReplacerType replacer_type, bool use_huge_pages, int numa_node)
     : pool_size_(pool_size),
       num_instances_(num_instances),
       instance_index_(instance_index),
       next_page_id_(instance_index),
+      frames_(pool_size, use_huge_pages, numa_node),
       disk_manager_(disk_manager),
-      log_manager_(log_manager) {
+      log_manager_(log_manager),
+      page_table_(pool_size) {
   BUSTUB_ASSERT(num_instances > 0, "If BPI is not part of a pool, then the pool size should just be 1");
   BUSTUB_ASSERT(
       instance_index < num_instances,
       "BPI index cannot be greater than the number of BPIs in the pool. In non-parallel case, index should just be 1.");
-  // We allocate a consecutive memory space for the buffer pool.
-  pages_ = new Page[pool_size_];
-  replacer_ = new LRUReplacer(pool_size);
+  // The book-keeping of all frames is allocated apart from their data, which the frame region keeps contiguous.
+  pages_ = std::allocator<Page>().allocate(pool_size_);
+  for (size_t i = 0; i < pool_size_; ++i) {
+    new (&pages_[i]) Page(frames_.GetFrame(static_cast<frame_id_t>(i)));
+  }
+  switch (replacer_type) {
+    case ReplacerType::LRU:
+      replacer_ = new LRUReplacer(pool_size);
+      break;
+    case ReplacerType::CLOCK:
+      replacer_ = new ClockReplacer(pool_size);
+      break;
+    case ReplacerType::LRU_K:
+      replacer_ = new LRUKReplacer(pool_size);
+      break;
+  }
+  second_chance_ = replacer_type != ReplacerType::LRU_K;
+  in_replacer_ = new std::atomic<bool>[pool_size_]();
+  referenced_ = new std::atomic<bool>[pool_size_]();
+  pending_reads_.resize(pool_size_);
 
   // Initially, every page is in the free list.
   for (size_t i = 0; i < pool_size_; ++i) {
+    pages_[i].pin_count_ = FRAME_FREE;
     free_list_.emplace_back(static_cast<int>(i));
   }
 }
 
 BufferPoolManagerInstance::~BufferPoolManagerInstance() {
-  delete[] pages_;
+  StopBackgroundWriter();
+  ReapPrefetches(true);
+  std::destroy_n(pages_, pool_size_);
+  std::allocator<Page>().deallocate(pages_, pool_size_);
   delete replacer_;
+  delete[] in_replacer_;
+  delete[] referenced_;
 }
 
 bool BufferPoolManagerInstance::FlushPgImp(page_id_t page_id) {
-  // Make sure you call DiskManager::WritePage!
-  return false;
+  frame_id_t frame_id;
+  if (!PinResidentPage(page_id, &frame_id)) {
+    return false;
+  }
+  Page *page = &pages_[frame_id];
+  // Clear the dirty bit before writing so that a concurrent UnpinPage(page_id, true) is never lost.
+  page->is_dirty_ = false;
+  disk_manager_->WritePage(page_id, page->GetData());
+  num_foreground_writes_++;
+  UnpinFrame(frame_id);
+  return true;
 }
 
 void BufferPoolManagerInstance::FlushAllPgsImp() {
-  // You can do it!
+  for (size_t i = 0; i < pool_size_; ++i) {
+    page_id_t page_id = pages_[i].page_id_;
+    if (page_id != INVALID_PAGE_ID) {
+      FlushPgImp(page_id);
+    }
+  }
 }
 
 Page *BufferPoolManagerInstance::NewPgImp(page_id_t *page_id) {
-  // 0.   Make sure you call AllocatePage!
-  // 1.   If all the pages in the buffer pool are pinned, return nullptr.
-  // 2.   Pick a victim page P from either the free list or the replacer. Always pick from the free list first.
-  // 3.   Update P's metadata, zero out memory and add P to the page table.
-  // 4.   Set the page ID output parameter. Return a pointer to P.
-  return nullptr;
+  bool reused;
+  return NewPgReusingImp(page_id, INVALID_PAGE_ID, &reused);
+}
+
+Page *BufferPoolManagerInstance::NewPgReusingImp(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) {
+  frame_id_t frame_id;
+  *reused = false;
+  if (!AcquireFrame(&frame_id, reuse_page_id, reused)) {
+    return nullptr;
+  }
+  Page *page = &pages_[frame_id];
+  page->is_dirty_ = false;
+  page->ResetMemory();
+  while (true) {
+    *page_id = AllocatePage();
+    std::scoped_lock stripe_latch(page_table_.GetStripeLatch(*page_id));
+    frame_id_t prefetched_frame_id;
+    // Read-ahead may have started reading the page between its allocation and now. A page must never map to two
+    // frames, so leave that page id to the prefetched frame and take the next one.
+    if (!page_table_.Find(*page_id, &prefetched_frame_id)) {
+      page->page_id_ = *page_id;
+      page_table_.Insert(*page_id, frame_id);
+      break;
+    }
+  }
+  page->pin_count_ = 1;
+  replacer_->RecordAccess(frame_id);
+  return page;
 }
 
 Page *BufferPoolManagerInstance::FetchPgImp(page_id_t page_id) {
-  // 1.     Search the page table for the requested page (P).
-  // 1.1    If P exists, pin it and return it immediately.
-  // 1.2    If P does not exist, find a replacement page (R) from either the free list or the replacer.
-  //        Note that pages are always found from the free list first.
-  // 2.     If R is dirty, write it back to the disk.
-  // 3.     Delete R from the page table and insert P.
-  // 4.     Update P's metadata, read in the page content from disk, and then return a pointer to P.
-  return nullptr;
+  bool loaded;
+  bool reused;
+  return FetchPgReusingImp(page_id, INVALID_PAGE_ID, &loaded, &reused);
+}
+
+Page *BufferPoolManagerInstance::FetchPgReusingImp(page_id_t page_id, page_id_t reuse_page_id, bool *loaded,
+                                                   bool *reused) {
+  *loaded = false;
+  *reused = false;
+  frame_id_t frame_id;
+  // Hit path: neither the lookup nor the pin takes a latch.
+  if (page_table_.Find(page_id, &frame_id) && TryPinFrame(frame_id, page_id)) {
+    referenced_[frame_id].store(true, std::memory_order_relaxed);
+    replacer_->RecordAccess(frame_id);
+    return &pages_[frame_id];
+  }
+
+  frame_id_t new_frame_id = -1;
+  while (true) {
+    std::unique_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    if (page_table_.Find(page_id, &frame_id)) {
+      if (TryPinFrame(frame_id, page_id) || (FinishPrefetch(frame_id) && TryPinFrame(frame_id, page_id))) {
+        stripe_latch.unlock();
+        if (new_frame_id != -1) {
+          // Somebody else loaded the page while we were looking for a frame.
+          ReleaseFrame(new_frame_id);
+          *reused = false;
+        }
+        replacer_->RecordAccess(frame_id);
+        return &pages_[frame_id];
+      }
+      // The page is being evicted or deleted. Wait for its entry to go away.
+      stripe_latch.unlock();
+      std::this_thread::yield();
+      continue;
+    }
+    if (new_frame_id == -1) {
+      // Eviction takes the stripe latch of the victim, so it must run without ours.
+      stripe_latch.unlock();
+      if (!AcquireFrame(&new_frame_id, reuse_page_id, reused)) {
+        return nullptr;
+      }
+      continue;
+    }
+    // Publish the frame while it is still busy and read without the stripe latch, so that the read does not hold up
+    // other misses and evictions in the stripe. Fetches of this page wait for the frame to become pinnable.
+    Page *page = &pages_[new_frame_id];
+    page->page_id_ = page_id;
+    page->is_dirty_ = false;
+    page->ResetMemory();
+    page_table_.Insert(page_id, new_frame_id);
+    stripe_latch.unlock();
+    try {
+      disk_manager_->ReadPage(page_id, page->GetData());
+    } catch (...) {
+      {
+        std::scoped_lock failed_stripe_latch(page_table_.GetStripeLatch(page_id));
+        page_table_.Remove(page_id);
+      }
+      ReleaseFrame(new_frame_id);
+      throw;
+    }
+    page->pin_count_ = 1;
+    num_fetch_misses_++;
+    *loaded = true;
+    replacer_->RecordAccess(new_frame_id);
+    return page;
+  }
 }
 
 bool BufferPoolManagerInstance::DeletePgImp(page_id_t page_id) {
-  // 0.   Make sure you call DeallocatePage!
-  // 1.   Search the page table for the requested page (P).
-  // 1.   If P does not exist, return true.
-  // 2.   If P exists, but has a non-zero pin-count, return false. Someone is using the page.
-  // 3.   Otherwise, P can be deleted. Remove P from the page table, reset its metadata and return it to the free list.
-  return false;
+  frame_id_t frame_id;
+  Page *page;
+  while (true) {
+    std::unique_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    if (!page_table_.Find(page_id, &frame_id)) {
+      DeallocatePage(page_id);
+      return true;
+    }
+    page = &pages_[frame_id];
+    FinishPrefetch(frame_id);
+    int pin_count = 0;
+    if (page->pin_count_.compare_exchange_strong(pin_count, FRAME_BUSY)) {
+      page_table_.Remove(page_id);
+      break;
+    }
+    if (pin_count > 0) {
+      return false;
+    }
+    // The page is being evicted; retry once its entry is gone.
+    stripe_latch.unlock();
+    std::this_thread::yield();
+  }
+  DeallocatePage(page_id);
+  if (in_replacer_[frame_id].exchange(false)) {
+    replacer_->Pin(frame_id);
+  }
+  replacer_->ForgetHistory(frame_id);
+  page->page_id_ = INVALID_PAGE_ID;
+  page->is_dirty_ = false;
+  page->ResetMemory();
+  ReleaseFrame(frame_id);
+  if (page_table_.NeedsCompaction()) {
+    page_table_.Compact();
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) {
+  frame_id_t frame_id;
+  if (!page_table_.Find(page_id, &frame_id)) {
+    // A lock-free lookup can miss while the page table is being compacted.
+    std::scoped_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return false;
+    }
+  }
+  Page *page = &pages_[frame_id];
+  if (page->page_id_ != page_id || page->pin_count_ <= 0) {
+    return false;
+  }
+  // Mark the page dirty before dropping the pin, otherwise it could be evicted without being written back.
+  if (is_dirty) {
+    page->is_dirty_ = true;
+  }
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count <= 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count - 1));
+  if (pin_count == 1 && !in_replacer_[frame_id].exchange(true)) {
+    replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::TryPinFrame(frame_id_t frame_id, page_id_t page_id) {
+  Page *page = &pages_[frame_id];
+  int pin_count = page->pin_count_.load();
+  do {
+    if (pin_count < 0) {
+      return false;
+    }
+  } while (!page->pin_count_.compare_exchange_weak(pin_count, pin_count + 1));
+  // The page id of a pinned frame cannot change, but the page table entry that led us here may have been stale.
+  if (page->page_id_ != page_id) {
+    UnpinFrame(frame_id);
+    return false;
+  }
+  return true;
+}
+
+bool BufferPoolManagerInstance::PinResidentPage(page_id_t page_id, frame_id_t *frame_id) {
+  if (page_table_.Find(page_id, frame_id) && TryPinFrame(*frame_id, page_id)) {
+    return true;
+  }
+  while (true) {
+    std::unique_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    if (!page_table_.Find(page_id, frame_id)) {
+      return false;
+    }
+    if (TryPinFrame(*frame_id, page_id) || (FinishPrefetch(*frame_id) && TryPinFrame(*frame_id, page_id))) {
+      return true;
+    }
+    stripe_latch.unlock();
+    std::this_thread::yield();
+  }
+}
+
+void BufferPoolManagerInstance::UnpinFrame(frame_id_t frame_id) {
+  if (pages_[frame_id].pin_count_.fetch_sub(1) == 1 && !in_replacer_[frame_id].exchange(true)) {
+    replacer_->Unpin(frame_id);
+  }
 }
 
-bool BufferPoolManagerInstance::UnpinPgImp(page_id_t page_id, bool is_dirty) { return false; }
+bool BufferPoolManagerInstance::AcquireFrame(frame_id_t *frame_id, page_id_t reuse_page_id, bool *reused) {
+  if (reuse_page_id != INVALID_PAGE_ID && EvictPage(reuse_page_id, frame_id)) {
+    if (reused != nullptr) {
+      *reused = true;
+    }
+    return true;
+  }
+  while (true) {
+    {
+      std::scoped_lock latch(latch_);
+      if (!free_list_.empty()) {
+        *frame_id = free_list_.front();
+        free_list_.pop_front();
+        pages_[*frame_id].pin_count_ = FRAME_BUSY;
+        return true;
+      }
+    }
+    if (EvictFrame(frame_id)) {
+      return true;
+    }
+    // DeletePage moves unpinned frames from the replacer to the free list, so an empty replacer does not mean every
+    // frame is pinned until the free list has been looked at again.
+    std::scoped_lock latch(latch_);
+    if (free_list_.empty()) {
+      return false;
+    }
+  }
+}
+
+bool BufferPoolManagerInstance::EvictFrame(frame_id_t *frame_id) {
+  size_t second_chances = 0;
+  bool reaped = false;
+  frame_id_t victim;
+  while (true) {
+    if (!replacer_->Victim(&victim)) {
+      // Frames whose prefetch has not been published yet are not in the replacer. Publish them and look again.
+      if (reaped) {
+        return false;
+      }
+      ReapPrefetches(true);
+      reaped = true;
+      continue;
+    }
+    Page *page = &pages_[victim];
+    // LRU and clock only see the unpin order, so a frame that was hit since it entered the replacer is put back at the
+    // end of the queue once instead of being evicted.
+    if (second_chance_ && second_chances < pool_size_ &&
+        referenced_[victim].exchange(false, std::memory_order_relaxed)) {
+      second_chances++;
+      replacer_->Unpin(victim);
+      continue;
+    }
+    int pin_count = 0;
+    if (!page->pin_count_.compare_exchange_strong(pin_count, FRAME_BUSY)) {
+      // Pinned (or freed) after it entered the replacer. Whoever drops the last pin puts it back; re-check here in case
+      // that happened before we cleared the flag.
+      in_replacer_[victim] = false;
+      if (page->pin_count_ == 0 && !in_replacer_[victim].exchange(true)) {
+        replacer_->Unpin(victim);
+      }
+      continue;
+    }
+    in_replacer_[victim] = false;
+    DetachFrame(victim);
+    *frame_id = victim;
+    return true;
+  }
+}
+
+bool BufferPoolManagerInstance::EvictPage(page_id_t page_id, frame_id_t *frame_id) {
+  frame_id_t victim;
+  if (!page_table_.Find(page_id, &victim)) {
+    return false;
+  }
+  Page *page = &pages_[victim];
+  int pin_count = 0;
+  if (!page->pin_count_.compare_exchange_strong(pin_count, FRAME_BUSY)) {
+    return false;
+  }
+  if (page->page_id_ != page_id) {
+    // The lookup was stale and the frame holds another page, which is none of our business.
+    page->pin_count_ = 0;
+    return false;
+  }
+  if (in_replacer_[victim].exchange(false)) {
+    replacer_->Pin(victim);
+  }
+  DetachFrame(victim);
+  *frame_id = victim;
+  return true;
+}
+
+void BufferPoolManagerInstance::DetachFrame(frame_id_t frame_id) {
+  Page *page = &pages_[frame_id];
+  referenced_[frame_id].store(false, std::memory_order_relaxed);
+  replacer_->ForgetHistory(frame_id);
+
+  // Write back before dropping the page table entry, so that a concurrent miss on this page reads the new contents.
+  page_id_t page_id = page->page_id_;
+  if (page->is_dirty_) {
+    disk_manager_->WritePage(page_id, page->GetData());
+    page->is_dirty_ = false;
+    num_foreground_writes_++;
+  }
+  {
+    std::scoped_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    page_table_.Remove(page_id);
+  }
+  page->page_id_ = INVALID_PAGE_ID;
+  if (page_table_.NeedsCompaction()) {
+    page_table_.Compact();
+  }
+}
+
+void BufferPoolManagerInstance::ReleaseFrame(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  pages_[frame_id].page_id_ = INVALID_PAGE_ID;
+  pages_[frame_id].pin_count_ = FRAME_FREE;
+  free_list_.push_front(frame_id);
+}
+
+void BufferPoolManagerInstance::MarkPgReferencedImp(page_id_t page_id) {
+  frame_id_t frame_id;
+  // The caller's pin keeps the page in its frame, but a lock-free lookup can still miss while the table is compacted.
+  if (!page_table_.Find(page_id, &frame_id)) {
+    std::scoped_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    if (!page_table_.Find(page_id, &frame_id)) {
+      return;
+    }
+  }
+  referenced_[frame_id].store(true, std::memory_order_relaxed);
+}
+
+void BufferPoolManagerInstance::PrefetchPgsImp(const std::vector<page_id_t> &page_ids) {
+  if (!CanPrefetchImp()) {
+    return;
+  }
+  ReapPrefetches(false);
+  for (page_id_t page_id : page_ids) {
+    // Pages that have not been allocated yet are not worth reading, and a copy read from past the end of the file
+    // would be stale by the time NewPage creates the page. Pages of a file written by an earlier pool are on disk.
+    if (page_id < 0 || static_cast<uint32_t>(page_id) % num_instances_ != instance_index_ ||
+        (page_id >= next_page_id_.load() && !disk_manager_->IsPageOnDisk(page_id))) {
+      continue;
+    }
+    frame_id_t frame_id;
+    if (page_table_.Find(page_id, &frame_id)) {
+      continue;
+    }
+    if (!AcquireFrame(&frame_id)) {
+      return;
+    }
+    {
+      std::scoped_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+      frame_id_t resident_frame_id;
+      if (page_table_.Find(page_id, &resident_frame_id)) {
+        ReleaseFrame(frame_id);
+        continue;
+      }
+      Page *page = &pages_[frame_id];
+      page->page_id_ = page_id;
+      page->is_dirty_ = false;
+      page->ResetMemory();
+      pending_reads_[frame_id] = disk_manager_->ReadPageAsync(page_id, page->GetData());
+      page_table_.Insert(page_id, frame_id);
+    }
+    {
+      std::scoped_lock latch(latch_);
+      prefetching_.push_back(frame_id);
+    }
+    num_prefetches_++;
+  }
+}
+
+bool BufferPoolManagerInstance::FinishPrefetch(frame_id_t frame_id) {
+  if (!pending_reads_[frame_id].valid()) {
+    return false;
+  }
+  try {
+    pending_reads_[frame_id].get();
+  } catch (const Exception &e) {
+    LOG_DEBUG("prefetch read failed: %s", e.what());
+  }
+  referenced_[frame_id].store(false, std::memory_order_relaxed);
+  pages_[frame_id].pin_count_ = 0;
+  if (!in_replacer_[frame_id].exchange(true)) {
+    replacer_->Unpin(frame_id);
+  }
+  return true;
+}
+
+void BufferPoolManagerInstance::ReapPrefetches(bool wait) {
+  std::vector<frame_id_t> frames;
+  {
+    std::scoped_lock latch(latch_);
+    frames.swap(prefetching_);
+  }
+  std::vector<frame_id_t> in_flight;
+  for (frame_id_t frame_id : frames) {
+    page_id_t page_id = pages_[frame_id].page_id_;
+    if (page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    std::scoped_lock stripe_latch(page_table_.GetStripeLatch(page_id));
+    // The frame may have been published, evicted and reused since it was queued; only its current state matters.
+    if (pages_[frame_id].page_id_ != page_id || !pending_reads_[frame_id].valid()) {
+      continue;
+    }
+    if (wait || pending_reads_[frame_id].wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+      FinishPrefetch(frame_id);
+    } else {
+      in_flight.push_back(frame_id);
+    }
+  }
+  if (!in_flight.empty()) {
+    std::scoped_lock latch(latch_);
+    prefetching_.insert(prefetching_.end(), in_flight.begin(), in_flight.end());
+  }
+}
+
+void BufferPoolManagerInstance::RunBackgroundWriter(double target_clean_ratio, size_t max_pages_per_second) {
+  StopBackgroundWriter();
+  bg_target_clean_ratio_ = std::clamp(target_clean_ratio, 0.0, 1.0);
+  bg_max_pages_per_second_ = max_pages_per_second;
+  bg_writer_running_ = true;
+  bg_writer_thread_ = std::thread(&BufferPoolManagerInstance::BackgroundWriterLoop, this);
+}
+
+void BufferPoolManagerInstance::StopBackgroundWriter() {
+  {
+    std::scoped_lock bg_latch(bg_writer_latch_);
+    if (!bg_writer_running_) {
+      return;
+    }
+    bg_writer_running_ = false;
+  }
+  bg_writer_cv_.notify_all();
+  bg_writer_thread_.join();
+}
+
+void BufferPoolManagerInstance::BackgroundWriterLoop() {
+  const auto num_frames = static_cast<size_t>(bg_target_clean_ratio_ * pool_size_);
+  // Token bucket for the write rate limit, holding at most one second worth of writes.
+  const auto rate = static_cast<double>(bg_max_pages_per_second_);
+  double budget = rate;
+  auto last_round = std::chrono::steady_clock::now();
+
+  std::unique_lock bg_latch(bg_writer_latch_);
+  while (bg_writer_running_) {
+    bg_writer_cv_.wait_for(bg_latch, background_writer_interval);
+    if (!bg_writer_running_) {
+      break;
+    }
+    bg_latch.unlock();
+
+    size_t max_pages = pool_size_;
+    if (bg_max_pages_per_second_ > 0) {
+      auto now = std::chrono::steady_clock::now();
+      budget = std::min(rate, budget + rate * std::chrono::duration<double>(now - last_round).count());
+      last_round = now;
+      max_pages = static_cast<size_t>(budget);
+    }
+    if (max_pages > 0) {
+      budget -= static_cast<double>(CleanVictimCandidates(num_frames, max_pages));
+    }
+
+    bg_latch.lock();
+  }
+}
+
+size_t BufferPoolManagerInstance::CleanVictimCandidates(size_t num_frames, size_t max_pages) {
+  size_t num_free;
+  {
+    std::scoped_lock latch(latch_);
+    num_free = free_list_.size();
+  }
+  if (num_free >= num_frames) {
+    return 0;
+  }
+
+  // Pick the dirty, unpinned frames among the next victims and pin them, so they cannot be evicted before they are
+  // written (their dirty bit is cleared before the write completes).
+  std::vector<std::pair<page_id_t, frame_id_t>> dirty;
+  for (frame_id_t frame_id : replacer_->PeekVictims(num_frames - num_free)) {
+    if (dirty.size() == max_pages) {
+      break;
+    }
+    Page *page = &pages_[frame_id];
+    page_id_t page_id = page->page_id_;
+    if (page->pin_count_ != 0 || !page->is_dirty_ || page_id == INVALID_PAGE_ID) {
+      continue;
+    }
+    if (TryPinFrame(frame_id, page_id)) {
+      dirty.emplace_back(page_id, frame_id);
+    }
+  }
+  std::sort(dirty.begin(), dirty.end());
+
+  // Copy runs of adjacent pages into one buffer and write each run at once.
+  size_t written = 0;
+  std::vector<char> buffer;
+  std::vector<frame_id_t> run;
+  page_id_t run_start = INVALID_PAGE_ID;
+  auto write_run = [&]() {
+    if (!run.empty()) {
+      disk_manager_->WritePages(run_start, buffer.data(), run.size());
+      written += run.size();
+      for (frame_id_t frame_id : run) {
+        UnpinFrame(frame_id);
+      }
+      run.clear();
+    }
+  };
+  for (auto [page_id, frame_id] : dirty) {
+    if (!run.empty() && page_id != run_start + static_cast<page_id_t>(run.size())) {
+      write_run();
+    }
+    Page *page = &pages_[frame_id];
+    page->RLatch();
+    // WAL: a page must not reach the disk before the log records that modified it.
+    bool log_behind = enable_logging && log_manager_ != nullptr && page->GetLSN() > log_manager_->GetPersistentLSN();
+    if (!page->is_dirty_ || log_behind) {
+      page->RUnlatch();
+      UnpinFrame(frame_id);
+      write_run();
+      continue;
+    }
+    if (run.empty()) {
+      run_start = page_id;
+    }
+    buffer.resize((run.size() + 1) * PAGE_SIZE);
+    memcpy(buffer.data() + run.size() * PAGE_SIZE, page->GetData(), PAGE_SIZE);
+    page->is_dirty_ = false;
+    page->RUnlatch();
+    run.push_back(frame_id);
+  }
+  write_run();
+  num_background_writes_ += written;
+  return written;
+}
 
 page_id_t BufferPoolManagerInstance::AllocatePage() {
-  const page_id_t next_page_id = next_page_id_;
-  next_page_id_ += num_instances_;
+  // NewPage no longer serializes on latch_, so the read and the bump must be one atomic step.
+  const page_id_t next_page_id = next_page_id_.fetch_add(num_instances_);
   ValidatePageId(next_page_id);
   return next_page_id;
 }
@@ -0,0 +1,60 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.cpp
+//
+// Identification: src/buffer/buffer_ring.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/buffer_ring.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+BufferRing::BufferRing(BufferPoolManager *bpm, size_t ring_size) : bpm_(bpm), ring_(ring_size, INVALID_PAGE_ID) {
+  BUSTUB_ASSERT(ring_size > 0, "a buffer ring needs at least one frame");
+}
+
+Page *BufferRing::FetchPgImp(page_id_t page_id) {
+  bool loaded;
+  bool reused;
+  Page *page = bpm_->FetchPageReusing(page_id, ring_[next_slot_], &loaded, &reused);
+  if (page != nullptr && loaded) {
+    Advance(page_id, reused);
+  }
+  return page;
+}
+
+Page *BufferRing::NewPgImp(page_id_t *page_id) {
+  bool reused;
+  Page *page = bpm_->NewPageReusing(page_id, ring_[next_slot_], &reused);
+  if (page != nullptr) {
+    Advance(*page_id, reused);
+  }
+  return page;
+}
+
+bool BufferRing::DeletePgImp(page_id_t page_id) {
+  if (!bpm_->DeletePage(page_id)) {
+    return false;
+  }
+  std::replace(ring_.begin(), ring_.end(), page_id, INVALID_PAGE_ID);
+  return true;
+}
+
+void BufferRing::Advance(page_id_t page_id, bool reused) {
+  ring_[next_slot_] = page_id;
+  next_slot_ = (next_slot_ + 1) % ring_.size();
+  if (reused) {
+    num_evictions_avoided_++;
+  }
+}
+
+}  // namespace bustub
@@ -14,16 +14,71 @@
 
 namespace bustub {
 
-ClockReplacer::ClockReplacer(size_t num_pages) {}
+ClockReplacer::ClockReplacer(size_t num_pages)
+    : num_pages_(num_pages), in_clock_(num_pages, false), ref_(num_pages, false) {}
 
 ClockReplacer::~ClockReplacer() = default;
 
-bool ClockReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool ClockReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock latch(latch_);
+  if (size_ == 0) {
+    return false;
+  }
+  // Every frame in the clock is reached within two sweeps: the first one clears the reference bits.
+  while (true) {
+    size_t frame = hand_;
+    hand_ = (hand_ + 1) % num_pages_;
+    if (!in_clock_[frame]) {
+      continue;
+    }
+    if (ref_[frame]) {
+      ref_[frame] = false;
+      continue;
+    }
+    in_clock_[frame] = false;
+    size_--;
+    *frame_id = static_cast<frame_id_t>(frame);
+    return true;
+  }
+}
 
-void ClockReplacer::Pin(frame_id_t frame_id) {}
+void ClockReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || !in_clock_[frame_id]) {
+    return;
+  }
+  in_clock_[frame_id] = false;
+  size_--;
+}
 
-void ClockReplacer::Unpin(frame_id_t frame_id) {}
+void ClockReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || in_clock_[frame_id]) {
+    return;
+  }
+  in_clock_[frame_id] = true;
+  ref_[frame_id] = true;
+  size_++;
+}
 
-size_t ClockReplacer::Size() { return 0; }
+size_t ClockReplacer::Size() {
+  std::scoped_lock latch(latch_);
+  return size_;
+}
+
+std::vector<frame_id_t> ClockReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock latch(latch_);
+  std::vector<frame_id_t> frames;
+  // The sweep takes the frames without a reference bit first, then the others in the same order.
+  for (bool referenced : {false, true}) {
+    for (size_t i = 0; i < num_pages_ && frames.size() < max_frames; i++) {
+      size_t frame = (hand_ + i) % num_pages_;
+      if (in_clock_[frame] && ref_[frame] == referenced) {
+        frames.push_back(static_cast<frame_id_t>(frame));
+      }
+    }
+  }
+  return frames;
+}
 
 }  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_region.cpp
+//
+// Identification: src/buffer/frame_region.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/frame_region.h"
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "common/logger.h"
+
+namespace bustub {
+
+FrameRegion::FrameRegion(size_t num_frames, bool use_huge_pages, int numa_node) {
+  size_t size = std::max<size_t>(num_frames, 1) * PAGE_SIZE;
+  if (use_huge_pages) {
+    size_t huge_size = (size + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE;
+    void *mapping = mmap(nullptr, huge_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (mapping != MAP_FAILED) {
+      mapping_ = mapping;
+      mapping_size_ = huge_size;
+      data_ = static_cast<char *>(mapping);
+      uses_huge_pages_ = true;
+    } else {
+      // No reserved huge pages. Over-allocate so that the frames can start on a huge page boundary, and ask for
+      // transparent huge pages.
+      mapping_size_ = huge_size + HUGE_PAGE_SIZE;
+      mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+      if (mapping_ == MAP_FAILED) {
+        throw std::bad_alloc();
+      }
+      auto address = reinterpret_cast<uintptr_t>(mapping_);
+      data_ = reinterpret_cast<char *>((address + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE * HUGE_PAGE_SIZE);
+      uses_huge_pages_ = madvise(data_, huge_size, MADV_HUGEPAGE) == 0;
+      if (!uses_huge_pages_) {
+        LOG_DEBUG("transparent huge pages are not available, using regular pages");
+      }
+    }
+    size = huge_size;
+  } else {
+    mapping_size_ = size;
+    mapping_ = mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapping_ == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    data_ = static_cast<char *>(mapping_);
+  }
+
+  if (numa_node >= 0) {
+    // The memory has not been touched yet, so binding it now decides where every frame is allocated.
+    // mbind takes the mask as an array of kernel longs, which are 64 bits wide on every 64-bit Linux target.
+    constexpr size_t MASK_BITS = 8 * sizeof(uint64_t);
+    std::vector<uint64_t> node_mask(numa_node / MASK_BITS + 1, 0);
+    node_mask[numa_node / MASK_BITS] |= uint64_t{1} << (numa_node % MASK_BITS);
+    if (syscall(__NR_mbind, data_, size, MPOL_BIND, node_mask.data(), node_mask.size() * MASK_BITS + 1, 0) == 0) {
+      numa_node_ = numa_node;
+    } else {
+      LOG_DEBUG("could not bind the buffer pool to NUMA node %d", numa_node);
+    }
+  }
+}
+
+FrameRegion::~FrameRegion() { munmap(mapping_, mapping_size_); }
+
+int FrameRegion::GetNumNumaNodes() {
+  // The file lists the possible nodes as ranges, e.g. "0" or "0-3".
+  std::ifstream possible("/sys/devices/system/node/possible");
+  std::string ranges;
+  if (!(possible >> ranges)) {
+    return 1;
+  }
+  size_t last_separator = ranges.find_last_of("-,");
+  std::string last = last_separator == std::string::npos ? ranges : ranges.substr(last_separator + 1);
+  try {
+    return std::stoi(last) + 1;
+  } catch (const std::exception &e) {
+    return 1;
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,149 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.cpp
+//
+// Identification: src/buffer/lru_k_replacer.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/lru_k_replacer.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+LRUKReplacer::LRUKReplacer(size_t num_pages, size_t k)
+    : num_pages_(num_pages),
+      k_(k),
+      history_(new std::atomic<uint64_t>[num_pages * k]()),
+      num_references_(new std::atomic<uint32_t>[num_pages]()),
+      evictable_(num_pages, false),
+      ordered_keys_(num_pages) {
+  BUSTUB_ASSERT(k > 0, "LRU-K needs at least one reference per frame");
+}
+
+LRUKReplacer::~LRUKReplacer() = default;
+
+bool LRUKReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock latch(latch_);
+  while (!victims_.empty()) {
+    auto front = victims_.begin();
+    if (Reorder(front)) {
+      continue;
+    }
+    frame_id_t victim = front->second;
+    victims_.erase(front);
+    evictable_[victim] = false;
+    *frame_id = victim;
+    return true;
+  }
+  return false;
+}
+
+void LRUKReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || !evictable_[frame_id]) {
+    return;
+  }
+  evictable_[frame_id] = false;
+  victims_.erase({ordered_keys_[frame_id], frame_id});
+}
+
+void LRUKReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_ || evictable_[frame_id]) {
+    return;
+  }
+  evictable_[frame_id] = true;
+  if (history_[frame_id * k_].load(std::memory_order_relaxed) == 0) {
+    history_[frame_id * k_].store(current_timestamp_.fetch_add(1, std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+  }
+  ordered_keys_[frame_id] = GetEvictionKey(frame_id);
+  victims_.emplace(ordered_keys_[frame_id], frame_id);
+}
+
+void LRUKReplacer::RecordAccess(frame_id_t frame_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_) {
+    return;
+  }
+  if (last_frame_id_.load(std::memory_order_relaxed) == frame_id &&
+      num_references_[frame_id].load(std::memory_order_relaxed) != 0) {
+    return;
+  }
+  last_frame_id_.store(frame_id, std::memory_order_relaxed);
+  uint64_t now = current_timestamp_.fetch_add(1, std::memory_order_relaxed) + 1;
+  std::atomic<uint64_t> *history = &history_[frame_id * k_];
+  for (size_t i = k_ - 1; i > 0; i--) {
+    history[i].store(history[i - 1].load(std::memory_order_relaxed), std::memory_order_relaxed);
+  }
+  history[0].store(now, std::memory_order_relaxed);
+  if (num_references_[frame_id].load(std::memory_order_relaxed) < k_) {
+    num_references_[frame_id].fetch_add(1, std::memory_order_relaxed);
+  }
+}
+
+void LRUKReplacer::ForgetHistory(frame_id_t frame_id) {
+  if (frame_id < 0 || static_cast<size_t>(frame_id) >= num_pages_) {
+    return;
+  }
+  for (size_t i = 0; i < k_; i++) {
+    history_[frame_id * k_ + i].store(0, std::memory_order_relaxed);
+  }
+  num_references_[frame_id].store(0, std::memory_order_relaxed);
+  // The next reference to this frame belongs to a different page and must not look correlated.
+  frame_id_t last = frame_id;
+  last_frame_id_.compare_exchange_strong(last, -1, std::memory_order_relaxed);
+}
+
+size_t LRUKReplacer::Size() {
+  std::scoped_lock latch(latch_);
+  return victims_.size();
+}
+
+std::vector<frame_id_t> LRUKReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock latch(latch_);
+  std::vector<frame_id_t> frames;
+  frames.reserve(std::min(max_frames, victims_.size()));
+  // Reordering a frame only moves it further back, so every frame passed over has its final place.
+  auto entry = victims_.begin();
+  while (frames.size() < max_frames && entry != victims_.end()) {
+    auto ordered = *entry;
+    if (Reorder(entry)) {
+      entry = victims_.upper_bound(ordered);
+      continue;
+    }
+    frames.push_back(entry->second);
+    ++entry;
+  }
+  return frames;
+}
+
+bool LRUKReplacer::Reorder(std::set<std::pair<EvictionKey, frame_id_t>>::iterator entry) {
+  frame_id_t frame_id = entry->second;
+  EvictionKey key = GetEvictionKey(frame_id);
+  if (!(entry->first < key)) {
+    return false;
+  }
+  victims_.erase(entry);
+  ordered_keys_[frame_id] = key;
+  victims_.emplace(key, frame_id);
+  return true;
+}
+
+LRUKReplacer::EvictionKey LRUKReplacer::GetEvictionKey(frame_id_t frame_id) const {
+  const std::atomic<uint64_t> *history = &history_[frame_id * k_];
+  if (num_references_[frame_id].load(std::memory_order_relaxed) < k_) {
+    return {false, history[0].load(std::memory_order_relaxed)};
+  }
+  return {true, history[k_ - 1].load(std::memory_order_relaxed)};
+}
+
+}  // namespace bustub
@@ -14,16 +14,52 @@
 
 namespace bustub {
 
-LRUReplacer::LRUReplacer(size_t num_pages) {}
+LRUReplacer::LRUReplacer(size_t num_pages) : num_pages_(num_pages) {}
 
 LRUReplacer::~LRUReplacer() = default;
 
-bool LRUReplacer::Victim(frame_id_t *frame_id) { return false; }
+bool LRUReplacer::Victim(frame_id_t *frame_id) {
+  std::scoped_lock latch(latch_);
+  if (lru_list_.empty()) {
+    return false;
+  }
+  *frame_id = lru_list_.front();
+  lru_map_.erase(*frame_id);
+  lru_list_.pop_front();
+  return true;
+}
 
-void LRUReplacer::Pin(frame_id_t frame_id) {}
+void LRUReplacer::Pin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  auto it = lru_map_.find(frame_id);
+  if (it == lru_map_.end()) {
+    return;
+  }
+  lru_list_.erase(it->second);
+  lru_map_.erase(it);
+}
 
-void LRUReplacer::Unpin(frame_id_t frame_id) {}
+void LRUReplacer::Unpin(frame_id_t frame_id) {
+  std::scoped_lock latch(latch_);
+  // Unpinning a frame that is already tracked does not refresh its position.
+  if (lru_map_.count(frame_id) != 0 || lru_list_.size() >= num_pages_) {
+    return;
+  }
+  lru_map_.emplace(frame_id, lru_list_.insert(lru_list_.end(), frame_id));
+}
 
-size_t LRUReplacer::Size() { return 0; }
+size_t LRUReplacer::Size() {
+  std::scoped_lock latch(latch_);
+  return lru_list_.size();
+}
+
+std::vector<frame_id_t> LRUReplacer::PeekVictims(size_t max_frames) {
+  std::scoped_lock latch(latch_);
+  std::vector<frame_id_t> frames;
+  for (auto it = lru_list_.begin(); it != lru_list_.end() && frames.size() < max_frames; ++it) {
+    frames.push_back(*it);
+  }
+  return frames;
+}
 
 }  // namespace bustub
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.cpp
+//
+// Identification: src/buffer/page_table.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/page_table.h"
+
+#include <vector>
+
+namespace bustub {
+
+PageTable::PageTable(size_t num_frames) {
+  // Keep the load factor at or below 1/4 so that probe sequences stay short even with tombstones around.
+  capacity_ = 16;
+  uint32_t bits = 4;
+  while (capacity_ < num_frames * 4) {
+    capacity_ <<= 1;
+    bits++;
+  }
+  slot_mask_ = capacity_ - 1;
+  hash_shift_ = 64 - bits;
+  slots_ = std::make_unique<std::atomic<uint64_t>[]>(capacity_);
+  for (size_t i = 0; i < capacity_; i++) {
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+
+  num_stripes_ = 1;
+  while (num_stripes_ < num_frames && num_stripes_ < 256) {
+    num_stripes_ <<= 1;
+  }
+  stripe_mask_ = num_stripes_ - 1;
+  stripe_latches_ = std::make_unique<std::mutex[]>(num_stripes_);
+}
+
+bool PageTable::Find(page_id_t page_id, frame_id_t *frame_id) const {
+  size_t idx = Home(page_id);
+  for (size_t probes = 0; probes < capacity_; probes++, idx = (idx + 1) & slot_mask_) {
+    uint64_t slot = slots_[idx].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (slot != TOMBSTONE_SLOT && PageOf(slot) == page_id) {
+      *frame_id = FrameOf(slot);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Insert(page_id_t page_id, frame_id_t frame_id) {
+  BUSTUB_ASSERT(page_id != INVALID_PAGE_ID, "cannot map the invalid page id");
+  const uint64_t entry = Pack(page_id, frame_id);
+  size_t idx = Home(page_id);
+  size_t tombstone_idx = capacity_;
+  for (size_t probes = 0; probes < capacity_;) {
+    uint64_t slot = slots_[idx].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      // The key is absent. Prefer recycling the first tombstone on the probe path; slots owned by other stripes can be
+      // claimed concurrently, so every claim is a CAS and a lost race just resumes the scan.
+      if (tombstone_idx != capacity_) {
+        uint64_t expected = TOMBSTONE_SLOT;
+        if (slots_[tombstone_idx].compare_exchange_strong(expected, entry)) {
+          num_tombstones_.fetch_sub(1, std::memory_order_relaxed);
+          return;
+        }
+        tombstone_idx = capacity_;
+        continue;
+      }
+      if (slots_[idx].compare_exchange_strong(slot, entry)) {
+        return;
+      }
+      continue;
+    }
+    if (slot == TOMBSTONE_SLOT) {
+      if (tombstone_idx == capacity_) {
+        tombstone_idx = idx;
+      }
+    } else if (PageOf(slot) == page_id) {
+      slots_[idx].store(entry, std::memory_order_release);
+      return;
+    }
+    probes++;
+    idx = (idx + 1) & slot_mask_;
+  }
+  UNREACHABLE("page table is full");
+}
+
+bool PageTable::Remove(page_id_t page_id) {
+  size_t idx = Home(page_id);
+  for (size_t probes = 0; probes < capacity_; probes++, idx = (idx + 1) & slot_mask_) {
+    uint64_t slot = slots_[idx].load(std::memory_order_acquire);
+    if (slot == EMPTY_SLOT) {
+      return false;
+    }
+    if (slot != TOMBSTONE_SLOT && PageOf(slot) == page_id) {
+      // Never go back to EMPTY here: that would cut the probe path of keys stored further along.
+      slots_[idx].store(TOMBSTONE_SLOT, std::memory_order_release);
+      num_tombstones_.fetch_add(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+void PageTable::Compact() {
+  std::vector<std::unique_lock<std::mutex>> latches;
+  latches.reserve(num_stripes_);
+  for (size_t i = 0; i < num_stripes_; i++) {
+    latches.emplace_back(stripe_latches_[i]);
+  }
+  if (!NeedsCompaction()) {
+    return;
+  }
+
+  // Lock-free readers may miss entries while the table is rebuilt. That is fine: a miss is always re-checked under the
+  // stripe latch, which we hold.
+  std::vector<uint64_t> live;
+  for (size_t i = 0; i < capacity_; i++) {
+    uint64_t slot = slots_[i].load(std::memory_order_relaxed);
+    if (slot != EMPTY_SLOT && slot != TOMBSTONE_SLOT) {
+      live.push_back(slot);
+    }
+    slots_[i].store(EMPTY_SLOT, std::memory_order_relaxed);
+  }
+  for (uint64_t entry : live) {
+    InsertFresh(entry);
+  }
+  num_tombstones_.store(0, std::memory_order_relaxed);
+}
+
+void PageTable::InsertFresh(uint64_t entry) {
+  size_t idx = Home(PageOf(entry));
+  while (slots_[idx].load(std::memory_order_relaxed) != EMPTY_SLOT) {
+    idx = (idx + 1) & slot_mask_;
+  }
+  slots_[idx].store(entry, std::memory_order_release);
+}
+
+}  // namespace bustub
@@ -12,58 +12,111 @@
 
 #include "buffer/parallel_buffer_pool_manager.h"
 
+#include "buffer/frame_region.h"
+
 namespace bustub {
 
 ParallelBufferPoolManager::ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                                                     LogManager *log_manager) {
-  // Allocate and create individual BufferPoolManagerInstances
+                                                     LogManager *log_manager, ReplacerType replacer_type,
+                                                     bool use_huge_pages, bool bind_numa_nodes) {
+  int num_nodes = bind_numa_nodes ? FrameRegion::GetNumNumaNodes() : 0;
+  instances_.reserve(num_instances);
+  for (size_t i = 0; i < num_instances; i++) {
+    int numa_node = bind_numa_nodes ? static_cast<int>(i % num_nodes) : -1;
+    instances_.push_back(new BufferPoolManagerInstance(pool_size, num_instances, i, disk_manager, log_manager,
+                                                       replacer_type, use_huge_pages, numa_node));
+  }
 }
 
-// Update constructor to destruct all BufferPoolManagerInstances and deallocate any associated memory
-ParallelBufferPoolManager::~ParallelBufferPoolManager() = default;
+ParallelBufferPoolManager::~ParallelBufferPoolManager() {
+  for (auto *instance : instances_) {
+    delete instance;
+  }
+}
 
 size_t ParallelBufferPoolManager::GetPoolSize() {
-  // Get size of all BufferPoolManagerInstances
-  return 0;
+  size_t pool_size = 0;
+  for (auto *instance : instances_) {
+    pool_size += instance->GetPoolSize();
+  }
+  return pool_size;
 }
 
 BufferPoolManager *ParallelBufferPoolManager::GetBufferPoolManager(page_id_t page_id) {
-  // Get BufferPoolManager responsible for handling given page id. You can use this method in your other methods.
-  return nullptr;
+  return instances_[page_id % instances_.size()];
 }
 
 Page *ParallelBufferPoolManager::FetchPgImp(page_id_t page_id) {
-  // Fetch page for page_id from responsible BufferPoolManagerInstance
-  return nullptr;
+  return GetBufferPoolManager(page_id)->FetchPage(page_id);
 }
 
 bool ParallelBufferPoolManager::UnpinPgImp(page_id_t page_id, bool is_dirty) {
-  // Unpin page_id from responsible BufferPoolManagerInstance
-  return false;
+  return GetBufferPoolManager(page_id)->UnpinPage(page_id, is_dirty);
 }
 
 bool ParallelBufferPoolManager::FlushPgImp(page_id_t page_id) {
-  // Flush page_id from responsible BufferPoolManagerInstance
-  return false;
+  return GetBufferPoolManager(page_id)->FlushPage(page_id);
 }
 
 Page *ParallelBufferPoolManager::NewPgImp(page_id_t *page_id) {
-  // create new page. We will request page allocation in a round robin manner from the underlying
-  // BufferPoolManagerInstances
-  // 1.   From a starting index of the BPMIs, call NewPageImpl until either 1) success and return 2) looped around to
-  // starting index and return nullptr
-  // 2.   Bump the starting index (mod number of instances) to start search at a different BPMI each time this function
-  // is called
+  // Start at a different instance every call, so that new pages are spread evenly and concurrent callers do not all
+  // contend on the same instance.
+  size_t start = next_instance_.fetch_add(1, std::memory_order_relaxed) % instances_.size();
+  for (size_t i = 0; i < instances_.size(); i++) {
+    Page *page = instances_[(start + i) % instances_.size()]->NewPage(page_id);
+    if (page != nullptr) {
+      return page;
+    }
+  }
   return nullptr;
 }
 
 bool ParallelBufferPoolManager::DeletePgImp(page_id_t page_id) {
-  // Delete page_id from responsible BufferPoolManagerInstance
-  return false;
+  return GetBufferPoolManager(page_id)->DeletePage(page_id);
 }
 
 void ParallelBufferPoolManager::FlushAllPgsImp() {
-  // flush all pages from all BufferPoolManagerInstances
+  for (auto *instance : instances_) {
+    instance->FlushAllPages();
+  }
+}
+
+void ParallelBufferPoolManager::PrefetchPgsImp(const std::vector<page_id_t> &page_ids) {
+  std::vector<std::vector<page_id_t>> per_instance(instances_.size());
+  for (auto page_id : page_ids) {
+    if (page_id != INVALID_PAGE_ID) {
+      per_instance[page_id % instances_.size()].push_back(page_id);
+    }
+  }
+  for (size_t i = 0; i < instances_.size(); i++) {
+    if (!per_instance[i].empty()) {
+      instances_[i]->PrefetchPages(per_instance[i]);
+    }
+  }
+}
+
+void ParallelBufferPoolManager::MarkPgReferencedImp(page_id_t page_id) {
+  GetBufferPoolManager(page_id)->MarkPageReferenced(page_id);
+}
+
+Page *ParallelBufferPoolManager::FetchPgReusingImp(page_id_t page_id, page_id_t reuse_page_id, bool *loaded,
+                                                   bool *reused) {
+  auto *bpm = GetBufferPoolManager(page_id);
+  if (reuse_page_id != INVALID_PAGE_ID && GetBufferPoolManager(reuse_page_id) != bpm) {
+    reuse_page_id = INVALID_PAGE_ID;
+  }
+  return bpm->FetchPageReusing(page_id, reuse_page_id, loaded, reused);
+}
+
+Page *ParallelBufferPoolManager::NewPgReusingImp(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) {
+  if (reuse_page_id != INVALID_PAGE_ID) {
+    Page *page = GetBufferPoolManager(reuse_page_id)->NewPageReusing(page_id, reuse_page_id, reused);
+    if (page != nullptr) {
+      return page;
+    }
+  }
+  *reused = false;
+  return NewPgImp(page_id);
 }
 
 }  // namespace bustub
@@ -0,0 +1,65 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.cpp
+//
+// Identification: src/buffer/read_ahead.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "buffer/read_ahead.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+void ReadAhead::OnPageAccess(page_id_t page_id) {
+  // Without asynchronous reads nothing would be prefetched, so do not walk the chain either.
+  if (bpm_ == nullptr || !next_pages_ || !enable_read_ahead || !bpm_->CanPrefetch() || page_id == INVALID_PAGE_ID ||
+      page_id == last_page_id_) {
+    return;
+  }
+  last_page_id_ = page_id;
+  if (ahead_pos_ < ahead_.size()) {
+    if (ahead_[ahead_pos_] == page_id) {
+      ahead_pos_++;
+    } else {
+      Reset();
+    }
+  }
+  if (++pages_visited_ <= SEQUENTIAL_THRESHOLD || chain_exhausted_) {
+    return;
+  }
+
+  // Issue the next batch once half of the window has been consumed, so that I/O overlaps with the scan.
+  size_t ahead = ahead_.size() - ahead_pos_;
+  if (ahead > window_ / 2) {
+    return;
+  }
+  page_id_t last_known_page_id = ahead == 0 ? page_id : ahead_.back();
+  ahead_.erase(ahead_.begin(), ahead_.begin() + ahead_pos_);
+  ahead_pos_ = 0;
+  size_t max_pages = window_ - ahead;
+  std::vector<page_id_t> page_ids;
+  next_pages_(last_known_page_id, max_pages, &page_ids);
+  chain_exhausted_ = page_ids.size() < max_pages;
+  if (page_ids.empty()) {
+    return;
+  }
+  bpm_->PrefetchPages(page_ids);
+  ahead_.insert(ahead_.end(), page_ids.begin(), page_ids.end());
+  window_ = std::min(window_ * 2, max_window_);
+}
+
+void ReadAhead::Reset() {
+  ahead_.clear();
+  ahead_pos_ = 0;
+  window_ = min_window_;
+  pages_visited_ = 0;
+  chain_exhausted_ = false;
+}
+
+}  // namespace bustub
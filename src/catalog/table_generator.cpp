@@ -70,17 +70,20 @@ void TableGenerator::FillTable(TableInfo *info, TableInsertMeta *table_meta) {
     for (auto &col_meta : table_meta->col_meta_) {
       values.emplace_back(MakeValues(&col_meta, num_values));
     }
+    std::vector<Tuple> tuples;
+    tuples.reserve(num_values);
     for (uint32_t i = 0; i < num_values; i++) {
       std::vector<Value> entry;
       entry.reserve(values.size());
       for (const auto &col : values) {
         entry.emplace_back(col[i]);
       }
-      RID rid;
-      bool inserted = info->table_->InsertTuple(Tuple(entry, &info->schema_), &rid, exec_ctx_->GetTransaction());
-      BUSTUB_ASSERT(inserted, "Sequential insertion cannot fail");
-      num_inserted++;
+      tuples.emplace_back(entry, &info->schema_);
     }
+    std::vector<RID> rids;
+    bool inserted = info->table_->InsertTuples(tuples, &rids, exec_ctx_->GetTransaction());
+    BUSTUB_ASSERT(inserted, "Sequential insertion cannot fail");
+    num_inserted += num_values;
   }
 }
 
@@ -163,19 +166,34 @@ void TableGenerator::GenerateTestTables() {
   };
 
   for (auto &table_meta : insert_meta) {
-    // Create Schema
-    std::vector<Column> cols{};
-    cols.reserve(table_meta.col_meta_.size());
-    for (const auto &col_meta : table_meta.col_meta_) {
-      if (col_meta.type_ != TypeId::VARCHAR) {
-        cols.emplace_back(col_meta.name_, col_meta.type_);
-      } else {
-        cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
-      }
+    CreateAndFillTable(&table_meta);
+  }
+}
+
+TableInfo *TableGenerator::GenerateTest1Table(const std::string &name, uint32_t num_rows) {
+  TableInsertMeta table_meta{name.c_str(),
+                             num_rows,
+                             {{"colA", TypeId::INTEGER, false, Dist::Serial, 0, 0},
+                              {"colB", TypeId::INTEGER, false, Dist::Uniform, 0, 9},
+                              {"colC", TypeId::INTEGER, false, Dist::Uniform, 0, 9999},
+                              {"colD", TypeId::INTEGER, false, Dist::Uniform, 0, 99999}}};
+  return CreateAndFillTable(&table_meta);
+}
+
+TableInfo *TableGenerator::CreateAndFillTable(TableInsertMeta *table_meta) {
+  // Create Schema
+  std::vector<Column> cols{};
+  cols.reserve(table_meta->col_meta_.size());
+  for (const auto &col_meta : table_meta->col_meta_) {
+    if (col_meta.type_ != TypeId::VARCHAR) {
+      cols.emplace_back(col_meta.name_, col_meta.type_);
+    } else {
+      cols.emplace_back(col_meta.name_, col_meta.type_, TEST_VARLEN_SIZE);
     }
-    Schema schema(cols);
-    auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta.name_, schema);
-    FillTable(info, &table_meta);
   }
+  Schema schema(cols);
+  auto info = exec_ctx_->GetCatalog()->CreateTable(exec_ctx_->GetTransaction(), table_meta->name_, schema);
+  FillTable(info, table_meta);
+  return info;
 }
 }  // namespace bustub
@@ -0,0 +1,405 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_state.cpp
+//
+// Identification: src/execution/aggregate_state.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/aggregate_state.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#include "common/exception.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return true if the type is accumulated as an int64_t */
+bool IsIntegerType(TypeId type_id) {
+  return type_id == TypeId::TINYINT || type_id == TypeId::SMALLINT || type_id == TypeId::INTEGER ||
+         type_id == TypeId::BIGINT;
+}
+
+/** @return a non-null integer value widened to 64 bits */
+int64_t IntegerOf(const Value &value) {
+  switch (value.GetTypeId()) {
+    case TypeId::TINYINT:
+      return value.GetAs<int8_t>();
+    case TypeId::SMALLINT:
+      return value.GetAs<int16_t>();
+    case TypeId::INTEGER:
+      return value.GetAs<int32_t>();
+    default:
+      return value.GetAs<int64_t>();
+  }
+}
+
+/** @return a non-null DECIMAL or integer value as a double */
+double DecimalOf(const Value &value) {
+  return value.GetTypeId() == TypeId::DECIMAL ? value.GetAs<double>() : static_cast<double>(IntegerOf(value));
+}
+
+/** Adds addend to the sum of a SUM or AVG over integers, which must not wrap around. */
+void AddToSum(int64_t *sum, int64_t addend) {
+  if (__builtin_add_overflow(*sum, addend, sum)) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "SUM or AVG is out of the range of BIGINT");
+  }
+}
+
+/** @return a COUNT as an INTEGER, which must not wrap around */
+Value MakeCountValue(int64_t count) {
+  if (count > BUSTUB_INT32_MAX) {
+    throw Exception(ExceptionType::OUT_OF_RANGE, "COUNT is out of the range of INTEGER");
+  }
+  return ValueFactory::GetIntegerValue(static_cast<int32_t>(count));
+}
+
+/** @return an integer of the given type; the accumulator never leaves the range of the input type */
+Value MakeIntegerValue(TypeId type_id, int64_t integer) {
+  switch (type_id) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(static_cast<int32_t>(integer));
+    default:
+      return ValueFactory::GetBigIntValue(integer);
+  }
+}
+
+/** @return the number of bytes that Value::SerializeTo() writes for the value */
+uint32_t SerializedSize(const Value &value) {
+  if (value.GetTypeId() == TypeId::VARCHAR) {
+    return sizeof(uint32_t) + (value.IsNull() ? 0 : value.GetLength());
+  }
+  return Type::GetTypeSize(value.GetTypeId());
+}
+
+/** Appends raw bytes to a record. */
+void AppendBytes(const void *data, size_t size, std::vector<char> *record) {
+  size_t offset = record->size();
+  record->resize(offset + size);
+  memcpy(record->data() + offset, data, size);
+}
+
+}  // namespace
+
+Aggregator::Aggregator(const std::vector<const AbstractExpression *> &agg_exprs,
+                       const std::vector<AggregationType> &agg_types) {
+  kinds_.reserve(agg_types.size());
+  input_types_.reserve(agg_types.size());
+  for (size_t i = 0; i < agg_types.size(); i++) {
+    TypeId input_type = agg_exprs[i]->GetReturnType();
+    bool is_integer = IsIntegerType(input_type);
+    bool is_decimal = input_type == TypeId::DECIMAL;
+    if ((agg_types[i] == AggregationType::SumAggregate || agg_types[i] == AggregationType::AvgAggregate) &&
+        !is_integer && !is_decimal) {
+      throw Exception(ExceptionType::MISMATCH_TYPE, "SUM and AVG take integer or DECIMAL inputs");
+    }
+    AccumulatorKind kind = AccumulatorKind::Count;
+    switch (agg_types[i]) {
+      case AggregationType::CountAggregate:
+        kind = AccumulatorKind::Count;
+        break;
+      case AggregationType::CountDistinctAggregate:
+        kind = AccumulatorKind::CountDistinct;
+        has_distinct_ = true;
+        break;
+      case AggregationType::SumAggregate:
+        kind = is_integer ? AccumulatorKind::IntegerSum : AccumulatorKind::DecimalSum;
+        break;
+      case AggregationType::AvgAggregate:
+        kind = is_integer ? AccumulatorKind::IntegerAvg : AccumulatorKind::DecimalAvg;
+        break;
+      case AggregationType::MinAggregate:
+        kind = is_integer ? AccumulatorKind::IntegerMin
+                          : (is_decimal ? AccumulatorKind::DecimalMin : AccumulatorKind::ValueMin);
+        break;
+      case AggregationType::MaxAggregate:
+        kind = is_integer ? AccumulatorKind::IntegerMax
+                          : (is_decimal ? AccumulatorKind::DecimalMax : AccumulatorKind::ValueMax);
+        break;
+    }
+    has_values_ = has_values_ || kind == AccumulatorKind::ValueMin || kind == AccumulatorKind::ValueMax;
+    kinds_.push_back(kind);
+    input_types_.push_back(input_type);
+  }
+}
+
+void Aggregator::Init(AggregateState *state) const {
+  if (kinds_.size() <= AGGREGATION_INLINE_ACCUMULATORS) {
+    std::fill_n(state->inline_.begin(), kinds_.size(), AggregateAccumulator{});
+    state->overflow_.clear();
+  } else {
+    state->overflow_.assign(kinds_.size(), AggregateAccumulator{});
+  }
+  if (has_values_) {
+    state->values_.assign(kinds_.size(), Value());
+  }
+  if (has_distinct_) {
+    state->distinct_.clear();
+    state->distinct_.resize(kinds_.size());
+  }
+}
+
+void Aggregator::Combine(AggregateState *state, const std::vector<Value> &inputs) const {
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    if (!inputs[i].IsNull()) {
+      CombineValue(state, i, inputs[i]);
+    }
+  }
+}
+
+void Aggregator::Combine(AggregateState *state, const std::vector<std::vector<Value>> &columns, uint32_t row) const {
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    const Value &input = columns[i][row];
+    if (!input.IsNull()) {
+      CombineValue(state, i, input);
+    }
+  }
+}
+
+void Aggregator::CombineValue(AggregateState *state, size_t i, const Value &input) const {
+  AggregateAccumulator &acc = state->Accumulators()[i];
+  switch (kinds_[i]) {
+    case AccumulatorKind::Count:
+      break;
+    case AccumulatorKind::CountDistinct:
+      state->distinct_[i].insert(input);
+      break;
+    case AccumulatorKind::IntegerSum:
+    case AccumulatorKind::IntegerAvg:
+      AddToSum(&acc.integer_, IntegerOf(input));
+      break;
+    case AccumulatorKind::DecimalSum:
+    case AccumulatorKind::DecimalAvg:
+      acc.decimal_ += DecimalOf(input);
+      break;
+    case AccumulatorKind::IntegerMin: {
+      int64_t integer = IntegerOf(input);
+      if (acc.count_ == 0 || integer < acc.integer_) {
+        acc.integer_ = integer;
+      }
+      break;
+    }
+    case AccumulatorKind::IntegerMax: {
+      int64_t integer = IntegerOf(input);
+      if (acc.count_ == 0 || integer > acc.integer_) {
+        acc.integer_ = integer;
+      }
+      break;
+    }
+    case AccumulatorKind::DecimalMin: {
+      double decimal = DecimalOf(input);
+      if (acc.count_ == 0 || decimal < acc.decimal_) {
+        acc.decimal_ = decimal;
+      }
+      break;
+    }
+    case AccumulatorKind::DecimalMax: {
+      double decimal = DecimalOf(input);
+      if (acc.count_ == 0 || decimal > acc.decimal_) {
+        acc.decimal_ = decimal;
+      }
+      break;
+    }
+    case AccumulatorKind::ValueMin:
+      if (acc.count_ == 0 || input.CompareLessThan(state->values_[i]) == CmpBool::CmpTrue) {
+        state->values_[i] = input;
+      }
+      break;
+    case AccumulatorKind::ValueMax:
+      if (acc.count_ == 0 || input.CompareGreaterThan(state->values_[i]) == CmpBool::CmpTrue) {
+        state->values_[i] = input;
+      }
+      break;
+  }
+  acc.count_++;
+}
+
+void Aggregator::Merge(AggregateState *state, AggregateState *partial) const {
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    AggregateAccumulator &acc = state->Accumulators()[i];
+    const AggregateAccumulator &other = partial->Accumulators()[i];
+    if (other.count_ == 0) {
+      continue;
+    }
+    switch (kinds_[i]) {
+      case AccumulatorKind::Count:
+        break;
+      case AccumulatorKind::CountDistinct: {
+        // Insert the smaller set into the larger one.
+        auto &distinct = state->distinct_[i];
+        auto &other_distinct = partial->distinct_[i];
+        if (distinct.size() < other_distinct.size()) {
+          distinct.swap(other_distinct);
+        }
+        distinct.insert(other_distinct.begin(), other_distinct.end());
+        break;
+      }
+      case AccumulatorKind::IntegerSum:
+      case AccumulatorKind::IntegerAvg:
+        AddToSum(&acc.integer_, other.integer_);
+        break;
+      case AccumulatorKind::DecimalSum:
+      case AccumulatorKind::DecimalAvg:
+        acc.decimal_ += other.decimal_;
+        break;
+      case AccumulatorKind::IntegerMin:
+        if (acc.count_ == 0 || other.integer_ < acc.integer_) {
+          acc.integer_ = other.integer_;
+        }
+        break;
+      case AccumulatorKind::IntegerMax:
+        if (acc.count_ == 0 || other.integer_ > acc.integer_) {
+          acc.integer_ = other.integer_;
+        }
+        break;
+      case AccumulatorKind::DecimalMin:
+        if (acc.count_ == 0 || other.decimal_ < acc.decimal_) {
+          acc.decimal_ = other.decimal_;
+        }
+        break;
+      case AccumulatorKind::DecimalMax:
+        if (acc.count_ == 0 || other.decimal_ > acc.decimal_) {
+          acc.decimal_ = other.decimal_;
+        }
+        break;
+      case AccumulatorKind::ValueMin:
+        if (acc.count_ == 0 || partial->values_[i].CompareLessThan(state->values_[i]) == CmpBool::CmpTrue) {
+          state->values_[i] = std::move(partial->values_[i]);
+        }
+        break;
+      case AccumulatorKind::ValueMax:
+        if (acc.count_ == 0 || partial->values_[i].CompareGreaterThan(state->values_[i]) == CmpBool::CmpTrue) {
+          state->values_[i] = std::move(partial->values_[i]);
+        }
+        break;
+    }
+    acc.count_ += other.count_;
+  }
+}
+
+void Aggregator::Finalize(const AggregateState &state, std::vector<Value> *values) const {
+  values->resize(kinds_.size());
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    const AggregateAccumulator &acc = state.Accumulators()[i];
+    Value &value = (*values)[i];
+    switch (kinds_[i]) {
+      case AccumulatorKind::Count:
+        value = MakeCountValue(acc.count_);
+        break;
+      case AccumulatorKind::CountDistinct:
+        value = MakeCountValue(static_cast<int64_t>(state.distinct_[i].size()));
+        break;
+      case AccumulatorKind::IntegerSum:
+        if (input_types_[i] == TypeId::BIGINT) {
+          value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(TypeId::BIGINT)
+                                  : ValueFactory::GetBigIntValue(acc.integer_);
+          break;
+        }
+        if (acc.integer_ > BUSTUB_INT32_MAX || acc.integer_ < BUSTUB_INT32_MIN) {
+          throw Exception(ExceptionType::OUT_OF_RANGE, "SUM is out of the range of INTEGER");
+        }
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER)
+                                : ValueFactory::GetIntegerValue(static_cast<int32_t>(acc.integer_));
+        break;
+      case AccumulatorKind::DecimalSum:
+      case AccumulatorKind::DecimalMin:
+      case AccumulatorKind::DecimalMax:
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(TypeId::DECIMAL)
+                                : ValueFactory::GetDecimalValue(acc.decimal_);
+        break;
+      case AccumulatorKind::IntegerAvg:
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(TypeId::DECIMAL)
+                                : ValueFactory::GetDecimalValue(static_cast<double>(acc.integer_) /
+                                                                static_cast<double>(acc.count_));
+        break;
+      case AccumulatorKind::DecimalAvg:
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(TypeId::DECIMAL)
+                                : ValueFactory::GetDecimalValue(acc.decimal_ / static_cast<double>(acc.count_));
+        break;
+      case AccumulatorKind::IntegerMin:
+      case AccumulatorKind::IntegerMax:
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(input_types_[i])
+                                : MakeIntegerValue(input_types_[i], acc.integer_);
+        break;
+      case AccumulatorKind::ValueMin:
+      case AccumulatorKind::ValueMax:
+        value = acc.count_ == 0 ? ValueFactory::GetNullValueByType(input_types_[i]) : state.values_[i];
+        break;
+    }
+  }
+}
+
+size_t Aggregator::GetFootprint(const AggregateState &state) const {
+  size_t footprint = sizeof(AggregateState) + state.overflow_.size() * sizeof(AggregateAccumulator) +
+                     state.values_.size() * sizeof(Value);
+  for (const auto &distinct : state.distinct_) {
+    // A node of the set holds the value, the cached hash and the link to the next node.
+    footprint += sizeof(DistinctValueSet) + distinct.size() * (sizeof(Value) + 2 * sizeof(void *));
+  }
+  return footprint;
+}
+
+void Aggregator::SerializeTo(const AggregateState &state, std::vector<char> *record) const {
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    const AggregateAccumulator &acc = state.Accumulators()[i];
+    AppendBytes(&acc, sizeof(AggregateAccumulator), record);
+    if ((kinds_[i] == AccumulatorKind::ValueMin || kinds_[i] == AccumulatorKind::ValueMax) && acc.count_ > 0) {
+      SerializeValue(state.values_[i], record);
+    } else if (kinds_[i] == AccumulatorKind::CountDistinct) {
+      auto num_values = static_cast<uint32_t>(state.distinct_[i].size());
+      AppendBytes(&num_values, sizeof(uint32_t), record);
+      for (const auto &value : state.distinct_[i]) {
+        SerializeValue(value, record);
+      }
+    }
+  }
+}
+
+void Aggregator::DeserializeFrom(const char **position, AggregateState *state) const {
+  Init(state);
+  for (size_t i = 0; i < kinds_.size(); i++) {
+    AggregateAccumulator &acc = state->Accumulators()[i];
+    memcpy(&acc, *position, sizeof(AggregateAccumulator));
+    *position += sizeof(AggregateAccumulator);
+    if ((kinds_[i] == AccumulatorKind::ValueMin || kinds_[i] == AccumulatorKind::ValueMax) && acc.count_ > 0) {
+      state->values_[i] = DeserializeValue(position);
+    } else if (kinds_[i] == AccumulatorKind::CountDistinct) {
+      uint32_t num_values;
+      memcpy(&num_values, *position, sizeof(uint32_t));
+      *position += sizeof(uint32_t);
+      state->distinct_[i].reserve(num_values);
+      for (uint32_t j = 0; j < num_values; j++) {
+        state->distinct_[i].insert(DeserializeValue(position));
+      }
+    }
+  }
+}
+
+void Aggregator::SerializeValue(const Value &value, std::vector<char> *record) {
+  size_t offset = record->size();
+  record->resize(offset + 1 + SerializedSize(value));
+  (*record)[offset] = static_cast<char>(value.GetTypeId());
+  value.SerializeTo(record->data() + offset + 1);
+}
+
+Value Aggregator::DeserializeValue(const char **position) {
+  auto type_id = static_cast<TypeId>(**position);
+  Value value = Value::DeserializeFrom(*position + 1, type_id);
+  *position += 1 + SerializedSize(value);
+  return value;
+}
+
+}  // namespace bustub
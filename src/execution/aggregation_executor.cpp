@@ -1,29 +1,549 @@
-//===----------------------------------------------------------------------===//
-//
-//                         BusTub
-//
-// aggregation_executor.cpp
-//
-// Identification: src/execution/aggregation_executor.cpp
-//
-// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
-//
-//===----------------------------------------------------------------------===//
-#include <memory>
-#include <vector>
-
-#include "execution/executors/aggregation_executor.h"
-
-namespace bustub {
-
-AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
-                                         std::unique_ptr<AbstractExecutor> &&child)
-    : AbstractExecutor(exec_ctx) {}
-
-void AggregationExecutor::Init() {}
-
-bool AggregationExecutor::Next(Tuple *tuple, RID *rid) { return false; }
-
-const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
-
-}  // namespace bustub
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_executor.cpp
+//
+// Identification: src/execution/aggregation_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executors/aggregation_executor.h"
+
+#include "common/exception.h"
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return the hash of a group; its low bits select the pre-aggregation slot and its high bits the partition */
+hash_t HashGroup(const AggregateKey &key) { return HashUtil::MixHash(std::hash<AggregateKey>()(key)); }
+
+/** The hash bits that each partitioning consumes; a split uses the bits above those of the earlier ones. */
+constexpr uint32_t PARTITION_LEVEL_BITS = 8;
+static_assert(AGGREGATION_PARTITIONS <= (1 << PARTITION_LEVEL_BITS));
+
+/** A partition is not split again after this many splits, e.g. when it holds a single large group. */
+constexpr uint32_t MAX_PARTITION_LEVEL = 32 / PARTITION_LEVEL_BITS - 1;
+
+/** @return the partition that a group with the given hash belongs to, after level splits of the partitions */
+size_t PartitionOf(hash_t hash, uint32_t level) {
+  return (hash >> (32 + level * PARTITION_LEVEL_BITS)) % AGGREGATION_PARTITIONS;
+}
+
+}  // namespace
+
+AggregationExecutor::AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
+                                         std::unique_ptr<AbstractExecutor> &&child)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_(std::move(child)),
+      aht_(plan->GetAggregates(), plan->GetAggregateTypes()),
+      aht_iterator_(aht_.Begin()),
+      having_(CompiledPredicate::CompileAggregate(plan->GetHaving())) {}
+
+AggregationExecutor::~AggregationExecutor() {
+  StopWorkers();
+  DropSpilledPages();
+}
+
+void AggregationExecutor::Init() {
+  StopWorkers();
+  DropSpilledPages();
+  child_->Init();
+  aht_.Clear();
+  aht_iterator_ = aht_.Begin();
+
+  size_t num_threads = exec_ctx_->GetParallelism();
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  if (num_threads > 1 || budget > 0) {
+    worker_error_ = nullptr;
+    num_spilled_pages_ = 0;
+    num_split_partitions_ = 0;
+    // Each worker gets an equal share of the budget, in both phases.
+    worker_budget_ = budget > 0 ? std::max<size_t>(budget / num_threads, 1) : 0;
+    PreAggregateParallel(num_threads);
+    next_partition_ = 0;
+    exchange_ = std::make_unique<Exchange>(num_threads, 2 * num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back([this] { MergePartitions(); });
+    }
+    return;
+  }
+
+  BuildHashTable();
+  aht_iterator_ = aht_.Begin();
+}
+
+void AggregationExecutor::BuildHashTable() {
+  if (!exec_ctx_->IsBatchExecution()) {
+    Tuple tuple;
+    RID rid;
+    while (child_->Next(&tuple, &rid)) {
+      aht_.InsertCombine(MakeAggregateKey(&tuple), MakeAggregateValue(&tuple));
+    }
+    return;
+  }
+
+  // Evaluate every group-by and aggregate expression over a whole batch, then combine the batch row by row.
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  std::vector<std::vector<Value>> group_by_columns(group_bys.size());
+  std::vector<std::vector<Value>> aggregate_columns(aggregates.size());
+  TupleBatch batch;
+  while (child_->NextBatch(&batch)) {
+    for (size_t i = 0; i < group_bys.size(); i++) {
+      group_bys[i]->EvaluateBatch(batch, &group_by_columns[i]);
+    }
+    for (size_t i = 0; i < aggregates.size(); i++) {
+      aggregates[i]->EvaluateBatch(batch, &aggregate_columns[i]);
+    }
+    AggregateKey key;
+    key.group_bys_.resize(group_bys.size());
+    for (uint32_t row : batch.GetSelection()) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        key.group_bys_[i] = group_by_columns[i][row];
+      }
+      aht_.InsertCombine(key, aggregate_columns, row);
+    }
+  }
+}
+
+void AggregationExecutor::PreAggregateParallel(size_t num_threads) {
+  pre_aggregations_.resize(num_threads);
+  Exchange input(1, 2 * num_threads);
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (auto &state : pre_aggregations_) {
+    threads.emplace_back([this, &state, &input] { PreAggregate(&state, &input); });
+  }
+
+  // The child is not thread-safe: this thread pulls its batches and the workers only aggregate them.
+  TupleBatch batch;
+  try {
+    bool open = true;
+    while (open && child_->NextBatch(&batch)) {
+      open = input.Push(&batch);
+    }
+  } catch (...) {
+    SetWorkerError(std::current_exception());
+  }
+  input.ProducerDone();
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  CheckWorkerError();
+}
+
+void AggregationExecutor::PreAggregate(PreAggregation *state, Exchange *input) {
+  // The table takes at most half of the budget, which leaves the other half to the partitions.
+  size_t num_slots = AGGREGATION_PREAGG_SLOTS;
+  if (worker_budget_ > 0) {
+    num_slots = std::clamp<size_t>(worker_budget_ / (2 * sizeof(PartialAggregate)), 1, AGGREGATION_PREAGG_SLOTS);
+  }
+  state->slots_.resize(num_slots);
+  state->occupied_.assign(num_slots, false);
+  state->buffered_bytes_ = num_slots * sizeof(PartialAggregate);
+  state->partitions_.resize(AGGREGATION_PARTITIONS);
+  state->spilled_pages_.resize(AGGREGATION_PARTITIONS);
+  const auto &group_bys = plan_->GetGroupBys();
+  const auto &aggregates = plan_->GetAggregates();
+  std::vector<std::vector<Value>> group_by_columns(group_bys.size());
+  std::vector<std::vector<Value>> aggregate_columns(aggregates.size());
+  const Aggregator &aggregator = aht_.GetAggregator();
+  bool states_grow = aggregator.HasDistinct();
+  AggregateKey key;
+  key.group_bys_.resize(group_bys.size());
+  TupleBatch batch;
+  try {
+    while (input->Pop(&batch)) {
+      for (size_t i = 0; i < group_bys.size(); i++) {
+        group_bys[i]->EvaluateBatch(batch, &group_by_columns[i]);
+      }
+      for (size_t i = 0; i < aggregates.size(); i++) {
+        aggregates[i]->EvaluateBatch(batch, &aggregate_columns[i]);
+      }
+      for (uint32_t row : batch.GetSelection()) {
+        for (size_t i = 0; i < group_bys.size(); i++) {
+          key.group_bys_[i] = group_by_columns[i][row];
+        }
+        hash_t hash = HashGroup(key);
+        size_t slot_idx = hash % state->slots_.size();
+        PartialAggregate &slot = state->slots_[slot_idx];
+        if (state->occupied_[slot_idx] && (slot.hash_ != hash || !(slot.key_ == key))) {
+          // Another group holds the slot: the newer group replaces it.
+          Evict(state, &slot);
+          state->occupied_[slot_idx] = false;
+        }
+        if (!state->occupied_[slot_idx]) {
+          slot.hash_ = hash;
+          slot.key_ = key;
+          aggregator.Init(&slot.state_);
+          state->occupied_[slot_idx] = true;
+          state->buffered_bytes_ += GetFootprint(slot) - sizeof(PartialAggregate);
+        }
+        if (states_grow) {
+          size_t footprint = aggregator.GetFootprint(slot.state_);
+          aggregator.Combine(&slot.state_, aggregate_columns, row);
+          state->buffered_bytes_ += aggregator.GetFootprint(slot.state_) - footprint;
+        } else {
+          aggregator.Combine(&slot.state_, aggregate_columns, row);
+        }
+        if (worker_budget_ > 0 && state->buffered_bytes_ > worker_budget_) {
+          ReleaseMemory(state);
+        }
+      }
+    }
+
+    for (size_t slot_idx = 0; slot_idx < state->slots_.size(); slot_idx++) {
+      if (state->occupied_[slot_idx]) {
+        Evict(state, &state->slots_[slot_idx]);
+        state->occupied_[slot_idx] = false;
+      }
+    }
+    if (worker_budget_ > 0 && state->buffered_bytes_ > worker_budget_) {
+      ReleaseMemory(state);
+    }
+  } catch (...) {
+    SetWorkerError(std::current_exception());
+    input->Close();
+  }
+}
+
+void AggregationExecutor::Evict(PreAggregation *state, PartialAggregate *partial) {
+  // The key and the state were counted when the group entered the table; only the entry of the partition is new.
+  state->buffered_bytes_ += sizeof(PartialAggregate);
+  state->partitions_[PartitionOf(partial->hash_, 0)].push_back(std::move(*partial));
+}
+
+void AggregationExecutor::ReleaseMemory(PreAggregation *state) {
+  state->buffered_bytes_ -= SpillPartitions(&state->partitions_, &state->spilled_pages_);
+  if (state->buffered_bytes_ <= worker_budget_) {
+    return;
+  }
+  // The groups in the table take the rest, e.g. with large COUNT(DISTINCT) sets: write them out as well.
+  for (size_t slot_idx = 0; slot_idx < state->slots_.size(); slot_idx++) {
+    if (state->occupied_[slot_idx]) {
+      Evict(state, &state->slots_[slot_idx]);
+      state->occupied_[slot_idx] = false;
+    }
+  }
+  state->buffered_bytes_ -= SpillPartitions(&state->partitions_, &state->spilled_pages_);
+}
+
+size_t AggregationExecutor::GetFootprint(const PartialAggregate &partial) const {
+  return sizeof(PartialAggregate) + partial.key_.group_bys_.size() * sizeof(Value) +
+         aht_.GetAggregator().GetFootprint(partial.state_);
+}
+
+size_t AggregationExecutor::SpillPartitions(std::vector<std::vector<PartialAggregate>> *partitions,
+                                            std::vector<std::vector<page_id_t>> *pages) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  std::vector<char> record;
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  size_t spilled_bytes = 0;
+  for (size_t p = 0; p < partitions->size(); p++) {
+    // Only one page of the worker is pinned at a time.
+    TmpTuplePage *page = nullptr;
+    for (const auto &partial : (*partitions)[p]) {
+      spilled_bytes += GetFootprint(partial);
+      record.clear();
+      for (const auto &value : partial.key_.group_bys_) {
+        Aggregator::SerializeValue(value, &record);
+      }
+      aht_.GetAggregator().SerializeTo(partial.state_, &record);
+      if (page != nullptr && page->Insert(record.data(), record.size(), &location)) {
+        continue;
+      }
+      if (page != nullptr) {
+        bpm->UnpinPage(page->GetTablePageId(), true);
+      }
+      page_id_t page_id;
+      page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+      if (page == nullptr) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to spill an aggregation partition");
+      }
+      page->Init(page_id, PAGE_SIZE);
+      (*pages)[p].push_back(page_id);
+      num_spilled_pages_++;
+      if (!page->Insert(record.data(), record.size(), &location)) {
+        throw Exception(ExceptionType::OUT_OF_MEMORY, "a partial aggregate does not fit in a temporary page");
+      }
+    }
+    if (page != nullptr) {
+      bpm->UnpinPage(page->GetTablePageId(), true);
+    }
+    (*partitions)[p].clear();
+  }
+  return spilled_bytes;
+}
+
+void AggregationExecutor::MergePartitions() {
+  PartitionMerge merge(plan_);
+  TupleBatch batch;
+  batch.Reset(plan_->OutputSchema()->GetColumnCount());
+  bool open = true;
+  try {
+    for (size_t p = next_partition_++; open && p < AGGREGATION_PARTITIONS; p = next_partition_++) {
+      // Only the worker that claimed partition p touches the partition p of every worker.
+      merge.level_ = 0;
+      for (auto &state : pre_aggregations_) {
+        for (auto &partial : state.partitions_[p]) {
+          MergePartial(std::move(partial.key_), std::move(partial.state_), &merge);
+        }
+        state.partitions_[p].clear();
+        state.partitions_[p].shrink_to_fit();
+        auto &pages = state.spilled_pages_[p];
+        while (!pages.empty()) {
+          MergeSpilledPage(pages.back(), &merge);
+          pages.pop_back();
+        }
+      }
+      open = FinishMerge(&merge, &batch);
+
+      // The parts of a split partition are merged like partitions of their own, and may be split again.
+      while (open && !merge.pending_.empty()) {
+        merge.level_ = merge.pending_.back().first;
+        auto &pages = merge.pending_.back().second;
+        while (!pages.empty()) {
+          MergeSpilledPage(pages.back(), &merge);
+          pages.pop_back();
+        }
+        merge.pending_.pop_back();
+        open = FinishMerge(&merge, &batch);
+      }
+    }
+    if (open && batch.GetNumRows() > 0) {
+      batch.SelectAll();
+      exchange_->Push(&batch);
+    }
+  } catch (...) {
+    SetWorkerError(std::current_exception());
+  }
+  DropParts(&merge);
+  exchange_->ProducerDone();
+}
+
+void AggregationExecutor::MergePartial(AggregateKey &&key, AggregateState &&state, PartitionMerge *merge) {
+  if (!merge->parts_.empty()) {
+    AddToPart(std::move(key), std::move(state), merge);
+    return;
+  }
+  merge->table_bytes_ += merge->table_.MergeInsert(std::move(key), std::move(state));
+  if (worker_budget_ == 0 || merge->table_bytes_ <= worker_budget_ || merge->level_ >= MAX_PARTITION_LEVEL) {
+    return;
+  }
+  // Still too large: split the partition with the next bits of the hash. The groups merged so far and the partial
+  // aggregates still to come go to the parts, which are merged one after the other.
+  num_split_partitions_++;
+  merge->parts_.resize(AGGREGATION_PARTITIONS);
+  merge->part_pages_.resize(AGGREGATION_PARTITIONS);
+  merge->table_.Drain([this, merge](AggregateKey &&group_key, AggregateState &&group_state) {
+    AddToPart(std::move(group_key), std::move(group_state), merge);
+  });
+  merge->table_bytes_ = 0;
+}
+
+void AggregationExecutor::AddToPart(AggregateKey &&key, AggregateState &&state, PartitionMerge *merge) {
+  hash_t hash = HashGroup(key);
+  auto &part = merge->parts_[PartitionOf(hash, merge->level_ + 1)];
+  part.push_back(PartialAggregate{hash, std::move(key), std::move(state)});
+  merge->parts_bytes_ += GetFootprint(part.back());
+  if (merge->parts_bytes_ > worker_budget_) {
+    merge->parts_bytes_ -= SpillPartitions(&merge->parts_, &merge->part_pages_);
+  }
+}
+
+bool AggregationExecutor::FinishMerge(PartitionMerge *merge, TupleBatch *batch) {
+  if (!merge->parts_.empty()) {
+    SpillPartitions(&merge->parts_, &merge->part_pages_);
+    for (auto &pages : merge->part_pages_) {
+      if (!pages.empty()) {
+        merge->pending_.emplace_back(merge->level_ + 1, std::move(pages));
+      }
+    }
+    merge->parts_.clear();
+    merge->part_pages_.clear();
+    merge->parts_bytes_ = 0;
+    return true;
+  }
+
+  const Schema *output_schema = plan_->OutputSchema();
+  AggregateValue val;
+  bool open = true;
+  for (auto iter = merge->table_.Begin(); open && iter != merge->table_.End(); ++iter) {
+    merge->table_.GetAggregator().Finalize(iter.Val(), &val.aggregates_);
+    const auto &group_bys = iter.Key().group_bys_;
+    const auto &aggregates = val.aggregates_;
+    if (!having_.EvaluateAggregate(group_bys, aggregates)) {
+      continue;
+    }
+    for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+      batch->GetMutableColumn(col_idx)->push_back(
+          output_schema->GetColumn(col_idx).GetExpr()->EvaluateAggregate(group_bys, aggregates));
+    }
+    batch->GetMutableRids()->emplace_back();
+    if (batch->IsFull()) {
+      batch->SelectAll();
+      open = exchange_->Push(batch);
+      batch->Reset(output_schema->GetColumnCount());
+    }
+  }
+  merge->table_.Clear();
+  merge->table_bytes_ = 0;
+  return open;
+}
+
+void AggregationExecutor::DropParts(PartitionMerge *merge) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  for (const auto &pages : merge->part_pages_) {
+    for (page_id_t page_id : pages) {
+      bpm->DeletePage(page_id);
+    }
+  }
+  for (const auto &part : merge->pending_) {
+    for (page_id_t page_id : part.second) {
+      bpm->DeletePage(page_id);
+    }
+  }
+  merge->parts_.clear();
+  merge->part_pages_.clear();
+  merge->pending_.clear();
+}
+
+void AggregationExecutor::MergeSpilledPage(page_id_t page_id, PartitionMerge *merge) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read an aggregation partition");
+  }
+  std::vector<Tuple> records;
+  page->GetTuples(&records);
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+
+  size_t num_group_bys = plan_->GetGroupBys().size();
+  for (const auto &record : records) {
+    const char *position = record.GetData();
+    AggregateKey key;
+    AggregateState state;
+    key.group_bys_.reserve(num_group_bys);
+    for (size_t i = 0; i < num_group_bys; i++) {
+      key.group_bys_.push_back(Aggregator::DeserializeValue(&position));
+    }
+    merge->table_.GetAggregator().DeserializeFrom(&position, &state);
+    MergePartial(std::move(key), std::move(state), merge);
+  }
+}
+
+void AggregationExecutor::SetWorkerError(std::exception_ptr error) {
+  std::scoped_lock latch(worker_error_latch_);
+  if (worker_error_ == nullptr) {
+    worker_error_ = std::move(error);
+  }
+}
+
+void AggregationExecutor::CheckWorkerError() {
+  std::exception_ptr error;
+  {
+    std::scoped_lock latch(worker_error_latch_);
+    error = worker_error_;
+  }
+  if (error != nullptr) {
+    std::rethrow_exception(error);
+  }
+}
+
+void AggregationExecutor::StopWorkers() {
+  if (exchange_ == nullptr) {
+    return;
+  }
+  exchange_->Close();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  exchange_.reset();
+}
+
+void AggregationExecutor::DropSpilledPages() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  for (const auto &state : pre_aggregations_) {
+    for (const auto &pages : state.spilled_pages_) {
+      for (page_id_t page_id : pages) {
+        bpm->DeletePage(page_id);
+      }
+    }
+  }
+  pre_aggregations_.clear();
+}
+
+bool AggregationExecutor::NextGroup(const AggregateKey **key, const AggregateValue **val) {
+  while (aht_iterator_ != aht_.End()) {
+    *key = &aht_iterator_.Key();
+    aht_.GetAggregator().Finalize(aht_iterator_.Val(), &group_val_.aggregates_);
+    *val = &group_val_;
+    ++aht_iterator_;
+    if (having_.EvaluateAggregate((*key)->group_bys_, (*val)->aggregates_)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool AggregationExecutor::Next(Tuple *tuple, RID *rid) {
+  if (exchange_ != nullptr) {
+    if (exchange_->PopTuple(plan_->OutputSchema(), tuple, rid)) {
+      return true;
+    }
+    CheckWorkerError();
+    return false;
+  }
+  const AggregateKey *key;
+  const AggregateValue *val;
+  if (!NextGroup(&key, &val)) {
+    return false;
+  }
+  const Schema *output_schema = plan_->OutputSchema();
+  std::vector<Value> values;
+  values.reserve(output_schema->GetColumnCount());
+  for (const auto &column : output_schema->GetColumns()) {
+    values.push_back(column.GetExpr()->EvaluateAggregate(key->group_bys_, val->aggregates_));
+  }
+  *tuple = Tuple(values, output_schema);
+  return true;
+}
+
+bool AggregationExecutor::NextBatch(TupleBatch *batch) {
+  if (exchange_ != nullptr) {
+    if (exchange_->Pop(batch)) {
+      return true;
+    }
+    CheckWorkerError();
+    return false;
+  }
+  const Schema *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  const AggregateKey *key;
+  const AggregateValue *val;
+  while (!batch->IsFull() && NextGroup(&key, &val)) {
+    for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+      batch->GetMutableColumn(col_idx)->push_back(
+          output_schema->GetColumn(col_idx).GetExpr()->EvaluateAggregate(key->group_bys_, val->aggregates_));
+    }
+    batch->GetMutableRids()->emplace_back();
+  }
+  batch->SelectAll();
+  return batch->GetNumSelected() > 0;
+}
+
+const AbstractExecutor *AggregationExecutor::GetChildExecutor() const { return child_.get(); }
+
+}  // namespace bustub
@@ -0,0 +1,282 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_filter.cpp
+//
+// Identification: src/execution/column_filter.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/column_filter.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+#include "common/macros.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+/** The most live slots a page can have */
+constexpr uint32_t MAX_SLOTS = TablePage::GetMaxTupleCount();
+/** The number of words of a selection bitmap over the slots of a page */
+constexpr uint32_t BITMAP_WORDS = (MAX_SLOTS + 63) / 64;
+
+/**
+ * Lanes<T> compares a vector of values of machine type T at a time, each comparison yielding one bit per lane. The
+ * primary template is for the types and targets without a vector comparison.
+ */
+template <typename T>
+struct Lanes {
+  static constexpr bool SUPPORTED = false;
+};
+
+#if defined(__AVX2__)
+
+template <>
+struct Lanes<int32_t> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 8;
+  using Vector = __m256i;
+  static Vector Load(const int32_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vector Broadcast(int32_t value) { return _mm256_set1_epi32(value); }
+  static uint32_t Greater(Vector a, Vector b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(a, b)));
+  }
+  static uint32_t Equal(Vector a, Vector b) {
+    return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+  }
+};
+
+template <>
+struct Lanes<int64_t> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 4;
+  using Vector = __m256i;
+  static Vector Load(const int64_t *values) { return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(values)); }
+  static Vector Broadcast(int64_t value) { return _mm256_set1_epi64x(value); }
+  static uint32_t Greater(Vector a, Vector b) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(a, b)));
+  }
+  static uint32_t Equal(Vector a, Vector b) {
+    return _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(a, b)));
+  }
+};
+
+template <>
+struct Lanes<double> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 4;
+  using Vector = __m256d;
+  static Vector Load(const double *values) { return _mm256_loadu_pd(values); }
+  static Vector Broadcast(double value) { return _mm256_set1_pd(value); }
+  static uint32_t Greater(Vector a, Vector b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_GT_OQ)); }
+  static uint32_t Equal(Vector a, Vector b) { return _mm256_movemask_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ)); }
+};
+
+#elif defined(__SSE2__)
+
+template <>
+struct Lanes<int32_t> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 4;
+  using Vector = __m128i;
+  static Vector Load(const int32_t *values) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)); }
+  static Vector Broadcast(int32_t value) { return _mm_set1_epi32(value); }
+  static uint32_t Greater(Vector a, Vector b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpgt_epi32(a, b))); }
+  static uint32_t Equal(Vector a, Vector b) { return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b))); }
+};
+
+#if defined(__SSE4_2__)
+template <>
+struct Lanes<int64_t> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 2;
+  using Vector = __m128i;
+  static Vector Load(const int64_t *values) { return _mm_loadu_si128(reinterpret_cast<const __m128i *>(values)); }
+  static Vector Broadcast(int64_t value) { return _mm_set1_epi64x(value); }
+  static uint32_t Greater(Vector a, Vector b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(a, b))); }
+  static uint32_t Equal(Vector a, Vector b) { return _mm_movemask_pd(_mm_castsi128_pd(_mm_cmpeq_epi64(a, b))); }
+};
+#endif
+
+template <>
+struct Lanes<double> {
+  static constexpr bool SUPPORTED = true;
+  static constexpr uint32_t WIDTH = 2;
+  using Vector = __m128d;
+  static Vector Load(const double *values) { return _mm_loadu_pd(values); }
+  static Vector Broadcast(double value) { return _mm_set1_pd(value); }
+  static uint32_t Greater(Vector a, Vector b) { return _mm_movemask_pd(_mm_cmpgt_pd(a, b)); }
+  static uint32_t Equal(Vector a, Vector b) { return _mm_movemask_pd(_mm_cmpeq_pd(a, b)); }
+};
+
+#endif
+
+/*
+ * The comparisons, each both on a pair of values and on a vector of values and a broadcast constant. The vector forms
+ * build every comparison from Greater() and Equal(); the caller masks off the lanes beyond the width.
+ */
+
+struct EqualOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value == constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return L::Equal(values, constant);
+  }
+};
+
+struct NotEqualOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value != constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return ~L::Equal(values, constant);
+  }
+};
+
+struct LessOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value < constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return L::Greater(constant, values);
+  }
+};
+
+struct LessEqualOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value <= constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return ~L::Greater(values, constant);
+  }
+};
+
+struct GreaterOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value > constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return L::Greater(values, constant);
+  }
+};
+
+struct GreaterEqualOp {
+  template <typename T>
+  static bool Holds(T value, T constant) {
+    return value >= constant;
+  }
+  template <typename L, typename V>
+  static uint32_t Bits(V values, V constant) {
+    return ~L::Greater(constant, values);
+  }
+};
+
+/**
+ * Sets bit i of the bitmap for every non-null value i that satisfies the comparison with the constant.
+ * @param use_simd false to compare with the scalar loop only
+ */
+template <typename T, typename Op>
+void CompareValues(const T *values, uint32_t num_values, T constant, bool use_simd, uint64_t *bitmap) {
+  uint32_t i = 0;
+  if constexpr (Lanes<T>::SUPPORTED) {
+    using L = Lanes<T>;
+    if (use_simd) {
+      constexpr uint32_t lane_mask = (1U << L::WIDTH) - 1;
+      typename L::Vector constants = L::Broadcast(constant);
+      typename L::Vector nulls = L::Broadcast(NullOf<T>());
+      // WIDTH divides 64, so the bits of a vector never straddle two words.
+      for (; i + L::WIDTH <= num_values; i += L::WIDTH) {
+        typename L::Vector vector = L::Load(values + i);
+        uint32_t bits = Op::template Bits<L>(vector, constants) & ~L::Equal(vector, nulls) & lane_mask;
+        bitmap[i / 64] |= static_cast<uint64_t>(bits) << (i % 64);
+      }
+    }
+  }
+  for (; i < num_values; i++) {
+    if (values[i] != NullOf<T>() && Op::Holds(values[i], constant)) {
+      bitmap[i / 64] |= uint64_t{1} << (i % 64);
+    }
+  }
+}
+
+/** Gathers the column of a page, compares it with the constant and appends the slots that match. */
+template <typename T>
+void FilterPage(TablePage *page, uint32_t column_offset, ComparisonType comp_type, T constant, bool use_simd,
+                std::vector<uint32_t> *slots) {
+  uint32_t live_slots[MAX_SLOTS];
+  T values[MAX_SLOTS];
+  uint64_t bitmap[BITMAP_WORDS] = {};
+  uint32_t num_live = page->GatherColumn(column_offset, sizeof(T), live_slots, reinterpret_cast<char *>(values));
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      CompareValues<T, EqualOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+    case ComparisonType::NotEqual:
+      CompareValues<T, NotEqualOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+    case ComparisonType::LessThan:
+      CompareValues<T, LessOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+    case ComparisonType::LessThanOrEqual:
+      CompareValues<T, LessEqualOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+    case ComparisonType::GreaterThan:
+      CompareValues<T, GreaterOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+    case ComparisonType::GreaterThanOrEqual:
+      CompareValues<T, GreaterEqualOp>(values, num_live, constant, use_simd, bitmap);
+      break;
+  }
+  for (uint32_t word = 0; word * 64 < num_live; word++) {
+    for (uint64_t bits = bitmap[word]; bits != 0; bits &= bits - 1) {
+      slots->push_back(live_slots[word * 64 + __builtin_ctzll(bits)]);
+    }
+  }
+}
+
+}  // namespace
+
+void ColumnFilter::Filter(TablePage *page, std::vector<uint32_t> *slots) const {
+  uint32_t offset = comparison_.offset_;
+  ComparisonType comp_type = comparison_.comp_type_;
+  switch (comparison_.type_) {
+    case TypeId::TINYINT:
+      FilterPage(page, offset, comp_type, static_cast<int8_t>(comparison_.integer_), use_simd_, slots);
+      break;
+    case TypeId::SMALLINT:
+      FilterPage(page, offset, comp_type, static_cast<int16_t>(comparison_.integer_), use_simd_, slots);
+      break;
+    case TypeId::INTEGER:
+      FilterPage(page, offset, comp_type, static_cast<int32_t>(comparison_.integer_), use_simd_, slots);
+      break;
+    case TypeId::BIGINT:
+      FilterPage(page, offset, comp_type, comparison_.integer_, use_simd_, slots);
+      break;
+    case TypeId::DECIMAL:
+      FilterPage(page, offset, comp_type, comparison_.decimal_, use_simd_, slots);
+      break;
+    default:
+      UNREACHABLE("A column filter compares a fixed-width numeric column.");
+  }
+}
+
+}  // namespace bustub
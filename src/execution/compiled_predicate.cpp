@@ -0,0 +1,397 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.cpp
+//
+// Identification: src/execution/compiled_predicate.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/compiled_predicate.h"
+
+#include <cstring>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "type/limits.h"
+
+namespace bustub {
+
+namespace {
+
+using TupleFunction = CompiledPredicate::TupleFunction;
+using AggregateFunction = CompiledPredicate::AggregateFunction;
+
+/** @return the value of machine type T stored at an offset of the tuple */
+template <typename T>
+T Load(const Tuple *tuple, uint32_t offset) {
+  T value;
+  memcpy(&value, tuple->GetData() + offset, sizeof(T));
+  return value;
+}
+
+/** Calls make with a value of the machine type of type_id; returns an empty function if the type has none. */
+template <typename Function, typename Make>
+Function WithMachineType(TypeId type_id, Make &&make) {
+  switch (type_id) {
+    case TypeId::TINYINT:
+      return make(int8_t{});
+    case TypeId::SMALLINT:
+      return make(int16_t{});
+    case TypeId::INTEGER:
+      return make(int32_t{});
+    case TypeId::BIGINT:
+      return make(int64_t{});
+    case TypeId::DECIMAL:
+      return make(double{});
+    default:
+      return {};
+  }
+}
+
+/** Calls make with the function object of a comparison over machine type T. */
+template <typename T, typename Function, typename Make>
+Function WithOperator(ComparisonType comp_type, Make &&make) {
+  switch (comp_type) {
+    case ComparisonType::Equal:
+      return make(std::equal_to<T>{});
+    case ComparisonType::NotEqual:
+      return make(std::not_equal_to<T>{});
+    case ComparisonType::LessThan:
+      return make(std::less<T>{});
+    case ComparisonType::LessThanOrEqual:
+      return make(std::less_equal<T>{});
+    case ComparisonType::GreaterThan:
+      return make(std::greater<T>{});
+    case ComparisonType::GreaterThanOrEqual:
+      return make(std::greater_equal<T>{});
+  }
+  return {};
+}
+
+/** @return the comparison that holds for (b, a) whenever comp_type holds for (a, b) */
+ComparisonType Flip(ComparisonType comp_type) {
+  switch (comp_type) {
+    case ComparisonType::LessThan:
+      return ComparisonType::GreaterThan;
+    case ComparisonType::LessThanOrEqual:
+      return ComparisonType::GreaterThanOrEqual;
+    case ComparisonType::GreaterThan:
+      return ComparisonType::LessThan;
+    case ComparisonType::GreaterThanOrEqual:
+      return ComparisonType::LessThanOrEqual;
+    default:
+      return comp_type;
+  }
+}
+
+/**
+ * Converts a constant to the machine type T of the operand it is compared with.
+ * @return false if the constant is NULL or its value has no exact counterpart in T
+ */
+template <typename T>
+bool ConvertConstant(const Value &constant, T *converted) {
+  if (constant.IsNull()) {
+    return false;
+  }
+  int64_t integer;
+  switch (constant.GetTypeId()) {
+    case TypeId::TINYINT:
+      integer = constant.GetAs<int8_t>();
+      break;
+    case TypeId::SMALLINT:
+      integer = constant.GetAs<int16_t>();
+      break;
+    case TypeId::INTEGER:
+      integer = constant.GetAs<int32_t>();
+      break;
+    case TypeId::BIGINT:
+      integer = constant.GetAs<int64_t>();
+      break;
+    case TypeId::DECIMAL:
+      // An integer operand is compared with a DECIMAL constant as a double; that is left to the interpreter.
+      if constexpr (std::is_same_v<T, double>) {
+        *converted = constant.GetAs<double>();
+        return true;
+      }
+      return false;
+    default:
+      return false;
+  }
+  if constexpr (std::is_same_v<T, double>) {
+    *converted = static_cast<double>(integer);
+    return true;
+  } else {
+    // The smallest value of an integer type stands for NULL.
+    if (integer <= static_cast<int64_t>(std::numeric_limits<T>::min()) ||
+        integer > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+      return false;
+    }
+    *converted = static_cast<T>(integer);
+    return true;
+  }
+}
+
+/** What an operand of a compiled comparison reads. */
+enum class OperandKind { Column, Term, Constant };
+
+/** An operand of a comparison, bound to where its value comes from. */
+struct Operand {
+  /** What the operand reads */
+  OperandKind kind_{OperandKind::Constant};
+  /** The type of the operand */
+  TypeId type_{TypeId::INVALID};
+  /** The tuple a column is read from: 0 for the left (or only) tuple, 1 for the right */
+  uint32_t side_{0};
+  /** The offset of a column in the tuple */
+  uint32_t offset_{0};
+  /** True if a term is a group-by term, false if it is an aggregate */
+  bool is_group_by_{false};
+  /** The index of a term */
+  uint32_t term_idx_{0};
+  /** The value of a constant */
+  Value constant_;
+};
+
+/**
+ * Binds a leaf of a comparison to where its value comes from.
+ * @param expr the leaf
+ * @param schemas the schemas of the left and right tuples, or nullptr; both are nullptr for a HAVING clause
+ * @param[out] operand the bound operand
+ * @return false if the leaf cannot be compiled
+ */
+bool Bind(const AbstractExpression *expr, const Schema *const schemas[2], Operand *operand) {
+  if (const auto *constant = dynamic_cast<const ConstantValueExpression *>(expr); constant != nullptr) {
+    operand->kind_ = OperandKind::Constant;
+    operand->constant_ = constant->Evaluate(nullptr, nullptr);
+    operand->type_ = operand->constant_.GetTypeId();
+    return true;
+  }
+  if (const auto *column = dynamic_cast<const ColumnValueExpression *>(expr); column != nullptr) {
+    uint32_t side = column->GetTupleIdx();
+    if (side > 1 || schemas[side] == nullptr) {
+      return false;
+    }
+    const Column &schema_column = schemas[side]->GetColumn(column->GetColIdx());
+    operand->kind_ = OperandKind::Column;
+    operand->type_ = schema_column.GetType();
+    operand->side_ = side;
+    operand->offset_ = schema_column.GetOffset();
+    return schema_column.IsInlined();
+  }
+  if (const auto *term = dynamic_cast<const AggregateValueExpression *>(expr); term != nullptr) {
+    if (schemas[0] != nullptr || schemas[1] != nullptr) {
+      return false;
+    }
+    operand->kind_ = OperandKind::Term;
+    operand->type_ = term->GetReturnType();
+    operand->is_group_by_ = term->IsGroupByTerm();
+    operand->term_idx_ = term->GetTermIdx();
+    return true;
+  }
+  return false;
+}
+
+/**
+ * Binds the operands of a comparison and moves a constant operand to the right.
+ * @return false if the expression is not a comparison of two leaves that can be compiled, at most one a constant
+ */
+bool BindComparison(const AbstractExpression *expr, const Schema *const schemas[2], ComparisonType *comp_type,
+                    Operand *lhs, Operand *rhs) {
+  const auto *comparison = dynamic_cast<const ComparisonExpression *>(expr);
+  if (comparison == nullptr || !Bind(comparison->GetChildAt(0), schemas, lhs) ||
+      !Bind(comparison->GetChildAt(1), schemas, rhs)) {
+    return false;
+  }
+  *comp_type = comparison->GetComparisonType();
+  if (lhs->kind_ == OperandKind::Constant) {
+    std::swap(*lhs, *rhs);
+    *comp_type = Flip(*comp_type);
+  }
+  return lhs->kind_ != OperandKind::Constant;
+}
+
+/** @return the specialized closure of a comparison over tuples, or an empty function if there is none */
+TupleFunction CompileTupleComparison(ComparisonType comp_type, const Operand &lhs, const Operand &rhs) {
+  return WithMachineType<TupleFunction>(lhs.type_, [&](auto type_tag) -> TupleFunction {
+    using T = decltype(type_tag);
+    uint32_t left_side = lhs.side_;
+    uint32_t left_offset = lhs.offset_;
+    if (rhs.kind_ == OperandKind::Constant) {
+      T constant;
+      if (!ConvertConstant(rhs.constant_, &constant)) {
+        return {};
+      }
+      return WithOperator<T, TupleFunction>(comp_type, [&](auto op) -> TupleFunction {
+        return [left_side, left_offset, constant, op](const Tuple *left, const Tuple *right) {
+          T value = Load<T>(left_side == 0 ? left : right, left_offset);
+          return value != NullOf<T>() && op(value, constant);
+        };
+      });
+    }
+    if (rhs.type_ != lhs.type_) {
+      return {};
+    }
+    uint32_t right_side = rhs.side_;
+    uint32_t right_offset = rhs.offset_;
+    return WithOperator<T, TupleFunction>(comp_type, [&](auto op) -> TupleFunction {
+      return [left_side, left_offset, right_side, right_offset, op](const Tuple *left, const Tuple *right) {
+        T left_value = Load<T>(left_side == 0 ? left : right, left_offset);
+        T right_value = Load<T>(right_side == 0 ? left : right, right_offset);
+        return left_value != NullOf<T>() && right_value != NullOf<T>() && op(left_value, right_value);
+      };
+    });
+  });
+}
+
+/**
+ * @return the specialized closure of a comparison over the terms of a group, or an empty function if there is none.
+ * The closure calls fallback for a group whose terms do not have the types that the plan declares.
+ */
+AggregateFunction CompileAggregateComparison(ComparisonType comp_type, const Operand &lhs, const Operand &rhs,
+                                             const AggregateFunction &fallback) {
+  return WithMachineType<AggregateFunction>(lhs.type_, [&](auto type_tag) -> AggregateFunction {
+    using T = decltype(type_tag);
+    TypeId type_id = lhs.type_;
+    bool left_is_group_by = lhs.is_group_by_;
+    uint32_t left_idx = lhs.term_idx_;
+    if (rhs.kind_ == OperandKind::Constant) {
+      T constant;
+      if (!ConvertConstant(rhs.constant_, &constant)) {
+        return {};
+      }
+      return WithOperator<T, AggregateFunction>(comp_type, [&](auto op) -> AggregateFunction {
+        return [type_id, left_is_group_by, left_idx, constant, op, fallback](const std::vector<Value> &group_bys,
+                                                                              const std::vector<Value> &aggregates) {
+          const Value &value = left_is_group_by ? group_bys[left_idx] : aggregates[left_idx];
+          if (value.GetTypeId() != type_id) {
+            return fallback(group_bys, aggregates);
+          }
+          return !value.IsNull() && op(value.GetAs<T>(), constant);
+        };
+      });
+    }
+    if (rhs.type_ != lhs.type_) {
+      return {};
+    }
+    bool right_is_group_by = rhs.is_group_by_;
+    uint32_t right_idx = rhs.term_idx_;
+    return WithOperator<T, AggregateFunction>(comp_type, [&](auto op) -> AggregateFunction {
+      return [type_id, left_is_group_by, left_idx, right_is_group_by, right_idx, op, fallback](
+                 const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+        const Value &left_value = left_is_group_by ? group_bys[left_idx] : aggregates[left_idx];
+        const Value &right_value = right_is_group_by ? group_bys[right_idx] : aggregates[right_idx];
+        if (left_value.GetTypeId() != type_id || right_value.GetTypeId() != type_id) {
+          return fallback(group_bys, aggregates);
+        }
+        return !left_value.IsNull() && !right_value.IsNull() &&
+               op(left_value.GetAs<T>(), right_value.GetAs<T>());
+      };
+    });
+  });
+}
+
+/** @return the specialized closure of a predicate over tuples, or an empty function if there is none */
+TupleFunction CompileTuplePredicate(const AbstractExpression *predicate, const Schema *left_schema,
+                                    const Schema *right_schema) {
+  const Schema *schemas[2] = {left_schema, right_schema};
+  ComparisonType comp_type;
+  Operand lhs;
+  Operand rhs;
+  if (!BindComparison(predicate, schemas, &comp_type, &lhs, &rhs)) {
+    return {};
+  }
+  return CompileTupleComparison(comp_type, lhs, rhs);
+}
+
+}  // namespace
+
+CompiledPredicate CompiledPredicate::Compile(const AbstractExpression *predicate, const Schema *schema) {
+  CompiledPredicate compiled;
+  if (predicate == nullptr) {
+    return compiled;
+  }
+  compiled.tuple_function_ = CompileTuplePredicate(predicate, schema, nullptr);
+  compiled.specialized_ = static_cast<bool>(compiled.tuple_function_);
+  if (!compiled.specialized_) {
+    compiled.tuple_function_ = [predicate, schema](const Tuple *tuple, const Tuple *) {
+      return predicate->Evaluate(tuple, schema).GetAs<bool>();
+    };
+    return compiled;
+  }
+
+  const Schema *schemas[2] = {schema, nullptr};
+  ComparisonType comp_type;
+  Operand lhs;
+  Operand rhs;
+  BindComparison(predicate, schemas, &comp_type, &lhs, &rhs);
+  if (lhs.kind_ == OperandKind::Column && rhs.kind_ == OperandKind::Constant) {
+    ColumnComparison comparison{lhs.type_, lhs.offset_, comp_type};
+    bool converted = WithMachineType<bool>(lhs.type_, [&](auto type_tag) {
+      using T = decltype(type_tag);
+      T constant;
+      if (!ConvertConstant(rhs.constant_, &constant)) {
+        return false;
+      }
+      if constexpr (std::is_same_v<T, double>) {
+        comparison.decimal_ = constant;
+      } else {
+        comparison.integer_ = constant;
+      }
+      return true;
+    });
+    if (converted) {
+      compiled.column_comparison_ = comparison;
+    }
+  }
+  return compiled;
+}
+
+CompiledPredicate CompiledPredicate::CompileJoin(const AbstractExpression *predicate, const Schema *left_schema,
+                                                 const Schema *right_schema) {
+  CompiledPredicate compiled;
+  if (predicate == nullptr) {
+    return compiled;
+  }
+  compiled.tuple_function_ = CompileTuplePredicate(predicate, left_schema, right_schema);
+  compiled.specialized_ = static_cast<bool>(compiled.tuple_function_);
+  if (!compiled.specialized_) {
+    compiled.tuple_function_ = [predicate, left_schema, right_schema](const Tuple *left_tuple,
+                                                                      const Tuple *right_tuple) {
+      return predicate->EvaluateJoin(left_tuple, left_schema, right_tuple, right_schema).GetAs<bool>();
+    };
+  }
+  return compiled;
+}
+
+CompiledPredicate CompiledPredicate::CompileAggregate(const AbstractExpression *predicate) {
+  CompiledPredicate compiled;
+  if (predicate == nullptr) {
+    return compiled;
+  }
+  AggregateFunction fallback = [predicate](const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) {
+    return predicate->EvaluateAggregate(group_bys, aggregates).GetAs<bool>();
+  };
+  const Schema *schemas[2] = {nullptr, nullptr};
+  ComparisonType comp_type;
+  Operand lhs;
+  Operand rhs;
+  if (BindComparison(predicate, schemas, &comp_type, &lhs, &rhs)) {
+    compiled.aggregate_function_ = CompileAggregateComparison(comp_type, lhs, rhs, fallback);
+  }
+  compiled.specialized_ = static_cast<bool>(compiled.aggregate_function_);
+  if (!compiled.specialized_) {
+    compiled.aggregate_function_ = std::move(fallback);
+  }
+  return compiled;
+}
+
+}  // namespace bustub
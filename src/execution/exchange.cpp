@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange.cpp
+//
+// Identification: src/execution/exchange.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/exchange.h"
+
+#include <utility>
+
+namespace bustub {
+
+bool Exchange::Push(TupleBatch *batch) {
+  std::unique_lock latch(latch_);
+  not_full_.wait(latch, [&] { return closed_ || batches_.size() < capacity_; });
+  if (closed_) {
+    return false;
+  }
+  batches_.push_back(std::move(*batch));
+  not_empty_.notify_one();
+  return true;
+}
+
+void Exchange::ProducerDone() {
+  std::scoped_lock latch(latch_);
+  BUSTUB_ASSERT(num_producers_ > 0, "More producers are done than were started.");
+  if (--num_producers_ == 0) {
+    not_empty_.notify_all();
+  }
+}
+
+bool Exchange::Pop(TupleBatch *batch) {
+  std::unique_lock latch(latch_);
+  not_empty_.wait(latch, [&] { return !batches_.empty() || num_producers_ == 0; });
+  if (batches_.empty()) {
+    return false;
+  }
+  *batch = std::move(batches_.front());
+  batches_.pop_front();
+  not_full_.notify_one();
+  return true;
+}
+
+bool Exchange::PopTuple(const Schema *schema, Tuple *tuple, RID *rid) {
+  while (current_idx_ == current_batch_.GetNumSelected()) {
+    if (!Pop(&current_batch_)) {
+      return false;
+    }
+    current_idx_ = 0;
+  }
+  uint32_t row = current_batch_.GetSelection()[current_idx_++];
+  *tuple = current_batch_.GetTuple(row, schema);
+  *rid = current_batch_.GetRid(row);
+  return true;
+}
+
+void Exchange::Close() {
+  std::scoped_lock latch(latch_);
+  closed_ = true;
+  batches_.clear();
+  not_full_.notify_all();
+}
+
+}  // namespace bustub
@@ -26,6 +26,8 @@
 #include "execution/executors/nested_index_join_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
 #include "execution/executors/seq_scan_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
 #include "execution/executors/update_executor.h"
 #include "storage/index/generic_key.h"
 
@@ -111,6 +113,20 @@ std::unique_ptr<AbstractExecutor> ExecutorFactory::CreateExecutor(ExecutorContex
       return std::make_unique<HashJoinExecutor>(exec_ctx, hash_join_plan, std::move(left), std::move(right));
     }
 
+    // Create a new sort executor
+    case PlanType::Sort: {
+      auto sort_plan = dynamic_cast<const SortPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, sort_plan->GetChildPlan());
+      return std::make_unique<SortExecutor>(exec_ctx, sort_plan, std::move(child_executor));
+    }
+
+    // Create a new top-n executor
+    case PlanType::TopN: {
+      auto topn_plan = dynamic_cast<const TopNPlanNode *>(plan);
+      auto child_executor = ExecutorFactory::CreateExecutor(exec_ctx, topn_plan->GetChildPlan());
+      return std::make_unique<TopNExecutor>(exec_ctx, topn_plan, std::move(child_executor));
+    }
+
     default:
       UNREACHABLE("Unsupported plan type.");
   }
@@ -12,15 +12,588 @@
 
 #include "execution/executors/hash_join_executor.h"
 
+#include <algorithm>
+#include <limits>
+
+#include "common/exception.h"
+
 namespace bustub {
 
+namespace {
+
+/** Marks the end of a bucket chain in the hash table of a radix join partition. */
+constexpr uint32_t END_OF_CHAIN = std::numeric_limits<uint32_t>::max();
+
+/** Runs fn(0) to fn(num_threads - 1) on their own threads and waits for all of them. */
+template <typename Fn>
+void RunOnThreads(size_t num_threads, const Fn &fn) {
+  std::vector<std::thread> threads;
+  threads.reserve(num_threads);
+  for (size_t t = 0; t < num_threads; t++) {
+    threads.emplace_back(fn, t);
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+}
+
+/** The hash bits that each split of a spilled join consumes; a split uses the bits above those of the earlier ones. */
+constexpr uint32_t SPILL_LEVEL_BITS = 8;
+static_assert(HASH_JOIN_SPILL_FANOUT <= (1 << SPILL_LEVEL_BITS));
+
+/** A partition is not split again after this many splits, e.g. when all of its rows have the same key. */
+constexpr uint32_t MAX_SPILL_LEVEL = sizeof(hash_t) * 8 / SPILL_LEVEL_BITS - 1;
+
+/** Deletes temporary pages without reading them. */
+void DeletePages(BufferPoolManager *bpm, const std::vector<page_id_t> &page_ids) {
+  for (page_id_t page_id : page_ids) {
+    bpm->DeletePage(page_id);
+  }
+}
+
+}  // namespace
+
 HashJoinExecutor::HashJoinExecutor(ExecutorContext *exec_ctx, const HashJoinPlanNode *plan,
                                    std::unique_ptr<AbstractExecutor> &&left_child,
                                    std::unique_ptr<AbstractExecutor> &&right_child)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_child_(std::move(left_child)),
+      right_child_(std::move(right_child)) {}
+
+HashJoinExecutor::~HashJoinExecutor() {
+  StopWorkers();
+  DropSpilledPages();
+}
+
+void HashJoinExecutor::Init() {
+  StopWorkers();
+  DropSpilledPages();
+  left_child_->Init();
+  right_child_->Init();
+
+  size_t num_threads = exec_ctx_->GetParallelism();
+  if (num_threads > 1 && exec_ctx_->GetMemoryBudget() == 0) {
+    Materialize(left_child_.get(), plan_->LeftJoinKeyExpression(), &build_input_);
+    Materialize(right_child_.get(), plan_->RightJoinKeyExpression(), &probe_input_);
+    // Enough partitions for every partition to fit in the cache and for the workers to balance the load.
+    size_t num_partitions = 1;
+    radix_bits_ = 0;
+    while (num_partitions < 4 * num_threads ||
+           num_partitions * HASH_JOIN_PARTITION_SIZE < build_input_.hashes_.size()) {
+      num_partitions <<= 1;
+      radix_bits_++;
+    }
+    Partition(&build_input_, num_threads);
+    Partition(&probe_input_, num_threads);
+    next_partition_ = 0;
+    exchange_ = std::make_unique<Exchange>(num_threads, 2 * num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back([this] { JoinPartitions(); });
+    }
+    return;
+  }
+
+  ClearHashTable();
+  matches_ = nullptr;
+  match_idx_ = 0;
+  right_batch_.Reset(0);
+  probe_idx_ = 0;
+  right_done_ = false;
+  spilled_ = false;
+
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const AbstractExpression *left_key = plan_->LeftJoinKeyExpression();
+  if (exec_ctx_->IsBatchExecution()) {
+    TupleBatch left_batch;
+    std::vector<Value> keys;
+    while (left_child_->NextBatch(&left_batch)) {
+      left_key->EvaluateBatch(left_batch, &keys);
+      for (uint32_t row : left_batch.GetSelection()) {
+        AddBuildTuple(left_batch.GetTuple(row, left_schema), keys[row]);
+      }
+    }
+  } else {
+    Tuple tuple;
+    RID rid;
+    while (left_child_->Next(&tuple, &rid)) {
+      AddBuildTuple(tuple, left_key->Evaluate(&tuple, left_schema));
+    }
+  }
+  if (spill_partitions_.empty()) {
+    return;
+  }
+
+  // The hash table did not fit: partition the right side the same way, then join the partitions one by one.
+  FinishSpillSide();
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  const AbstractExpression *right_key = plan_->RightJoinKeyExpression();
+  if (exec_ctx_->IsBatchExecution()) {
+    TupleBatch right_batch;
+    std::vector<Value> keys;
+    while (right_child_->NextBatch(&right_batch)) {
+      right_key->EvaluateBatch(right_batch, &keys);
+      for (uint32_t row : right_batch.GetSelection()) {
+        SpillTuple(right_batch.GetTuple(row, right_schema), keys[row], false);
+      }
+    }
+  } else {
+    Tuple tuple;
+    RID rid;
+    while (right_child_->Next(&tuple, &rid)) {
+      SpillTuple(tuple, right_key->Evaluate(&tuple, right_schema), false);
+    }
+  }
+  FinishSpill();
+  spilled_ = true;
+  probe_tuples_.clear();
+  probe_tuple_idx_ = 0;
+  LoadNextPartition();
+}
+
+void HashJoinExecutor::InsertBuildTuple(const Tuple &tuple, const Value &key) {
+  if (key.IsNull()) {
+    return;
+  }
+  hash_table_[HashJoinKey{key}].push_back(static_cast<uint32_t>(build_tuples_.size()));
+  build_tuples_.push_back(tuple);
+  // An estimate: the tuple, its entry in the key's vector and a share of the map node.
+  build_bytes_ += sizeof(Tuple) + tuple.GetLength() + sizeof(uint32_t) + sizeof(HashJoinKey);
+}
+
+void HashJoinExecutor::AddBuildTuple(const Tuple &tuple, const Value &key) {
+  if (!spill_partitions_.empty()) {
+    SpillTuple(tuple, key, true);
+    return;
+  }
+  InsertBuildTuple(tuple, key);
+  if (IsOverBudget()) {
+    BeginSpill(0);
+    SpillHashTable();
+  }
+}
+
+void HashJoinExecutor::ClearHashTable() {
+  build_tuples_.clear();
+  hash_table_.clear();
+  build_bytes_ = 0;
+}
+
+bool HashJoinExecutor::IsOverBudget() const {
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  return budget != 0 && build_bytes_ > budget;
+}
+
+void HashJoinExecutor::BeginSpill(uint32_t level) {
+  spill_partitions_.assign(HASH_JOIN_SPILL_FANOUT, SpillPartition{});
+  for (auto &partition : spill_partitions_) {
+    partition.level_ = level;
+  }
+  spill_pages_.assign(HASH_JOIN_SPILL_FANOUT, nullptr);
+}
+
+void HashJoinExecutor::SpillHashTable() {
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  for (const auto &tuple : build_tuples_) {
+    SpillTuple(tuple, plan_->LeftJoinKeyExpression()->Evaluate(&tuple, left_schema), true);
+  }
+  ClearHashTable();
+}
+
+void HashJoinExecutor::SpillTuple(const Tuple &tuple, const Value &key, bool build_side) {
+  if (key.IsNull()) {
+    return;
+  }
+  uint32_t level = spill_partitions_[0].level_;
+  size_t partition =
+      (HashUtil::MixHash(HashUtil::HashValue(&key)) >> (level * SPILL_LEVEL_BITS)) % HASH_JOIN_SPILL_FANOUT;
+  TmpTuplePage *&page = spill_pages_[partition];
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  if (page != nullptr && page->Insert(tuple, &location)) {
+    return;
+  }
+
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  if (page != nullptr) {
+    bpm->UnpinPage(page->GetTablePageId(), true);
+  }
+  page_id_t page_id;
+  page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a hash join partition");
+  }
+  page->Init(page_id, PAGE_SIZE);
+  auto &pages = build_side ? spill_partitions_[partition].build_pages_ : spill_partitions_[partition].probe_pages_;
+  pages.push_back(page_id);
+  if (!page->Insert(tuple, &location)) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "a tuple does not fit in a temporary page");
+  }
+}
+
+void HashJoinExecutor::FinishSpillSide() {
+  for (auto &page : spill_pages_) {
+    if (page != nullptr) {
+      exec_ctx_->GetBufferPoolManager()->UnpinPage(page->GetTablePageId(), true);
+      page = nullptr;
+    }
+  }
+}
+
+void HashJoinExecutor::FinishSpill() {
+  FinishSpillSide();
+  for (auto &partition : spill_partitions_) {
+    pending_partitions_.push_back(std::move(partition));
+  }
+  spill_partitions_.clear();
+}
+
+void HashJoinExecutor::ReadSpilledPage(page_id_t page_id, std::vector<Tuple> *tuples) {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  auto *page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read a hash join partition");
+  }
+  page->GetTuples(tuples);
+  bpm->UnpinPage(page_id, false);
+  bpm->DeletePage(page_id);
+}
+
+void HashJoinExecutor::DropSpilledPages() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  FinishSpill();
+  for (const auto &partition : pending_partitions_) {
+    DeletePages(bpm, partition.build_pages_);
+    DeletePages(bpm, partition.probe_pages_);
+  }
+  pending_partitions_.clear();
+  DeletePages(bpm, probe_pages_);
+  probe_pages_.clear();
+}
+
+bool HashJoinExecutor::LoadNextPartition() {
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  std::vector<Tuple> tuples;
+  while (!pending_partitions_.empty()) {
+    SpillPartition partition = std::move(pending_partitions_.back());
+    pending_partitions_.pop_back();
+    ClearHashTable();
+    if (partition.build_pages_.empty() || partition.probe_pages_.empty()) {
+      // Nothing in this partition can match.
+      DeletePages(exec_ctx_->GetBufferPoolManager(), partition.build_pages_);
+      DeletePages(exec_ctx_->GetBufferPoolManager(), partition.probe_pages_);
+      continue;
+    }
+
+    bool split = false;
+    for (size_t i = 0; i < partition.build_pages_.size(); i++) {
+      tuples.clear();
+      ReadSpilledPage(partition.build_pages_[i], &tuples);
+      for (const auto &tuple : tuples) {
+        if (split) {
+          SpillTuple(tuple, plan_->LeftJoinKeyExpression()->Evaluate(&tuple, left_schema), true);
+        } else {
+          InsertBuildTuple(tuple, plan_->LeftJoinKeyExpression()->Evaluate(&tuple, left_schema));
+        }
+      }
+      if (!split && IsOverBudget() && partition.level_ < MAX_SPILL_LEVEL) {
+        // Still too large: split it with the next bits of the hash.
+        split = true;
+        BeginSpill(partition.level_ + 1);
+        SpillHashTable();
+      }
+    }
+    if (!split) {
+      probe_pages_ = std::move(partition.probe_pages_);
+      return true;
+    }
+
+    FinishSpillSide();
+    for (page_id_t page_id : partition.probe_pages_) {
+      tuples.clear();
+      ReadSpilledPage(page_id, &tuples);
+      for (const auto &tuple : tuples) {
+        SpillTuple(tuple, plan_->RightJoinKeyExpression()->Evaluate(&tuple, right_schema), false);
+      }
+    }
+    FinishSpill();
+  }
+  return false;
+}
+
+bool HashJoinExecutor::NextProbeTuple(Tuple *tuple) {
+  if (!spilled_) {
+    RID rid;
+    return right_child_->Next(tuple, &rid);
+  }
+  while (probe_tuple_idx_ == probe_tuples_.size()) {
+    probe_tuples_.clear();
+    probe_tuple_idx_ = 0;
+    if (!probe_pages_.empty()) {
+      ReadSpilledPage(probe_pages_.back(), &probe_tuples_);
+      probe_pages_.pop_back();
+    } else if (!LoadNextPartition()) {
+      return false;
+    }
+  }
+  *tuple = probe_tuples_[probe_tuple_idx_++];
+  return true;
+}
+
+bool HashJoinExecutor::NextProbeBatch(TupleBatch *batch) {
+  if (!spilled_) {
+    return right_child_->NextBatch(batch);
+  }
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  batch->Reset(right_schema->GetColumnCount());
+  // A batch never spans two partitions, because the hash table only holds the left rows of one.
+  while (!batch->IsFull()) {
+    if (probe_tuple_idx_ < probe_tuples_.size()) {
+      batch->AppendTuple(probe_tuples_[probe_tuple_idx_++], right_schema);
+      continue;
+    }
+    probe_tuples_.clear();
+    probe_tuple_idx_ = 0;
+    if (!probe_pages_.empty()) {
+      ReadSpilledPage(probe_pages_.back(), &probe_tuples_);
+      probe_pages_.pop_back();
+    } else if (batch->GetNumRows() > 0 || !LoadNextPartition()) {
+      break;
+    }
+  }
+  return batch->GetNumRows() > 0;
+}
+
+const std::vector<uint32_t> *HashJoinExecutor::FindMatches(const Value &key) const {
+  if (key.IsNull()) {
+    return nullptr;
+  }
+  auto it = hash_table_.find(HashJoinKey{key});
+  return it == hash_table_.end() ? nullptr : &it->second;
+}
+
+bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *right_schema = right_child_->GetOutputSchema();
+  const Schema *output_schema = plan_->OutputSchema();
+  if (exchange_ != nullptr) {
+    return exchange_->PopTuple(output_schema, tuple, rid);
+  }
+  while (matches_ == nullptr || match_idx_ == matches_->size()) {
+    if (!NextProbeTuple(&right_tuple_)) {
+      return false;
+    }
+    matches_ = FindMatches(plan_->RightJoinKeyExpression()->Evaluate(&right_tuple_, right_schema));
+    match_idx_ = 0;
+  }
+
+  const Tuple &left_tuple = build_tuples_[(*matches_)[match_idx_++]];
+  std::vector<Value> values;
+  values.reserve(output_schema->GetColumnCount());
+  for (const auto &column : output_schema->GetColumns()) {
+    values.push_back(column.GetExpr()->EvaluateJoin(&left_tuple, left_schema, &right_tuple_, right_schema));
+  }
+  *tuple = Tuple(values, output_schema);
+  return true;
+}
+
+bool HashJoinExecutor::NextBatch(TupleBatch *batch) {
+  if (exchange_ != nullptr) {
+    return exchange_->Pop(batch);
+  }
+  const Schema *left_schema = left_child_->GetOutputSchema();
+  const Schema *output_schema = plan_->OutputSchema();
+  left_rows_.Reset(left_schema->GetColumnCount());
+  right_rows_.Reset(right_child_->GetOutputSchema()->GetColumnCount());
+
+  // Collect up to a batch of joined pairs.
+  while (!right_done_ && !left_rows_.IsFull()) {
+    if (probe_idx_ == right_batch_.GetNumSelected()) {
+      if (!NextProbeBatch(&right_batch_)) {
+        right_done_ = true;
+        break;
+      }
+      plan_->RightJoinKeyExpression()->EvaluateBatch(right_batch_, &right_keys_);
+      probe_idx_ = 0;
+    }
+    uint32_t row = right_batch_.GetSelection()[probe_idx_];
+    if (matches_ == nullptr) {
+      matches_ = FindMatches(right_keys_[row]);
+      match_idx_ = 0;
+    }
+    while (matches_ != nullptr && match_idx_ < matches_->size() && !left_rows_.IsFull()) {
+      left_rows_.AppendTuple(build_tuples_[(*matches_)[match_idx_++]], left_schema);
+      right_rows_.AppendRow(right_batch_, row);
+    }
+    if (matches_ == nullptr || match_idx_ == matches_->size()) {
+      matches_ = nullptr;
+      probe_idx_++;
+    }
+  }
+  if (left_rows_.GetNumRows() == 0) {
+    return false;
+  }
+
+  batch->Reset(output_schema->GetColumnCount());
+  for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+    output_schema->GetColumn(col_idx).GetExpr()->EvaluateJoinBatch(left_rows_, right_rows_,
+                                                                     batch->GetMutableColumn(col_idx));
+  }
+  batch->GetMutableRids()->resize(left_rows_.GetNumRows());
+  batch->SelectAll();
+  return true;
+}
+
+void HashJoinExecutor::StopWorkers() {
+  if (exchange_ == nullptr) {
+    return;
+  }
+  exchange_->Close();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  exchange_.reset();
+}
+
+void HashJoinExecutor::Materialize(AbstractExecutor *child, const AbstractExpression *key_expr,
+                                   PartitionedInput *input) {
+  uint32_t num_columns = child->GetOutputSchema()->GetColumnCount();
+  input->columns_.assign(num_columns, {});
+  input->keys_.clear();
+  input->hashes_.clear();
+  TupleBatch batch;
+  std::vector<Value> keys;
+  while (child->NextBatch(&batch)) {
+    key_expr->EvaluateBatch(batch, &keys);
+    for (uint32_t row : batch.GetSelection()) {
+      if (keys[row].IsNull()) {
+        continue;
+      }
+      for (uint32_t col_idx = 0; col_idx < num_columns; col_idx++) {
+        input->columns_[col_idx].push_back(batch.GetValue(col_idx, row));
+      }
+      input->hashes_.push_back(HashUtil::MixHash(HashUtil::HashValue(&keys[row])));
+      input->keys_.push_back(keys[row]);
+    }
+  }
+}
+
+void HashJoinExecutor::Partition(PartitionedInput *input, size_t num_threads) {
+  size_t num_partitions = static_cast<size_t>(1) << radix_bits_;
+  hash_t mask = num_partitions - 1;
+  size_t num_rows = input->hashes_.size();
+  size_t chunk = (num_rows + num_threads - 1) / num_threads;
+
+  // Each worker counts the rows of its chunk per partition.
+  std::vector<std::vector<size_t>> cursors(num_threads, std::vector<size_t>(num_partitions, 0));
+  RunOnThreads(num_threads, [&](size_t t) {
+    for (size_t row = t * chunk; row < std::min(num_rows, (t + 1) * chunk); row++) {
+      cursors[t][input->hashes_[row] & mask]++;
+    }
+  });
+
+  // The counts become the position of each worker's first entry in each partition.
+  input->offsets_.assign(num_partitions + 1, 0);
+  size_t position = 0;
+  for (size_t p = 0; p < num_partitions; p++) {
+    input->offsets_[p] = position;
+    for (size_t t = 0; t < num_threads; t++) {
+      size_t count = cursors[t][p];
+      cursors[t][p] = position;
+      position += count;
+    }
+  }
+  input->offsets_[num_partitions] = position;
+
+  // Each worker scatters its chunk into place; no two workers write the same entry.
+  input->entries_.resize(num_rows);
+  RunOnThreads(num_threads, [&](size_t t) {
+    for (size_t row = t * chunk; row < std::min(num_rows, (t + 1) * chunk); row++) {
+      hash_t hash = input->hashes_[row];
+      input->entries_[cursors[t][hash & mask]++] = {hash, static_cast<uint32_t>(row)};
+    }
+  });
+}
+
+void HashJoinExecutor::JoinPartitions() {
+  const Schema *output_schema = plan_->OutputSchema();
+  auto num_left_columns = static_cast<uint32_t>(build_input_.columns_.size());
+  auto num_right_columns = static_cast<uint32_t>(probe_input_.columns_.size());
+  size_t num_partitions = build_input_.offsets_.size() - 1;
+  std::vector<uint32_t> heads;
+  std::vector<uint32_t> chain;
+  TupleBatch left_rows;
+  TupleBatch right_rows;
+  TupleBatch batch;
+  left_rows.Reset(num_left_columns);
+  right_rows.Reset(num_right_columns);
+  bool open = true;
+
+  auto append = [](const PartitionedInput &input, uint32_t row, TupleBatch *rows) {
+    for (uint32_t col_idx = 0; col_idx < rows->GetNumColumns(); col_idx++) {
+      rows->GetMutableColumn(col_idx)->push_back(input.columns_[col_idx][row]);
+    }
+    rows->GetMutableRids()->emplace_back();
+  };
+  // Evaluates the output schema over the collected pairs and hands the batch on to the consumer.
+  auto flush = [&] {
+    left_rows.SelectAll();
+    right_rows.SelectAll();
+    batch.Reset(output_schema->GetColumnCount());
+    for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+      output_schema->GetColumn(col_idx).GetExpr()->EvaluateJoinBatch(left_rows, right_rows,
+                                                                       batch.GetMutableColumn(col_idx));
+    }
+    batch.GetMutableRids()->resize(left_rows.GetNumRows());
+    batch.SelectAll();
+    open = exchange_->Push(&batch);
+    left_rows.Reset(num_left_columns);
+    right_rows.Reset(num_right_columns);
+  };
+
+  for (size_t p = next_partition_++; open && p < num_partitions; p = next_partition_++) {
+    size_t build_begin = build_input_.offsets_[p];
+    size_t build_size = build_input_.offsets_[p + 1] - build_begin;
+    if (build_size == 0) {
+      continue;
+    }
 
-void HashJoinExecutor::Init() {}
+    // Build: chain the entries of the partition into buckets, selected by the hash bits above the radix bits.
+    size_t num_buckets = 1;
+    while (num_buckets < build_size) {
+      num_buckets <<= 1;
+    }
+    hash_t bucket_mask = num_buckets - 1;
+    heads.assign(num_buckets, END_OF_CHAIN);
+    chain.resize(build_size);
+    for (uint32_t i = 0; i < build_size; i++) {
+      size_t bucket = (build_input_.entries_[build_begin + i].first >> radix_bits_) & bucket_mask;
+      chain[i] = heads[bucket];
+      heads[bucket] = i;
+    }
 
-bool HashJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+    // Probe with the right rows of the same partition.
+    for (size_t j = probe_input_.offsets_[p]; open && j < probe_input_.offsets_[p + 1]; j++) {
+      const auto &[hash, probe_row] = probe_input_.entries_[j];
+      for (uint32_t i = heads[(hash >> radix_bits_) & bucket_mask]; open && i != END_OF_CHAIN; i = chain[i]) {
+        const auto &[build_hash, build_row] = build_input_.entries_[build_begin + i];
+        if (build_hash != hash ||
+            build_input_.keys_[build_row].CompareEquals(probe_input_.keys_[probe_row]) != CmpBool::CmpTrue) {
+          continue;
+        }
+        append(build_input_, build_row, &left_rows);
+        append(probe_input_, probe_row, &right_rows);
+        if (left_rows.IsFull()) {
+          flush();
+        }
+      }
+    }
+  }
+  if (open && left_rows.GetNumRows() > 0) {
+    flush();
+  }
+  exchange_->ProducerDone();
+}
 
 }  // namespace bustub
@@ -11,17 +11,102 @@
 //===----------------------------------------------------------------------===//
 
 #include <memory>
+#include <vector>
 
+#include "common/exception.h"
 #include "execution/executors/insert_executor.h"
 
 namespace bustub {
 
 InsertExecutor::InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                                std::unique_ptr<AbstractExecutor> &&child_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      table_info_(exec_ctx->GetCatalog()->GetTable(plan->TableOid())),
+      indexes_(exec_ctx->GetCatalog()->GetTableIndexes(table_info_->name_)) {}
 
-void InsertExecutor::Init() {}
+InsertExecutor::~InsertExecutor() {
+  if (buffer_ring_ != nullptr) {
+    exec_ctx_->AddRingEvictionsAvoided(buffer_ring_->GetNumEvictionsAvoided());
+  }
+}
 
-bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) { return false; }
+void InsertExecutor::Init() {
+  if (child_executor_ != nullptr) {
+    child_executor_->Init();
+  }
+  size_t ring_size = exec_ctx_->GetBufferRingSize();
+  if (ring_size > 0 && buffer_ring_ == nullptr) {
+    buffer_ring_ = std::make_unique<BufferRing>(exec_ctx_->GetBufferPoolManager(), ring_size);
+    ring_table_heap_ = std::make_unique<TableHeap>(buffer_ring_.get(), exec_ctx_->GetLockManager(),
+                                                   exec_ctx_->GetLogManager(), table_info_->table_->GetFirstPageId());
+  }
+  done_ = false;
+}
+
+bool InsertExecutor::Next([[maybe_unused]] Tuple *tuple, RID *rid) {
+  if (done_) {
+    return false;
+  }
+  if (plan_->IsRawInsert()) {
+    std::vector<Tuple> tuples;
+    tuples.reserve(plan_->RawValues().size());
+    for (const auto &values : plan_->RawValues()) {
+      tuples.emplace_back(values, &table_info_->schema_);
+    }
+    InsertTuples(tuples);
+  } else {
+    Tuple child_tuple;
+    RID child_rid;
+    while (child_executor_->Next(&child_tuple, &child_rid)) {
+      InsertTuple(child_tuple);
+    }
+  }
+  done_ = true;
+  return false;
+}
+
+void InsertExecutor::InsertTuple(const Tuple &tuple) {
+  RID rid;
+  if (!GetTableHeap()->InsertTuple(tuple, &rid, exec_ctx_->GetTransaction())) {
+    throw Exception("insert into table " + table_info_->name_ + " failed");
+  }
+  FixWriteRecords(1);
+  InsertIndexEntries(tuple, rid);
+}
+
+void InsertExecutor::InsertTuples(const std::vector<Tuple> &tuples) {
+  std::vector<RID> rids;
+  bool inserted = GetTableHeap()->InsertTuples(tuples, &rids, exec_ctx_->GetTransaction());
+  FixWriteRecords(rids.size());
+  if (!inserted) {
+    throw Exception("insert into table " + table_info_->name_ + " failed");
+  }
+  for (size_t i = 0; i < tuples.size(); i++) {
+    InsertIndexEntries(tuples[i], rids[i]);
+  }
+}
+
+void InsertExecutor::FixWriteRecords(size_t num_records) {
+  if (ring_table_heap_ == nullptr) {
+    return;
+  }
+  // The write records must name the catalog's heap, the ring view does not outlive this executor.
+  auto write_set = exec_ctx_->GetTransaction()->GetWriteSet();
+  for (auto it = write_set->rbegin(); it != write_set->rend() && num_records > 0; ++it, --num_records) {
+    it->table_ = table_info_->table_.get();
+  }
+}
+
+void InsertExecutor::InsertIndexEntries(const Tuple &tuple, const RID &rid) {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  for (IndexInfo *index_info : indexes_) {
+    Tuple key = tuple.KeyFromTuple(table_info_->schema_, index_info->key_schema_, index_info->index_->GetKeyAttrs());
+    index_info->index_->InsertEntry(key, rid, txn);
+    txn->GetIndexWriteSet()->emplace_back(rid, table_info_->oid_, WType::INSERT, tuple, index_info->index_oid_,
+                                          exec_ctx_->GetCatalog());
+  }
+}
 
 }  // namespace bustub
@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.cpp
+//
+// Identification: src/execution/morsel_queue.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/morsel_queue.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace bustub {
+
+MorselQueue::MorselQueue(TableHeap *table_heap) {
+  page_id_t first_page_id = table_heap->GetFirstPageId();
+  if (first_page_id == INVALID_PAGE_ID) {
+    return;
+  }
+  // The free space map lists the page chain, so the pages are known after reading the map pages alone, and each table
+  // page is read only once, by the worker that scans it.
+  page_ids_.push_back(first_page_id);
+  table_heap->GetNextPagesFn()(first_page_id, std::numeric_limits<size_t>::max(), &page_ids_);
+  // The map falls behind the chain while a page is being appended, or if a map page could not be fetched. The last
+  // listed page is where the chain goes on, so reading it is all this costs when the map is complete.
+  for (page_id_t page_id = table_heap->GetNextPageId(page_ids_.back()); page_id != INVALID_PAGE_ID;
+       page_id = table_heap->GetNextPageId(page_id)) {
+    page_ids_.push_back(page_id);
+  }
+}
+
+bool MorselQueue::Next(std::vector<page_id_t> *page_ids) {
+  size_t begin = next_idx_.fetch_add(SCAN_MORSEL_SIZE);
+  if (begin >= page_ids_.size()) {
+    page_ids->clear();
+    return false;
+  }
+  size_t end = std::min(begin + SCAN_MORSEL_SIZE, page_ids_.size());
+  page_ids->assign(page_ids_.begin() + begin, page_ids_.begin() + end);
+  return true;
+}
+
+}  // namespace bustub
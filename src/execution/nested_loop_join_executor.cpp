@@ -12,15 +12,53 @@
 
 #include "execution/executors/nested_loop_join_executor.h"
 
+#include <vector>
+
 namespace bustub {
 
 NestedLoopJoinExecutor::NestedLoopJoinExecutor(ExecutorContext *exec_ctx, const NestedLoopJoinPlanNode *plan,
                                                std::unique_ptr<AbstractExecutor> &&left_executor,
                                                std::unique_ptr<AbstractExecutor> &&right_executor)
-    : AbstractExecutor(exec_ctx) {}
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      left_executor_(std::move(left_executor)),
+      right_executor_(std::move(right_executor)),
+      predicate_(CompiledPredicate::CompileJoin(plan->Predicate(), left_executor_->GetOutputSchema(),
+                                                right_executor_->GetOutputSchema())) {}
 
-void NestedLoopJoinExecutor::Init() {}
+void NestedLoopJoinExecutor::Init() {
+  left_executor_->Init();
+  RID rid;
+  has_left_tuple_ = left_executor_->Next(&left_tuple_, &rid);
+  right_executor_->Init();
+}
 
-bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+bool NestedLoopJoinExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *left_schema = left_executor_->GetOutputSchema();
+  const Schema *right_schema = right_executor_->GetOutputSchema();
+  Tuple right_tuple;
+  RID right_rid;
+  while (has_left_tuple_) {
+    while (right_executor_->Next(&right_tuple, &right_rid)) {
+      if (!predicate_.EvaluateJoin(&left_tuple_, &right_tuple)) {
+        continue;
+      }
+      const Schema *output_schema = plan_->OutputSchema();
+      std::vector<Value> values;
+      values.reserve(output_schema->GetColumnCount());
+      for (const auto &column : output_schema->GetColumns()) {
+        values.push_back(column.GetExpr()->EvaluateJoin(&left_tuple_, left_schema, &right_tuple, right_schema));
+      }
+      *tuple = Tuple(values, output_schema);
+      return true;
+    }
+    // The inner side is scanned again for every tuple of the outer side.
+    has_left_tuple_ = left_executor_->Next(&left_tuple_, rid);
+    if (has_left_tuple_) {
+      right_executor_->Init();
+    }
+  }
+  return false;
+}
 
 }  // namespace bustub
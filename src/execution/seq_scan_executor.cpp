@@ -12,12 +12,291 @@
 
 #include "execution/executors/seq_scan_executor.h"
 
+#include <map>
+#include <set>
+#include <utility>
+
+#include "execution/expressions/column_value_expression.h"
+
 namespace bustub {
 
-SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan) : AbstractExecutor(exec_ctx) {}
+namespace {
+
+/** Adds the indexes of the columns that expr reads to columns. */
+void CollectColumns(const AbstractExpression *expr, std::set<uint32_t> *columns) {
+  if (expr == nullptr) {
+    return;
+  }
+  if (const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(expr); column_expr != nullptr) {
+    columns->insert(column_expr->GetColIdx());
+  }
+  for (const auto *child : expr->GetChildren()) {
+    CollectColumns(child, columns);
+  }
+}
+
+}  // namespace
+
+SeqScanExecutor::SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      table_info_(exec_ctx->GetCatalog()->GetTable(plan->GetTableOid())),
+      predicate_(CompiledPredicate::Compile(plan->GetPredicate(), &table_info_->schema_)) {
+  // A specialized predicate reads its columns from the table tuples, so they are decoded only if the output needs them.
+  std::set<uint32_t> columns;
+  if (!predicate_.IsSpecialized()) {
+    CollectColumns(plan_->GetPredicate(), &columns);
+  }
+  // An output column that only passes on a table column nothing else in the output reads takes that column over.
+  const Schema *output_schema = plan_->OutputSchema();
+  std::vector<std::set<uint32_t>> output_columns(output_schema->GetColumnCount());
+  std::map<uint32_t, uint32_t> num_readers;
+  for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+    CollectColumns(output_schema->GetColumn(col_idx).GetExpr(), &output_columns[col_idx]);
+    for (uint32_t table_col_idx : output_columns[col_idx]) {
+      columns.insert(table_col_idx);
+      num_readers[table_col_idx]++;
+    }
+  }
+  for (uint32_t col_idx = 0; col_idx < output_schema->GetColumnCount(); col_idx++) {
+    const auto *column_expr = dynamic_cast<const ColumnValueExpression *>(output_schema->GetColumn(col_idx).GetExpr());
+    if (column_expr != nullptr && num_readers[column_expr->GetColIdx()] == 1) {
+      moved_columns_.emplace_back(col_idx, column_expr->GetColIdx());
+    } else {
+      evaluated_columns_.push_back(col_idx);
+    }
+  }
+  referenced_columns_.assign(columns.begin(), columns.end());
+  if (const auto *comparison = predicate_.GetColumnComparison(); comparison != nullptr) {
+    column_filter_ = std::make_unique<ColumnFilter>(*comparison);
+  }
+}
+
+SeqScanExecutor::~SeqScanExecutor() {
+  StopWorkers();
+  if (buffer_ring_ != nullptr) {
+    exec_ctx_->AddRingEvictionsAvoided(buffer_ring_->GetNumEvictionsAvoided());
+  }
+}
+
+void SeqScanExecutor::Init() {
+  StopWorkers();
+  TableHeap *table_heap = table_info_->table_.get();
+
+  // Tuple locks are taken through the transaction, which is not thread-safe, so the scan runs serially when logging
+  // (and with it locking) is on.
+  size_t num_threads = exec_ctx_->GetParallelism();
+  if (num_threads > 1 && !enable_logging) {
+    morsels_ = std::make_unique<MorselQueue>(table_heap);
+    exchange_ = std::make_unique<Exchange>(num_threads, 2 * num_threads);
+    for (size_t i = 0; i < num_threads; i++) {
+      workers_.emplace_back([this] { ScanMorsels(); });
+    }
+    return;
+  }
+
+  size_t ring_size = exec_ctx_->GetBufferRingSize();
+  if (ring_size > 0 && buffer_ring_ == nullptr) {
+    buffer_ring_ = std::make_unique<BufferRing>(exec_ctx_->GetBufferPoolManager(), ring_size);
+    ring_table_heap_ = std::make_unique<TableHeap>(buffer_ring_.get(), exec_ctx_->GetLockManager(),
+                                                   exec_ctx_->GetLogManager(), table_heap->GetFirstPageId());
+  }
+  if (ring_table_heap_ != nullptr) {
+    table_heap = ring_table_heap_.get();
+  }
+  scan_table_heap_ = table_heap;
+  read_ahead_ = std::make_unique<ReadAhead>(
+      buffer_ring_ != nullptr ? buffer_ring_.get() : exec_ctx_->GetBufferPoolManager(), table_heap->GetNextPagesFn());
+  scan_page_id_ = table_heap->GetFirstPageId();
+  scan_slot_ = 0;
+  output_tuples_.clear();
+  output_rids_.clear();
+  output_idx_ = 0;
+}
+
+void SeqScanExecutor::StopWorkers() {
+  if (exchange_ == nullptr) {
+    return;
+  }
+  exchange_->Close();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+  workers_.clear();
+  exchange_.reset();
+  morsels_.reset();
+}
+
+bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) {
+  const Schema *output_schema = plan_->OutputSchema();
+  if (exchange_ != nullptr) {
+    return exchange_->PopTuple(output_schema, tuple, rid);
+  }
+
+  // The scan filters and projects a page at a time while the page is latched, and hands out the projected tuples
+  // afterwards, so no latch is held while the consumer runs.
+  const Schema *table_schema = &table_info_->schema_;
+  while (output_idx_ == output_tuples_.size()) {
+    if (scan_page_id_ == INVALID_PAGE_ID) {
+      return false;
+    }
+    output_tuples_.clear();
+    output_rids_.clear();
+    output_idx_ = 0;
+    TablePageGuard guard;
+    page_views_.clear();
+    scan_page_id_ = ReadPage(scan_table_heap_, scan_page_id_, &guard, &page_views_);
+    read_ahead_->OnPageAccess(scan_page_id_);
+    for (const auto &view : page_views_) {
+      const Tuple &current = view.AsTuple();
+      if (column_filter_ == nullptr && !predicate_.Evaluate(&current)) {
+        continue;
+      }
+      std::vector<Value> values;
+      values.reserve(output_schema->GetColumnCount());
+      for (const auto &column : output_schema->GetColumns()) {
+        values.push_back(column.GetExpr()->Evaluate(&current, table_schema));
+      }
+      output_tuples_.emplace_back(values, output_schema);
+      output_rids_.push_back(view.GetRid());
+    }
+  }
+  *tuple = std::move(output_tuples_[output_idx_]);
+  *rid = output_rids_[output_idx_];
+  output_idx_++;
+  return true;
+}
+
+bool SeqScanExecutor::NextBatch(TupleBatch *batch) {
+  if (exchange_ != nullptr) {
+    return exchange_->Pop(batch);
+  }
+
+  while (scan_page_id_ != INVALID_PAGE_ID) {
+    table_batch_.Reset(table_info_->schema_.GetColumnCount());
+    while (!table_batch_.IsFull() && scan_page_id_ != INVALID_PAGE_ID) {
+      page_id_t next_page_id;
+      if (AppendPage(scan_table_heap_, scan_page_id_, &scan_slot_, &table_batch_, &next_page_id, &page_views_)) {
+        read_ahead_->OnPageAccess(next_page_id);
+        scan_page_id_ = next_page_id;
+        scan_slot_ = 0;
+      }
+    }
+    if (FilterAndProject(&table_batch_, &predicate_result_, batch)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+page_id_t SeqScanExecutor::ReadPage(TableHeap *table_heap, page_id_t page_id, TablePageGuard *guard,
+                                    std::vector<TupleView> *views) const {
+  Transaction *txn = exec_ctx_->GetTransaction();
+  if (column_filter_ != nullptr) {
+    return table_heap->GetPageTupleViews(page_id, *column_filter_, guard, views, txn);
+  }
+  return table_heap->GetPageTupleViews(page_id, guard, views, txn);
+}
+
+bool SeqScanExecutor::AppendPage(TableHeap *table_heap, page_id_t page_id, uint32_t *slot, TupleBatch *table_batch,
+                                 page_id_t *next_page_id, std::vector<TupleView> *views) const {
+  TablePageGuard guard;
+  views->clear();
+  *next_page_id = ReadPage(table_heap, page_id, &guard, views);
+  for (const auto &view : *views) {
+    uint32_t view_slot = view.GetRid().GetSlotNum();
+    if (view_slot < *slot) {
+      continue;
+    }
+    if (table_batch->IsFull()) {
+      *slot = view_slot;
+      return false;
+    }
+    AppendTableTuple(view.AsTuple(), table_batch);
+  }
+  return true;
+}
+
+void SeqScanExecutor::AppendTableTuple(const Tuple &tuple, TupleBatch *table_batch) const {
+  // Tuples read through the column filter already satisfy the predicate.
+  if (predicate_.IsSpecialized() && column_filter_ == nullptr && !predicate_.Evaluate(&tuple)) {
+    return;
+  }
+  for (uint32_t col_idx : referenced_columns_) {
+    table_batch->GetMutableColumn(col_idx)->push_back(tuple.GetValue(&table_info_->schema_, col_idx));
+  }
+  table_batch->GetMutableRids()->push_back(tuple.GetRid());
+}
+
+bool SeqScanExecutor::FilterAndProject(TupleBatch *table_batch, std::vector<Value> *predicate_result,
+                                       TupleBatch *batch) const {
+  table_batch->SelectAll();
+  const AbstractExpression *predicate = plan_->GetPredicate();
+  if (predicate != nullptr && !predicate_.IsSpecialized()) {
+    predicate->EvaluateBatch(*table_batch, predicate_result);
+    std::vector<uint32_t> selection;
+    selection.reserve(table_batch->GetNumSelected());
+    for (uint32_t row : table_batch->GetSelection()) {
+      if ((*predicate_result)[row].GetAs<bool>()) {
+        selection.push_back(row);
+      }
+    }
+    table_batch->SetSelection(std::move(selection));
+  }
+  if (table_batch->GetNumSelected() == 0) {
+    return false;
+  }
+
+  // Columns are swapped rather than copied, so table_batch gets the storage of the last batch back for its next rows.
+  const Schema *output_schema = plan_->OutputSchema();
+  batch->Reset(output_schema->GetColumnCount());
+  for (uint32_t col_idx : evaluated_columns_) {
+    output_schema->GetColumn(col_idx).GetExpr()->EvaluateBatch(*table_batch, batch->GetMutableColumn(col_idx));
+  }
+  for (const auto &[col_idx, table_col_idx] : moved_columns_) {
+    batch->GetMutableColumn(col_idx)->swap(*table_batch->GetMutableColumn(table_col_idx));
+  }
+  batch->GetMutableRids()->swap(*table_batch->GetMutableRids());
+  batch->SetSelection(std::vector<uint32_t>(table_batch->GetSelection()));
+  return true;
+}
+
+void SeqScanExecutor::ScanMorsels() {
+  TableHeap *table_heap = table_info_->table_.get();
+  uint32_t num_columns = table_info_->schema_.GetColumnCount();
+  std::vector<page_id_t> page_ids;
+  std::vector<TupleView> views;
+  TupleBatch table_batch;
+  TupleBatch batch;
+  std::vector<Value> predicate_result;
+  bool open = true;
 
-void SeqScanExecutor::Init() {}
+  // Hands a full (or the last) batch of table rows on to the consumer.
+  auto flush = [&] {
+    if (FilterAndProject(&table_batch, &predicate_result, &batch)) {
+      open = exchange_->Push(&batch);
+    }
+    table_batch.Reset(num_columns);
+  };
 
-bool SeqScanExecutor::Next(Tuple *tuple, RID *rid) { return false; }
+  table_batch.Reset(num_columns);
+  while (open && morsels_->Next(&page_ids)) {
+    for (page_id_t page_id : page_ids) {
+      // A page that fills the batch is released before the batch is pushed, and read again for its remaining rows.
+      uint32_t slot = 0;
+      page_id_t next_page_id;
+      while (open && !AppendPage(table_heap, page_id, &slot, &table_batch, &next_page_id, &views)) {
+        flush();
+      }
+      if (open && table_batch.IsFull()) {
+        flush();
+      }
+    }
+  }
+  if (open && table_batch.GetNumRows() > 0) {
+    flush();
+  }
+  exchange_->ProducerDone();
+}
 
 }  // namespace bustub
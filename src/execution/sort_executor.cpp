@@ -0,0 +1,234 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.cpp
+//
+// Identification: src/execution/sort_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/sort_executor.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "common/exception.h"
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+std::vector<Value> SortKeyComparator::MakeKey(const Tuple &tuple, const Schema *schema) const {
+  std::vector<Value> key;
+  key.reserve(order_bys_->size());
+  for (const auto &[type, expr] : *order_bys_) {
+    key.push_back(expr->Evaluate(&tuple, schema));
+  }
+  return key;
+}
+
+bool SortKeyComparator::operator()(const std::vector<Value> &a, const std::vector<Value> &b) const {
+  for (size_t i = 0; i < order_bys_->size(); i++) {
+    bool descending = (*order_bys_)[i].first == OrderByType::DESC;
+    if (a[i].IsNull() || b[i].IsNull()) {
+      if (a[i].IsNull() == b[i].IsNull()) {
+        continue;
+      }
+      // NULL is smaller than every other value.
+      return a[i].IsNull() != descending;
+    }
+    if (a[i].CompareEquals(b[i]) == CmpBool::CmpTrue) {
+      continue;
+    }
+    return (a[i].CompareLessThan(b[i]) == CmpBool::CmpTrue) != descending;
+  }
+  return false;
+}
+
+size_t SortRowFootprint(const Tuple &tuple, const std::vector<Value> &key) {
+  return sizeof(Tuple) + tuple.GetLength() + sizeof(std::vector<Value>) + key.size() * sizeof(Value) +
+         sizeof(uint32_t);
+}
+
+SortExecutor::SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      comparator_(&plan->GetOrderBy()) {}
+
+SortExecutor::~SortExecutor() { DropRuns(); }
+
+void SortExecutor::Init() {
+  DropRuns();
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+  next_row_ = 0;
+  memory_usage_ = 0;
+  peak_memory_usage_ = 0;
+  num_spilled_runs_ = 0;
+
+  child_executor_->Init();
+  const Schema *child_schema = child_executor_->GetOutputSchema();
+  if (exec_ctx_->IsBatchExecution()) {
+    TupleBatch batch;
+    while (child_executor_->NextBatch(&batch)) {
+      for (uint32_t row : batch.GetSelection()) {
+        AddTuple(batch.GetTuple(row, child_schema));
+      }
+    }
+  } else {
+    Tuple tuple;
+    RID rid;
+    while (child_executor_->Next(&tuple, &rid)) {
+      AddTuple(tuple);
+    }
+  }
+  SortRows();
+  if (runs_.empty()) {
+    return;
+  }
+
+  // The rows left in memory become the last run of the merge.
+  Run last_run;
+  last_run.tuples_.reserve(order_.size());
+  for (auto it = order_.rbegin(); it != order_.rend(); ++it) {
+    last_run.tuples_.push_back(tuples_[*it]);
+  }
+  runs_.push_back(std::move(last_run));
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+
+  // A run is below another in the heap if its next key is larger; runs of equal keys go in the order of the input.
+  auto later = [this](size_t a, size_t b) {
+    return comparator_(runs_[b].key_, runs_[a].key_) || (!comparator_(runs_[a].key_, runs_[b].key_) && a > b);
+  };
+  for (size_t i = 0; i < runs_.size(); i++) {
+    if (PrepareRun(&runs_[i])) {
+      merge_heap_.push_back(i);
+    }
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(), later);
+}
+
+void SortExecutor::AddTuple(const Tuple &tuple) {
+  std::vector<Value> key = comparator_.MakeKey(tuple, child_executor_->GetOutputSchema());
+  size_t footprint = SortRowFootprint(tuple, key);
+  size_t budget = exec_ctx_->GetMemoryBudget();
+  if (budget != 0 && !tuples_.empty() && memory_usage_ + footprint > budget) {
+    SortRows();
+    SpillRun();
+  }
+  tuples_.push_back(tuple);
+  keys_.push_back(std::move(key));
+  memory_usage_ += footprint;
+  peak_memory_usage_ = std::max(peak_memory_usage_, memory_usage_);
+}
+
+void SortExecutor::SortRows() {
+  order_.resize(tuples_.size());
+  std::iota(order_.begin(), order_.end(), 0);
+  std::stable_sort(order_.begin(), order_.end(),
+                   [this](uint32_t a, uint32_t b) { return comparator_(keys_[a], keys_[b]); });
+}
+
+void SortExecutor::SpillRun() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  runs_.emplace_back();
+  Run &run = runs_.back();
+  TmpTuplePage *page = nullptr;
+  TmpTuple location(INVALID_PAGE_ID, 0);
+  for (uint32_t row : order_) {
+    if (page != nullptr && page->Insert(tuples_[row], &location)) {
+      continue;
+    }
+    if (page != nullptr) {
+      bpm->UnpinPage(page->GetTablePageId(), true);
+    }
+    page_id_t page_id;
+    page = reinterpret_cast<TmpTuplePage *>(bpm->NewPage(&page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame for a sort run");
+    }
+    page->Init(page_id, PAGE_SIZE);
+    run.pages_.push_back(page_id);
+    if (!page->Insert(tuples_[row], &location)) {
+      bpm->UnpinPage(page_id, true);
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "a tuple does not fit in a temporary page");
+    }
+  }
+  if (page != nullptr) {
+    bpm->UnpinPage(page->GetTablePageId(), true);
+  }
+  num_spilled_runs_++;
+  tuples_.clear();
+  keys_.clear();
+  order_.clear();
+  memory_usage_ = 0;
+}
+
+bool SortExecutor::PrepareRun(Run *run) {
+  if (run->tuples_.empty()) {
+    if (run->next_page_ == run->pages_.size()) {
+      return false;
+    }
+    // Pages hold the most recently inserted tuple first, so the tuple read last is the next one of the run.
+    BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+    page_id_t page_id = run->pages_[run->next_page_++];
+    auto *page = reinterpret_cast<TmpTuplePage *>(bpm->FetchPage(page_id));
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read a sort run");
+    }
+    page->GetTuples(&run->tuples_);
+    bpm->UnpinPage(page_id, false);
+    bpm->DeletePage(page_id);
+  }
+  run->key_ = comparator_.MakeKey(run->tuples_.back(), child_executor_->GetOutputSchema());
+  return true;
+}
+
+void SortExecutor::DropRuns() {
+  BufferPoolManager *bpm = exec_ctx_->GetBufferPoolManager();
+  for (const auto &run : runs_) {
+    for (size_t i = run.next_page_; i < run.pages_.size(); i++) {
+      bpm->DeletePage(run.pages_[i]);
+    }
+  }
+  runs_.clear();
+  merge_heap_.clear();
+}
+
+bool SortExecutor::Next(Tuple *tuple, RID *rid) {
+  if (runs_.empty()) {
+    if (next_row_ == order_.size()) {
+      return false;
+    }
+    *tuple = tuples_[order_[next_row_++]];
+    *rid = tuple->GetRid();
+    return true;
+  }
+
+  if (merge_heap_.empty()) {
+    return false;
+  }
+  auto later = [this](size_t a, size_t b) {
+    return comparator_(runs_[b].key_, runs_[a].key_) || (!comparator_(runs_[a].key_, runs_[b].key_) && a > b);
+  };
+  std::pop_heap(merge_heap_.begin(), merge_heap_.end(), later);
+  Run &run = runs_[merge_heap_.back()];
+  *tuple = run.tuples_.back();
+  *rid = tuple->GetRid();
+  run.tuples_.pop_back();
+  if (PrepareRun(&run)) {
+    std::push_heap(merge_heap_.begin(), merge_heap_.end(), later);
+  } else {
+    merge_heap_.pop_back();
+  }
+  return true;
+}
+
+}  // namespace bustub
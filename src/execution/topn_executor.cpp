@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.cpp
+//
+// Identification: src/execution/topn_executor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/executors/topn_executor.h"
+
+#include <algorithm>
+
+namespace bustub {
+
+TopNExecutor::TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan,
+                           std::unique_ptr<AbstractExecutor> &&child_executor)
+    : AbstractExecutor(exec_ctx),
+      plan_(plan),
+      child_executor_(std::move(child_executor)),
+      comparator_(&plan->GetOrderBy()) {}
+
+void TopNExecutor::Init() {
+  rows_.clear();
+  next_row_ = 0;
+  memory_usage_ = 0;
+  peak_memory_usage_ = 0;
+
+  child_executor_->Init();
+  const Schema *child_schema = child_executor_->GetOutputSchema();
+  if (exec_ctx_->IsBatchExecution()) {
+    TupleBatch batch;
+    while (child_executor_->NextBatch(&batch)) {
+      for (uint32_t row : batch.GetSelection()) {
+        AddTuple(batch.GetTuple(row, child_schema));
+      }
+    }
+  } else {
+    Tuple tuple;
+    RID rid;
+    while (child_executor_->Next(&tuple, &rid)) {
+      AddTuple(tuple);
+    }
+  }
+  std::sort_heap(rows_.begin(), rows_.end(),
+                 [this](const Row &a, const Row &b) { return comparator_(a.first, b.first); });
+}
+
+void TopNExecutor::AddTuple(const Tuple &tuple) {
+  if (plan_->GetN() == 0) {
+    return;
+  }
+  auto before = [this](const Row &a, const Row &b) { return comparator_(a.first, b.first); };
+  std::vector<Value> key = comparator_.MakeKey(tuple, child_executor_->GetOutputSchema());
+  if (rows_.size() == plan_->GetN()) {
+    // The heap is full: the row must order before the last of the first n rows so far to replace it.
+    if (!comparator_(key, rows_.front().first)) {
+      return;
+    }
+    std::pop_heap(rows_.begin(), rows_.end(), before);
+    memory_usage_ -= SortRowFootprint(rows_.back().second, rows_.back().first);
+    rows_.pop_back();
+  }
+  memory_usage_ += SortRowFootprint(tuple, key);
+  peak_memory_usage_ = std::max(peak_memory_usage_, memory_usage_);
+  rows_.emplace_back(std::move(key), tuple);
+  std::push_heap(rows_.begin(), rows_.end(), before);
+}
+
+bool TopNExecutor::Next(Tuple *tuple, RID *rid) {
+  if (next_row_ == rows_.size()) {
+    return false;
+  }
+  *tuple = rows_[next_row_++].second;
+  *rid = tuple->GetRid();
+  return true;
+}
+
+}  // namespace bustub
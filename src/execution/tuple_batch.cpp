@@ -0,0 +1,58 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.cpp
+//
+// Identification: src/execution/tuple_batch.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "execution/tuple_batch.h"
+
+namespace bustub {
+
+void TupleBatch::Reset(uint32_t num_columns) {
+  columns_.resize(num_columns);
+  for (auto &column : columns_) {
+    column.clear();
+  }
+  rids_.clear();
+  selection_.clear();
+}
+
+void TupleBatch::SelectAll() {
+  selection_.resize(GetNumRows());
+  for (uint32_t row = 0; row < selection_.size(); row++) {
+    selection_[row] = row;
+  }
+}
+
+void TupleBatch::AppendTuple(const Tuple &tuple, const Schema *schema) {
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].push_back(tuple.GetValue(schema, col_idx));
+  }
+  selection_.push_back(GetNumRows());
+  rids_.push_back(tuple.GetRid());
+}
+
+void TupleBatch::AppendRow(const TupleBatch &other, uint32_t row) {
+  for (uint32_t col_idx = 0; col_idx < columns_.size(); col_idx++) {
+    columns_[col_idx].push_back(other.columns_[col_idx][row]);
+  }
+  selection_.push_back(GetNumRows());
+  rids_.push_back(other.rids_[row]);
+}
+
+Tuple TupleBatch::GetTuple(uint32_t row, const Schema *schema) const {
+  std::vector<Value> values;
+  values.reserve(columns_.size());
+  for (const auto &column : columns_) {
+    values.push_back(column[row]);
+  }
+  return Tuple(values, schema);
+}
+
+}  // namespace bustub
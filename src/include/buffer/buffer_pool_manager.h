@@ -15,6 +15,7 @@
 #include <list>
 #include <mutex>  // NOLINT
 #include <unordered_map>
+#include <vector>
 
 #include "buffer/lru_replacer.h"
 #include "recovery/log_manager.h"
@@ -84,6 +85,48 @@ class BufferPoolManager {
     GradingCallback(callback, CallbackType::AFTER, INVALID_PAGE_ID);
   }
 
+  /**
+   * Starts loading pages that are about to be fetched, without waiting for the I/O. This is only a hint: pages that are
+   * resident or invalid are skipped, and prefetching stops early if no frame can be freed.
+   * @param page_ids ids of the pages to load
+   */
+  void PrefetchPages(const std::vector<page_id_t> &page_ids) { PrefetchPgsImp(page_ids); }
+
+  /** @return true if PrefetchPages() loads pages without stalling the caller, so that it is worth calling */
+  bool CanPrefetch() const { return CanPrefetchImp(); }
+
+  /**
+   * Counts a pinned page as accessed again, for a caller that reads the whole page under a single pin where it used to
+   * fetch it once per tuple. Replacement then treats the page as one that was hit since it was loaded.
+   * @param page_id id of a page the caller has pinned
+   */
+  void MarkPageReferenced(page_id_t page_id) { MarkPgReferencedImp(page_id); }
+
+  /**
+   * Fetches a page like FetchPage(). On a miss, the page is loaded into the frame of reuse_page_id if that page is
+   * resident and unpinned, instead of into a frame from the free list or the replacer. This is how a BufferRing
+   * recycles its frames.
+   * @param page_id id of the page to fetch
+   * @param reuse_page_id the page whose frame may be reused, INVALID_PAGE_ID for none
+   * @param[out] loaded true if the page was read from disk
+   * @param[out] reused true if the frame of reuse_page_id was reused
+   * @return the page, or nullptr if no frame could be found
+   */
+  Page *FetchPageReusing(page_id_t page_id, page_id_t reuse_page_id, bool *loaded, bool *reused) {
+    return FetchPgReusingImp(page_id, reuse_page_id, loaded, reused);
+  }
+
+  /**
+   * Creates a new page like NewPage(), in the frame of reuse_page_id if that page is resident and unpinned.
+   * @param[out] page_id id of the created page
+   * @param reuse_page_id the page whose frame may be reused, INVALID_PAGE_ID for none
+   * @param[out] reused true if the frame of reuse_page_id was reused
+   * @return the page, or nullptr if no frame could be found
+   */
+  Page *NewPageReusing(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) {
+    return NewPgReusingImp(page_id, reuse_page_id, reused);
+  }
+
   /** @return size of the buffer pool */
   virtual size_t GetPoolSize() = 0;
 
@@ -141,5 +184,40 @@ class BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   virtual void FlushAllPgsImp() = 0;
+
+  /**
+   * Starts loading the given pages asynchronously. Buffer pools that cannot prefetch ignore the hint.
+   * @param page_ids ids of the pages to load
+   */
+  virtual void PrefetchPgsImp(const std::vector<page_id_t> &page_ids) {}
+
+  /** @return true if PrefetchPgsImp() reads asynchronously; false for buffer pools that ignore the hint */
+  virtual bool CanPrefetchImp() const { return false; }
+
+  /**
+   * Marks a pinned page as referenced. Buffer pools that do not track references, and buffer rings, whose pages are
+   * meant to be evicted soon, ignore it.
+   * @param page_id id of the page
+   */
+  virtual void MarkPgReferencedImp(page_id_t page_id) {}
+
+  /**
+   * Fetches a page, reusing the frame of reuse_page_id on a miss. Buffer pools that cannot reuse a given frame fetch
+   * the page normally and report neither a load nor a reuse.
+   */
+  virtual Page *FetchPgReusingImp(page_id_t page_id, page_id_t reuse_page_id, bool *loaded, bool *reused) {
+    *loaded = false;
+    *reused = false;
+    return FetchPgImp(page_id);
+  }
+
+  /**
+   * Creates a new page, reusing the frame of reuse_page_id. Buffer pools that cannot reuse a given frame create the
+   * page normally.
+   */
+  virtual Page *NewPgReusingImp(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) {
+    *reused = false;
+    return NewPgImp(page_id);
+  }
 };
 }  // namespace bustub
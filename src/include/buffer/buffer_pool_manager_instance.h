@@ -12,12 +12,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>  // NOLINT
+#include <future>  // NOLINT
 #include <list>
-#include <mutex>  // NOLINT
-#include <unordered_map>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
 
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/clock_replacer.h"
+#include "buffer/frame_region.h"
+#include "buffer/lru_k_replacer.h"
 #include "buffer/lru_replacer.h"
+#include "buffer/page_table.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -26,6 +34,11 @@ namespace bustub {
 
 /**
  * BufferPoolManager reads disk pages to and from its internal buffer pool.
+ *
+ * Pinning and unpinning a resident page is latch-free: the frame is found through a lock-free PageTable lookup and
+ * pinned with a CAS on its pin count. Only page misses, evictions and deletions take a PageTable stripe latch (and
+ * latch_ for the free list). A frame whose pin count is negative is owned by a single thread, either because it sits
+ * on the free list or because it is being loaded, evicted or deleted, and cannot be pinned.
  */
 class BufferPoolManagerInstance : public BufferPoolManager {
  public:
@@ -34,8 +47,10 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param pool_size the size of the buffer pool
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
    */
-  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr);
+  BufferPoolManagerInstance(size_t pool_size, DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU);
   /**
    * Creates a new BufferPoolManagerInstance.
    * @param pool_size the size of the buffer pool
@@ -43,9 +58,14 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    * @param instance_index index of this BPI in the parallel BPM
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy
+   * @param use_huge_pages true to back the frames with 2 MiB huge pages, see FrameRegion
+   * @param numa_node the NUMA node to allocate the frames on, -1 for the default memory policy
    */
   BufferPoolManagerInstance(size_t pool_size, uint32_t num_instances, uint32_t instance_index,
-                            DiskManager *disk_manager, LogManager *log_manager = nullptr);
+                            DiskManager *disk_manager, LogManager *log_manager = nullptr,
+                            ReplacerType replacer_type = ReplacerType::LRU, bool use_huge_pages = false,
+                            int numa_node = -1);
 
   /**
    * Destroys an existing BufferPoolManagerInstance.
@@ -58,6 +78,46 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** @return pointer to all the pages in the buffer pool */
   Page *GetPages() { return pages_; }
 
+  /**
+   * Starts a background writer thread that writes back dirty, unpinned frames in the order in which the replacer will
+   * victimize them, so that evictions on the FetchPage/NewPage path find clean frames. Every
+   * background_writer_interval it cleans frames until target_clean_ratio of the pool is either free or clean at the
+   * victim end of the replacer. Runs of adjacent page ids are written with a single disk write. Pages whose LSN is
+   * not yet persistent in the log are skipped.
+   * @param target_clean_ratio fraction of the pool to keep clean ahead of eviction, in [0, 1]
+   * @param max_pages_per_second upper bound on the pages written per second, 0 for no limit
+   */
+  void RunBackgroundWriter(double target_clean_ratio = 0.1, size_t max_pages_per_second = 0);
+
+  /** Stops and joins the background writer thread, if running. */
+  void StopBackgroundWriter();
+
+  /**
+   * Runs one background writer round on the calling thread.
+   * @param num_frames how many frames should be free or clean at the victim end of the replacer
+   * @param max_pages the maximum number of pages to write
+   * @return the number of pages written
+   */
+  size_t CleanVictimCandidates(size_t num_frames, size_t max_pages);
+
+  /** @return number of pages written back by callers of this instance (evictions and explicit flushes) */
+  uint64_t GetNumForegroundWrites() const { return num_foreground_writes_; }
+
+  /** @return true if the frames are backed by huge pages */
+  bool UsesHugePages() const { return frames_.UsesHugePages(); }
+
+  /** @return the NUMA node the frames are bound to, -1 if they are not bound */
+  int GetNumaNode() const { return frames_.GetNumaNode(); }
+
+  /** @return number of pages written back by the background writer */
+  uint64_t GetNumBackgroundWrites() const { return num_background_writes_; }
+
+  /** @return number of fetches that had to read the page from disk */
+  uint64_t GetNumFetchMisses() const { return num_fetch_misses_; }
+
+  /** @return number of pages read from disk by PrefetchPages() */
+  uint64_t GetNumPrefetches() const { return num_prefetches_; }
+
  protected:
   /**
    * Fetch the requested page from the buffer pool.
@@ -100,6 +160,27 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void FlushAllPgsImp() override;
 
+  /**
+   * Starts asynchronous reads of the pages that are not resident. A prefetched page is mapped in the page table right
+   * away, but its frame stays busy until the read has completed and the page has been published by FinishPrefetch().
+   * Nothing is prefetched if the disk manager reads synchronously, as that would only stall the caller.
+   * @param page_ids ids of the pages to load
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return true if the disk manager reads asynchronously */
+  bool CanPrefetchImp() const override { return disk_manager_->HasAsyncReads(); }
+
+  /**
+   * Sets the referenced flag of the frame of a pinned page, giving the frame a second chance under LRU and clock.
+   * @param page_id id of the page
+   */
+  void MarkPgReferencedImp(page_id_t page_id) override;
+
+  Page *FetchPgReusingImp(page_id_t page_id, page_id_t reuse_page_id, bool *loaded, bool *reused) override;
+
+  Page *NewPgReusingImp(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) override;
+
   /**
    * Allocate a page on disk.∂
    * @return the id of the allocated page
@@ -121,6 +202,70 @@ class BufferPoolManagerInstance : public BufferPoolManager {
    */
   void ValidatePageId(page_id_t page_id) const;
 
+  /**
+   * Pins frame_id if it is resident and still holds page_id. Never blocks.
+   * @return true if the frame was pinned
+   */
+  bool TryPinFrame(frame_id_t frame_id, page_id_t page_id);
+
+  /**
+   * Pins page_id if it is resident, without loading it from disk.
+   * @param page_id id of the page to pin
+   * @param[out] frame_id the frame holding the page
+   * @return false if the page is not in the buffer pool
+   */
+  bool PinResidentPage(page_id_t page_id, frame_id_t *frame_id);
+
+  /** Drops one pin of frame_id and hands the frame to the replacer once it is no longer pinned. */
+  void UnpinFrame(frame_id_t frame_id);
+
+  /**
+   * Takes exclusive ownership of a frame: the frame of reuse_page_id if that page is resident and unpinned, otherwise
+   * one from the free list, and otherwise by evicting a victim.
+   * @param[out] frame_id the acquired frame
+   * @param reuse_page_id the page whose frame should be reused, INVALID_PAGE_ID for none
+   * @param[out] reused if not nullptr, set to true if the frame of reuse_page_id was taken
+   * @return false if every frame is pinned
+   */
+  bool AcquireFrame(frame_id_t *frame_id, page_id_t reuse_page_id = INVALID_PAGE_ID, bool *reused = nullptr);
+
+  /** Evicts a victim chosen by the replacer, writing it back if dirty. */
+  bool EvictFrame(frame_id_t *frame_id);
+
+  /**
+   * Evicts page_id if it is resident and unpinned, writing it back if dirty.
+   * @param[out] frame_id the frame that held the page, now exclusively owned by the caller
+   * @return false if the page is not resident or is in use
+   */
+  bool EvictPage(page_id_t page_id, frame_id_t *frame_id);
+
+  /** Writes back and unmaps the page in a frame that the caller has just made busy. */
+  void DetachFrame(frame_id_t frame_id);
+
+  /** Returns an exclusively owned frame to the free list. */
+  void ReleaseFrame(frame_id_t frame_id);
+
+  /** Body of the background writer thread. */
+  void BackgroundWriterLoop();
+
+  /**
+   * Waits for the prefetch read into frame_id and makes the page resident with a pin count of zero. The caller must
+   * hold the stripe latch of the page being loaded.
+   * @return false if the frame is not being prefetched
+   */
+  bool FinishPrefetch(frame_id_t frame_id);
+
+  /**
+   * Publishes the prefetched pages whose reads have completed.
+   * @param wait if true, also waits for the reads still in flight
+   */
+  void ReapPrefetches(bool wait);
+
+  /** Pin count of a frame owned by the thread that is loading, evicting or deleting it. */
+  static constexpr int FRAME_BUSY = -1;
+  /** Pin count of a frame on the free list. */
+  static constexpr int FRAME_FREE = -2;
+
   /** Number of pages in the buffer pool. */
   const size_t pool_size_;
   /** How many instances are in the parallel BPM (if present, otherwise just 1 BPI) */
@@ -130,19 +275,48 @@ class BufferPoolManagerInstance : public BufferPoolManager {
   /** Each BPI maintains its own counter for page_ids to hand out, must ensure they mod back to its instance_index_ */
   std::atomic<page_id_t> next_page_id_ = instance_index_;
 
-  /** Array of buffer pool pages. */
+  /** The page data of all frames. */
+  FrameRegion frames_;
+  /** Array of buffer pool pages, i.e. the book-keeping of every frame. The data lives in frames_. */
   Page *pages_;
   /** Pointer to the disk manager. */
   DiskManager *disk_manager_ __attribute__((__unused__));
   /** Pointer to the log manager. */
   LogManager *log_manager_ __attribute__((__unused__));
   /** Page table for keeping track of buffer pool pages. */
-  std::unordered_map<page_id_t, frame_id_t> page_table_;
-  /** Replacer to find unpinned pages for replacement. */
+  PageTable page_table_;
+  /**
+   * Replacer to find unpinned pages for replacement. Frames are not removed from it when they get pinned; instead the
+   * victim search skips frames whose pin count is not zero.
+   */
   Replacer *replacer_;
+  /** Per frame: true while the frame has an entry in replacer_. */
+  std::atomic<bool> *in_replacer_;
+  /** Per frame: set when the frame is pinned on the hit path, gives the frame a second chance during victim search. */
+  std::atomic<bool> *referenced_;
+  /** Whether victim search gives referenced frames a second chance. LRU-K sees every hit and orders them itself. */
+  bool second_chance_;
   /** List of free pages. */
   std::list<frame_id_t> free_list_;
-  /** This latch protects shared data structures. We recommend updating this comment to describe what it protects. */
+  /** This latch protects free_list_. It is only taken on page misses, evictions and deletions. */
   std::mutex latch_;
+
+  /** Background writer thread and its settings, see RunBackgroundWriter(). */
+  std::thread bg_writer_thread_;
+  bool bg_writer_running_{false};
+  double bg_target_clean_ratio_{0};
+  size_t bg_max_pages_per_second_{0};
+  /** Protects bg_writer_running_, used to wake the background writer up for shutdown. */
+  std::mutex bg_writer_latch_;
+  std::condition_variable bg_writer_cv_;
+  std::atomic<uint64_t> num_foreground_writes_{0};
+  std::atomic<uint64_t> num_background_writes_{0};
+
+  /** Per frame: the outstanding read of a prefetch, valid until the page is published. Guarded by the stripe latch. */
+  std::vector<std::future<void>> pending_reads_;
+  /** Frames that may have a prefetch in flight. Protected by latch_. */
+  std::vector<frame_id_t> prefetching_;
+  std::atomic<uint64_t> num_prefetches_{0};
+  std::atomic<uint64_t> num_fetch_misses_{0};
 };
 }  // namespace bustub
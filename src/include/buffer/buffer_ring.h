@@ -0,0 +1,69 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_ring.h
+//
+// Identification: src/include/buffer/buffer_ring.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * BufferRing is an access strategy for large sequential scans and bulk inserts. It wraps a buffer pool and limits the
+ * number of frames that the pages it loads may occupy to ring_size: once the ring is full, every page read from disk
+ * (or created) replaces the oldest page that the ring itself loaded, provided nobody is using it. The rest of the pool,
+ * e.g. the working set of concurrent transactions, is left alone.
+ *
+ * Pages that are already resident are used where they are and do not enter the ring. If the oldest ring page is
+ * pinned, the page is loaded into a frame of the shared pool as usual.
+ *
+ * A BufferRing belongs to a single executor and is not thread-safe.
+ */
+class BufferRing : public BufferPoolManager {
+ public:
+  /**
+   * Creates a new BufferRing.
+   * @param bpm the buffer pool to go through
+   * @param ring_size the number of frames the ring recycles
+   */
+  BufferRing(BufferPoolManager *bpm, size_t ring_size);
+
+  /** @return size of the underlying buffer pool */
+  size_t GetPoolSize() override { return bpm_->GetPoolSize(); }
+
+  /** @return number of times a ring frame was reused instead of a frame taken from the shared pool */
+  uint64_t GetNumEvictionsAvoided() const { return num_evictions_avoided_; }
+
+ protected:
+  Page *FetchPgImp(page_id_t page_id) override;
+  bool UnpinPgImp(page_id_t page_id, bool is_dirty) override { return bpm_->UnpinPage(page_id, is_dirty); }
+  bool FlushPgImp(page_id_t page_id) override { return bpm_->FlushPage(page_id); }
+  Page *NewPgImp(page_id_t *page_id) override;
+  bool DeletePgImp(page_id_t page_id) override;
+  void FlushAllPgsImp() override { bpm_->FlushAllPages(); }
+  // Prefetching would take frames from the shared pool, so the ring ignores the hint.
+
+ private:
+  /** Records that the page was loaded into the ring slot that comes next. */
+  void Advance(page_id_t page_id, bool reused);
+
+  BufferPoolManager *bpm_;
+  /** Pages loaded through the ring, INVALID_PAGE_ID for unused slots. */
+  std::vector<page_id_t> ring_;
+  /** The slot to fill next, holding the oldest page. */
+  size_t next_slot_{0};
+  uint64_t num_evictions_avoided_{0};
+};
+
+}  // namespace bustub
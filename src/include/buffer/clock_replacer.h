@@ -12,7 +12,6 @@
 
 #pragma once
 
-#include <list>
 #include <mutex>  // NOLINT
 #include <vector>
 
@@ -45,8 +44,21 @@ class ClockReplacer : public Replacer {
 
   size_t Size() override;
 
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
  private:
-  // TODO(student): implement me!
+  /** Number of frames, frame ids range from 0 to num_pages_ - 1. */
+  size_t num_pages_;
+  /** Per frame: true if the frame can be victimized. */
+  std::vector<bool> in_clock_;
+  /** Per frame: the reference bit, set when the frame is unpinned and cleared as the hand passes over it. */
+  std::vector<bool> ref_;
+  /** Number of frames in the clock. */
+  size_t size_{0};
+  /** The frame the clock hand points to. */
+  size_t hand_{0};
+  /** Protects all of the above. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,70 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// frame_region.h
+//
+// Identification: src/include/buffer/frame_region.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * FrameRegion is the memory that holds the page data of a buffer pool: num_frames page-aligned frames of PAGE_SIZE
+ * bytes, back to back, mapped straight from the kernel and zero-filled.
+ *
+ * The region can be backed by 2 MiB huge pages, which lets a large pool be covered by far fewer TLB entries. Explicit
+ * huge pages (hugetlbfs) are used if the system has reserved any, otherwise the region is 2 MiB aligned and the kernel
+ * is asked to back it with transparent huge pages. The region can also be bound to a NUMA node, so that its memory is
+ * allocated there no matter which thread touches it first.
+ *
+ * Both are requests: if the kernel refuses, the region falls back to regular pages or the default memory policy.
+ */
+class FrameRegion {
+ public:
+  /**
+   * Maps a new region.
+   * @param num_frames the number of frames
+   * @param use_huge_pages true to back the region with huge pages
+   * @param numa_node the NUMA node to allocate the memory on, -1 for the default policy
+   */
+  explicit FrameRegion(size_t num_frames, bool use_huge_pages = false, int numa_node = -1);
+
+  ~FrameRegion();
+
+  DISALLOW_COPY_AND_MOVE(FrameRegion);
+
+  /** @return the data of frame frame_id */
+  char *GetFrame(frame_id_t frame_id) const { return data_ + static_cast<size_t>(frame_id) * PAGE_SIZE; }
+
+  /** @return true if the region is backed by huge pages (explicitly reserved or transparent) */
+  bool UsesHugePages() const { return uses_huge_pages_; }
+
+  /** @return the NUMA node the region is bound to, -1 if it is not bound */
+  int GetNumaNode() const { return numa_node_; }
+
+  /** @return the number of NUMA nodes of this machine, at least 1 */
+  static int GetNumNumaNodes();
+
+ private:
+  static constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+  char *data_{nullptr};
+  /** The address and length of the whole mapping, which may start before data_. */
+  void *mapping_{nullptr};
+  size_t mapping_size_{0};
+  bool uses_huge_pages_{false};
+  int numa_node_{-1};
+};
+
+}  // namespace bustub
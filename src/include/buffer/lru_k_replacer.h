@@ -0,0 +1,118 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer.h
+//
+// Identification: src/include/buffer/lru_k_replacer.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+#include <set>
+#include <utility>
+#include <vector>
+
+#include "buffer/replacer.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * LRUKReplacer implements the LRU-K replacement policy.
+ *
+ * The victim is the frame with the largest backward K-distance, i.e. whose K-th most recent reference lies furthest in
+ * the past. Frames with fewer than K references have an infinite distance and are evicted first, least recently
+ * referenced among them first. Pages touched by a single scan therefore leave the pool before pages that are
+ * referenced over and over, such as the upper levels of an index.
+ *
+ * Time advances by one whenever a different frame is referenced. Repeated references to the same frame with nothing
+ * in between (a scan reading every tuple of a page) are correlated and count as one.
+ *
+ * RecordAccess() does not take a latch. Concurrent references to the same frame can lose a history entry, which only
+ * makes the policy slightly less precise.
+ *
+ * Evictable frames are kept ordered by the eviction key they had when they were last ordered. References only ever
+ * move a frame back in that order, so a frame whose key has grown since is reordered when it reaches the front,
+ * and finding a victim takes logarithmic time.
+ */
+class LRUKReplacer : public Replacer {
+ public:
+  /**
+   * Create a new LRUKReplacer.
+   * @param num_pages the maximum number of pages the LRUKReplacer will be required to store
+   * @param k the number of references remembered per frame
+   */
+  explicit LRUKReplacer(size_t num_pages, size_t k = LRUK_REPLACER_K);
+
+  /**
+   * Destroys the LRUKReplacer.
+   */
+  ~LRUKReplacer() override;
+
+  /**
+   * Removes the victim. It keeps its history until ForgetHistory(), so a victim that the buffer pool does not evict
+   * after all goes back to its place when it is unpinned again.
+   */
+  bool Victim(frame_id_t *frame_id) override;
+
+  /** Makes the frame non-evictable. Its history is kept. */
+  void Pin(frame_id_t frame_id) override;
+
+  /**
+   * Makes the frame evictable. A frame without history is ordered as if it had been touched now, with zero references.
+   */
+  void Unpin(frame_id_t frame_id) override;
+
+  void RecordAccess(frame_id_t frame_id) override;
+
+  void ForgetHistory(frame_id_t frame_id) override;
+
+  size_t Size() override;
+
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
+ private:
+  /** Eviction order of an evictable frame, smaller keys are evicted first. */
+  struct EvictionKey {
+    bool has_k_references_;
+    uint64_t timestamp_;
+
+    bool operator<(const EvictionKey &other) const {
+      return has_k_references_ != other.has_k_references_ ? !has_k_references_ : timestamp_ < other.timestamp_;
+    }
+  };
+
+  EvictionKey GetEvictionKey(frame_id_t frame_id) const;
+
+  /** Moves an evictable frame whose key has grown since it was ordered to its current place. Requires latch_. */
+  bool Reorder(std::set<std::pair<EvictionKey, frame_id_t>>::iterator entry);
+
+  /** Number of frames, frame ids range from 0 to num_pages_ - 1. */
+  size_t num_pages_;
+  size_t k_;
+  /** History of every frame: k_ timestamps, most recent first, 0 for none. */
+  std::unique_ptr<std::atomic<uint64_t>[]> history_;
+  /** Number of references recorded per frame, saturating at k_. */
+  std::unique_ptr<std::atomic<uint32_t>[]> num_references_;
+  /** Logical clock. */
+  std::atomic<uint64_t> current_timestamp_{0};
+  /** The most recently referenced frame, used to detect correlated references. */
+  std::atomic<frame_id_t> last_frame_id_{-1};
+
+  /** Per frame: true if the frame can be victimized. Protected by latch_. */
+  std::vector<bool> evictable_;
+  /** Per evictable frame: the key it is ordered by in victims_. Protected by latch_. */
+  std::vector<EvictionKey> ordered_keys_;
+  /** The evictable frames in eviction order, as of their ordered_keys_. Protected by latch_. */
+  std::set<std::pair<EvictionKey, frame_id_t>> victims_;
+  std::mutex latch_;
+};
+
+}  // namespace bustub
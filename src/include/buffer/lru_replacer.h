@@ -14,6 +14,7 @@
 
 #include <list>
 #include <mutex>  // NOLINT
+#include <unordered_map>
 #include <vector>
 
 #include "buffer/replacer.h"
@@ -45,8 +46,17 @@ class LRUReplacer : public Replacer {
 
   size_t Size() override;
 
+  std::vector<frame_id_t> PeekVictims(size_t max_frames) override;
+
  private:
-  // TODO(student): implement me!
+  /** Maximum number of frames tracked at once. */
+  size_t num_pages_;
+  /** Unpinned frames, least recently unpinned at the front. */
+  std::list<frame_id_t> lru_list_;
+  /** Position of each unpinned frame in lru_list_. */
+  std::unordered_map<frame_id_t, std::list<frame_id_t>::iterator> lru_map_;
+  /** Protects lru_list_ and lru_map_. */
+  std::mutex latch_;
 };
 
 }  // namespace bustub
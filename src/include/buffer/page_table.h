@@ -0,0 +1,113 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_table.h
+//
+// Identification: src/include/buffer/page_table.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>  // NOLINT
+
+#include "common/config.h"
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * PageTable maps the ids of resident pages to the frames holding them.
+ *
+ * The table is open-addressed with linear probing. Each slot is a single 64-bit word that packs the page id together
+ * with the frame id, so Find() is a plain scan of atomic loads and never takes a latch. Writers (Insert() and Remove())
+ * must hold the stripe latch of the page id they modify, which serializes concurrent writers of the same page without
+ * a table-wide mutex. Removed entries leave tombstones behind; Compact() clears them under all stripe latches once
+ * too many have accumulated.
+ *
+ * Because Find() does not synchronize with writers, a lock-free lookup is only a hint. Callers must validate the frame
+ * they get back and must repeat a lookup that misses while holding the stripe latch before concluding that the page is
+ * not resident.
+ */
+class PageTable {
+ public:
+  /**
+   * Creates a new PageTable.
+   * @param num_frames the maximum number of entries that will be live at the same time
+   */
+  explicit PageTable(size_t num_frames);
+
+  ~PageTable() = default;
+
+  DISALLOW_COPY_AND_MOVE(PageTable);
+
+  /**
+   * Lock-free lookup.
+   * @param page_id the page to look up
+   * @param[out] frame_id the frame holding the page, if found
+   * @return true if an entry for page_id was observed
+   */
+  bool Find(page_id_t page_id, frame_id_t *frame_id) const;
+
+  /**
+   * Inserts or overwrites the entry of page_id. The caller must hold GetStripeLatch(page_id).
+   * @param page_id the page to insert
+   * @param frame_id the frame holding the page
+   */
+  void Insert(page_id_t page_id, frame_id_t frame_id);
+
+  /**
+   * Removes the entry of page_id. The caller must hold GetStripeLatch(page_id).
+   * @param page_id the page to remove
+   * @return true if an entry was removed
+   */
+  bool Remove(page_id_t page_id);
+
+  /** @return the latch serializing writers of page_id */
+  std::mutex &GetStripeLatch(page_id_t page_id) { return stripe_latches_[Home(page_id) & stripe_mask_]; }
+
+  /** @return true if enough tombstones have accumulated that Compact() should be called */
+  bool NeedsCompaction() const { return num_tombstones_.load(std::memory_order_relaxed) > capacity_ / 4; }
+
+  /**
+   * Clears all tombstones by rebuilding the table in place. Takes every stripe latch, so the caller must not hold any.
+   */
+  void Compact();
+
+ private:
+  static constexpr uint64_t EMPTY_SLOT = ~static_cast<uint64_t>(0);
+  static constexpr uint64_t TOMBSTONE_SLOT = EMPTY_SLOT - 1;
+
+  static uint64_t Pack(page_id_t page_id, frame_id_t frame_id) {
+    return (static_cast<uint64_t>(static_cast<uint32_t>(page_id)) << 32) | static_cast<uint32_t>(frame_id);
+  }
+  static page_id_t PageOf(uint64_t slot) { return static_cast<page_id_t>(slot >> 32); }
+  static frame_id_t FrameOf(uint64_t slot) { return static_cast<frame_id_t>(slot & 0xFFFFFFFF); }
+
+  /** @return the home slot of page_id (Fibonacci hashing, page ids are mostly sequential) */
+  size_t Home(page_id_t page_id) const {
+    return static_cast<size_t>((static_cast<uint64_t>(static_cast<uint32_t>(page_id)) * 0x9E3779B97F4A7C15ULL) >>
+                               hash_shift_);
+  }
+
+  /** Inserts without looking for tombstones; only used by Compact() on a table without any. */
+  void InsertFresh(uint64_t entry);
+
+  /** Number of slots, always a power of two. */
+  size_t capacity_;
+  size_t slot_mask_;
+  uint32_t hash_shift_;
+  std::unique_ptr<std::atomic<uint64_t>[]> slots_;
+  std::atomic<size_t> num_tombstones_{0};
+
+  size_t num_stripes_;
+  size_t stripe_mask_;
+  std::unique_ptr<std::mutex[]> stripe_latches_;
+};
+
+}  // namespace bustub
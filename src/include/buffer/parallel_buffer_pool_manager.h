@@ -12,7 +12,11 @@
 
 #pragma once
 
+#include <atomic>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/buffer_pool_manager_instance.h"
 #include "recovery/log_manager.h"
 #include "storage/disk/disk_manager.h"
 #include "storage/page/page.h"
@@ -27,9 +31,14 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * @param pool_size the pool size of each BufferPoolManagerInstance
    * @param disk_manager the disk manager
    * @param log_manager the log manager (for testing only: nullptr = disable logging)
+   * @param replacer_type the replacement policy of every instance
+   * @param use_huge_pages true to back the frames of every instance with huge pages
+   * @param bind_numa_nodes true to spread the instances over the NUMA nodes, instance i allocating its frames on node
+   * i % number of nodes, so that each node serves the pages of its own instances from local memory
    */
   ParallelBufferPoolManager(size_t num_instances, size_t pool_size, DiskManager *disk_manager,
-                            LogManager *log_manager = nullptr);
+                            LogManager *log_manager = nullptr, ReplacerType replacer_type = ReplacerType::LRU,
+                            bool use_huge_pages = false, bool bind_numa_nodes = false);
 
   /**
    * Destroys an existing ParallelBufferPoolManager.
@@ -39,6 +48,12 @@ class ParallelBufferPoolManager : public BufferPoolManager {
   /** @return size of the buffer pool */
   size_t GetPoolSize() override;
 
+  /** @return the instance at index instance_index */
+  BufferPoolManagerInstance *GetInstance(size_t instance_index) { return instances_[instance_index]; }
+
+  /** @return the number of instances */
+  size_t GetNumInstances() const { return instances_.size(); }
+
  protected:
   /**
    * @param page_id id of page
@@ -86,5 +101,37 @@ class ParallelBufferPoolManager : public BufferPoolManager {
    * Flushes all the pages in the buffer pool to disk.
    */
   void FlushAllPgsImp() override;
+
+  /**
+   * Hands every page to the instance responsible for it.
+   * @param page_ids ids of the pages to load
+   */
+  void PrefetchPgsImp(const std::vector<page_id_t> &page_ids) override;
+
+  /** @return true if the instances can prefetch, which share one disk manager */
+  bool CanPrefetchImp() const override { return instances_[0]->CanPrefetch(); }
+
+  /**
+   * Marks the page referenced in its instance.
+   * @param page_id id of the page
+   */
+  void MarkPgReferencedImp(page_id_t page_id) override;
+
+  /**
+   * Fetches a page from its instance. The frame of reuse_page_id can only be reused if both pages map to the same
+   * instance, otherwise the page is fetched normally.
+   */
+  Page *FetchPgReusingImp(page_id_t page_id, page_id_t reuse_page_id, bool *loaded, bool *reused) override;
+
+  /**
+   * Creates a new page in the instance of reuse_page_id, in the frame of that page, before falling back to NewPgImp().
+   */
+  Page *NewPgReusingImp(page_id_t *page_id, page_id_t reuse_page_id, bool *reused) override;
+
+ private:
+  /** The instances, page i belongs to instances_[i % instances_.size()]. */
+  std::vector<BufferPoolManagerInstance *> instances_;
+  /** The instance NewPgImp() tries first. */
+  std::atomic<size_t> next_instance_{0};
 };
 }  // namespace bustub
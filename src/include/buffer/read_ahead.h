@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// read_ahead.h
+//
+// Identification: src/include/buffer/read_ahead.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * ReadAhead follows the pages visited by a scan along a page chain and prefetches the pages ahead of it once the scan
+ * has gone past a few pages.
+ *
+ * The pages to prefetch come from the chain itself, as listed by a NextPagesFn, rather than being guessed from the
+ * page ids. The window of pages kept in flight starts at min_window and doubles every time the scan consumes half of
+ * the prefetched pages, up to max_window. A scan that leaves the predicted chain resets the window.
+ */
+class ReadAhead {
+ public:
+  /** Lists up to max_pages pages that follow page_id in the chain, in chain order. */
+  using NextPagesFn = std::function<void(page_id_t page_id, size_t max_pages, std::vector<page_id_t> *page_ids)>;
+
+  /**
+   * Creates a new ReadAhead.
+   * @param bpm the buffer pool to prefetch into, nullptr disables read-ahead
+   * @param next_pages lists the pages of the chain, an empty function disables read-ahead
+   * @param min_window the initial number of pages kept in flight
+   * @param max_window the maximum number of pages kept in flight
+   */
+  ReadAhead(BufferPoolManager *bpm, NextPagesFn next_pages, size_t min_window = 4, size_t max_window = 64)
+      : bpm_(bpm),
+        next_pages_(std::move(next_pages)),
+        min_window_(min_window),
+        max_window_(max_window),
+        window_(min_window) {}
+
+  /**
+   * Records that the scan moved to page_id, prefetching the pages that follow it once the scan is long enough. Call
+   * this before fetching the page.
+   * @param page_id the page the scan is about to read
+   */
+  void OnPageAccess(page_id_t page_id);
+
+  /** @return the current window size */
+  size_t GetWindow() const { return window_; }
+
+ private:
+  /** Number of pages a scan visits before read-ahead starts. */
+  static constexpr size_t SEQUENTIAL_THRESHOLD = 2;
+
+  /** Forgets the prefetched pages and shrinks the window. */
+  void Reset();
+
+  BufferPoolManager *bpm_;
+  NextPagesFn next_pages_;
+  size_t min_window_;
+  size_t max_window_;
+  size_t window_;
+  page_id_t last_page_id_{INVALID_PAGE_ID};
+  size_t pages_visited_{0};
+  /** The prefetched pages from ahead_[ahead_pos_] on have not been visited yet. */
+  std::vector<page_id_t> ahead_;
+  size_t ahead_pos_{0};
+  /** Set once the chain has no pages left to prefetch. */
+  bool chain_exhausted_{false};
+};
+
+}  // namespace bustub
@@ -12,10 +12,23 @@
 
 #pragma once
 
+#include <vector>
+
 #include "common/config.h"
 
 namespace bustub {
 
+/** The replacement policies a buffer pool can be created with. */
+enum class ReplacerType {
+  /** Evict the least recently unpinned frame (LRUReplacer). */
+  LRU,
+  /** Clock approximation of LRU (ClockReplacer). */
+  CLOCK,
+  /** Evict the frame whose K-th most recent reference is oldest (LRUKReplacer), which keeps scans from flushing the
+     frequently used pages. */
+  LRU_K,
+};
+
 /**
  * Replacer is an abstract class that tracks page usage.
  */
@@ -43,8 +56,29 @@ class Replacer {
    */
   virtual void Unpin(frame_id_t frame_id) = 0;
 
+  /**
+   * Records a reference to the page held by a frame. The buffer pool calls this on every fetch, including hits, so it
+   * must be cheap and must not take a latch. Policies that only look at the unpin order ignore it.
+   * @param frame_id the id of the frame that was accessed
+   */
+  virtual void RecordAccess(frame_id_t frame_id) {}
+
+  /**
+   * Forgets the references recorded for a frame whose page has left the buffer pool, so that the next page the frame
+   * holds starts without history. Policies that keep no history ignore it.
+   * @param frame_id the id of the frame whose page was evicted or deleted
+   */
+  virtual void ForgetHistory(frame_id_t frame_id) {}
+
   /** @return the number of elements in the replacer that can be victimized */
   virtual size_t Size() = 0;
+
+  /**
+   * Lists the frames that would be victimized next, in victim order, without removing them.
+   * @param max_frames the maximum number of frames to return
+   * @return up to max_frames frame ids, the next victim first
+   */
+  virtual std::vector<frame_id_t> PeekVictims(size_t max_frames) = 0;
 };
 
 }  // namespace bustub
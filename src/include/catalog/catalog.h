@@ -220,9 +220,18 @@ class Catalog {
     // Populate the index with all tuples in table heap
     auto *table_meta = GetTable(table_name);
     auto *heap = table_meta->table_.get();
-    for (auto tuple = heap->Begin(txn); tuple != heap->End(); ++tuple) {
-      index->InsertEntry(tuple->KeyFromTuple(schema, key_schema, key_attrs), tuple->GetRid(), txn);
-    }
+    auto tuple = heap->Begin(txn);
+    index->InsertEntries(
+        [&](Tuple *key, RID *rid) {
+          if (tuple == heap->End()) {
+            return false;
+          }
+          *key = tuple->KeyFromTuple(schema, key_schema, key_attrs);
+          *rid = tuple->GetRid();
+          ++tuple;
+          return true;
+        },
+        txn);
 
     // Get the next OID for the new index
     const auto index_oid = next_index_oid_.fetch_add(1);
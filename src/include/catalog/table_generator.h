@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,14 @@ class TableGenerator {
    */
   void GenerateTestTables();
 
+  /**
+   * Generate a table with the columns of test_1 but an arbitrary number of rows, e.g. for benchmarks.
+   * @param name the name of the new table
+   * @param num_rows the number of rows to insert
+   * @return the metadata of the new table
+   */
+  TableInfo *GenerateTest1Table(const std::string &name, uint32_t num_rows);
+
  private:
   /** Enumeration to characterize the distribution of values in a given column */
   enum class Dist : uint8_t { Uniform, Zipf_50, Zipf_75, Zipf_95, Zipf_99, Serial, Cyclic };
@@ -103,6 +112,8 @@ class TableGenerator {
 
   void FillTable(TableInfo *info, TableInsertMeta *table_meta);
 
+  TableInfo *CreateAndFillTable(TableInsertMeta *table_meta);
+
   std::vector<Value> MakeValues(ColumnInsertMeta *col_meta, uint32_t count);
 
   template <typename CppType>
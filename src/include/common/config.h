@@ -27,6 +27,15 @@ extern std::atomic<bool> enable_logging;
 /** If ENABLE_LOGGING is true, the log should be flushed to disk every LOG_TIMEOUT. */
 extern std::chrono::duration<int64_t> log_timeout;
 
+/**
+ * True if table and index scans should prefetch the pages ahead of them, false otherwise. Prefetching only pays off
+ * with asynchronous reads, so scans skip it when the disk manager reads synchronously, as with the FSTREAM backend.
+ */
+extern std::atomic<bool> enable_read_ahead;
+
+/** A running background writer cleans buffer pool frames every BACKGROUND_WRITER_INTERVAL. */
+extern std::chrono::milliseconds background_writer_interval;
+
 static constexpr int INVALID_PAGE_ID = -1;                                    // invalid page id
 static constexpr int INVALID_TXN_ID = -1;                                     // invalid transaction id
 static constexpr int INVALID_LSN = -1;                                        // invalid log sequence number
@@ -35,6 +44,16 @@ static constexpr int PAGE_SIZE = 4096;                                        //
 static constexpr int BUFFER_POOL_SIZE = 10;                                   // size of buffer pool
 static constexpr int LOG_BUFFER_SIZE = ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE);  // size of a log buffer in byte
 static constexpr int BUCKET_SIZE = 50;                                        // size of extendible hash bucket
+static constexpr int LRUK_REPLACER_K = 2;                                     // references remembered by lru-k
+static constexpr int COMPRESSED_EXTENT_UNIT = 512;                            // unit of compressed page extents
+static constexpr int EXECUTION_BATCH_SIZE = 1024;                             // maximum rows in a tuple batch
+static constexpr int SCAN_MORSEL_SIZE = 16;                                   // pages per parallel scan morsel
+static constexpr int HASH_JOIN_PARTITION_SIZE = 4096;                         // build rows per radix join partition
+static constexpr int HASH_JOIN_SPILL_FANOUT = 8;                              // partitions per Grace hash join split
+static constexpr int AGGREGATION_PREAGG_SLOTS = 1024;                         // groups per pre-aggregation table
+static constexpr int AGGREGATION_PARTITIONS = 64;                             // partitions of a parallel aggregation
+static constexpr int AGGREGATION_INLINE_ACCUMULATORS = 4;                     // aggregates stored inline in a group
+static constexpr int INDEX_BUILD_MEMORY_BUDGET = 16 << 20;                    // bytes an index build sorts in memory
 
 using frame_id_t = int32_t;    // frame id type
 using page_id_t = int32_t;     // page id type
@@ -0,0 +1,78 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// optimistic_latch.h
+//
+// Identification: src/include/common/optimistic_latch.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <thread>  // NOLINT
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/**
+ * Version latch for optimistic latch coupling.
+ *
+ * Writers hold the latch exclusively and bump the version when they release it. Readers never write to the latch: they
+ * remember the version, read the protected data, and then check that the version has not changed. A reader that fails
+ * the check may have seen a torn state and must throw away what it read.
+ *
+ * The version is odd while a writer holds the latch.
+ */
+class OptimisticLatch {
+ public:
+  OptimisticLatch() = default;
+
+  DISALLOW_COPY(OptimisticLatch);
+
+  /**
+   * Wait until no writer holds the latch.
+   * @return the version to validate the following reads against
+   */
+  uint64_t ReadVersion() const {
+    uint64_t version = version_.load(std::memory_order_acquire);
+    while ((version & 1) != 0) {
+      std::this_thread::yield();
+      version = version_.load(std::memory_order_acquire);
+    }
+    return version;
+  }
+
+  /** @return true if no writer has held the latch since ReadVersion returned version */
+  bool Validate(uint64_t version) const {
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return version_.load(std::memory_order_relaxed) == version;
+  }
+
+  /**
+   * Acquire the latch exclusively, unless a writer has held it since ReadVersion returned version.
+   * @return true if the latch was acquired
+   */
+  bool TryUpgrade(uint64_t version) {
+    return version_.compare_exchange_strong(version, version + 1, std::memory_order_acquire);
+  }
+
+  /** Acquire the latch exclusively. */
+  void WLock() {
+    while (!TryUpgrade(ReadVersion())) {
+    }
+  }
+
+  /** Release the latch and publish a new version. */
+  void WUnlock() { version_.fetch_add(1, std::memory_order_release); }
+
+ private:
+  std::atomic<uint64_t> version_{0};
+};
+
+}  // namespace bustub
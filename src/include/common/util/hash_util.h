@@ -45,6 +45,19 @@ class HashUtil {
     return HashBytes(reinterpret_cast<char *>(both), sizeof(hash_t) * 2);
   }
 
+  /**
+   * Mixes every bit of a hash into every other bit, for callers that partition by some of the bits. HashValue() leaves
+   * the low bits of small integers almost constant. This is the 64-bit finalizer of MurmurHash3.
+   */
+  static inline hash_t MixHash(hash_t hash) {
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
   static inline hash_t SumHashes(hash_t l, hash_t r) { return (l % PRIME_FACTOR + r % PRIME_FACTOR) % PRIME_FACTOR; }
 
   template <typename T>
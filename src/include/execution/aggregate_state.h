@@ -0,0 +1,183 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_state.h
+//
+// Identification: src/include/execution/aggregate_state.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "common/config.h"
+#include "common/util/hash_util.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/** The running state of one aggregate of one group, in a machine type rather than a Value. */
+struct AggregateAccumulator {
+  union {
+    /** The running sum, minimum or maximum of integer inputs */
+    int64_t integer_{0};
+    /** The running sum, minimum or maximum of DECIMAL inputs */
+    double decimal_;
+  };
+  /** The number of non-null inputs so far; every aggregate but a count is NULL while it is zero */
+  int64_t count_{0};
+};
+
+/** Hashes the inputs of a COUNT(DISTINCT) aggregate. */
+struct DistinctValueHash {
+  std::size_t operator()(const Value &value) const { return HashUtil::HashValue(&value); }
+};
+
+/** Compares the inputs of a COUNT(DISTINCT) aggregate. */
+struct DistinctValueEqual {
+  bool operator()(const Value &left, const Value &right) const {
+    return left.CompareEquals(right) == CmpBool::CmpTrue;
+  }
+};
+
+/** The distinct non-null inputs of a COUNT(DISTINCT) aggregate */
+using DistinctValueSet = std::unordered_set<Value, DistinctValueHash, DistinctValueEqual>;
+
+/**
+ * The running state of every aggregate of one group. The accumulators of a plan with up to
+ * AGGREGATION_INLINE_ACCUMULATORS aggregates are stored in the state itself, so that a new group allocates nothing.
+ */
+struct AggregateState {
+  /** @return the accumulators, one per aggregate */
+  AggregateAccumulator *Accumulators() { return overflow_.empty() ? inline_.data() : overflow_.data(); }
+
+  /** @return the accumulators, one per aggregate */
+  const AggregateAccumulator *Accumulators() const { return overflow_.empty() ? inline_.data() : overflow_.data(); }
+
+  /** The accumulators, unless the plan has more aggregates than fit */
+  std::array<AggregateAccumulator, AGGREGATION_INLINE_ACCUMULATORS> inline_;
+  /** The accumulators of a plan with more than AGGREGATION_INLINE_ACCUMULATORS aggregates; empty otherwise */
+  std::vector<AggregateAccumulator> overflow_;
+  /** The minimum or maximum of aggregates over inputs without a machine type, e.g. VARCHAR; empty if there are none */
+  std::vector<Value> values_;
+  /** The inputs of the COUNT(DISTINCT) aggregates; empty if there are none */
+  std::vector<DistinctValueSet> distinct_;
+};
+
+/**
+ * Aggregator accumulates the aggregates of an aggregation plan into AggregateStates. When it is created, it picks an
+ * accumulator for every aggregate from the aggregation type and the type of the input expression, so that combining a
+ * row takes a switch and an operation on an int64_t or a double instead of virtual calls that build temporary Values.
+ * Inputs without a machine type fall back to Value comparisons. NULL inputs are skipped.
+ *
+ * The values of the aggregates have the types that aggregation plans declare: COUNT and COUNT(DISTINCT) are INTEGER,
+ * AVG is DECIMAL, SUM of a BIGINT or DECIMAL input has the type of the input and other integer sums are INTEGER, and
+ * MIN and MAX have the type of the input.
+ */
+class Aggregator {
+ public:
+  /**
+   * Creates the aggregator of a plan.
+   * @param agg_exprs the aggregate input expressions
+   * @param agg_types the aggregation types
+   */
+  Aggregator(const std::vector<const AbstractExpression *> &agg_exprs, const std::vector<AggregationType> &agg_types);
+
+  /** Resets a state to that of a group without rows. */
+  void Init(AggregateState *state) const;
+
+  /**
+   * Combines a row into the state of its group.
+   * @param state the state of the group
+   * @param inputs the value of every aggregate input expression over the row
+   */
+  void Combine(AggregateState *state, const std::vector<Value> &inputs) const;
+
+  /**
+   * Combines a row of a batch into the state of its group.
+   * @param state the state of the group
+   * @param columns the aggregate input expressions evaluated over the batch, one column per aggregate
+   * @param row the row of the batch
+   */
+  void Combine(AggregateState *state, const std::vector<std::vector<Value>> &columns, uint32_t row) const;
+
+  /**
+   * Merges the state of a group over some rows into the state of the same group over other rows.
+   * @param state the state to merge into
+   * @param partial the state to merge, which may be moved from
+   */
+  void Merge(AggregateState *state, AggregateState *partial) const;
+
+  /**
+   * Computes the values of the aggregates, as HAVING clauses and output schemas see them.
+   * @param state the state of a group
+   * @param[out] values the value of every aggregate
+   */
+  void Finalize(const AggregateState &state, std::vector<Value> *values) const;
+
+  /** @return an estimate of the memory that a state takes */
+  size_t GetFootprint(const AggregateState &state) const;
+
+  /** @return true if some aggregate is a COUNT(DISTINCT), whose state grows with every new input */
+  bool HasDistinct() const { return has_distinct_; }
+
+  /** Appends a state to a record that is written to a temporary page. */
+  void SerializeTo(const AggregateState &state, std::vector<char> *record) const;
+
+  /**
+   * Reads a state that SerializeTo() appended to a record.
+   * @param[in,out] position where the state starts; advanced past it
+   * @param[out] state the state
+   */
+  void DeserializeFrom(const char **position, AggregateState *state) const;
+
+  /** Appends a value, preceded by its type, to a record that is written to a temporary page. */
+  static void SerializeValue(const Value &value, std::vector<char> *record);
+
+  /**
+   * Reads a value that SerializeValue() appended to a record.
+   * @param[in,out] position where the value starts; advanced past it
+   * @return the value
+   */
+  static Value DeserializeValue(const char **position);
+
+ private:
+  /** How an aggregate is accumulated */
+  enum class AccumulatorKind {
+    Count,
+    CountDistinct,
+    IntegerSum,
+    DecimalSum,
+    IntegerAvg,
+    DecimalAvg,
+    IntegerMin,
+    IntegerMax,
+    DecimalMin,
+    DecimalMax,
+    ValueMin,
+    ValueMax
+  };
+
+  /** Combines a non-null input into the accumulator of aggregate i. */
+  void CombineValue(AggregateState *state, size_t i, const Value &input) const;
+
+  /** The accumulator of every aggregate */
+  std::vector<AccumulatorKind> kinds_;
+  /** The type of the input of every aggregate */
+  std::vector<TypeId> input_types_;
+  /** True if some aggregate needs AggregateState::values_ */
+  bool has_values_{false};
+  /** True if some aggregate needs AggregateState::distinct_ */
+  bool has_distinct_{false};
+};
+
+}  // namespace bustub
@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_filter.h
+//
+// Identification: src/include/execution/column_filter.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "execution/compiled_predicate.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+/**
+ * ColumnFilter evaluates a comparison of a fixed-width column with a constant on a whole table page at a time. It
+ * gathers the column of every live slot into a dense array, compares the array with the constant a vector at a time
+ * into a selection bitmap, and selects the slots whose bit is set, so that a scan copies only the matching tuples.
+ *
+ * INTEGER, BIGINT and DECIMAL columns are compared with AVX2 where the compiler targets it and with SSE otherwise;
+ * TINYINT and SMALLINT columns, the tail of the array and builds without either use a scalar loop. NULLs never match.
+ */
+class ColumnFilter : public SlotFilter {
+ public:
+  /**
+   * Creates the filter of a scan predicate.
+   * @param comparison the predicate, as CompiledPredicate::GetColumnComparison() describes it
+   * @param use_simd false to compare with the scalar loop only
+   */
+  explicit ColumnFilter(const CompiledPredicate::ColumnComparison &comparison, bool use_simd = true)
+      : comparison_(comparison), use_simd_(use_simd) {}
+
+  void Filter(TablePage *page, std::vector<uint32_t> *slots) const override;
+
+ private:
+  /** The comparison of the column with the constant */
+  CompiledPredicate::ColumnComparison comparison_;
+  /** False to compare with the scalar loop only */
+  bool use_simd_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate.h
+//
+// Identification: src/include/execution/compiled_predicate.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "execution/expressions/abstract_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * CompiledPredicate is a predicate expression bound to the schemas of its inputs once, before the rows arrive.
+ *
+ * A comparison of a column, a group-by term or an aggregate with a constant or with another operand of the same type
+ * compiles to a closure specialized for the machine type of the operands (TINYINT, SMALLINT, INTEGER, BIGINT or
+ * DECIMAL) and the comparison operator. Over tuples, the closure reads the operands straight from the tuple bytes at
+ * the offsets of their columns; over the values of a group, it reads them from the Values without a virtual call.
+ * Either way, no Value is built per row. A comparison with a NULL operand does not hold.
+ *
+ * Any other predicate, e.g. a comparison of VARCHARs or of operands of different types, falls back to interpreting
+ * the expression.
+ */
+class CompiledPredicate {
+ public:
+  /** Creates the predicate of a plan without one, which every row satisfies. */
+  CompiledPredicate() = default;
+
+  /**
+   * Compiles the predicate of a scan.
+   * @param predicate the predicate, nullptr if there is none
+   * @param schema the schema of the tuples it is evaluated on
+   */
+  static CompiledPredicate Compile(const AbstractExpression *predicate, const Schema *schema);
+
+  /**
+   * Compiles the predicate of a join, whose columns refer to the left (tuple index 0) or the right tuple (index 1).
+   * @param predicate the predicate, nullptr if there is none
+   * @param left_schema the schema of the left tuples
+   * @param right_schema the schema of the right tuples
+   */
+  static CompiledPredicate CompileJoin(const AbstractExpression *predicate, const Schema *left_schema,
+                                       const Schema *right_schema);
+
+  /**
+   * Compiles the HAVING clause of an aggregation.
+   * @param predicate the clause, nullptr if there is none
+   */
+  static CompiledPredicate CompileAggregate(const AbstractExpression *predicate);
+
+  /** @return true if the predicate of a scan holds for the tuple */
+  bool Evaluate(const Tuple *tuple) const { return !tuple_function_ || tuple_function_(tuple, nullptr); }
+
+  /** @return true if the predicate of a join holds for the pair of tuples */
+  bool EvaluateJoin(const Tuple *left_tuple, const Tuple *right_tuple) const {
+    return !tuple_function_ || tuple_function_(left_tuple, right_tuple);
+  }
+
+  /** @return true if the HAVING clause holds for the group */
+  bool EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const {
+    return !aggregate_function_ || aggregate_function_(group_bys, aggregates);
+  }
+
+  /** @return true if there is no predicate */
+  bool IsEmpty() const { return !tuple_function_ && !aggregate_function_; }
+
+  /** @return true if the predicate compiled to a specialized closure rather than falling back to the expression */
+  bool IsSpecialized() const { return specialized_; }
+
+  /** A scan predicate that compares a fixed-width column with a constant, the column on the left. */
+  struct ColumnComparison {
+    /** The type of the column */
+    TypeId type_;
+    /** The offset of the column in a tuple */
+    uint32_t offset_;
+    /** The comparison */
+    ComparisonType comp_type_;
+    /** The constant, if the column has an integer type */
+    int64_t integer_{0};
+    /** The constant, if the column is DECIMAL */
+    double decimal_{0};
+  };
+
+  /** @return the predicate as a comparison of a column and a constant, nullptr if it is anything else */
+  const ColumnComparison *GetColumnComparison() const {
+    return column_comparison_.has_value() ? &column_comparison_.value() : nullptr;
+  }
+
+  /** Evaluates a predicate over one tuple or a pair of tuples. */
+  using TupleFunction = std::function<bool(const Tuple *, const Tuple *)>;
+  /** Evaluates a HAVING clause over the group-by terms and aggregates of a group. */
+  using AggregateFunction = std::function<bool(const std::vector<Value> &, const std::vector<Value> &)>;
+
+ private:
+  /** The predicate over tuples, empty if there is none */
+  TupleFunction tuple_function_;
+  /** The HAVING clause, empty if there is none */
+  AggregateFunction aggregate_function_;
+  /** True if the predicate is a specialized closure */
+  bool specialized_{false};
+  /** The predicate of a scan, if it compares a column with a constant */
+  std::optional<ColumnComparison> column_comparison_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,92 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// exchange.h
+//
+// Identification: src/include/execution/exchange.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <mutex>  // NOLINT
+
+#include "catalog/schema.h"
+#include "common/macros.h"
+#include "execution/tuple_batch.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Exchange connects the worker threads of a parallel operator to the single-threaded executor that consumes its
+ * output. Producers push batches into a bounded queue and block while it is full, so a slow consumer throttles the
+ * workers instead of letting their output pile up. The order of the batches is the order in which they were pushed.
+ */
+class Exchange {
+ public:
+  /**
+   * Creates an exchange.
+   * @param num_producers the number of producers that will call ProducerDone()
+   * @param capacity the number of batches that can be queued before producers block
+   */
+  Exchange(size_t num_producers, size_t capacity) : capacity_(capacity), num_producers_(num_producers) {}
+
+  DISALLOW_COPY_AND_MOVE(Exchange);
+
+  /**
+   * Queues a batch, blocking while the queue is full.
+   * @param batch the batch to queue; it is moved from
+   * @return false if the consumer closed the exchange, in which case the producer should stop
+   */
+  bool Push(TupleBatch *batch);
+
+  /** Signals that one producer will not push any more batches. */
+  void ProducerDone();
+
+  /**
+   * Dequeues a batch, blocking until one is available.
+   * @param[out] batch the dequeued batch
+   * @return false once every producer is done and the queue is empty
+   */
+  bool Pop(TupleBatch *batch);
+
+  /**
+   * Dequeues the next selected row, for a consumer that works tuple-at-a-time. Must not be mixed with Pop().
+   * @param schema the schema of the rows
+   * @param[out] tuple the next row
+   * @param[out] rid the RID of the next row
+   * @return false once every producer is done and the queue is empty
+   */
+  bool PopTuple(const Schema *schema, Tuple *tuple, RID *rid);
+
+  /** Discards the queued batches and makes every later Push() fail, for a consumer that stops early. */
+  void Close();
+
+ private:
+  /** Protects the members below */
+  std::mutex latch_;
+  /** Signaled when a batch is queued or the last producer is done */
+  std::condition_variable not_empty_;
+  /** Signaled when a batch is dequeued or the exchange is closed */
+  std::condition_variable not_full_;
+  /** The queued batches */
+  std::deque<TupleBatch> batches_;
+  /** The maximum number of queued batches */
+  size_t capacity_;
+  /** The number of producers that are not done */
+  size_t num_producers_;
+  /** True once the consumer closed the exchange */
+  bool closed_{false};
+  /** The batch PopTuple() returns rows of, only touched by the consumer */
+  TupleBatch current_batch_;
+  /** The position in the selection vector of current_batch_ of the next row PopTuple() returns */
+  uint32_t current_idx_{0};
+};
+
+}  // namespace bustub
@@ -20,6 +20,7 @@
 #include "execution/executor_context.h"
 #include "execution/executor_factory.h"
 #include "execution/plans/abstract_plan.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 namespace bustub {
 
@@ -57,11 +58,22 @@ class ExecutionEngine {
 
     // Execute the query plan
     try {
-      Tuple tuple;
-      RID rid;
-      while (executor->Next(&tuple, &rid)) {
-        if (result_set != nullptr) {
-          result_set->push_back(tuple);
+      if (exec_ctx->IsBatchExecution()) {
+        TupleBatch batch;
+        while (executor->NextBatch(&batch)) {
+          if (result_set != nullptr) {
+            for (uint32_t row : batch.GetSelection()) {
+              result_set->push_back(batch.GetTuple(row, executor->GetOutputSchema()));
+            }
+          }
+        }
+      } else {
+        Tuple tuple;
+        RID rid;
+        while (executor->Next(&tuple, &rid)) {
+          if (result_set != nullptr) {
+            result_set->push_back(tuple);
+          }
         }
       }
     } catch (Exception &e) {
@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <atomic>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -60,6 +61,57 @@ class ExecutorContext {
   /** @return the transaction manager */
   TransactionManager *GetTransactionManager() { return txn_mgr_; }
 
+  /**
+   * Makes sequential scans and inserts go through a BufferRing of ring_size frames, so that one large query does not
+   * flush the rest of the buffer pool.
+   * @param ring_size the number of frames each scan or insert may recycle, 0 (the default) to use the whole pool
+   */
+  void SetBufferRingSize(size_t ring_size) { buffer_ring_size_ = ring_size; }
+
+  /** @return the number of frames each scan or insert may recycle, 0 if buffer rings are off */
+  size_t GetBufferRingSize() const { return buffer_ring_size_; }
+
+  /** @return the number of shared buffer pool evictions that the buffer rings of this context avoided */
+  uint64_t GetNumRingEvictionsAvoided() const { return num_ring_evictions_avoided_; }
+
+  /** Called by executors that used a buffer ring to report the evictions it avoided. */
+  void AddRingEvictionsAvoided(uint64_t num_evictions) { num_ring_evictions_avoided_ += num_evictions; }
+
+  /**
+   * Makes the execution engine pull batches (AbstractExecutor::NextBatch) instead of single tuples from the root of
+   * the plan. Executors with a native batch path then also pull batches from their children.
+   * @param batch_execution true to execute a batch at a time, false (the default) for tuple-at-a-time
+   */
+  void SetBatchExecution(bool batch_execution) { batch_execution_ = batch_execution; }
+
+  /** @return true if plans run a batch at a time */
+  bool IsBatchExecution() const { return batch_execution_; }
+
+  /**
+   * Sets the number of worker threads that parallel executors use. Sequential scans with more than one thread divide
+   * the table into morsels that the workers scan concurrently, and read through the shared buffer pool rather than a
+   * buffer ring; their output order is not the table order.
+   * @param num_threads the number of worker threads, 1 (the default) to run every executor on the calling thread
+   */
+  void SetParallelism(size_t num_threads) { parallelism_ = num_threads; }
+
+  /** @return the number of worker threads that parallel executors use */
+  size_t GetParallelism() const { return parallelism_; }
+
+  /**
+   * Limits the memory that a hash join may use for its hash table, a sort for the rows it holds and an aggregation for
+   * its partial aggregates. A join whose build side outgrows the budget becomes a Grace hash join: it partitions both
+   * inputs into temporary pages in the buffer pool and joins one pair of partitions at a time. Hash joins with a budget
+   * run on the calling thread. A sort that outgrows the budget writes sorted runs to temporary pages and merges them.
+   * An aggregation with a budget runs in two phases and writes the partitions of its partial aggregates to temporary
+   * pages when they outgrow the budget.
+   * @param budget the budget in bytes, 0 (the default) for no limit
+   */
+  void SetMemoryBudget(size_t budget) { memory_budget_ = budget; }
+
+  /** @return the memory budget of a hash join, sort or aggregation in bytes, 0 if there is no limit */
+  size_t GetMemoryBudget() const { return memory_budget_; }
+
  private:
   /** The transaction context associated with this executor context */
   Transaction *transaction_;
@@ -71,6 +123,16 @@ class ExecutorContext {
   TransactionManager *txn_mgr_;
   /** The lock manager associated with this executor context */
   LockManager *lock_mgr_;
+  /** The size of the buffer ring used by scans and inserts, 0 if they use the shared pool */
+  size_t buffer_ring_size_{0};
+  /** The number of evictions avoided by buffer rings */
+  std::atomic<uint64_t> num_ring_evictions_avoided_{0};
+  /** True if plans run a batch at a time */
+  bool batch_execution_{false};
+  /** The number of worker threads of parallel executors */
+  size_t parallelism_{1};
+  /** The memory budget of a hash join, sort or aggregation in bytes, 0 for no limit */
+  size_t memory_budget_{0};
 };
 
 }  // namespace bustub
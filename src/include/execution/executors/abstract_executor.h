@@ -13,6 +13,7 @@
 #pragma once
 
 #include "execution/executor_context.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -20,6 +21,10 @@ namespace bustub {
  * The AbstractExecutor implements the Volcano tuple-at-a-time iterator model.
  * This is the base class from which all executors in the BustTub execution
  * engine inherit, and defines the minimal interface that all executors support.
+ *
+ * Executors may also produce their output a batch at a time through NextBatch(). The default NextBatch() is an
+ * adapter that fills the batch by calling Next(), so a plan can mix executors that implement batches natively with
+ * ones that only implement Next(), and every executor keeps working when pulled tuple-at-a-time.
  */
 class AbstractExecutor {
  public:
@@ -46,6 +51,25 @@ class AbstractExecutor {
    */
   virtual bool Next(Tuple *tuple, RID *rid) = 0;
 
+  /**
+   * Yield the next batch of tuples from this executor. A call either produces at least one selected row or reports
+   * the end of the output; Next() and NextBatch() must not be mixed on one executor.
+   * @param[out] batch The batch to fill, reset by the call; it has the columns of GetOutputSchema()
+   * @return `true` if the batch has selected rows, `false` if there are no more tuples
+   */
+  virtual bool NextBatch(TupleBatch *batch) {
+    // Executors that modify tables have no output schema.
+    const Schema *output_schema = GetOutputSchema();
+    batch->Reset(output_schema == nullptr ? 0 : output_schema->GetColumnCount());
+    Tuple tuple;
+    RID rid;
+    while (!batch->IsFull() && Next(&tuple, &rid)) {
+      batch->AppendTuple(tuple, output_schema);
+      batch->GetMutableRids()->back() = rid;
+    }
+    return batch->GetNumSelected() > 0;
+  }
+
   /** @return The schema of the tuples that this executor produces */
   virtual const Schema *GetOutputSchema() = 0;
 
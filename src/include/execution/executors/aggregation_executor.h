@@ -12,13 +12,20 @@
 
 #pragma once
 
+#include <atomic>
+#include <exception>
 #include <memory>
+#include <mutex>  // NOLINT
+#include <thread>  // NOLINT
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "common/util/hash_util.h"
 #include "container/hash/hash_function.h"
+#include "execution/aggregate_state.h"
+#include "execution/compiled_predicate.h"
+#include "execution/exchange.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/expressions/abstract_expression.h"
@@ -40,85 +47,73 @@ class SimpleAggregationHashTable {
    */
   SimpleAggregationHashTable(const std::vector<const AbstractExpression *> &agg_exprs,
                              const std::vector<AggregationType> &agg_types)
-      : agg_exprs_{agg_exprs}, agg_types_{agg_types} {}
-
-  /** @return The initial aggregrate value for this aggregation executor */
-  AggregateValue GenerateInitialAggregateValue() {
-    std::vector<Value> values{};
-    for (const auto &agg_type : agg_types_) {
-      switch (agg_type) {
-        case AggregationType::CountAggregate:
-          // Count starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum starts at zero.
-          values.emplace_back(ValueFactory::GetIntegerValue(0));
-          break;
-        case AggregationType::MinAggregate:
-          // Min starts at INT_MAX.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MAX));
-          break;
-        case AggregationType::MaxAggregate:
-          // Max starts at INT_MIN.
-          values.emplace_back(ValueFactory::GetIntegerValue(BUSTUB_INT32_MIN));
-          break;
-      }
-    }
-    return {values};
+      : aggregator_{agg_exprs, agg_types} {}
+
+  /** @return the aggregator that accumulates the rows of a group into its state */
+  const Aggregator &GetAggregator() const { return aggregator_; }
+
+  /**
+   * Inserts a value into the hash table and then combines it with the current aggregation.
+   * @param agg_key the key to be inserted
+   * @param agg_val the value to be inserted
+   */
+  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
+    aggregator_.Combine(FindOrInsert(agg_key), agg_val.aggregates_);
+  }
+
+  /**
+   * Inserts a row of a batch into the hash table and then combines it with the current aggregation.
+   * @param agg_key the key of the row
+   * @param agg_columns the aggregate input expressions evaluated over the batch
+   * @param row the row of the batch
+   */
+  void InsertCombine(const AggregateKey &agg_key, const std::vector<std::vector<Value>> &agg_columns, uint32_t row) {
+    aggregator_.Combine(FindOrInsert(agg_key), agg_columns, row);
   }
 
   /**
-   * Combines the input into the aggregation result.
-   * @param[out] result The output aggregate value
-   * @param input The input value
+   * Merges the state of a group over some of the rows into the hash table.
+   * @param agg_key the key of the group
+   * @param partial the state of the group
+   * @return the estimated number of bytes the table grew by
    */
-  void CombineAggregateValues(AggregateValue *result, const AggregateValue &input) {
-    for (uint32_t i = 0; i < agg_exprs_.size(); i++) {
-      switch (agg_types_[i]) {
-        case AggregationType::CountAggregate:
-          // Count increases by one.
-          result->aggregates_[i] = result->aggregates_[i].Add(ValueFactory::GetIntegerValue(1));
-          break;
-        case AggregationType::SumAggregate:
-          // Sum increases by addition.
-          result->aggregates_[i] = result->aggregates_[i].Add(input.aggregates_[i]);
-          break;
-        case AggregationType::MinAggregate:
-          // Min is just the min.
-          result->aggregates_[i] = result->aggregates_[i].Min(input.aggregates_[i]);
-          break;
-        case AggregationType::MaxAggregate:
-          // Max is just the max.
-          result->aggregates_[i] = result->aggregates_[i].Max(input.aggregates_[i]);
-          break;
-      }
+  size_t MergeInsert(AggregateKey &&agg_key, AggregateState &&partial) {
+    auto iter = ht_.find(agg_key);
+    if (iter == ht_.end()) {
+      // A node of the table holds the key, the state and the link to the next node.
+      size_t footprint = sizeof(AggregateKey) + agg_key.group_bys_.size() * sizeof(Value) +
+                         aggregator_.GetFootprint(partial) + sizeof(void *);
+      ht_.emplace(std::move(agg_key), std::move(partial));
+      return footprint;
     }
+    size_t footprint = aggregator_.GetFootprint(iter->second);
+    aggregator_.Merge(&iter->second, &partial);
+    return aggregator_.GetFootprint(iter->second) - footprint;
   }
 
   /**
-   * Inserts a value into the hash table and then combines it with the current aggregation.
-   * @param agg_key the key to be inserted
-   * @param agg_val the value to be inserted
+   * Removes every group, handing its key and state over.
+   * @param fn called with the key and the state of every group, which it may move from
    */
-  void InsertCombine(const AggregateKey &agg_key, const AggregateValue &agg_val) {
-    if (ht_.count(agg_key) == 0) {
-      ht_.insert({agg_key, GenerateInitialAggregateValue()});
+  template <typename Fn>
+  void Drain(Fn &&fn) {
+    while (!ht_.empty()) {
+      auto node = ht_.extract(ht_.begin());
+      fn(std::move(node.key()), std::move(node.mapped()));
     }
-    CombineAggregateValues(&ht_[agg_key], agg_val);
   }
 
   /** An iterator over the aggregation hash table */
   class Iterator {
    public:
     /** Creates an iterator for the aggregate map. */
-    explicit Iterator(std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter) : iter_{iter} {}
+    explicit Iterator(std::unordered_map<AggregateKey, AggregateState>::const_iterator iter) : iter_{iter} {}
 
     /** @return The key of the iterator */
     const AggregateKey &Key() { return iter_->first; }
 
-    /** @return The value of the iterator */
-    const AggregateValue &Val() { return iter_->second; }
+    /** @return The state of the aggregates of the group, which Aggregator::Finalize() turns into values */
+    const AggregateState &Val() { return iter_->second; }
 
     /** @return The iterator before it is incremented */
     Iterator &operator++() {
@@ -134,9 +129,15 @@ class SimpleAggregationHashTable {
 
    private:
     /** Aggregates map */
-    std::unordered_map<AggregateKey, AggregateValue>::const_iterator iter_;
+    std::unordered_map<AggregateKey, AggregateState>::const_iterator iter_;
   };
 
+  /** Removes all groups. */
+  void Clear() { ht_.clear(); }
+
+  /** @return the number of groups */
+  size_t Size() const { return ht_.size(); }
+
   /** @return Iterator to the start of the hash table */
   Iterator Begin() { return Iterator{ht_.cbegin()}; }
 
@@ -144,17 +145,35 @@ class SimpleAggregationHashTable {
   Iterator End() { return Iterator{ht_.cend()}; }
 
  private:
-  /** The hash table is just a map from aggregate keys to aggregate values */
-  std::unordered_map<AggregateKey, AggregateValue> ht_{};
-  /** The aggregate expressions that we have */
-  const std::vector<const AbstractExpression *> &agg_exprs_;
-  /** The types of aggregations that we have */
-  const std::vector<AggregationType> &agg_types_;
+  /** @return the state of a group, which is added to the table without rows if it is new */
+  AggregateState *FindOrInsert(const AggregateKey &agg_key) {
+    auto iter = ht_.find(agg_key);
+    if (iter == ht_.end()) {
+      iter = ht_.emplace(agg_key, AggregateState{}).first;
+      aggregator_.Init(&iter->second);
+    }
+    return &iter->second;
+  }
+
+  /** The hash table is just a map from aggregate keys to the state of their aggregates */
+  std::unordered_map<AggregateKey, AggregateState> ht_{};
+  /** Accumulates the aggregates of the plan */
+  Aggregator aggregator_;
 };
 
 /**
  * AggregationExecutor executes an aggregation operation (e.g. COUNT, SUM, MIN, MAX)
  * over the tuples produced by a child executor.
+ *
+ * With a parallelism above one, or with a memory budget, the aggregation runs in two phases. In the first phase, the
+ * calling thread feeds the child's batches to worker threads that each pre-aggregate into a small direct-mapped table
+ * of up to AGGREGATION_PREAGG_SLOTS groups, which stays in the cache and absorbs the rows of frequent groups. A group
+ * that is evicted from it is appended as a partial aggregate to one of AGGREGATION_PARTITIONS partitions of the
+ * worker, chosen by the hash of the group. When the table and the partitions of a worker outgrow its share of the
+ * memory budget, the partitions are written to temporary pages. In the second phase, the workers claim partitions,
+ * merge the partial aggregates of every worker for their partition into a hash table, and hand the groups to the
+ * consumer through an exchange. A partition whose hash table still outgrows the budget is split again with the next
+ * bits of the hash, like a partition of a spilled hash join, and its parts are merged one after the other.
  */
 class AggregationExecutor : public AbstractExecutor {
  public:
@@ -167,6 +186,9 @@ class AggregationExecutor : public AbstractExecutor {
   AggregationExecutor(ExecutorContext *exec_ctx, const AggregationPlanNode *plan,
                       std::unique_ptr<AbstractExecutor> &&child);
 
+  /** Stops the workers of a parallel aggregation and deletes its temporary pages. */
+  ~AggregationExecutor() override;
+
   /** Initialize the aggregation */
   void Init() override;
 
@@ -178,13 +200,71 @@ class AggregationExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch of groups from the aggregation.
+   * @param[out] batch The next batch produced by the aggregation
+   * @return `true` if the batch has selected rows, `false` if there are no more groups
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the aggregation */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
   /** Do not use or remove this function, otherwise you will get zero points. */
   const AbstractExecutor *GetChildExecutor() const;
 
+  /** @return the number of temporary pages that the last parallel aggregation wrote its partitions to */
+  size_t GetNumSpilledPages() const { return num_spilled_pages_; }
+
+  /** @return the number of times the last parallel aggregation split a partition that outgrew the budget */
+  size_t GetNumSplitPartitions() const { return num_split_partitions_; }
+
  private:
+  /** The partial aggregate of a group over some of the input rows. */
+  struct PartialAggregate {
+    /** The hash of the group, mixed so that every bit depends on the whole key */
+    hash_t hash_;
+    /** The group */
+    AggregateKey key_;
+    /** The state of the aggregates of the group over the rows seen so far */
+    AggregateState state_;
+  };
+
+  /** The state of a worker of a parallel aggregation. */
+  struct PreAggregation {
+    /** The direct-mapped pre-aggregation table, indexed by the hash of the group modulo its size */
+    std::vector<PartialAggregate> slots_;
+    /** Whether each slot holds a group */
+    std::vector<bool> occupied_;
+    /** The partial aggregates evicted from the table, by partition */
+    std::vector<std::vector<PartialAggregate>> partitions_;
+    /** The temporary pages that the partial aggregates of each partition were written to */
+    std::vector<std::vector<page_id_t>> spilled_pages_;
+    /** The estimated size of the pre-aggregation table, with the groups in it, and of the partitions */
+    size_t buffered_bytes_{0};
+  };
+
+  /** The state of a worker of the second phase while it merges a partition, or a part of a split partition. */
+  struct PartitionMerge {
+    explicit PartitionMerge(const AggregationPlanNode *plan)
+        : table_(plan->GetAggregates(), plan->GetAggregateTypes()) {}
+
+    /** The groups merged so far */
+    SimpleAggregationHashTable table_;
+    /** The estimated size of table_ */
+    size_t table_bytes_{0};
+    /** How many times the partial aggregates being merged were split; the next split uses the hash bits above */
+    uint32_t level_{0};
+    /** Once table_ outgrew the budget, the partial aggregates being merged are split into these parts instead */
+    std::vector<std::vector<PartialAggregate>> parts_;
+    /** The temporary pages that the partial aggregates of each part were written to */
+    std::vector<std::vector<page_id_t>> part_pages_;
+    /** The estimated size of the partial aggregates in parts_ */
+    size_t parts_bytes_{0};
+    /** The parts of split partitions that are left to merge, with their level */
+    std::vector<std::pair<uint32_t, std::vector<page_id_t>>> pending_;
+  };
+
   /** @return The tuple as an AggregateKey */
   AggregateKey MakeAggregateKey(const Tuple *tuple) {
     std::vector<Value> keys;
@@ -194,6 +274,76 @@ class AggregationExecutor : public AbstractExecutor {
     return {keys};
   }
 
+  /** Builds the hash table from the child's tuples, a batch at a time if the context runs batches. */
+  void BuildHashTable();
+
+  /**
+   * Runs the first phase of a parallel aggregation: feeds the child's batches to the workers, which pre-aggregate
+   * them, and waits for the workers to finish.
+   */
+  void PreAggregateParallel(size_t num_threads);
+
+  /**
+   * The loop of a worker of the first phase.
+   * @param state the state of the worker
+   * @param input the exchange that carries the child's batches
+   */
+  void PreAggregate(PreAggregation *state, Exchange *input);
+
+  /** Moves a partial aggregate out of the pre-aggregation table of a worker into its partition. */
+  void Evict(PreAggregation *state, PartialAggregate *partial);
+
+  /** Writes partitions to temporary pages until the worker is within its budget, evicting the table if need be. */
+  void ReleaseMemory(PreAggregation *state);
+
+  /**
+   * Writes the partial aggregates of some partitions to temporary pages, one pinned page at a time.
+   * @param partitions the partial aggregates, by partition; emptied
+   * @param pages the temporary pages of each partition, which the new pages are appended to
+   * @return the estimated size of the partial aggregates written
+   */
+  size_t SpillPartitions(std::vector<std::vector<PartialAggregate>> *partitions,
+                         std::vector<std::vector<page_id_t>> *pages);
+
+  /** The loop of a worker of the second phase: merges claimed partitions and hands their groups on. */
+  void MergePartitions();
+
+  /** Merges the partial aggregate of a group into the partition being merged; splits it if it outgrows the budget. */
+  void MergePartial(AggregateKey &&key, AggregateState &&state, PartitionMerge *merge);
+
+  /** Adds the partial aggregate of a group to its part of the partition being split. */
+  void AddToPart(AggregateKey &&key, AggregateState &&state, PartitionMerge *merge);
+
+  /**
+   * Finishes the partition being merged: hands its groups on, or queues its parts if it was split.
+   * @return false if the consumer closed the exchange
+   */
+  bool FinishMerge(PartitionMerge *merge, TupleBatch *batch);
+
+  /** Deletes the temporary pages of the parts that a worker of the second phase did not merge. */
+  void DropParts(PartitionMerge *merge);
+
+  /** @return the estimated memory footprint of a partial aggregate */
+  size_t GetFootprint(const PartialAggregate &partial) const;
+
+  /** Reads the partial aggregates back from a temporary page into the partition being merged, and deletes the page. */
+  void MergeSpilledPage(page_id_t page_id, PartitionMerge *merge);
+
+  /** Keeps the first exception that a worker throws, for the consumer to rethrow. */
+  void SetWorkerError(std::exception_ptr error);
+
+  /** Rethrows the exception of a failed worker, if any. */
+  void CheckWorkerError();
+
+  /** Stops the workers of the second phase. */
+  void StopWorkers();
+
+  /** Deletes the temporary pages that no worker has read back. */
+  void DropSpilledPages();
+
+  /** @return the next group that satisfies the HAVING clause, or false if there is none left */
+  bool NextGroup(const AggregateKey **key, const AggregateValue **val);
+
   /** @return The tuple as an AggregateValue */
   AggregateValue MakeAggregateValue(const Tuple *tuple) {
     std::vector<Value> vals;
@@ -209,8 +359,30 @@ class AggregationExecutor : public AbstractExecutor {
   /** The child executor that produces tuples over which the aggregation is computed */
   std::unique_ptr<AbstractExecutor> child_;
   /** Simple aggregation hash table */
-  // TODO(Student): Uncomment SimpleAggregationHashTable aht_;
+  SimpleAggregationHashTable aht_;
   /** Simple aggregation hash table iterator */
-  // TODO(Student): Uncomment SimpleAggregationHashTable::Iterator aht_iterator_;
+  SimpleAggregationHashTable::Iterator aht_iterator_;
+  /** The HAVING clause of the plan, compiled */
+  CompiledPredicate having_;
+  /** The values of the aggregates of the group that NextGroup() returned last */
+  AggregateValue group_val_;
+  /** The state of every worker of a parallel aggregation */
+  std::vector<PreAggregation> pre_aggregations_;
+  /** The share of the memory budget of every worker in bytes, 0 for no limit */
+  size_t worker_budget_{0};
+  /** The next partition that no worker of the second phase has claimed */
+  std::atomic<size_t> next_partition_{0};
+  /** The number of temporary pages written by the workers */
+  std::atomic<size_t> num_spilled_pages_{0};
+  /** The number of partitions that the workers of the second phase split */
+  std::atomic<size_t> num_split_partitions_{0};
+  /** Carries the groups of the workers of the second phase to the consumer */
+  std::unique_ptr<Exchange> exchange_;
+  /** The workers of the second phase */
+  std::vector<std::thread> workers_;
+  /** Protects worker_error_ */
+  std::mutex worker_error_latch_;
+  /** The first exception that a worker threw */
+  std::exception_ptr worker_error_;
 };
 }  // namespace bustub
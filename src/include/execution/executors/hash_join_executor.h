@@ -12,18 +12,67 @@
 
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <thread>  // NOLINT
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
+#include "common/util/hash_util.h"
+#include "execution/exchange.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/expressions/abstract_expression.h"
 #include "execution/plans/hash_join_plan.h"
+#include "storage/page/tmp_tuple_page.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
+/** HashJoinKey represents the value of a join key in the join hash table */
+struct HashJoinKey {
+  /** The join key */
+  Value key_;
+
+  /**
+   * Compares two join keys for equality.
+   * @param other the other join key to be compared with
+   * @return `true` if both join keys are equal, `false` otherwise
+   */
+  bool operator==(const HashJoinKey &other) const { return key_.CompareEquals(other.key_) == CmpBool::CmpTrue; }
+};
+
+}  // namespace bustub
+
+namespace std {
+
+/** Implements std::hash on HashJoinKey */
+template <>
+struct hash<bustub::HashJoinKey> {
+  std::size_t operator()(const bustub::HashJoinKey &join_key) const {
+    return bustub::HashUtil::HashValue(&join_key.key_);
+  }
+};
+
+}  // namespace std
+
+namespace bustub {
+
 /**
- * HashJoinExecutor executes a nested-loop JOIN on two tables.
+ * HashJoinExecutor executes an equi-JOIN on two tables. Init() builds a hash table over the left child, keyed by the
+ * left join key; the right child then probes it. Rows with a NULL join key never match.
+ *
+ * If the hash table outgrows the memory budget of the executor context, the join spills: both inputs are split into
+ * HASH_JOIN_SPILL_FANOUT partitions by join key hash and written to TmpTuplePages in the buffer pool, and every pair of
+ * partitions is then joined like a small join of its own. A partition whose left rows still exceed the budget is split
+ * again with the next bits of the hash.
+ *
+ * When the executor context asks for more than one thread, the join is a parallel radix join instead. Init()
+ * materializes both children and partitions them by the low bits of the join key hash, so that the left rows of each
+ * partition fit in the cache. Worker threads then claim partitions, build a hash table over the left rows of a
+ * partition in flat arrays, probe it with the right rows of the same partition and push the joined rows into an
+ * Exchange that Next() and NextBatch() read from.
  */
 class HashJoinExecutor : public AbstractExecutor {
  public:
@@ -48,12 +97,165 @@ class HashJoinExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch from the join. Probes the hash table with a batch of right tuples, collects the matching
+   * pairs and evaluates the output schema over all of them at once.
+   * @param[out] batch The next batch produced by the join
+   * @return `true` if the batch has selected rows, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the join */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
+  /** Stops the workers of a radix join, if any. */
+  ~HashJoinExecutor() override;
+
  private:
-  /** The NestedLoopJoin plan node to be executed. */
+  /** One partition of both inputs of a spilled join, stored in temporary pages. */
+  struct SpillPartition {
+    /** The pages that hold the left rows */
+    std::vector<page_id_t> build_pages_;
+    /** The pages that hold the right rows */
+    std::vector<page_id_t> probe_pages_;
+    /** How many times the rows of this partition have been split; selects the hash bits of the next split */
+    uint32_t level_{0};
+  };
+
+  /** One side of a radix join: the rows of a child, and their join keys grouped by partition. */
+  struct PartitionedInput {
+    /** The values of the rows, column by column */
+    std::vector<std::vector<Value>> columns_;
+    /** The join key of every row */
+    std::vector<Value> keys_;
+    /** The hash of the join key of every row */
+    std::vector<hash_t> hashes_;
+    /** The (hash, row) pairs of all rows, grouped by partition */
+    std::vector<std::pair<hash_t, uint32_t>> entries_;
+    /** The entries of partition p are [offsets_[p], offsets_[p + 1]) */
+    std::vector<size_t> offsets_;
+  };
+
+  /** Reads every row with a non-NULL join key from child into input. */
+  void Materialize(AbstractExecutor *child, const AbstractExpression *key_expr, PartitionedInput *input);
+
+  /** Groups the rows of input by partition, with one histogram and scatter pass per worker. */
+  void Partition(PartitionedInput *input, size_t num_threads);
+
+  /** The body of a worker of a radix join: builds and probes partitions until there are none left. */
+  void JoinPartitions();
+
+  /** Stops and joins the workers of a radix join, if any. */
+  void StopWorkers();
+
+  /** Adds a left tuple to the hash table. */
+  void InsertBuildTuple(const Tuple &tuple, const Value &key);
+
+  /** Adds a left tuple to the hash table, or to its partition once the join has spilled. */
+  void AddBuildTuple(const Tuple &tuple, const Value &key);
+
+  /** Empties the hash table. */
+  void ClearHashTable();
+
+  /** @return true if the hash table exceeds the memory budget */
+  bool IsOverBudget() const;
+
+  /** Starts splitting rows into HASH_JOIN_SPILL_FANOUT new partitions of the given level. */
+  void BeginSpill(uint32_t level);
+
+  /** Moves the rows of the hash table into the partitions being written. */
+  void SpillHashTable();
+
+  /** Writes a row to the partition of its join key; rows with a NULL key are dropped. */
+  void SpillTuple(const Tuple &tuple, const Value &key, bool build_side);
+
+  /** Unpins the pages that the partitions being written append to. */
+  void FinishSpillSide();
+
+  /** Unpins the pages being written and queues the new partitions for joining. */
+  void FinishSpill();
+
+  /** Reads the tuples of a temporary page and deletes the page. */
+  void ReadSpilledPage(page_id_t page_id, std::vector<Tuple> *tuples);
+
+  /** Deletes the temporary pages that have not been read, e.g. when the consumer stops early. */
+  void DropSpilledPages();
+
+  /**
+   * Loads the left rows of the next pending partition into the hash table, splitting partitions that do not fit.
+   * @return false if every partition has been joined
+   */
+  bool LoadNextPartition();
+
+  /** Reads the next right tuple, from the right child or from the spilled partitions. */
+  bool NextProbeTuple(Tuple *tuple);
+
+  /** Reads the next batch of right tuples, from the right child or from the spilled partitions. */
+  bool NextProbeBatch(TupleBatch *batch);
+
+  /** @return the indexes into build_tuples_ of the left tuples that match key, nullptr if there are none */
+  const std::vector<uint32_t> *FindMatches(const Value &key) const;
+
+  /** The HashJoin plan node to be executed. */
   const HashJoinPlanNode *plan_;
+  /** The child executor that produces the build side */
+  std::unique_ptr<AbstractExecutor> left_child_;
+  /** The child executor that produces the probe side */
+  std::unique_ptr<AbstractExecutor> right_child_;
+  /** The left tuples */
+  std::vector<Tuple> build_tuples_;
+  /** Maps each left join key to its tuples */
+  std::unordered_map<HashJoinKey, std::vector<uint32_t>> hash_table_;
+  /** The estimated memory used by the hash table in bytes */
+  size_t build_bytes_{0};
+  /** The left tuples that match the current right tuple, nullptr if it has none */
+  const std::vector<uint32_t> *matches_{nullptr};
+  /** The next entry of matches_ to join */
+  size_t match_idx_{0};
+
+  /** The current right tuple, for Next() */
+  Tuple right_tuple_;
+
+  /** The current batch of right tuples, for NextBatch() */
+  TupleBatch right_batch_;
+  /** The join key of every row of right_batch_ */
+  std::vector<Value> right_keys_;
+  /** The position in the selection vector of right_batch_ of the row being probed */
+  uint32_t probe_idx_{0};
+  /** True once the right child is exhausted */
+  bool right_done_{false};
+  /** The left halves of the joined pairs of the batch being produced */
+  TupleBatch left_rows_;
+  /** The right halves of the joined pairs of the batch being produced */
+  TupleBatch right_rows_;
+
+  /** True if the join spilled; the right rows then come from the partitions */
+  bool spilled_{false};
+  /** The partitions that have yet to be joined */
+  std::vector<SpillPartition> pending_partitions_;
+  /** The partitions being written */
+  std::vector<SpillPartition> spill_partitions_;
+  /** The pinned page that each partition being written appends to, nullptr if it has none */
+  std::vector<TmpTuplePage *> spill_pages_;
+  /** The right pages of the partition being joined that have not been read */
+  std::vector<page_id_t> probe_pages_;
+  /** The right tuples of the last page read */
+  std::vector<Tuple> probe_tuples_;
+  /** The next entry of probe_tuples_ to probe with */
+  size_t probe_tuple_idx_{0};
+
+  /** The left rows of a radix join */
+  PartitionedInput build_input_;
+  /** The right rows of a radix join */
+  PartitionedInput probe_input_;
+  /** The number of hash bits that select the partition */
+  uint32_t radix_bits_{0};
+  /** The next partition that no worker has claimed */
+  std::atomic<size_t> next_partition_{0};
+  /** Carries the output of the workers of a radix join to the consumer */
+  std::unique_ptr<Exchange> exchange_;
+  /** The workers of a radix join */
+  std::vector<std::thread> workers_;
 };
 
 }  // namespace bustub
@@ -14,7 +14,9 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
+#include "buffer/buffer_ring.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/insert_plan.h"
@@ -39,6 +41,9 @@ class InsertExecutor : public AbstractExecutor {
   InsertExecutor(ExecutorContext *exec_ctx, const InsertPlanNode *plan,
                  std::unique_ptr<AbstractExecutor> &&child_executor);
 
+  /** Reports the evictions avoided by the buffer ring, if any, to the executor context. */
+  ~InsertExecutor() override;
+
   /** Initialize the insert */
   void Init() override;
 
@@ -57,8 +62,35 @@ class InsertExecutor : public AbstractExecutor {
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
 
  private:
+  /** Inserts one tuple into the table and all of its indexes. */
+  void InsertTuple(const Tuple &tuple);
+
+  /** Inserts tuples into the table page by page, then into all of its indexes. */
+  void InsertTuples(const std::vector<Tuple> &tuples);
+
+  /** @return the heap the insert writes to */
+  TableHeap *GetTableHeap() { return ring_table_heap_ != nullptr ? ring_table_heap_.get() : table_info_->table_.get(); }
+
+  /** Points the last num_records write records, written through the ring view, at the catalog's heap. */
+  void FixWriteRecords(size_t num_records);
+
+  /** Adds the entries of the tuple at rid to all indexes of the table. */
+  void InsertIndexEntries(const Tuple &tuple, const RID &rid);
+
   /** The insert plan node to be executed*/
   const InsertPlanNode *plan_;
+  /** The child executor producing the tuples to insert, nullptr for a raw insert */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The table to insert into */
+  TableInfo *table_info_;
+  /** The indexes of the table */
+  std::vector<IndexInfo *> indexes_;
+  /** The buffer ring the insert goes through, nullptr if it uses the shared pool */
+  std::unique_ptr<BufferRing> buffer_ring_;
+  /** A view of the table heap that writes through the buffer ring */
+  std::unique_ptr<TableHeap> ring_table_heap_;
+  /** True once all tuples have been inserted */
+  bool done_{false};
 };
 
 }  // namespace bustub
@@ -53,5 +53,7 @@ class LimitExecutor : public AbstractExecutor {
   const LimitPlanNode *plan_;
   /** The child executor from which tuples are obtained */
   std::unique_ptr<AbstractExecutor> child_executor_;
+  /** The number of tuples returned so far */
+  size_t num_emitted_{0};
 };
 }  // namespace bustub
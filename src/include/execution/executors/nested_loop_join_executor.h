@@ -15,6 +15,7 @@
 #include <memory>
 #include <utility>
 
+#include "execution/compiled_predicate.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
 #include "execution/plans/nested_loop_join_plan.h"
@@ -23,7 +24,9 @@
 namespace bustub {
 
 /**
- * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables.
+ * NestedLoopJoinExecutor executes a nested-loop JOIN on two tables. For every tuple of the left (outer) child, it
+ * re-initializes and scans the right (inner) child, evaluating the join predicate, compiled against the output schemas
+ * of both children, on every pair.
  */
 class NestedLoopJoinExecutor : public AbstractExecutor {
  public:
@@ -55,6 +58,16 @@ class NestedLoopJoinExecutor : public AbstractExecutor {
  private:
   /** The NestedLoopJoin plan node to be executed. */
   const NestedLoopJoinPlanNode *plan_;
+  /** The child executor of the outer side */
+  std::unique_ptr<AbstractExecutor> left_executor_;
+  /** The child executor of the inner side */
+  std::unique_ptr<AbstractExecutor> right_executor_;
+  /** The join predicate, compiled */
+  CompiledPredicate predicate_;
+  /** The current tuple of the outer side */
+  Tuple left_tuple_;
+  /** False once the outer side is exhausted */
+  bool has_left_tuple_{false};
 };
 
 }  // namespace bustub
@@ -12,17 +12,40 @@
 
 #pragma once
 
+#include <memory>
+#include <thread>  // NOLINT
+#include <utility>
 #include <vector>
 
+#include "buffer/buffer_ring.h"
+#include "buffer/read_ahead.h"
+#include "execution/column_filter.h"
+#include "execution/compiled_predicate.h"
+#include "execution/exchange.h"
 #include "execution/executor_context.h"
 #include "execution/executors/abstract_executor.h"
+#include "execution/morsel_queue.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "storage/page/table_page_guard.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
 /**
  * The SeqScanExecutor executor executes a sequential table scan.
+ *
+ * When the executor context asks for more than one thread, Init() starts that many workers. They claim morsels of
+ * pages from a MorselQueue, filter and project them a batch at a time, and push the batches into an Exchange from
+ * which Next() and NextBatch() read.
+ *
+ * The predicate is compiled against the table schema when the executor is created. If it compiles to a specialized
+ * closure, rows are filtered on the tuple bytes before any of their columns are decoded. If it compares a fixed-width
+ * column with a constant, the scan reads the table a page at a time through a ColumnFilter, which evaluates the
+ * predicate on the page in place, and copies only the tuples that satisfy it.
+ *
+ * Table tuples are never copied: the scan reads each page through a TablePageGuard and evaluates the predicate and the
+ * projection on TupleViews of the page. No guard is held between calls, so the consumer may write to the table.
  */
 class SeqScanExecutor : public AbstractExecutor {
  public:
@@ -33,6 +56,9 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   SeqScanExecutor(ExecutorContext *exec_ctx, const SeqScanPlanNode *plan);
 
+  /** Stops the workers of a parallel scan and reports the evictions avoided by the buffer ring, if any. */
+  ~SeqScanExecutor() override;
+
   /** Initialize the sequential scan */
   void Init() override;
 
@@ -44,11 +70,102 @@ class SeqScanExecutor : public AbstractExecutor {
    */
   bool Next(Tuple *tuple, RID *rid) override;
 
+  /**
+   * Yield the next batch from the sequential scan. The scan reads up to a batch of tuples, decoding only the columns
+   * that the predicate and the output schema refer to, narrows the selection vector with the predicate and projects
+   * the selected rows onto the output schema.
+   * @param[out] batch The next batch produced by the scan
+   * @return `true` if the batch has selected rows, `false` if there are no more tuples
+   */
+  bool NextBatch(TupleBatch *batch) override;
+
   /** @return The output schema for the sequential scan */
   const Schema *GetOutputSchema() override { return plan_->OutputSchema(); }
 
  private:
+  /**
+   * Appends the columns of a table tuple that the scan refers to as a new row of table_batch, unless a specialized
+   * predicate rejects the tuple.
+   */
+  void AppendTableTuple(const Tuple &tuple, TupleBatch *table_batch) const;
+
+  /**
+   * Applies the predicate to the selected rows of table_batch, unless AppendTableTuple() already did, and projects the
+   * remaining rows onto the output schema. Columns that are passed on unchanged move from table_batch to batch.
+   * @param table_batch rows with the table schema, narrowed by the predicate; its rows are consumed
+   * @param predicate_result scratch space for the predicate
+   * @param[out] batch the projected rows
+   * @return true if any row satisfied the predicate
+   */
+  bool FilterAndProject(TupleBatch *table_batch, std::vector<Value> *predicate_result, TupleBatch *batch) const;
+
+  /**
+   * Reads the tuples of one page that may satisfy the predicate in place: those that column_filter_ selects, or all
+   * of them if the scan has no column filter.
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t ReadPage(TableHeap *table_heap, page_id_t page_id, TablePageGuard *guard,
+                     std::vector<TupleView> *views) const;
+
+  /**
+   * Appends the rows of one page, from a slot on, to table_batch until it is full. The page is released on return.
+   * @param[in,out] slot the first slot to append; on a full batch, the first slot that was not appended
+   * @param[out] next_page_id the id of the next page of the table
+   * @param views scratch space for the views of the page
+   * @return true if the rest of the page was appended, false if the batch filled up first
+   */
+  bool AppendPage(TableHeap *table_heap, page_id_t page_id, uint32_t *slot, TupleBatch *table_batch,
+                  page_id_t *next_page_id, std::vector<TupleView> *views) const;
+
+  /** The body of a worker of a parallel scan. */
+  void ScanMorsels();
+
+  /** Stops and joins the workers of a parallel scan, if any. */
+  void StopWorkers();
+
   /** The sequential scan plan node to be executed */
   const SeqScanPlanNode *plan_;
+  /** The table being scanned */
+  TableInfo *table_info_;
+  /** The predicate of the plan, compiled against the table schema */
+  CompiledPredicate predicate_;
+  /** Evaluates the predicate on whole pages, nullptr unless it compares a fixed-width column with a constant */
+  std::unique_ptr<ColumnFilter> column_filter_;
+  /** The buffer ring the scan goes through, nullptr if it uses the shared pool */
+  std::unique_ptr<BufferRing> buffer_ring_;
+  /** A view of the table heap that reads through the buffer ring */
+  std::unique_ptr<TableHeap> ring_table_heap_;
+  /** The table heap that a serial scan reads from */
+  TableHeap *scan_table_heap_{nullptr};
+  /** Prefetches the pages ahead of a serial scan */
+  std::unique_ptr<ReadAhead> read_ahead_;
+  /** The page that a serial scan reads next, INVALID_PAGE_ID after the last page */
+  page_id_t scan_page_id_{INVALID_PAGE_ID};
+  /** The first slot of scan_page_id_ that NextBatch() has not read yet */
+  uint32_t scan_slot_{0};
+  /** The views of the page being read */
+  std::vector<TupleView> page_views_;
+  /** The projected tuples of the last page that Next() read */
+  std::vector<Tuple> output_tuples_;
+  /** The rids of output_tuples_ */
+  std::vector<RID> output_rids_;
+  /** The position of Next() in output_tuples_ */
+  size_t output_idx_{0};
+  /** The table columns that the predicate or the output schema refer to */
+  std::vector<uint32_t> referenced_columns_;
+  /** The output columns that FilterAndProject() evaluates */
+  std::vector<uint32_t> evaluated_columns_;
+  /** The output columns that FilterAndProject() takes over from a table column, as (output, table) column indexes */
+  std::vector<std::pair<uint32_t, uint32_t>> moved_columns_;
+  /** The rows read from the table by NextBatch(), with the table schema */
+  TupleBatch table_batch_;
+  /** The predicate result of every row of table_batch_ */
+  std::vector<Value> predicate_result_;
+  /** Hands out the pages of the table to the workers of a parallel scan */
+  std::unique_ptr<MorselQueue> morsels_;
+  /** Carries the output of the workers of a parallel scan to the consumer */
+  std::unique_ptr<Exchange> exchange_;
+  /** The workers of a parallel scan */
+  std::vector<std::thread> workers_;
 };
 }  // namespace bustub
@@ -0,0 +1,151 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_executor.h
+//
+// Identification: src/include/execution/executors/sort_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/plans/sort_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** SortKeyComparator orders the sort keys of tuples, as computed by MakeKey(), by a list of ORDER BY keys. */
+class SortKeyComparator {
+ public:
+  /**
+   * Creates a comparator.
+   * @param order_bys the ORDER BY keys, which must outlive the comparator
+   */
+  explicit SortKeyComparator(const std::vector<OrderBy> *order_bys) : order_bys_(order_bys) {}
+
+  /**
+   * Evaluates the ORDER BY keys over a tuple.
+   * @param tuple the tuple
+   * @param schema the schema of the tuple
+   * @return the sort key of the tuple
+   */
+  std::vector<Value> MakeKey(const Tuple &tuple, const Schema *schema) const;
+
+  /** @return true if sort key a orders before sort key b */
+  bool operator()(const std::vector<Value> &a, const std::vector<Value> &b) const;
+
+ private:
+  /** The ORDER BY keys */
+  const std::vector<OrderBy> *order_bys_;
+};
+
+/**
+ * @return an estimate of the memory that a sorting executor uses to hold a tuple and its sort key, in bytes
+ */
+size_t SortRowFootprint(const Tuple &tuple, const std::vector<Value> &key);
+
+/**
+ * SortExecutor orders the output of its child. Init() reads the child; rows are sorted in memory while they fit in the
+ * memory budget of the executor context. Otherwise every budget-full of rows is sorted into a run and written to
+ * TmpTuplePages in the buffer pool, and Next() merges the runs, with the rows left in memory as the last run, through
+ * a heap of the current row of each run.
+ */
+class SortExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new SortExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The sort plan to be executed
+   * @param child_executor The child executor from which tuples are pulled
+   */
+  SortExecutor(ExecutorContext *exec_ctx, const SortPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Deletes the runs that were not merged. */
+  ~SortExecutor() override;
+
+  /** Initialize the sort: reads and sorts the output of the child. */
+  void Init() override;
+
+  /**
+   * Yield the next tuple in sort order.
+   * @param[out] tuple The next tuple produced by the sort
+   * @param[out] rid The next tuple RID produced by the sort
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the sort */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** @return the number of runs written to temporary pages, 0 if the sort fit in memory */
+  size_t GetNumSpilledRuns() const { return num_spilled_runs_; }
+
+  /** @return the largest estimated memory that the rows held in memory took, in bytes */
+  size_t GetPeakMemoryUsage() const { return peak_memory_usage_; }
+
+ private:
+  /** A sorted run, and the position of the merge in it. */
+  struct Run {
+    /** The temporary pages of the run, in order */
+    std::vector<page_id_t> pages_;
+    /** The next page of pages_ to read */
+    size_t next_page_{0};
+    /** The unmerged tuples that are in memory, the next one last */
+    std::vector<Tuple> tuples_;
+    /** The sort key of the next tuple */
+    std::vector<Value> key_;
+  };
+
+  /** Adds a tuple of the child, spilling the rows in memory first if the tuple does not fit in the budget. */
+  void AddTuple(const Tuple &tuple);
+
+  /** Sorts the rows in memory into order_. */
+  void SortRows();
+
+  /** Writes the rows in memory to temporary pages as a sorted run and empties memory. */
+  void SpillRun();
+
+  /** Makes the next tuple of a run available, reading its next page if needed. @return false if the run is done */
+  bool PrepareRun(Run *run);
+
+  /** Deletes the pages of every run that have not been read. */
+  void DropRuns();
+
+  /** The sort plan node to be executed */
+  const SortPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Orders sort keys */
+  SortKeyComparator comparator_;
+
+  /** The rows held in memory */
+  std::vector<Tuple> tuples_;
+  /** The sort key of every row in memory */
+  std::vector<std::vector<Value>> keys_;
+  /** The indexes of the rows in memory, in sort order once sorted */
+  std::vector<uint32_t> order_;
+  /** The next entry of order_ to return when the sort did not spill */
+  size_t next_row_{0};
+  /** The estimated memory of the rows in memory */
+  size_t memory_usage_{0};
+  /** The largest value memory_usage_ reached */
+  size_t peak_memory_usage_{0};
+
+  /** The runs being merged; empty if the sort fit in memory */
+  std::vector<Run> runs_;
+  /** The number of runs written to temporary pages */
+  size_t num_spilled_runs_{0};
+  /** The indexes of the runs that have tuples left, as a heap with the run with the smallest next key on top */
+  std::vector<size_t> merge_heap_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_executor.h
+//
+// Identification: src/include/execution/executors/topn_executor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "execution/executor_context.h"
+#include "execution/executors/abstract_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/plans/topn_plan.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TopNExecutor returns the first n tuples of its child in sort order. Init() reads the child through a max-heap of at
+ * most n rows, so that memory is bounded by n rather than by the size of the input: a row replaces the top of a full
+ * heap only if it orders before it.
+ */
+class TopNExecutor : public AbstractExecutor {
+ public:
+  /**
+   * Construct a new TopNExecutor instance.
+   * @param exec_ctx The executor context
+   * @param plan The top-n plan to be executed
+   * @param child_executor The child executor from which tuples are pulled
+   */
+  TopNExecutor(ExecutorContext *exec_ctx, const TopNPlanNode *plan, std::unique_ptr<AbstractExecutor> &&child_executor);
+
+  /** Initialize the top-n: reads the output of the child and keeps its first n tuples. */
+  void Init() override;
+
+  /**
+   * Yield the next tuple in sort order.
+   * @param[out] tuple The next tuple produced by the top-n
+   * @param[out] rid The next tuple RID produced by the top-n
+   * @return `true` if a tuple was produced, `false` if there are no more tuples
+   */
+  bool Next(Tuple *tuple, RID *rid) override;
+
+  /** @return The output schema for the top-n */
+  const Schema *GetOutputSchema() override { return plan_->OutputSchema(); };
+
+  /** @return the largest estimated memory that the rows held in memory took, in bytes */
+  size_t GetPeakMemoryUsage() const { return peak_memory_usage_; }
+
+ private:
+  /** A row of the heap: its sort key and the tuple */
+  using Row = std::pair<std::vector<Value>, Tuple>;
+
+  /** Offers a tuple of the child to the heap. */
+  void AddTuple(const Tuple &tuple);
+
+  /** The top-n plan node to be executed */
+  const TopNPlanNode *plan_;
+  /** The child executor from which tuples are obtained */
+  std::unique_ptr<AbstractExecutor> child_executor_;
+  /** Orders sort keys */
+  SortKeyComparator comparator_;
+  /** The first n rows so far: a max-heap during Init(), then in sort order */
+  std::vector<Row> rows_;
+  /** The next entry of rows_ to return */
+  size_t next_row_{0};
+  /** The estimated memory of the rows in memory */
+  size_t memory_usage_{0};
+  /** The largest value memory_usage_ reached */
+  size_t peak_memory_usage_{0};
+};
+
+}  // namespace bustub
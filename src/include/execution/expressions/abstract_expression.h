@@ -16,6 +16,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "execution/tuple_batch.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
@@ -58,6 +59,24 @@ class AbstractExpression {
    */
   virtual Value EvaluateAggregate(const std::vector<Value> &group_bys, const std::vector<Value> &aggregates) const = 0;
 
+  /**
+   * Evaluates the expression on every selected row of a batch.
+   * @param batch The input rows, with the columns of the schema the expression was built against
+   * @param[out] result Resized to the number of rows in the batch; the value of each selected row is stored at its row
+   * index, unselected entries are left unspecified
+   */
+  virtual void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const = 0;
+
+  /**
+   * Evaluates a JOIN on pairs of rows: row i of the left batch joined with row i of the right batch, for every row i
+   * selected in the left batch. Both batches must have the same number of rows.
+   * @param left_batch The left rows
+   * @param right_batch The right rows
+   * @param[out] result Resized to the number of rows; one value per selected row, stored at its row index
+   */
+  virtual void EvaluateJoinBatch(const TupleBatch &left_batch, const TupleBatch &right_batch,
+                                 std::vector<Value> *result) const = 0;
+
   /** @return the child_idx'th child of this expression */
   const AbstractExpression *GetChildAt(uint32_t child_idx) const { return children_[child_idx]; }
 
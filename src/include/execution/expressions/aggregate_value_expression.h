@@ -54,6 +54,23 @@ class AggregateValueExpression : public AbstractExpression {
     return is_group_by_term_ ? group_bys[term_idx_] : aggregates[term_idx_];
   }
 
+  /** Invalid operation for `AggregateValueExpression` */
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
+  /** Invalid operation for `AggregateValueExpression` */
+  void EvaluateJoinBatch(const TupleBatch &left_batch, const TupleBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    UNREACHABLE("Aggregation should only refer to group-by and aggregates.");
+  }
+
+  /** @return true if this expression is a group-by term, false if it is an aggregate */
+  bool IsGroupByTerm() const { return is_group_by_term_; }
+
+  /** @return the index of the term among the group-by terms or the aggregates */
+  uint32_t GetTermIdx() const { return term_idx_; }
+
  private:
   /** The flag indicating if this expression is a group-by term */
   bool is_group_by_term_;
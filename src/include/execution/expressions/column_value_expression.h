@@ -45,10 +45,28 @@ class ColumnValueExpression : public AbstractExpression {
     BUSTUB_ASSERT(false, "Aggregation should only refer to group-by and aggregates.");
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    CopySelected(batch.GetColumn(col_idx_), batch.GetNumRows(), batch.GetSelection(), result);
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left_batch, const TupleBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    const TupleBatch &batch = tuple_idx_ == 0 ? left_batch : right_batch;
+    CopySelected(batch.GetColumn(col_idx_), batch.GetNumRows(), left_batch.GetSelection(), result);
+  }
+
   uint32_t GetTupleIdx() const { return tuple_idx_; }
   uint32_t GetColIdx() const { return col_idx_; }
 
  private:
+  static void CopySelected(const std::vector<Value> &column, uint32_t num_rows, const std::vector<uint32_t> &selection,
+                           std::vector<Value> *result) {
+    result->resize(num_rows);
+    for (uint32_t row : selection) {
+      (*result)[row] = column[row];
+    }
+  }
+
   /** Tuple index 0 = left side of join, tuple index 1 = right side of join */
   uint32_t tuple_idx_;
   /** Column index refers to the index within the schema of the tuple, e.g. schema {A,B,C} has indexes {0,1,2} */
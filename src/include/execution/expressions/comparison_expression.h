@@ -53,7 +53,35 @@ class ComparisonExpression : public AbstractExpression {
     return ValueFactory::GetBooleanValue(PerformComparison(lhs, rhs));
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateBatch(batch, &lhs);
+    GetChildAt(1)->EvaluateBatch(batch, &rhs);
+    CompareSelected(lhs, rhs, batch.GetSelection(), result);
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left_batch, const TupleBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    std::vector<Value> lhs;
+    std::vector<Value> rhs;
+    GetChildAt(0)->EvaluateJoinBatch(left_batch, right_batch, &lhs);
+    GetChildAt(1)->EvaluateJoinBatch(left_batch, right_batch, &rhs);
+    CompareSelected(lhs, rhs, left_batch.GetSelection(), result);
+  }
+
+  /** @return the type of the comparison */
+  ComparisonType GetComparisonType() const { return comp_type_; }
+
  private:
+  void CompareSelected(const std::vector<Value> &lhs, const std::vector<Value> &rhs,
+                       const std::vector<uint32_t> &selection, std::vector<Value> *result) const {
+    result->resize(lhs.size());
+    for (uint32_t row : selection) {
+      (*result)[row] = ValueFactory::GetBooleanValue(PerformComparison(lhs[row], rhs[row]));
+    }
+  }
+
   CmpBool PerformComparison(const Value &lhs, const Value &rhs) const {
     switch (comp_type_) {
       case ComparisonType::Equal:
@@ -36,6 +36,18 @@ class ConstantValueExpression : public AbstractExpression {
     return val_;
   }
 
+  void EvaluateBatch(const TupleBatch &batch, std::vector<Value> *result) const override {
+    result->resize(batch.GetNumRows());
+    for (uint32_t row : batch.GetSelection()) {
+      (*result)[row] = val_;
+    }
+  }
+
+  void EvaluateJoinBatch(const TupleBatch &left_batch, const TupleBatch &right_batch,
+                         std::vector<Value> *result) const override {
+    EvaluateBatch(left_batch, result);
+  }
+
  private:
   Value val_;
 };
@@ -0,0 +1,54 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// morsel_queue.h
+//
+// Identification: src/include/execution/morsel_queue.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <vector>
+
+#include "common/config.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+/**
+ * MorselQueue hands out the pages of a table to the workers of a parallel scan in "morsels" of up to
+ * SCAN_MORSEL_SIZE consecutive pages of the page chain. Workers claim a new morsel whenever they finish one, so
+ * faster workers take more of the table and all of them finish at about the same time.
+ *
+ * The pages are listed once when the queue is created, from the free space map of the table rather than the table
+ * pages, so claiming a morsel is a single atomic increment, workers never wait for each other and a cold table is
+ * not read twice. Pages appended to the table afterwards are not part of the scan.
+ */
+class MorselQueue {
+ public:
+  /**
+   * Creates a queue over all pages of a table.
+   * @param table_heap the table to hand out
+   */
+  explicit MorselQueue(TableHeap *table_heap);
+
+  /**
+   * Claims the next morsel.
+   * @param[out] page_ids the pages of the morsel, replacing the previous contents
+   * @return false if the whole table has been handed out
+   */
+  bool Next(std::vector<page_id_t> *page_ids);
+
+ private:
+  /** The pages of the table, in chain order */
+  std::vector<page_id_t> page_ids_;
+  /** The index in page_ids_ of the first page that has not been handed out; may run past the end */
+  std::atomic<size_t> next_idx_{0};
+};
+
+}  // namespace bustub
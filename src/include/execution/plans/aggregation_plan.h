@@ -22,7 +22,14 @@
 namespace bustub {
 
 /** AggregationType enumerates all the possible aggregation functions in our system */
-enum class AggregationType { CountAggregate, SumAggregate, MinAggregate, MaxAggregate };
+enum class AggregationType {
+  CountAggregate,
+  CountDistinctAggregate,
+  SumAggregate,
+  AvgAggregate,
+  MinAggregate,
+  MaxAggregate
+};
 
 /**
  * AggregationPlanNode represents the various SQL aggregation functions.
@@ -94,12 +101,19 @@ struct AggregateKey {
   std::vector<Value> group_bys_;
 
   /**
-   * Compares two aggregate keys for equality.
+   * Compares two aggregate keys for equality. Unlike in a comparison, NULL equals NULL here, so that all rows with a
+   * NULL group-by value fall into one group.
    * @param other the other aggregate key to be compared with
    * @return `true` if both aggregate keys have equivalent group-by expressions, `false` otherwise
    */
   bool operator==(const AggregateKey &other) const {
     for (uint32_t i = 0; i < other.group_bys_.size(); i++) {
+      if (group_bys_[i].IsNull() || other.group_bys_[i].IsNull()) {
+        if (group_bys_[i].IsNull() != other.group_bys_[i].IsNull()) {
+          return false;
+        }
+        continue;
+      }
       if (group_bys_[i].CompareEquals(other.group_bys_[i]) != CmpBool::CmpTrue) {
         return false;
       }
@@ -108,7 +122,7 @@ struct AggregateKey {
   }
 };
 
-/** AggregateValue represents a value for each of the running aggregates */
+/** AggregateValue holds a value for each of the aggregates: their inputs from a row, or their results for a group */
 struct AggregateValue {
   /** The aggregate values */
   std::vector<Value> aggregates_;
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_plan.h
+//
+// Identification: src/include/execution/plans/sort_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/expressions/abstract_expression.h"
+#include "execution/plans/abstract_plan.h"
+
+namespace bustub {
+
+/** OrderByType is the direction of an ORDER BY key */
+enum class OrderByType { ASC, DESC };
+
+/** An ORDER BY key: its direction and the expression that computes it from a tuple of the child */
+using OrderBy = std::pair<OrderByType, const AbstractExpression *>;
+
+/**
+ * Sort orders the output of its child by a list of ORDER BY keys, the first key first. NULLs come before every other
+ * value in ascending order and after them in descending order. The output schema must be that of the child.
+ */
+class SortPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new SortPlanNode instance.
+   * @param output_schema The output schema of this plan node, the schema of the child
+   * @param child The child plan from which tuples are obtained
+   * @param order_bys The ORDER BY keys
+   */
+  SortPlanNode(const Schema *output_schema, const AbstractPlanNode *child, std::vector<OrderBy> order_bys)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)) {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::Sort; }
+
+  /** @return The ORDER BY keys */
+  const std::vector<OrderBy> &GetOrderBy() const { return order_bys_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "Sort should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The ORDER BY keys */
+  std::vector<OrderBy> order_bys_;
+};
+
+}  // namespace bustub
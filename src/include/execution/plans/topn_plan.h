@@ -0,0 +1,62 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// topn_plan.h
+//
+// Identification: src/include/execution/plans/topn_plan.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "execution/plans/abstract_plan.h"
+#include "execution/plans/sort_plan.h"
+
+namespace bustub {
+
+/**
+ * TopN returns the first n tuples of its child in the order of a list of ORDER BY keys, i.e. ORDER BY ... LIMIT n.
+ * Keys are ordered as by SortPlanNode. The output schema must be that of the child.
+ */
+class TopNPlanNode : public AbstractPlanNode {
+ public:
+  /**
+   * Construct a new TopNPlanNode instance.
+   * @param output_schema The output schema of this plan node, the schema of the child
+   * @param child The child plan from which tuples are obtained
+   * @param order_bys The ORDER BY keys
+   * @param n The number of tuples to return
+   */
+  TopNPlanNode(const Schema *output_schema, const AbstractPlanNode *child, std::vector<OrderBy> order_bys,
+               std::size_t n)
+      : AbstractPlanNode(output_schema, {child}), order_bys_(std::move(order_bys)), n_{n} {}
+
+  /** @return The type of the plan node */
+  PlanType GetType() const override { return PlanType::TopN; }
+
+  /** @return The ORDER BY keys */
+  const std::vector<OrderBy> &GetOrderBy() const { return order_bys_; }
+
+  /** @return The number of tuples to return */
+  size_t GetN() const { return n_; }
+
+  /** @return The child plan node */
+  const AbstractPlanNode *GetChildPlan() const {
+    BUSTUB_ASSERT(GetChildren().size() == 1, "TopN should have exactly one child plan.");
+    return GetChildAt(0);
+  }
+
+ private:
+  /** The ORDER BY keys */
+  std::vector<OrderBy> order_bys_;
+  /** The number of tuples to return */
+  std::size_t n_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,114 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_batch.h
+//
+// Identification: src/include/execution/tuple_batch.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "common/config.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+#include "type/value.h"
+
+namespace bustub {
+
+/**
+ * TupleBatch holds up to EXECUTION_BATCH_SIZE rows in column-oriented form, the unit of work of the batch execution
+ * model (AbstractExecutor::NextBatch). Each column is a vector with one value per row. The selection vector lists the
+ * rows that are still live, in order: a filter narrows the selection instead of moving rows, and every consumer only
+ * looks at the selected rows.
+ *
+ * Batches returned by NextBatch() have every column filled. A batch that an executor only uses internally may leave
+ * the columns that no expression refers to empty.
+ */
+class TupleBatch {
+ public:
+  /** Creates an empty batch without columns. */
+  TupleBatch() = default;
+
+  /**
+   * Empties the batch and gives it num_columns empty columns. Column storage is kept so that a batch can be refilled
+   * without reallocating.
+   * @param num_columns the number of columns of the batch
+   */
+  void Reset(uint32_t num_columns);
+
+  /** @return the number of columns */
+  uint32_t GetNumColumns() const { return static_cast<uint32_t>(columns_.size()); }
+
+  /** @return the number of rows, selected or not */
+  uint32_t GetNumRows() const { return static_cast<uint32_t>(rids_.size()); }
+
+  /** @return true if no more rows fit */
+  bool IsFull() const { return GetNumRows() >= static_cast<uint32_t>(EXECUTION_BATCH_SIZE); }
+
+  /** @return the values of column col_idx, indexed by row */
+  const std::vector<Value> &GetColumn(uint32_t col_idx) const { return columns_[col_idx]; }
+
+  /** @return the values of column col_idx, for producers that fill the batch column by column */
+  std::vector<Value> *GetMutableColumn(uint32_t col_idx) { return &columns_[col_idx]; }
+
+  /** @return the value of column col_idx in the given row */
+  const Value &GetValue(uint32_t col_idx, uint32_t row) const { return columns_[col_idx][row]; }
+
+  /** @return the RID of the given row, the default RID if the row was computed rather than read from a table */
+  const RID &GetRid(uint32_t row) const { return rids_[row]; }
+
+  /** @return the RIDs of all rows; a producer that fills columns directly appends one RID per row here */
+  std::vector<RID> *GetMutableRids() { return &rids_; }
+
+  /** @return the indexes of the selected rows, in ascending order */
+  const std::vector<uint32_t> &GetSelection() const { return selection_; }
+
+  /** @return the number of selected rows */
+  uint32_t GetNumSelected() const { return static_cast<uint32_t>(selection_.size()); }
+
+  /** Replaces the selection vector, which must stay in ascending order. */
+  void SetSelection(std::vector<uint32_t> &&selection) { selection_ = std::move(selection); }
+
+  /** Selects every row. */
+  void SelectAll();
+
+  /**
+   * Appends the values of a tuple as a new, selected row.
+   * @param tuple the tuple to append
+   * @param schema the schema of the tuple, which must have GetNumColumns() columns
+   */
+  void AppendTuple(const Tuple &tuple, const Schema *schema);
+
+  /**
+   * Appends a row of another batch with the same columns as a new, selected row.
+   * @param other the batch to copy from
+   * @param row the row of other to copy
+   */
+  void AppendRow(const TupleBatch &other, uint32_t row);
+
+  /**
+   * Materializes a row as a tuple.
+   * @param row the row to materialize
+   * @param schema the schema to build the tuple with, which must have GetNumColumns() columns
+   * @return the tuple; GetRid(row) has its RID
+   */
+  Tuple GetTuple(uint32_t row, const Schema *schema) const;
+
+ private:
+  /** One vector of values per column */
+  std::vector<std::vector<Value>> columns_;
+  /** The RID of every row */
+  std::vector<RID> rids_;
+  /** The selected rows */
+  std::vector<uint32_t> selection_;
+};
+
+}  // namespace bustub
@@ -0,0 +1,162 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.h
+//
+// Identification: src/include/storage/disk/compressed_disk_manager.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <future>  // NOLINT
+#include <mutex>   // NOLINT
+#include <string>
+#include <vector>
+
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+/**
+ * CompressedDiskManager is a DiskManager that compresses every page on its way to disk, transparently to the buffer
+ * pool. A compressed page occupies a variable-size extent of whole COMPRESSED_EXTENT_UNITs in the database file, so
+ * pages no longer sit at page_id * PAGE_SIZE and a page-mapping table records where each page lives. Pages that do
+ * not compress by at least one unit are stored as they are.
+ *
+ * A compressed page begins its extent with its compressed size, so the mapping table only records where each extent
+ * is and how large it is, and a page rewritten in place with a different size writes its data and its size in the same
+ * write. A page that still fits its extent is rewritten in place, otherwise it moves to a free extent of the right
+ * size or to the end of the file; a page changing between compressed and uncompressed always moves.
+ *
+ * The mapping table is kept in memory and saved next to the database file (with the extension .pmap), from where the
+ * next CompressedDiskManager on the same file loads it. Every move is appended to the .pmap file once the page data in
+ * its new extent has been fsynced, and the record is fsynced in turn, so the file on disk never maps a page to an
+ * extent that was not completely written. A page that moves keeps its old extent until the record of the move is on
+ * disk, and only then is the old extent recycled. Loading replays the appended records and compacts them into a fresh
+ * table. A page rewritten in place is not fsynced, and is only as safe from a torn write as an uncompressed page.
+ *
+ * Page I/O is synchronous: the asynchronous variants complete before they return.
+ */
+class CompressedDiskManager : public DiskManager {
+ public:
+  /**
+   * Creates a new compressed disk manager, loading the mapping table of db_file if there is one. Throws an Exception,
+   * leaving both files untouched, if the table cannot be read or a non-empty db_file has none.
+   * @param db_file the file name of the database file to write to
+   * @param io_backend the I/O path used for the extents
+   * @param io_queue_depth maximum number of asynchronous requests in flight (ignored for FSTREAM)
+   */
+  explicit CompressedDiskManager(const std::string &db_file, IOBackendType io_backend = IOBackendType::FSTREAM,
+                                 size_t io_queue_depth = 64);
+
+  /**
+   * Closes the page map log if ShutDown() was skipped. Records already written to the log stay durable.
+   */
+  ~CompressedDiskManager() override;
+
+  /**
+   * Saves the mapping table, then shuts down the disk manager.
+   */
+  void ShutDown() override;
+
+  /**
+   * Compresses a page and writes it to its extent.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  void WritePage(page_id_t page_id, const char *page_data) override;
+
+  /**
+   * Reads a page from its extent and decompresses it. A page that was never written reads as zeros, a page that does
+   * not decompress throws an Exception.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  void ReadPage(page_id_t page_id, char *page_data) override;
+
+  /**
+   * Writes a run of consecutive pages. Their extents are not adjacent, so every page is written on its own, but the
+   * pages that move are recorded in the .pmap file together, with one fsync of each file.
+   * @param first_page_id id of the first page in the run
+   * @param pages_data raw data of num_pages pages, back to back
+   * @param num_pages number of pages in the run
+   */
+  void WritePages(page_id_t first_page_id, const char *pages_data, size_t num_pages) override;
+
+  /** Writes a page like WritePage(). */
+  std::future<void> WritePageAsync(page_id_t page_id, const char *page_data) override;
+
+  /** Reads a page like ReadPage(). */
+  std::future<void> ReadPageAsync(page_id_t page_id, char *page_data) override;
+
+  /** @return false, pages are read and decompressed synchronously */
+  bool HasAsyncReads() const override { return false; }
+
+  /** @return true if the page has an extent */
+  bool IsPageOnDisk(page_id_t page_id) override;
+
+  /** @return the number of bytes of the database file occupied by extents, free or in use */
+  uint64_t GetAllocatedBytes();
+
+  /** @return the number of pages stored compressed */
+  size_t GetNumCompressedPages();
+
+ private:
+  /**
+   * Where a page is stored: an extent of capacity bytes at offset. capacity 0 means never written, PAGE_SIZE means
+   * stored uncompressed.
+   */
+  struct Extent {
+    uint64_t offset_;
+    uint64_t capacity_;
+  };
+
+  /** A change to the extent of a page, as appended to the mapping table. */
+  struct MapRecord {
+    uint64_t page_id_;
+    Extent extent_;
+  };
+
+  /**
+   * Finds an extent of the given capacity for page_id: its own extent if it fits, otherwise a free one. The mapping
+   * table is not changed until CommitPages(). Must hold map_latch_.
+   */
+  Extent PlacePage(page_id_t page_id, uint32_t capacity);
+
+  /**
+   * Points a run of pages at the extents their data was just written to. If any extent changed, the data and then the
+   * changes appended to the .pmap file are fsynced, once for the whole run, before the old extents are recycled. Must
+   * hold map_latch_.
+   */
+  void CommitPages(page_id_t first_page_id, const std::vector<Extent> &extents);
+
+  /**
+   * Reads the mapping table, replays the records appended to it and rebuilds the free extents from the gaps. Throws if
+   * the table exists but cannot be read, or is missing while the database file is not empty.
+   */
+  void LoadPageMap();
+
+  /**
+   * Writes the mapping table to a new .pmap file that replaces the old one, dropping the appended records. The new file
+   * and the rename are fsynced.
+   */
+  void SavePageMap();
+
+  std::string map_name_;
+  /** Descriptor of the .pmap file, open for appending records. */
+  int map_log_fd_{-1};
+  /** Protects the mapping table, the free extents and the end of the file. */
+  std::mutex map_latch_;
+  /** The extent of every page, indexed by page id. */
+  std::vector<Extent> page_map_;
+  /** Free extents by their capacity in units, e.g. free_extents_[2] holds the offsets of free two-unit extents. */
+  std::vector<std::vector<uint64_t>> free_extents_;
+  /** The offset at which the next new extent is allocated. */
+  uint64_t file_end_{0};
+};
+
+}  // namespace bustub
@@ -0,0 +1,168 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_backend.h
+//
+// Identification: src/include/storage/disk/disk_io_backend.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <condition_variable>  // NOLINT
+#include <deque>
+#include <future>  // NOLINT
+#include <memory>
+#include <mutex>   // NOLINT
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+/** The I/O path a DiskManager uses for database pages. */
+enum class IOBackendType {
+  /** Synchronous reads and writes through a single std::fstream. */
+  FSTREAM,
+  /** pread/pwrite executed by a pool of worker threads. */
+  THREAD_POOL,
+  /** Linux io_uring. Falls back to THREAD_POOL if the kernel refuses to set up a ring. */
+  IO_URING,
+};
+
+/**
+ * DiskIOBackend executes positioned reads and writes against an open file descriptor. Requests are submitted without
+ * blocking (unless queue_depth requests are already in flight) and complete through the returned future, so callers
+ * can keep many requests outstanding. All methods are thread-safe.
+ *
+ * A read that runs past the end of the file is completed with the missing bytes zeroed. I/O errors are reported by
+ * storing an Exception in the future.
+ */
+class DiskIOBackend {
+ public:
+  explicit DiskIOBackend(int fd) : fd_(fd) {}
+  virtual ~DiskIOBackend() = default;
+
+  DISALLOW_COPY_AND_MOVE(DiskIOBackend);
+
+  /**
+   * Creates a backend of the given type.
+   * @param type the requested backend, must not be FSTREAM
+   * @param fd the file to operate on, owned by the caller
+   * @param queue_depth maximum number of requests in flight
+   */
+  static std::unique_ptr<DiskIOBackend> Create(IOBackendType type, int fd, size_t queue_depth);
+
+  /** @return the type of this backend, which can differ from the requested one after a fallback */
+  virtual IOBackendType GetType() const = 0;
+
+  /**
+   * Reads size bytes at offset into data. data must stay valid until the future is ready.
+   */
+  virtual std::future<void> SubmitRead(char *data, size_t size, size_t offset) = 0;
+
+  /**
+   * Writes size bytes from data at offset. data must stay valid until the future is ready.
+   */
+  virtual std::future<void> SubmitWrite(const char *data, size_t size, size_t offset) = 0;
+
+ protected:
+  int fd_;
+};
+
+/**
+ * ThreadPoolIOBackend hands every request to one of a fixed set of worker threads, which issue blocking pread/pwrite
+ * calls. This works everywhere, at the cost of one context switch per request.
+ */
+class ThreadPoolIOBackend : public DiskIOBackend {
+ public:
+  ThreadPoolIOBackend(int fd, size_t num_threads);
+  ~ThreadPoolIOBackend() override;
+
+  DISALLOW_COPY_AND_MOVE(ThreadPoolIOBackend);
+
+  IOBackendType GetType() const override { return IOBackendType::THREAD_POOL; }
+  std::future<void> SubmitRead(char *data, size_t size, size_t offset) override;
+  std::future<void> SubmitWrite(const char *data, size_t size, size_t offset) override;
+
+ private:
+  struct Request {
+    bool is_write_;
+    char *data_;
+    size_t size_;
+    size_t offset_;
+    std::promise<void> promise_;
+  };
+
+  std::future<void> Enqueue(bool is_write, char *data, size_t size, size_t offset);
+  void WorkerLoop();
+
+  std::vector<std::thread> workers_;
+  std::deque<Request> queue_;
+  bool shutdown_{false};
+  /** Protects queue_ and shutdown_. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+/**
+ * IoUringIOBackend submits requests to a Linux io_uring (through the raw system calls, liburing is not required) and
+ * reaps completions on a dedicated thread.
+ */
+class IoUringIOBackend : public DiskIOBackend {
+ public:
+  IoUringIOBackend(int fd, size_t queue_depth);
+  ~IoUringIOBackend() override;
+
+  DISALLOW_COPY_AND_MOVE(IoUringIOBackend);
+
+  /** @return true if the ring was set up; if not, the backend must not be used */
+  bool IsValid() const { return ring_fd_ >= 0; }
+
+  IOBackendType GetType() const override { return IOBackendType::IO_URING; }
+  std::future<void> SubmitRead(char *data, size_t size, size_t offset) override;
+  std::future<void> SubmitWrite(const char *data, size_t size, size_t offset) override;
+
+ private:
+  struct Request {
+    bool is_write_;
+    char *data_;
+    size_t size_;
+    size_t offset_;
+    std::promise<void> promise_;
+  };
+
+  /** Places one SQE for request (or a NOP if request is nullptr) on the ring and submits it. */
+  void PushSqe(Request *request);
+  void CompletionLoop();
+
+  int ring_fd_{-1};
+  unsigned queue_depth_{0};
+  // Submission queue ring.
+  void *sq_ring_{nullptr};
+  size_t sq_ring_size_{0};
+  unsigned *sq_tail_{nullptr};
+  unsigned *sq_mask_{nullptr};
+  unsigned *sq_array_{nullptr};
+  void *sqes_{nullptr};
+  size_t sqes_size_{0};
+  // Completion queue ring, possibly sharing the mapping of the submission ring.
+  void *cq_ring_{nullptr};
+  size_t cq_ring_size_{0};
+  unsigned *cq_head_{nullptr};
+  unsigned *cq_tail_{nullptr};
+  unsigned *cq_mask_{nullptr};
+  void *cqes_{nullptr};
+
+  std::thread completion_thread_;
+  size_t in_flight_{0};
+  /** Protects the submission queue and in_flight_. */
+  std::mutex latch_;
+  std::condition_variable cv_;
+};
+
+}  // namespace bustub
@@ -15,10 +15,12 @@
 #include <atomic>
 #include <fstream>
 #include <future>  // NOLINT
-#include <mutex>   // NOLINT
+#include <memory>
+#include <mutex>  // NOLINT
 #include <string>
 
 #include "common/config.h"
+#include "storage/disk/disk_io_backend.h"
 
 namespace bustub {
 
@@ -31,29 +33,70 @@ class DiskManager {
   /**
    * Creates a new disk manager that writes to the specified database file.
    * @param db_file the file name of the database file to write to
+   * @param io_backend the I/O path used for database pages
+   * @param io_queue_depth maximum number of asynchronous page requests in flight (ignored for FSTREAM)
    */
-  explicit DiskManager(const std::string &db_file);
+  explicit DiskManager(const std::string &db_file, IOBackendType io_backend = IOBackendType::FSTREAM,
+                       size_t io_queue_depth = 64);
 
-  ~DiskManager() = default;
+  virtual ~DiskManager();
 
   /**
    * Shut down the disk manager and close all the file resources.
    */
-  void ShutDown();
+  virtual void ShutDown();
 
   /**
    * Write a page to the database file.
    * @param page_id id of the page
    * @param page_data raw page data
    */
-  void WritePage(page_id_t page_id, const char *page_data);
+  virtual void WritePage(page_id_t page_id, const char *page_data);
 
   /**
    * Read a page from the database file.
    * @param page_id id of the page
    * @param[out] page_data output buffer
    */
-  void ReadPage(page_id_t page_id, char *page_data);
+  virtual void ReadPage(page_id_t page_id, char *page_data);
+
+  /**
+   * Write a run of consecutive pages to the database file with a single write.
+   * @param first_page_id id of the first page in the run
+   * @param pages_data raw data of num_pages pages, back to back
+   * @param num_pages number of pages in the run
+   */
+  virtual void WritePages(page_id_t first_page_id, const char *pages_data, size_t num_pages);
+
+  /**
+   * Start writing a page to the database file. page_data must stay valid until the returned future is ready.
+   * With the FSTREAM backend the write is performed synchronously.
+   * @param page_id id of the page
+   * @param page_data raw page data
+   */
+  virtual std::future<void> WritePageAsync(page_id_t page_id, const char *page_data);
+
+  /**
+   * Start reading a page from the database file. page_data must stay valid until the returned future is ready.
+   * With the FSTREAM backend the read is performed synchronously.
+   * @param page_id id of the page
+   * @param[out] page_data output buffer
+   */
+  virtual std::future<void> ReadPageAsync(page_id_t page_id, char *page_data);
+
+  /** @return true if ReadPageAsync() returns before the read has completed, false if it reads synchronously */
+  virtual bool HasAsyncReads() const { return io_backend_ != nullptr; }
+
+  /**
+   * @param page_id id of the page
+   * @return true if the page has been written to the database file
+   */
+  virtual bool IsPageOnDisk(page_id_t page_id);
+
+  /** @return the I/O path in use for database pages */
+  IOBackendType GetIOBackendType() const {
+    return io_backend_ == nullptr ? IOBackendType::FSTREAM : io_backend_->GetType();
+  }
 
   /**
    * Flush the entire log buffer into disk.
@@ -80,6 +123,9 @@ class DiskManager {
   /** @return the number of disk writes */
   int GetNumWrites() const;
 
+  /** @return the number of bytes written to the database file */
+  uint64_t GetNumBytesWritten() const;
+
   /**
    * Sets the future which is used to check for non-blocking flushes.
    * @param f the non-blocking flush check
@@ -89,8 +135,34 @@ class DiskManager {
   /** Checks if the non-blocking flush future was set. */
   inline bool HasFlushLogFuture() { return flush_log_f_ != nullptr; }
 
+ protected:
+  /**
+   * Write raw bytes to the database file with a single write.
+   * @param offset offset in the file
+   * @param data the bytes to write
+   * @param size number of bytes
+   */
+  void WriteBytes(size_t offset, const char *data, size_t size);
+
+  /**
+   * Read raw bytes from the database file. Bytes past the end of the file read as zeros.
+   * @param offset offset in the file
+   * @param[out] data output buffer
+   * @param size number of bytes
+   */
+  void ReadBytes(size_t offset, char *data, size_t size);
+
+  /**
+   * Waits until everything written to the database file so far is on stable storage.
+   * @return false on an I/O error
+   */
+  bool SyncBytes();
+
+  /** @return the database file name */
+  const std::string &GetFileName() const { return file_name_; }
+
  private:
-  int GetFileSize(const std::string &file_name);
+  int64_t GetFileSize(const std::string &file_name);
   // stream to write log file
   std::fstream log_io_;
   std::string log_name_;
@@ -98,11 +170,15 @@ class DiskManager {
   std::fstream db_io_;
   std::string file_name_;
   int num_flushes_;
-  int num_writes_;
+  std::atomic<int> num_writes_;
+  std::atomic<uint64_t> num_bytes_written_{0};
   bool flush_log_;
   std::future<void> *flush_log_f_;
   // With multiple buffer pool instances, need to protect file access
   std::mutex db_io_latch_;
+  // file descriptor of the db file and the backend using it, unless pages go through db_io_
+  int db_fd_{-1};
+  std::unique_ptr<DiskIOBackend> io_backend_;
 };
 
 }  // namespace bustub
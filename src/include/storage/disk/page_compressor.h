@@ -0,0 +1,48 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.h
+//
+// Identification: src/include/storage/disk/page_compressor.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstddef>
+
+namespace bustub {
+
+/**
+ * PageCompressor is a byte-oriented LZ77 codec producing the LZ4 block format: every sequence is a token (literal
+ * length and match length, 4 bits each), the literals, a 2-byte little-endian match offset and the match length
+ * overflow. Matches are found through a single-probe hash table of 4-byte prefixes, which trades ratio for speed, so
+ * compressing or decompressing a page costs about as much as copying it a few times.
+ */
+class PageCompressor {
+ public:
+  /**
+   * Compresses a buffer.
+   * @param src the data to compress
+   * @param size the number of bytes to compress
+   * @param[out] dst output buffer
+   * @param capacity the size of dst
+   * @return the compressed size, or 0 if the data does not compress into capacity bytes
+   */
+  static size_t Compress(const char *src, size_t size, char *dst, size_t capacity);
+
+  /**
+   * Decompresses a buffer produced by Compress().
+   * @param src the compressed data
+   * @param size the compressed size
+   * @param[out] dst output buffer
+   * @param capacity the size of dst
+   * @return the decompressed size, or 0 if src is malformed or does not fit into capacity bytes
+   */
+  static size_t Decompress(const char *src, size_t size, char *dst, size_t capacity);
+};
+
+}  // namespace bustub
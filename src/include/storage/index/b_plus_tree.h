@@ -10,10 +10,14 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <atomic>
+#include <functional>
 #include <queue>
 #include <string>
 #include <vector>
 
+#include "buffer/read_ahead.h"
+#include "common/optimistic_latch.h"
 #include "concurrency/transaction.h"
 #include "storage/index/index_iterator.h"
 #include "storage/page/b_plus_tree_internal_page.h"
@@ -28,19 +32,34 @@ namespace bustub {
  *
  * Implementation of simple b+ tree data structure where internal pages direct
  * the search and leaf pages contain actual data.
- * (1) We only support unique key
+ * (1) We only support unique key, unless the keys are PostingKeys (see ScanKey)
  * (2) support insert & remove
  * (3) The structure should shrink and grow dynamically
  * (4) Implement index iterator for range scan
+ *
+ * Pages hold entries of varying length: leaves compress their keys against a base key, and internal pages hold the
+ * shortest separators between their children (see Separator). Pages split when their entries no longer fit and merge
+ * when they use less than half their space; the max sizes only cap the number of entries. Trees over IntegerKey use
+ * pages of their own instead, with fixed-size entries and the keys in an array apart from the values. So do trees over
+ * PostingKey, whose leaves store the record ids of an index key as delta encoded posting lists.
+ *
+ * Concurrency uses optimistic latch coupling over the version latch of each page (see OptimisticLatch), plus one for
+ * the root page id. Readers take no latch at all: they remember the version of a page, read it, and check that the
+ * version did not change before they trust what they read or follow a child pointer; otherwise they restart from the
+ * root. Writers first descend the same way and latch only the leaf if the change stays within it. A change that may
+ * split or merge pages descends again, latching pages exclusively from the root down and releasing the ancestors of
+ * each page that is safe, so only the pages that change stay latched. These are kept in the page set of the
+ * transaction.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
   using InternalPage = BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator>;
   using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  friend INDEXITERATOR_TYPE;
 
  public:
   explicit BPlusTree(std::string name, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
-                     int leaf_max_size = LEAF_PAGE_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
+                     int leaf_max_size = LeafPage::MAX_SIZE, int internal_max_size = INTERNAL_PAGE_SIZE);
 
   // Returns true if this B+ tree has no keys and values.
   bool IsEmpty() const;
@@ -54,6 +73,13 @@ class BPlusTree {
   // return the value associated with a given key
   bool GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
 
+  // return the values of every entry with the index key of key: more than one for trees over PostingKey
+  bool ScanKey(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction = nullptr);
+
+  // Build an empty tree bottom-up from the entries that next_entry returns in increasing key order, until it returns
+  // false.
+  bool BulkLoad(const std::function<bool(MappingType *)> &next_entry, double fill_factor = 1.0);
+
   // index iterator
   INDEXITERATOR_TYPE Begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
@@ -71,7 +97,7 @@ class BPlusTree {
     out.close();
   }
 
-  // read data from file and insert one by one
+  // read data from file and bulk load it, or insert it one by one if the tree is not empty
   void InsertFromFile(const std::string &file_name, Transaction *transaction = nullptr);
 
   // read data from file and remove one by one
@@ -80,10 +106,51 @@ class BPlusTree {
   Page *FindLeafPage(const KeyType &key, bool leftMost = false);
 
  private:
-  void StartNewTree(const KeyType &key, const ValueType &value);
+  enum class Operation { INSERT, REMOVE };
+
+  Page *FindLeafOptimistic(const KeyType &key, bool left_most, uint64_t *version);
+
+  bool FindLeafPessimistic(const KeyType &key, Operation operation, Transaction *transaction);
+
+  bool IsSafe(BPlusTreePage *node, Operation operation) const;
+
+  void ReleaseLatches(Transaction *transaction, bool is_dirty);
+
+  Page *FetchTreePage(page_id_t page_id);
+
+  ReadAhead::NextPagesFn GetNextLeavesFn();
+
+  void GetNextLeaves(page_id_t leaf_page_id, size_t max_pages, std::vector<page_id_t> *page_ids,
+                     page_id_t *parent_page_id);
+
+  bool CollectLeaves(page_id_t page_id, const std::vector<page_id_t> &children, size_t begin, size_t child_height,
+                     size_t max_pages, std::vector<page_id_t> *page_ids, page_id_t *leaf_parent_page_id);
+
+  bool ReadChildren(page_id_t page_id, std::vector<page_id_t> *children);
+
+  bool ReadParentPageId(page_id_t page_id, page_id_t *parent_page_id);
+
+  Page *LatchedParent(BPlusTreePage *node, Transaction *transaction);
+
+  void WLatchPage(Page *page);
+
+  void WUnlatchPage(Page *page);
+
+  bool StartNewTree(const KeyType &key, const ValueType &value);
+
+  Page *BulkLoadNewPage(size_t height);
+
+  void BulkLoadAddChild(std::vector<Page *> *levels, size_t height, const KeyType &key, Page *child, int fill,
+                        double fill_factor);
+
+  void BulkLoadBalance(const std::vector<Page *> &levels);
+
+  KeyType Separator(const KeyType &left, const KeyType &right) const;
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction = nullptr);
 
+  void RemoveFromLeaf(const KeyType &key, Transaction *transaction = nullptr);
+
   void InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
                         Transaction *transaction = nullptr);
 
@@ -98,7 +165,8 @@ class BPlusTree {
                 int index, Transaction *transaction = nullptr);
 
   template <typename N>
-  void Redistribute(N *neighbor_node, N *node, int index);
+  bool Redistribute(N *neighbor_node, N *node, BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *parent,
+                    int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
@@ -111,7 +179,9 @@ class BPlusTree {
 
   // member variable
   std::string index_name_;
-  page_id_t root_page_id_;
+  std::atomic<page_id_t> root_page_id_;
+  /** Protects root_page_id_ the way a page latch protects the child pointers of an internal page. */
+  OptimisticLatch root_latch_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
   int leaf_max_size_;
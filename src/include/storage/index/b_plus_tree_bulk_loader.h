@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_loader.h
+//
+// Identification: src/include/storage/index/b_plus_tree_bulk_loader.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/index/b_plus_tree.h"
+
+namespace bustub {
+
+#define BPLUSTREE_BULK_LOADER_TYPE BPlusTreeBulkLoader<KeyType, ValueType, KeyComparator>
+
+/**
+ * Collects the entries of a new index in any order and builds its B+ tree bottom-up (see BPlusTree::BulkLoad).
+ *
+ * The entries are sorted in memory. Once they outgrow the memory budget, the sorted entries are written to pages of
+ * the buffer pool as a run, and all runs are merged when the tree is built. Since the tree only holds unique keys, the
+ * first entry added for a key is kept and later ones are dropped, as if the entries were inserted in order.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTreeBulkLoader {
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+
+ public:
+  /**
+   * @param tree the tree to build
+   * @param buffer_pool_manager the buffer pool that holds the runs
+   * @param comparator the comparator of the tree
+   * @param memory_budget the bytes of entries held in memory before they are written out as a run, 0 for no limit
+   * @param fill_factor the share of a full page that each page of the tree gets
+   */
+  BPlusTreeBulkLoader(Tree *tree, BufferPoolManager *buffer_pool_manager, const KeyComparator &comparator,
+                      size_t memory_budget = 0, double fill_factor = 1.0);
+
+  /** Deletes the pages of the runs. */
+  ~BPlusTreeBulkLoader();
+
+  DISALLOW_COPY_AND_MOVE(BPlusTreeBulkLoader);
+
+  /** Add an entry to the tree. */
+  void Add(const KeyType &key, const ValueType &value);
+
+  /**
+   * Build the tree from the entries added. If the tree is not empty anymore, the entries are inserted one at a time.
+   * @return true if the tree was bulk loaded
+   */
+  bool Finish(Transaction *transaction = nullptr);
+
+  /** @return the number of runs written out so far */
+  size_t GetNumRuns() const { return runs_.size(); }
+
+ private:
+  /** Sorted entries that were written to pages, PAGE_SIZE / sizeof(MappingType) entries per page. */
+  struct Run {
+    std::vector<page_id_t> page_ids_;
+    size_t size_;
+  };
+
+  /** The position of the merge in one run, with the page of the run it reads from. */
+  struct RunReader {
+    const Run *run_;
+    size_t position_;
+    std::vector<MappingType> page_entries_;
+  };
+
+  /** Sort the entries in memory and drop the duplicate keys. */
+  void SortEntries();
+
+  /** Write the entries in memory to pages as a run. */
+  void Spill();
+
+  /** Start merging the runs from their first entries. */
+  void StartMerge();
+
+  /** @return false once the runs are merged, otherwise the next entry of the merge */
+  bool NextMerged(MappingType *entry);
+
+  /** Make the entry at the position of the reader available in its page entries. */
+  void ReadRunPage(RunReader *reader);
+
+  /** @return true if the next entry of reader a comes after the one of reader b */
+  bool ComesAfter(size_t a, size_t b) const;
+
+  Tree *tree_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  size_t memory_budget_;
+  double fill_factor_;
+  std::vector<MappingType> entries_;
+  std::vector<Run> runs_;
+  std::vector<RunReader> readers_;
+  /** The readers that have entries left, as a heap on their next entries. */
+  std::vector<size_t> merge_heap_;
+  /** The last entry the merge returned, to drop the duplicates of its key. */
+  MappingType last_merged_;
+  bool merged_any_{false};
+};
+
+}  // namespace bustub
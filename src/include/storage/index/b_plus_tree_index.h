@@ -30,6 +30,8 @@ class BPlusTreeIndex : public Index {
 
   void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
+  void InsertEntries(const std::function<bool(Tuple *key, RID *rid)> &next_entry, Transaction *transaction) override;
+
   void DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) override;
 
   void ScanKey(const Tuple &key, std::vector<RID> *result, Transaction *transaction) override;
@@ -41,10 +43,22 @@ class BPlusTreeIndex : public Index {
   INDEXITERATOR_TYPE GetEndIterator();
 
  protected:
+  // the key of the entry for the row, which holds the record id too if the index allows duplicate keys
+  static KeyType MakeKey(const Tuple &key, RID rid);
+
   // comparator for key
   KeyComparator comparator_;
+  // buffer pool of the tree
+  BufferPoolManager *buffer_pool_manager_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
 };
 
+/**
+ * Create a B+ tree index whose key type is chosen for its key schema: IntegerKey for a single integer column, the
+ * smallest GenericKey that holds the key otherwise. An index without unique keys takes a PostingKey of that type.
+ */
+std::unique_ptr<Index> CreateBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                            BufferPoolManager *buffer_pool_manager, bool unique_keys = true);
+
 }  // namespace bustub
@@ -99,6 +99,10 @@ class GenericComparator {
   // constructor
   explicit GenericComparator(Schema *key_schema) : key_schema_(key_schema) {}
 
+  // Whether the trailing bytes of a key may be zeroed, as the B+ tree does for its separators. That is the case unless
+  // a column is stored out of line, behind an offset that a zeroed byte would change.
+  inline bool CanTruncateKeys() const { return key_schema_->IsInlined(); }
+
  private:
   Schema *key_schema_;
 };
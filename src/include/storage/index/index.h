@@ -12,6 +12,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <utility>
@@ -159,6 +160,20 @@ class Index {
    */
   virtual void InsertEntry(const Tuple &key, RID rid, Transaction *transaction) = 0;
 
+  /**
+   * Insert many entries, e.g. to fill a new index with the tuples of its table. Indexes that can build their structure
+   * faster from all entries at once than one entry at a time override this.
+   * @param next_entry Returns the next key and its RID, or false once there are no more entries
+   * @param transaction The transaction context
+   */
+  virtual void InsertEntries(const std::function<bool(Tuple *key, RID *rid)> &next_entry, Transaction *transaction) {
+    Tuple key;
+    RID rid;
+    while (next_entry(&key, &rid)) {
+      InsertEntry(key, rid, transaction);
+    }
+  }
+
   /**
    * Delete an index entry by key.
    * @param key The index key
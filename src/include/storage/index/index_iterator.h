@@ -13,31 +13,84 @@
  * For range scan of b+ tree
  */
 #pragma once
+#include <vector>
+
+#include "buffer/read_ahead.h"
 #include "storage/page/b_plus_tree_leaf_page.h"
 
 namespace bustub {
 
 #define INDEXITERATOR_TYPE IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS
+class BPlusTree;
+
+/**
+ * Iterator over the leaf chain of a BPlusTree.
+ *
+ * Leaves are read optimistically, like every other read of the tree: the iterator copies the entries of the current
+ * leaf and keeps it pinned, but not latched, so writers are never blocked by a scan. Moving to the next leaf validates
+ * the version of the current one, which proves that the next page id is still its right sibling. If a writer changed
+ * the current leaf meanwhile, the iterator looks up the last key it returned in the tree again instead, or the key it
+ * was started from if it has not returned one yet.
+ *
+ * A long scan prefetches the leaves ahead of it, as listed by the internal pages above the current leaf.
+ */
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
+  using Tree = BPlusTree<KeyType, ValueType, KeyComparator>;
+  using LeafPage = BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>;
+  friend Tree;
+
  public:
-  // you may define your own constructor based on your member variables
+  /** Creates the end iterator. */
   IndexIterator();
   ~IndexIterator();
 
+  DISALLOW_COPY(IndexIterator);
+  IndexIterator(IndexIterator &&other) noexcept;
+  IndexIterator &operator=(IndexIterator &&other) noexcept;
+
   bool IsEnd();
 
   const MappingType &operator*();
 
   IndexIterator &operator++();
 
-  bool operator==(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator==(const IndexIterator &itr) const { return page_ == itr.page_ && index_ == itr.index_; }
 
-  bool operator!=(const IndexIterator &itr) const { throw std::runtime_error("unimplemented"); }
+  bool operator!=(const IndexIterator &itr) const { return !(*this == itr); }
 
  private:
-  // add your own private member variables here
+  IndexIterator(Tree *tree, BufferPoolManager *buffer_pool_manager);
+
+  /** Position the iterator at the first key of the tree (left_most), the first key >= key, or the first key > key. */
+  void Seek(const KeyType &key, bool inclusive, bool left_most);
+
+  /** Make the leaf the current one if its entries can be copied at version. Unpins the leaf otherwise. */
+  bool Load(Page *page, uint64_t version);
+
+  /** Move on through the leaf chain while the current leaf has no entries left. */
+  void SkipExhaustedLeaves();
+
+  /** Unpin the current leaf and become the end iterator. */
+  void Release();
+
+  Tree *tree_{nullptr};
+  BufferPoolManager *buffer_pool_manager_{nullptr};
+  /** The pinned current leaf, nullptr at the end. */
+  Page *page_{nullptr};
+  /** The version the entries were copied at. */
+  uint64_t version_{0};
+  /** The entries of the current leaf from the first one in range. */
+  std::vector<MappingType> entries_;
+  page_id_t next_page_id_{INVALID_PAGE_ID};
+  size_t index_{0};
+  /** Where to seek again if a writer changes the current leaf: after the last key returned, or from the start key. */
+  KeyType resume_key_{};
+  bool resume_inclusive_{true};
+  bool resume_left_most_{true};
+  ReadAhead read_ahead_{nullptr, {}};
 };
 
 }  // namespace bustub
@@ -0,0 +1,184 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// integer_key.h
+//
+// Identification: src/include/storage/index/integer_key.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#if defined(__AVX2__) || defined(__SSE4_2__)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <ostream>
+
+#include "catalog/schema.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * Key of an index on a single integer column (TINYINT, SMALLINT, INTEGER or BIGINT), widened to an int64_t so that
+ * keys compare as machine integers. B+ tree pages over these keys keep them in a contiguous array, apart from their
+ * values, and search it with vector comparisons (see IntegerKeyRank).
+ *
+ * NULLs are stored as the smallest value of their type, so they sort before every other key.
+ */
+class IntegerKey {
+ public:
+  /** The tuple holds the column alone, serialized in as many bytes as its type takes. */
+  inline void SetFromKey(const Tuple &tuple) {
+    switch (tuple.GetLength()) {
+      case sizeof(int8_t):
+        value_ = *reinterpret_cast<const int8_t *>(tuple.GetData());
+        break;
+      case sizeof(int16_t):
+        value_ = *reinterpret_cast<const int16_t *>(tuple.GetData());
+        break;
+      case sizeof(int32_t):
+        value_ = *reinterpret_cast<const int32_t *>(tuple.GetData());
+        break;
+      default:
+        memcpy(&value_, tuple.GetData(), sizeof(int64_t));
+        break;
+    }
+  }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) { value_ = key; }
+
+  // NOTE: for test purpose only
+  inline int64_t ToString() const { return value_; }
+
+  // NOTE: for test purpose only
+  friend std::ostream &operator<<(std::ostream &os, const IntegerKey &key) {
+    os << key.value_;
+    return os;
+  }
+
+  int64_t value_;
+};
+
+/**
+ * Function object that compares two integer keys, for trees over them.
+ */
+class IntegerComparator {
+ public:
+  inline int operator()(const IntegerKey &lhs, const IntegerKey &rhs) const {
+    return static_cast<int>(lhs.value_ > rhs.value_) - static_cast<int>(lhs.value_ < rhs.value_);
+  }
+
+  // The key schema is only taken to be constructed like GenericComparator.
+  explicit IntegerComparator(Schema *key_schema = nullptr) {}
+
+  // The B+ tree keeps integer keys whole, in pages of fixed-size entries.
+  inline bool CanTruncateKeys() const { return false; }
+
+  /** @return true if an index over the key schema can use integer keys: it has a single integer column */
+  static bool SupportsKeySchema(const Schema &key_schema) {
+    if (key_schema.GetColumnCount() != 1) {
+      return false;
+    }
+    switch (key_schema.GetColumn(0).GetType()) {
+      case TypeId::TINYINT:
+      case TypeId::SMALLINT:
+      case TypeId::INTEGER:
+      case TypeId::BIGINT:
+        return true;
+      default:
+        return false;
+    }
+  }
+};
+
+/** Keys in the block a search ends in, which are compared all at once. */
+static constexpr int INTEGER_SEARCH_BLOCK = 16;
+
+/**
+ * Count the keys in the block that are less than key, or less than or equal to key if OrEqual, a vector of keys at a
+ * time where the target has 64-bit vector comparisons.
+ */
+template <bool OrEqual>
+inline int IntegerKeyBlockRank(const int64_t *keys, int size, int64_t key) {
+  int rank = 0;
+  int i = 0;
+#if defined(__AVX2__)
+  __m256i target = _mm256_set1_epi64x(key);
+  for (; i + 4 <= size; i += 4) {
+    __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(keys + i));
+    // Lanes with a key greater than the target for <=, lanes with the target greater than the key for <.
+    __m256i bits = OrEqual ? _mm256_cmpgt_epi64(block, target) : _mm256_cmpgt_epi64(target, block);
+    int count = __builtin_popcount(_mm256_movemask_pd(_mm256_castsi256_pd(bits)));
+    rank += OrEqual ? 4 - count : count;
+  }
+#elif defined(__SSE4_2__)
+  __m128i target = _mm_set1_epi64x(key);
+  for (; i + 2 <= size; i += 2) {
+    __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i *>(keys + i));
+    __m128i bits = OrEqual ? _mm_cmpgt_epi64(block, target) : _mm_cmpgt_epi64(target, block);
+    int count = __builtin_popcount(_mm_movemask_pd(_mm_castsi128_pd(bits)));
+    rank += OrEqual ? 2 - count : count;
+  }
+#endif
+  for (; i < size; i++) {
+    rank += static_cast<int>(OrEqual ? keys[i] <= key : keys[i] < key);
+  }
+  return rank;
+}
+
+/**
+ * Count the sorted keys that are less than key, or less than or equal to key if OrEqual; that is the position of key
+ * among them. Only the keys in [0, size) are read.
+ *
+ * A first probe interpolates the position of key between the first and the last key: keys spread evenly over their
+ * range, as sequential ids are, put key in the block around it, which settles the search. Otherwise the probe at
+ * least tells on which side of the block key lies. A binary search without branches, whose probes compile to
+ * conditional moves, narrows that side down to a block, and the block is compared all at once.
+ */
+template <bool OrEqual>
+inline int IntegerKeyRank(const int64_t *keys, int size, int64_t key) {
+  auto before = [key](int64_t other) { return OrEqual ? other <= key : other < key; };
+  const int64_t *base = keys;
+  int n = size;
+  if (n > INTEGER_SEARCH_BLOCK) {
+    if (!before(keys[0])) {
+      return 0;
+    }
+    if (before(keys[n - 1])) {
+      return n;
+    }
+    // The differences are taken as unsigned, so they do not overflow for keys far apart.
+    double share = static_cast<double>(static_cast<uint64_t>(key) - static_cast<uint64_t>(keys[0])) /
+                   static_cast<double>(static_cast<uint64_t>(keys[n - 1]) - static_cast<uint64_t>(keys[0]));
+    // Keys that a writer is changing under an optimistic reader may be out of order, and the share beyond 1.
+    int guess = static_cast<int>(std::min(share, 1.0) * (n - 1));
+    int begin = std::clamp(guess - INTEGER_SEARCH_BLOCK / 2, 1, n - INTEGER_SEARCH_BLOCK);
+    // keys[0] is before key and keys[n - 1] is not, so the position is in [1, n - 1].
+    if (!before(keys[begin - 1])) {
+      n = begin;
+    } else if (before(keys[begin + INTEGER_SEARCH_BLOCK - 1])) {
+      base = keys + begin + INTEGER_SEARCH_BLOCK;
+      n -= begin + INTEGER_SEARCH_BLOCK;
+    } else {
+      base = keys + begin;
+      n = INTEGER_SEARCH_BLOCK;
+    }
+  }
+  // The position is in [base, base + n].
+  while (n > INTEGER_SEARCH_BLOCK) {
+    int half = n / 2;
+    base = before(base[half - 1]) ? base + half : base;
+    n -= half;
+  }
+  return static_cast<int>(base - keys) + IntegerKeyBlockRank<OrEqual>(base, n, key);
+}
+
+}  // namespace bustub
@@ -0,0 +1,107 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// posting_key.h
+//
+// Identification: src/include/storage/index/posting_key.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <type_traits>
+
+#include "catalog/schema.h"
+#include "common/rid.h"
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/** The record id as an integer that orders record ids by page id, then slot, the order of posting lists. */
+inline uint64_t RidToInteger(const RID &rid) {
+  return static_cast<uint64_t>(static_cast<uint32_t>(rid.GetPageId())) << 32 | rid.GetSlotNum();
+}
+
+inline RID IntegerToRid(uint64_t rid) {
+  return RID(static_cast<page_id_t>(static_cast<uint32_t>(rid >> 32)), static_cast<uint32_t>(rid));
+}
+
+/**
+ * Key of an index that allows duplicate keys: the index key of a row followed by its record id, which tells apart the
+ * rows with equal index keys. A tree over these keys holds an entry per row, so it splits and merges pages as if keys
+ * were unique, but its leaf pages store the record ids of an index key as one posting list instead of repeating the
+ * key (see BPlusTreeLeafPage). The value of an entry is the record id of its key.
+ */
+template <typename KeyType>
+class PostingKey {
+ public:
+  /** The record id is the smallest one, so the key comes before every entry with the index key of the tuple. */
+  inline void SetFromKey(const Tuple &tuple) {
+    key_.SetFromKey(tuple);
+    rid_ = 0;
+  }
+
+  inline void SetRid(const RID &rid) { rid_ = RidToInteger(rid); }
+
+  inline RID GetRid() const { return IntegerToRid(rid_); }
+
+  // NOTE: for test purpose only
+  inline void SetFromInteger(int64_t key) {
+    key_.SetFromInteger(key);
+    rid_ = 0;
+  }
+
+  // NOTE: for test purpose only
+  inline int64_t ToString() const { return key_.ToString(); }
+
+  // NOTE: for test purpose only
+  friend std::ostream &operator<<(std::ostream &os, const PostingKey &key) {
+    os << key.key_ << "@" << (key.rid_ >> 32) << ":" << static_cast<uint32_t>(key.rid_);
+    return os;
+  }
+
+  KeyType key_;
+  /** The record id, as RidToInteger orders it. */
+  uint64_t rid_;
+};
+
+/**
+ * Function object that orders posting keys by their index keys, as the comparator of the index keys does, then by
+ * their record ids.
+ */
+template <typename KeyType, typename KeyComparator>
+class PostingComparator {
+ public:
+  inline int operator()(const PostingKey<KeyType> &lhs, const PostingKey<KeyType> &rhs) const {
+    int cmp = key_comparator_(lhs.key_, rhs.key_);
+    if (cmp != 0) {
+      return cmp;
+    }
+    return static_cast<int>(lhs.rid_ > rhs.rid_) - static_cast<int>(lhs.rid_ < rhs.rid_);
+  }
+
+  /** Compare the index keys alone. */
+  inline int CompareKeys(const KeyType &lhs, const KeyType &rhs) const { return key_comparator_(lhs, rhs); }
+
+  explicit PostingComparator(Schema *key_schema) : key_comparator_(key_schema) {}
+
+  // Zeroed trailing bytes are safe where they are for the index keys; the record id is an integer like any other.
+  inline bool CanTruncateKeys() const { return key_comparator_.CanTruncateKeys(); }
+
+ private:
+  KeyComparator key_comparator_;
+};
+
+/** Whether the key type is a PostingKey, i.e. the tree or index over it allows duplicate keys. */
+template <typename KeyType>
+struct IsPostingKey : std::false_type {};
+
+template <typename KeyType>
+struct IsPostingKey<PostingKey<KeyType>> : std::true_type {};
+
+}  // namespace bustub
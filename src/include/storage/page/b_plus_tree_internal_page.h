@@ -11,14 +11,21 @@
 #pragma once
 
 #include <queue>
+#include <vector>
 
+#include "storage/index/integer_key.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_INTERNAL_PAGE_TYPE BPlusTreeInternalPage<KeyType, ValueType, KeyComparator>
-#define INTERNAL_PAGE_HEADER_SIZE 24
-#define INTERNAL_PAGE_SIZE ((PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE) / (sizeof(MappingType)))
+#define INTERNAL_PAGE_HEADER_SIZE 28
+// bytes left for slots and keys after the header
+#define INTERNAL_PAGE_CAPACITY (PAGE_SIZE - INTERNAL_PAGE_HEADER_SIZE)
+// bytes of a slot: the offset and length of its key, and its child page id
+#define INTERNAL_PAGE_SLOT_SIZE (2 * sizeof(uint16_t) + sizeof(page_id_t))
+// the most children a page holds, when every key is empty
+#define INTERNAL_PAGE_SIZE (INTERNAL_PAGE_CAPACITY / INTERNAL_PAGE_SLOT_SIZE)
 /**
  * Store n indexed keys and n+1 child pointers (page_id) within internal page.
  * Pointer PAGE_ID(i) points to a subtree in which all keys K satisfy:
@@ -27,10 +34,21 @@ namespace bustub {
  * the first key always remains invalid. That is to say, any search/lookup
  * should ignore the first key.
  *
- * Internal page format (keys are stored in increasing order):
- *  --------------------------------------------------------------------------
- * | HEADER | KEY(1)+PAGE_ID(1) | KEY(2)+PAGE_ID(2) | ... | KEY(n)+PAGE_ID(n) |
- *  --------------------------------------------------------------------------
+ * A key only needs to separate its subtrees, so the tree picks short ones (see BPlusTree::Separator), whose trailing
+ * bytes are zero. Keys are stored without their trailing zero bytes: the slots at the front of the page hold the
+ * offset and length of their key along with the child page id, and the keys fill the page from its end.
+ *
+ * Internal page format (slots are stored in increasing key order):
+ *  --------------------------------------------------------------------------------------------
+ * | HEADER | SLOT(0) | SLOT(1) | ... | SLOT(n) | free space | KEY(n) | ... | KEY(1) | KEY(0) |
+ *  --------------------------------------------------------------------------------------------
+ *
+ *  Slot format (size in byte, 8 bytes in total):
+ *  ------------------------------------------
+ * | KeyOffset (2) | KeyLength (2) | PageId (4) |
+ *  ------------------------------------------
+ *
+ * Max size caps the number of children, but a page is usually full once its keys take all its space.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
@@ -43,24 +61,108 @@ class BPlusTreeInternalPage : public BPlusTreePage {
   int ValueIndex(const ValueType &value) const;
   ValueType ValueAt(int index) const;
 
+  // space accounting
+  bool HasRoomFor(const KeyType &key, double fill_factor = 1.0) const;
+  bool HasRoomToSetKeyAt(int index, const KeyType &key) const;
+  bool IsFull() const;
+  bool IsUnderflow() const;
+  bool MayUnderflowAfterRemove() const;
+  bool CanMergeFrom(const BPlusTreeInternalPage *other, const KeyType &middle_key) const;
+
+  ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  void Append(const KeyType &key, const ValueType &value);
+  void Remove(int index);
+  ValueType RemoveAndReturnOnlyChild();
+
+  // Split and Merge utility methods
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
+  void InsertAndMoveHalfTo(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value,
+                           BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+  void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                        BufferPoolManager *buffer_pool_manager);
+  void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
+                         BufferPoolManager *buffer_pool_manager);
+
+ private:
+  struct Slot {
+    uint16_t key_offset_;
+    uint16_t key_length_;
+    ValueType value_;
+  };
+
+  static size_t KeyLength(const KeyType &key);
+  int GetUsedSpace() const;
+  int GetFreeSpace() const;
+  void Reset();
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void WriteKey(int index, const KeyType &key);
+  void EraseKey(int index);
+  void Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager);
+  uint16_t keys_begin_;
+  uint16_t unused_;
+  Slot slots_[0];
+};
+
+#define INTEGER_INTERNAL_PAGE_HEADER_SIZE 24
+// the most children an internal page of integer keys holds
+#define INTEGER_INTERNAL_PAGE_SIZE \
+  ((PAGE_SIZE - INTEGER_INTERNAL_PAGE_HEADER_SIZE) / (sizeof(int64_t) + sizeof(page_id_t)))
+
+/**
+ * Internal page of integer keys. Like in the leaves, the keys are stored apart from the child pointers, in an array of
+ * their own, so that a lookup reads only keys and compares several at once (see IntegerKeyRank). The max size is
+ * capped to the children that fit the page.
+ *
+ * Internal page format:
+ *  ---------------------------------------------------------------------------------------
+ * | HEADER | KEY(0) | KEY(1) | ... | KEY(n) | PAGE_ID(0) | PAGE_ID(1) | ... | PAGE_ID(n) |
+ *  ---------------------------------------------------------------------------------------
+ */
+template <>
+class BPlusTreeInternalPage<IntegerKey, page_id_t, IntegerComparator> : public BPlusTreePage {
+  using KeyType = IntegerKey;
+  using ValueType = page_id_t;
+  using KeyComparator = IntegerComparator;
+
+ public:
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = INTEGER_INTERNAL_PAGE_SIZE);
+
+  KeyType KeyAt(int index) const;
+  void SetKeyAt(int index, const KeyType &key);
+  int ValueIndex(const ValueType &value) const;
+  ValueType ValueAt(int index) const;
+
+  // space accounting
+  bool HasRoomFor(const KeyType &key, double fill_factor = 1.0) const;
+  bool HasRoomToSetKeyAt(int index, const KeyType &key) const;
+  bool IsFull() const;
+  bool IsUnderflow() const;
+  bool MayUnderflowAfterRemove() const;
+  bool CanMergeFrom(const BPlusTreeInternalPage *other, const KeyType &middle_key) const;
+
   ValueType Lookup(const KeyType &key, const KeyComparator &comparator) const;
   void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
   int InsertNodeAfter(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value);
+  void Append(const KeyType &key, const ValueType &value);
   void Remove(int index);
   ValueType RemoveAndReturnOnlyChild();
 
   // Split and Merge utility methods
   void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key, BufferPoolManager *buffer_pool_manager);
-  void MoveHalfTo(BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+  void InsertAndMoveHalfTo(const ValueType &old_value, const KeyType &new_key, const ValueType &new_value,
+                           BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                         BufferPoolManager *buffer_pool_manager);
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
                          BufferPoolManager *buffer_pool_manager);
 
  private:
-  void CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager);
-  void CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  void CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager);
-  MappingType array_[0];
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void MoveRangeTo(int begin, BPlusTreeInternalPage *recipient, BufferPoolManager *buffer_pool_manager);
+  void Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager);
+  int64_t keys_[INTEGER_INTERNAL_PAGE_SIZE];
+  page_id_t values_[INTEGER_INTERNAL_PAGE_SIZE];
 };
 }  // namespace bustub
@@ -13,31 +13,51 @@
 #include <utility>
 #include <vector>
 
+#include "common/rid.h"
+#include "storage/index/integer_key.h"
+#include "storage/index/posting_key.h"
 #include "storage/page/b_plus_tree_page.h"
 
 namespace bustub {
 
 #define B_PLUS_TREE_LEAF_PAGE_TYPE BPlusTreeLeafPage<KeyType, ValueType, KeyComparator>
-#define LEAF_PAGE_HEADER_SIZE 28
-#define LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / sizeof(MappingType))
+#define LEAF_PAGE_HEADER_SIZE 32
+// bytes of the bitmap that marks which bytes of a key an entry stores
+#define LEAF_KEY_MASK_SIZE ((sizeof(KeyType) + 7) / 8)
+// bytes left for slots and entries after the header and the base key
+#define LEAF_PAGE_CAPACITY (PAGE_SIZE - LEAF_PAGE_HEADER_SIZE - sizeof(KeyType))
+// the most entries a page holds, when every key equals the base key
+#define LEAF_PAGE_SIZE (LEAF_PAGE_CAPACITY / (sizeof(uint16_t) + LEAF_KEY_MASK_SIZE + sizeof(ValueType)))
 
 /**
  * Store indexed key and record id(record id = page id combined with slot id,
  * see include/common/rid.h for detailed implementation) together within leaf
  * page. Only support unique key.
  *
- * Leaf page format (keys are stored in order):
- *  ----------------------------------------------------------------------
- * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
- *  ----------------------------------------------------------------------
+ * Keys are prefix compressed against the base key of the page, the first key it got while empty. Neighbouring keys
+ * share most of their bytes, wherever the columns put them, so an entry stores a bitmap of the bytes where its key
+ * differs from the base key and only those bytes, followed by the record id. Entries vary in length: the slots at the
+ * front of the page hold the offsets of the entries in key order, and the entries fill the page from its end.
  *
- *  Header format (size in byte, 28 bytes in total):
+ * Leaf page format:
+ *  ----------------------------------------------------------------------------------------
+ * | HEADER | BASE KEY | SLOT(1) | SLOT(2) | ... | SLOT(n) | free space | entries in any order |
+ *  ----------------------------------------------------------------------------------------
+ *
+ *  Entry format:
+ *  ---------------------------------------------------------------
+ * | MASK (LEAF_KEY_MASK_SIZE) | bytes that differ | RID |
+ *  ---------------------------------------------------------------
+ *
+ *  Header format (size in byte, 32 bytes in total):
  *  ---------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  *  ---------------------------------------------------------------------
- *  -----------------------------------------------
- * | ParentPageId (4) | PageId (4) | NextPageId (4)
- *  -----------------------------------------------
+ *  -----------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | EntriesBegin (2) | (2)
+ *  -----------------------------------------------------------------------
+ *
+ * Max size caps the number of entries, but a page is usually full once its entries take all its space.
  */
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeLeafPage : public BPlusTreePage {
@@ -50,24 +70,223 @@ class BPlusTreeLeafPage : public BPlusTreePage {
   void SetNextPageId(page_id_t next_page_id);
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
-  const MappingType &GetItem(int index);
+  MappingType GetItem(int index) const;
+  void GetItems(std::vector<MappingType> *items) const;
+
+  // space accounting
+  bool HasRoomFor(const KeyType &key, double fill_factor = 1.0) const;
+  bool IsFull() const;
+  bool IsUnderflow() const;
+  bool MayUnderflowAfterRemove() const;
+  bool CanMergeFrom(const BPlusTreeLeafPage *other) const;
+
+  // insert and delete methods
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  void Append(const MappingType &item);
+  bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+
+  // Split and Merge utility methods
+  void InsertAndMoveHalfTo(const KeyType &key, const ValueType &value, BPlusTreeLeafPage *recipient,
+                           const KeyComparator &comparator);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  // the max size trees give their leaf pages unless told otherwise
+  static constexpr int MAX_SIZE = LEAF_PAGE_SIZE;
+
+ private:
+  static size_t EntrySize(const KeyType &key, const KeyType &base_key);
+  static size_t EntriesSize(const std::vector<MappingType> &items, size_t begin, size_t end, const KeyType &base_key);
+  static size_t EntrySize(const char *entry);
+  const char *Entry(int index) const;
+  KeyType EntryKey(const char *entry) const;
+  ValueType EntryValue(const char *entry) const;
+  int GetUsedSpace() const;
+  void Reset(const KeyType &base_key);
+  void Fill(const std::vector<MappingType> &items, size_t begin, size_t end, const KeyType &base_key);
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+  page_id_t next_page_id_;
+  uint16_t entries_begin_;
+  uint16_t unused_;
+  KeyType base_key_;
+  uint16_t slots_[0];
+};
+
+// the most entries a leaf page of integer keys holds
+#define INTEGER_LEAF_PAGE_SIZE ((PAGE_SIZE - LEAF_PAGE_HEADER_SIZE) / (sizeof(int64_t) + sizeof(RID)))
+
+/**
+ * Leaf page of integer keys. The keys are stored apart from the record ids, in an array of their own, so that a search
+ * reads only keys and compares several at once (see IntegerKeyRank). Entries take a fixed size, so only the max size
+ * limits them; it is capped so that the max size - 1 entries of a full page fit.
+ *
+ * Leaf page format:
+ *  -----------------------------------------------------------------
+ * | HEADER | KEY(1) | KEY(2) | ... | KEY(n) | RID(1) | ... | RID(n) |
+ *  -----------------------------------------------------------------
+ *
+ *  Header format (size in byte, 32 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  ---------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | (4)
+ *  ---------------------------------------------------
+ */
+template <>
+class BPlusTreeLeafPage<IntegerKey, RID, IntegerComparator> : public BPlusTreePage {
+  using KeyType = IntegerKey;
+  using ValueType = RID;
+  using KeyComparator = IntegerComparator;
+
+ public:
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = MAX_SIZE);
+  // helper methods
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  KeyType KeyAt(int index) const;
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  MappingType GetItem(int index) const;
+  void GetItems(std::vector<MappingType> *items) const;
+
+  // space accounting
+  bool HasRoomFor(const KeyType &key, double fill_factor = 1.0) const;
+  bool IsFull() const;
+  bool IsUnderflow() const;
+  bool MayUnderflowAfterRemove() const;
+  bool CanMergeFrom(const BPlusTreeLeafPage *other) const;
 
   // insert and delete methods
   int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  void Append(const MappingType &item);
   bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
   int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
 
   // Split and Merge utility methods
-  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void InsertAndMoveHalfTo(const KeyType &key, const ValueType &value, BPlusTreeLeafPage *recipient,
+                           const KeyComparator &comparator);
   void MoveAllTo(BPlusTreeLeafPage *recipient);
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
   void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
 
+  static constexpr int MAX_SIZE = INTEGER_LEAF_PAGE_SIZE + 1;
+
+ private:
+  int GetClampedSize() const;
+  void InsertAt(int index, const KeyType &key, const ValueType &value);
+  void RemoveAt(int index);
+  void MoveRangeTo(int begin, BPlusTreeLeafPage *recipient);
+  page_id_t next_page_id_;
+  uint32_t unused_;
+  int64_t keys_[INTEGER_LEAF_PAGE_SIZE];
+  RID values_[INTEGER_LEAF_PAGE_SIZE];
+};
+
+#define POSTING_LEAF_PAGE_TYPE \
+  BPlusTreeLeafPage<PostingKey<IndexKey>, RID, PostingComparator<IndexKey, IndexComparator>>
+#define POSTING_LEAF_PAGE_HEADER_SIZE 40
+// bytes left for runs after the header
+#define POSTING_LEAF_PAGE_CAPACITY (PAGE_SIZE - POSTING_LEAF_PAGE_HEADER_SIZE)
+// the most entries a leaf page of posting lists holds: a record id takes at least two bytes
+#define POSTING_LEAF_PAGE_SIZE (POSTING_LEAF_PAGE_CAPACITY / 2)
+
+/**
+ * Leaf page of a tree with duplicate keys (see PostingKey). Entries with equal index keys form runs: a run stores the
+ * index key once, followed by the posting list of the record ids of its entries, sorted and delta encoded. A record id
+ * takes a varint of the difference of its page id from the one before, followed by a varint of its slot, or of the
+ * difference of its slot if the page id is the same; the first one in a run follows page 0, slot 0. Rows with equal
+ * keys that are stored close together thus take two bytes each. Runs are packed in key order from the header on, so
+ * adding a record id after the last one only writes at the end of the runs. The entries of an index key may span
+ * several runs and pages. Runs are only merged when their index keys compare equal, or have the same bytes where no
+ * comparator is at hand, so each run keeps the bytes of the first key that started it.
+ *
+ * The page holds as many entries as the tree sees, one per record id, so it splits, merges and moves entries one at a
+ * time like the other leaf pages; only the max size counts entries, and a page is full once its runs take all its
+ * space. Positions within a run are found by decoding the run up to them.
+ *
+ * Leaf page format:
+ *  ------------------------------------------------------
+ * | HEADER | RUN(1) | RUN(2) | ... | RUN(k) | free space |
+ *  ------------------------------------------------------
+ *
+ *  Run format:
+ *  ----------------------------------------------------------------------------
+ * | INDEX KEY | Count (2) | Length (2) | RECORD ID(1) | ... | RECORD ID(Count) |
+ *  ----------------------------------------------------------------------------
+ *
+ *  Header format (size in byte, 40 bytes in total):
+ *  ---------------------------------------------------------------------
+ * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
+ *  ---------------------------------------------------------------------
+ *  --------------------------------------------------------------------------------------------
+ * | ParentPageId (4) | PageId (4) | NextPageId (4) | RunsEnd (2) | LastRun (2) | LastRecordId (8) |
+ *  --------------------------------------------------------------------------------------------
+ */
+template <typename IndexKey, typename IndexComparator>
+class BPlusTreeLeafPage<PostingKey<IndexKey>, RID, PostingComparator<IndexKey, IndexComparator>>
+    : public BPlusTreePage {
+  using KeyType = PostingKey<IndexKey>;
+  using ValueType = RID;
+  using KeyComparator = PostingComparator<IndexKey, IndexComparator>;
+
+ public:
+  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID, int max_size = MAX_SIZE);
+  // helper methods
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+  KeyType KeyAt(int index) const;
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  MappingType GetItem(int index) const;
+  void GetItems(std::vector<MappingType> *items) const;
+  bool ScanKey(const KeyType &key, const KeyComparator &comparator, std::vector<ValueType> *result) const;
+
+  // space accounting
+  bool HasRoomFor(const KeyType &key, double fill_factor = 1.0) const;
+  bool IsFull() const;
+  bool IsUnderflow() const;
+  bool MayUnderflowAfterRemove() const;
+  bool CanMergeFrom(const BPlusTreeLeafPage *other) const;
+
+  // insert and delete methods
+  int Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator);
+  void Append(const MappingType &item);
+  bool Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const;
+  int RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator);
+
+  // Split and Merge utility methods
+  void InsertAndMoveHalfTo(const KeyType &key, const ValueType &value, BPlusTreeLeafPage *recipient,
+                           const KeyComparator &comparator);
+  void MoveAllTo(BPlusTreeLeafPage *recipient);
+  void MoveFirstToEndOf(BPlusTreeLeafPage *recipient);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient);
+
+  static constexpr int MAX_SIZE = POSTING_LEAF_PAGE_SIZE + 1;
+
  private:
-  void CopyNFrom(MappingType *items, int size);
-  void CopyLastFrom(const MappingType &item);
-  void CopyFirstFrom(const MappingType &item);
+  static size_t RunSize(const std::vector<uint64_t> &rids);
+  static size_t EntriesSize(const std::vector<MappingType> &items, size_t begin, size_t end);
+  int GetUsedSpace() const;
+  const char *RunsEnd() const;
+  int RunOffsets(uint16_t *offsets) const;
+  size_t RunSize(size_t offset) const;
+  IndexKey RunKey(size_t offset) const;
+  int RunCount(size_t offset) const;
+  uint64_t RunFirstRid(size_t offset) const;
+  void DecodeRun(size_t offset, std::vector<uint64_t> *rids) const;
+  int FindRun(const KeyType &key, const KeyComparator &comparator, const uint16_t *offsets, int runs) const;
+  int FindEntry(int index, const uint16_t *offsets, int runs, uint64_t *rid) const;
+  void Reset();
+  void Fill(const std::vector<MappingType> &items, size_t begin, size_t end);
+  void WriteRun(size_t offset, size_t old_size, const IndexKey &key, const std::vector<uint64_t> &rids);
+  bool InsertIntoRun(size_t offset, uint64_t rid);
+  void RemoveFromRun(size_t offset, int position);
   page_id_t next_page_id_;
-  MappingType array_[0];
+  uint16_t runs_end_;
+  uint16_t last_run_;
+  uint64_t last_rid_;
+  char runs_[0];
 };
 }  // namespace bustub
@@ -0,0 +1,126 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.h
+//
+// Identification: src/include/storage/page/free_space_map_page.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstdint>
+
+#include "common/config.h"
+
+namespace bustub {
+
+/**
+ * Free space map page of a table heap. It records, for up to MAX_ENTRIES table pages, how much free space each of
+ * them has, rounded down to a category of CATEGORY_SIZE bytes so that an entry takes one byte. The map pages of a
+ * table form a singly linked list; the first one, the root, also records the last map page and the last table page.
+ *
+ * Map page format (size in bytes):
+ * ------------------------------------------------------------------------------------------------------
+ * | NextPageId (4) | LastMapPageId (4) | LastTablePageId (4) | NumEntries (4) | MaxCategory (4) | ...
+ * ------------------------------------------------------------------------------------------------------
+ * -------------------------------------------------------------------------
+ * | TablePageId_1 (4) | ... | TablePageId_n (4) | Category_1 (1) | ... |
+ * -------------------------------------------------------------------------
+ */
+class FreeSpaceMapPage {
+ public:
+  /** Free space is recorded in multiples of this many bytes. */
+  static constexpr uint32_t CATEGORY_SIZE = PAGE_SIZE / 256;
+  /** The number of table pages a map page records. */
+  static constexpr uint32_t MAX_ENTRIES = (PAGE_SIZE - 5 * sizeof(uint32_t)) / (sizeof(page_id_t) + sizeof(uint8_t));
+
+  /**
+   * Initializes an empty map page.
+   * @param page_id the page id of this map page
+   */
+  void Init(page_id_t page_id);
+
+  /** @return the page id of the next map page */
+  page_id_t GetNextPageId() const { return next_page_id_; }
+
+  /** Sets the page id of the next map page. */
+  void SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+  /** @return the page id of the last map page, only maintained on the root */
+  page_id_t GetLastMapPageId() const { return last_map_page_id_; }
+
+  /** Sets the page id of the last map page. */
+  void SetLastMapPageId(page_id_t last_map_page_id) { last_map_page_id_ = last_map_page_id; }
+
+  /** @return the page id of the last table page, only maintained on the root */
+  page_id_t GetLastTablePageId() const { return last_table_page_id_; }
+
+  /** Sets the page id of the last table page. */
+  void SetLastTablePageId(page_id_t last_table_page_id) { last_table_page_id_ = last_table_page_id; }
+
+  /** @return true if no more table pages can be added */
+  bool IsFull() const { return num_entries_ == MAX_ENTRIES; }
+
+  /** @return the largest category of any entry */
+  uint32_t GetMaxCategory() const { return max_category_; }
+
+  /**
+   * Adds an entry. The page must not be full.
+   * @param table_page_id the table page
+   * @param free_space its free space
+   */
+  void AddEntry(page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Finds the entry by a linear search and updates it, rescanning the entries if it held the largest category.
+   * @param table_page_id the table page
+   * @param free_space its free space
+   * @return false if this map page has no entry for table_page_id
+   */
+  bool UpdateEntry(page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Searches the entries from the newest, unless MaxCategory already rules out this map page.
+   * @param space_needed the free space needed
+   * @return a table page with at least space_needed bytes free, INVALID_PAGE_ID if there is none
+   */
+  page_id_t FindTablePage(uint32_t space_needed) const;
+
+  /**
+   * @param table_page_id the table page
+   * @return the index of the entry of table_page_id, or -1 if this map page has none
+   */
+  int FindEntry(page_id_t table_page_id) const;
+
+  /** @return the number of entries */
+  uint32_t GetNumEntries() const { return num_entries_; }
+
+  /** @return the table page of the entry at index */
+  page_id_t GetTablePageId(uint32_t index) const { return table_page_ids_[index]; }
+
+  /** @return the category of free_space bytes, rounded down */
+  static uint32_t ToCategory(uint32_t free_space) { return free_space / CATEGORY_SIZE; }
+
+  /** @return the smallest category that guarantees space_needed bytes, i.e. rounded up */
+  static uint32_t ToRequiredCategory(uint32_t space_needed) {
+    return (space_needed + CATEGORY_SIZE - 1) / CATEGORY_SIZE;
+  }
+
+ private:
+  page_id_t next_page_id_;
+  page_id_t last_map_page_id_;
+  page_id_t last_table_page_id_;
+  uint32_t num_entries_;
+  uint32_t max_category_;
+  page_id_t table_page_ids_[MAX_ENTRIES];
+  uint8_t categories_[MAX_ENTRIES];
+};
+
+static_assert(sizeof(FreeSpaceMapPage) <= PAGE_SIZE);
+static_assert(PAGE_SIZE / FreeSpaceMapPage::CATEGORY_SIZE - 1 <= UINT8_MAX);
+
+}  // namespace bustub
@@ -12,10 +12,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cstring>
 #include <iostream>
 
 #include "common/config.h"
+#include "common/macros.h"
+#include "common/optimistic_latch.h"
 #include "common/rwlatch.h"
 
 namespace bustub {
@@ -24,17 +28,26 @@ namespace bustub {
  * Page is the basic unit of storage within the database system. Page provides a wrapper for actual data pages being
  * held in main memory. Page also contains book-keeping information that is used by the buffer pool manager, e.g.
  * pin count, dirty flag, page id, etc.
+ *
+ * The data is not stored inline. A page created on its own allocates it; the pages of a buffer pool point into the
+ * pool's FrameRegion, which keeps the frames contiguous and the book-keeping of all frames in a separate array.
  */
 class Page {
   // There is book-keeping information inside the page that should only be relevant to the buffer pool manager.
   friend class BufferPoolManagerInstance;
 
  public:
-  /** Constructor. Zeros out the page data. */
-  Page() { ResetMemory(); }
+  /** Constructor. Allocates zeroed page data. */
+  Page() : data_(new char[PAGE_SIZE]()), owns_data_(true) {}
 
-  /** Default destructor. */
-  ~Page() = default;
+  /** Destructor. */
+  ~Page() {
+    if (owns_data_) {
+      delete[] data_;
+    }
+  }
+
+  DISALLOW_COPY_AND_MOVE(Page);
 
   /** @return the actual data contained within this page */
   inline char *GetData() { return data_; }
@@ -43,7 +56,7 @@ class Page {
   inline page_id_t GetPageId() { return page_id_; }
 
   /** @return the pin count of this page */
-  inline int GetPinCount() { return pin_count_; }
+  inline int GetPinCount() { return std::max(pin_count_.load(), 0); }
 
   /** @return true if the page in memory has been modified from the page on disk, false otherwise */
   inline bool IsDirty() { return is_dirty_; }
@@ -60,6 +73,21 @@ class Page {
   /** Release the page read latch. */
   inline void RUnlatch() { rwlatch_.RUnlock(); }
 
+  /** @return the version of the page's optimistic latch, once no writer holds it */
+  inline uint64_t ReadVersion() const { return version_latch_.ReadVersion(); }
+
+  /** @return true if the page's optimistic latch is still at version */
+  inline bool ValidateVersion(uint64_t version) const { return version_latch_.Validate(version); }
+
+  /** Acquire the page's optimistic latch exclusively if it is still at version. */
+  inline bool TryUpgradeVersion(uint64_t version) { return version_latch_.TryUpgrade(version); }
+
+  /** Acquire the page's optimistic latch exclusively. */
+  inline void VersionWLatch() { version_latch_.WLock(); }
+
+  /** Release the page's optimistic latch. */
+  inline void VersionWUnlatch() { version_latch_.WUnlock(); }
+
   /** @return the page LSN. */
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + OFFSET_LSN); }
 
@@ -75,19 +103,29 @@ class Page {
   static constexpr size_t OFFSET_LSN = 4;
 
  private:
+  /** Creates a page whose data lives in memory owned by someone else, e.g. a buffer pool frame. */
+  explicit Page(char *data) : data_(data) {}
+
   /** Zeroes out the data that is held within the page. */
   inline void ResetMemory() { memset(data_, OFFSET_PAGE_START, PAGE_SIZE); }
 
-  /** The actual data that is stored within a page. */
-  char data_[PAGE_SIZE]{};
+  /** The actual data that is stored within a page, PAGE_SIZE bytes. */
+  char *data_;
+  /** True if data_ was allocated by this page. */
+  bool owns_data_{false};
   /** The ID of this page. */
-  page_id_t page_id_ = INVALID_PAGE_ID;
-  /** The pin count of this page. */
-  int pin_count_ = 0;
+  std::atomic<page_id_t> page_id_ = INVALID_PAGE_ID;
+  /**
+   * The pin count of this page. The buffer pool pins resident pages without holding a latch, so this also encodes
+   * frames that are owned by a single thread (negative values, see BufferPoolManagerInstance).
+   */
+  std::atomic<int> pin_count_ = 0;
   /** True if the page is dirty, i.e. it is different from its corresponding page on disk. */
-  bool is_dirty_ = false;
+  std::atomic<bool> is_dirty_ = false;
   /** Page latch. */
   ReaderWriterLatch rwlatch_;
+  /** Version latch for readers that do not block writers, see OptimisticLatch. It is not reset with the frame. */
+  OptimisticLatch version_latch_;
 };
 
 }  // namespace bustub
@@ -13,12 +13,14 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
 #include "recovery/log_manager.h"
 #include "storage/page/page.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 static constexpr uint64_t DELETE_MASK = (1U << (8 * sizeof(uint32_t) - 1));
 
@@ -36,13 +38,23 @@ namespace bustub {
  *  ----------------------------------------------------------------------------
  *  | PageId (4)| LSN (4)| PrevPageId (4)| NextPageId (4)| FreeSpacePointer(4) |
  *  ----------------------------------------------------------------------------
- *  ----------------------------------------------------------------
- *  | TupleCount (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
- *  ----------------------------------------------------------------
+ *  ------------------------------------------------------------------------------------------------------------
+ *  | TupleCount (4) | FormatVersion (4) | FreeSpaceMapPageId (4) | Tuple_1 offset (4) | Tuple_1 size (4) | ... |
+ *  ------------------------------------------------------------------------------------------------------------
+ *
+ *  FormatVersion is FORMAT_VERSION. FreeSpaceMapPageId is the free space map page that records the free space of this
+ *  page.
  *
  */
 class TablePage : public Page {
  public:
+  /**
+   * The format of this header, written by Init(). The second format added FormatVersion and FreeSpaceMapPageId. Pages
+   * of the first format hold the offset of their first tuple where FormatVersion is now, which is at most PAGE_SIZE,
+   * so they can never be mistaken for a later format.
+   */
+  static constexpr uint32_t FORMAT_VERSION = 0x54500002;
+
   /**
    * Initialize the TablePage header.
    * @param page_id the page ID of this table page
@@ -72,6 +84,33 @@ class TablePage : public Page {
     memcpy(GetData() + OFFSET_NEXT_PAGE_ID, &next_page_id, sizeof(page_id_t));
   }
 
+  /** @return the format version recorded in the header, see FORMAT_VERSION */
+  uint32_t GetFormatVersion() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FORMAT_VERSION); }
+
+  /** @return the page ID of the free space map page holding the entry of this page */
+  page_id_t GetFreeSpaceMapPageId() {
+    return *reinterpret_cast<page_id_t *>(GetData() + OFFSET_FREE_SPACE_MAP_PAGE_ID);
+  }
+
+  /** Set the page id of the free space map page holding the entry of this page. */
+  void SetFreeSpaceMapPageId(page_id_t map_page_id) {
+    memcpy(GetData() + OFFSET_FREE_SPACE_MAP_PAGE_ID, &map_page_id, sizeof(page_id_t));
+  }
+
+  /** @return the number of bytes between the slot array and the tuples */
+  uint32_t GetFreeSpaceRemaining() {
+    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
+  }
+
+  /** @return the free space a tuple of tuple_size bytes takes up, including its slot */
+  static uint32_t GetSpaceNeeded(uint32_t tuple_size) { return tuple_size + SIZE_TUPLE; }
+
+  /** @return the size of the largest tuple that fits into an empty page */
+  static uint32_t GetMaxTupleSize() { return PAGE_SIZE - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE; }
+
+  /** @return an upper bound on the number of slots of a page */
+  static constexpr uint32_t GetMaxTupleCount() { return (PAGE_SIZE - SIZE_TABLE_PAGE_HEADER) / SIZE_TUPLE; }
+
   /**
    * Insert a tuple into the table.
    * @param tuple tuple to insert
@@ -83,6 +122,20 @@ class TablePage : public Page {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager);
 
+  /**
+   * Insert as many tuples as fit into the table, in order, starting at tuples[first]. All of them are covered by a
+   * single log record.
+   * @param tuples tuples to insert
+   * @param first index of the first tuple to insert
+   * @param[out] rids the rids of the inserted tuples are appended here
+   * @param txn transaction performing the insert
+   * @param lock_manager the lock manager
+   * @param log_manager the log manager
+   * @return the number of tuples inserted, 0 if tuples[first] does not fit
+   */
+  uint32_t InsertTuples(const std::vector<Tuple> &tuples, uint32_t first, std::vector<RID> *rids, Transaction *txn,
+                        LockManager *lock_manager, LogManager *log_manager);
+
   /**
    * Mark a tuple as deleted. This does not actually delete the tuple.
    * @param rid rid of the tuple to mark as deleted
@@ -122,6 +175,16 @@ class TablePage : public Page {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager);
 
+  /**
+   * Read a tuple from a table in place, without copying it. The view is valid while the page stays pinned and latched.
+   * @param rid rid of the tuple to read
+   * @param[out] view the view of the tuple
+   * @param txn transaction performing the read
+   * @param lock_manager the lock manager
+   * @return true if the read is successful (i.e. the tuple exists)
+   */
+  bool GetTupleView(const RID &rid, TupleView *view, Transaction *txn, LockManager *lock_manager);
+
   /** @return the rid of the first tuple in this page */
 
   /**
@@ -137,17 +200,32 @@ class TablePage : public Page {
    */
   bool GetNextTupleRid(const RID &cur_rid, RID *next_rid);
 
+  /**
+   * Copies a fixed-width column of every live tuple into a dense array, without copying the tuples. Scans evaluate
+   * simple predicates on the array a vector of values at a time.
+   * @param column_offset the offset of the column in a tuple
+   * @param width the width of the column in bytes
+   * @param[out] slots the slot of every live tuple, at least GetMaxTupleCount() entries
+   * @param[out] values the column of every live tuple, width bytes each, at least GetMaxTupleCount() * width bytes
+   * @return the number of live tuples
+   */
+  uint32_t GatherColumn(uint32_t column_offset, uint32_t width, uint32_t *slots, char *values);
+
  private:
   static_assert(sizeof(page_id_t) == 4);
 
-  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 24;
+  static constexpr size_t SIZE_TABLE_PAGE_HEADER = 32;
   static constexpr size_t SIZE_TUPLE = 8;
   static constexpr size_t OFFSET_PREV_PAGE_ID = 8;
   static constexpr size_t OFFSET_NEXT_PAGE_ID = 12;
   static constexpr size_t OFFSET_FREE_SPACE = 16;
   static constexpr size_t OFFSET_TUPLE_COUNT = 20;
-  static constexpr size_t OFFSET_TUPLE_OFFSET = 24;  // Naming things is hard.
-  static constexpr size_t OFFSET_TUPLE_SIZE = 28;
+  static constexpr size_t OFFSET_FORMAT_VERSION = 24;
+  static constexpr size_t OFFSET_FREE_SPACE_MAP_PAGE_ID = 28;
+  static constexpr size_t OFFSET_TUPLE_OFFSET = 32;  // Naming things is hard.
+  static constexpr size_t OFFSET_TUPLE_SIZE = 36;
+
+  static_assert(FORMAT_VERSION > PAGE_SIZE);
 
   /** @return pointer to the end of the current free space, see header comment */
   uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
@@ -166,10 +244,6 @@ class TablePage : public Page {
   /** Set the number of tuples in this page. */
   void SetTupleCount(uint32_t tuple_count) { memcpy(GetData() + OFFSET_TUPLE_COUNT, &tuple_count, sizeof(uint32_t)); }
 
-  uint32_t GetFreeSpaceRemaining() {
-    return GetFreeSpacePointer() - SIZE_TABLE_PAGE_HEADER - SIZE_TUPLE * GetTupleCount();
-  }
-
   /** @return tuple offset at slot slot_num */
   uint32_t GetTupleOffsetAtSlot(uint32_t slot_num) {
     return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_TUPLE_OFFSET + SIZE_TUPLE * slot_num);
@@ -199,4 +273,19 @@ class TablePage : public Page {
   /** @return tuple size with the deleted flag unset */
   static uint32_t UnsetDeletedFlag(uint32_t tuple_size) { return static_cast<uint32_t>(tuple_size & (~DELETE_MASK)); }
 };
+
+/**
+ * SlotFilter picks the slots of a table page whose tuples a scan returns, looking at the tuples in place, so that the
+ * scan copies only the tuples it returns.
+ */
+class SlotFilter {
+ public:
+  virtual ~SlotFilter() = default;
+
+  /**
+   * @param page a table page, latched by the caller
+   * @param[out] slots the selected slots in increasing order, appended
+   */
+  virtual void Filter(TablePage *page, std::vector<uint32_t> *slots) const = 0;
+};
 }  // namespace bustub
@@ -0,0 +1,61 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_page_guard.h
+//
+// Identification: src/include/storage/page/table_page_guard.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/macros.h"
+#include "storage/page/table_page.h"
+
+namespace bustub {
+
+/**
+ * TablePageGuard pins a table page in the buffer pool and holds its read latch until it is released or destroyed, so
+ * that TupleViews of the page stay valid in the meantime. Do not hold a guard across calls that may write to the same
+ * table, such as returning from an executor's Next().
+ */
+class TablePageGuard {
+ public:
+  /** Creates a guard that holds no page. */
+  TablePageGuard() = default;
+
+  /**
+   * Fetches and read-latches a table page, and marks it referenced in the buffer pool.
+   * @param bpm the buffer pool of the table
+   * @param page_id the page to guard
+   */
+  TablePageGuard(BufferPoolManager *bpm, page_id_t page_id);
+
+  TablePageGuard(TablePageGuard &&other) noexcept;
+  TablePageGuard &operator=(TablePageGuard &&other) noexcept;
+  DISALLOW_COPY(TablePageGuard);
+
+  /** Releases the page, if any. */
+  ~TablePageGuard() { Release(); }
+
+  /** @return the guarded page, nullptr if the guard holds no page */
+  TablePage *GetPage() const { return page_; }
+
+  /** @return the id of the guarded page, INVALID_PAGE_ID if the guard holds no page */
+  page_id_t GetPageId() const { return page_ == nullptr ? INVALID_PAGE_ID : page_->GetTablePageId(); }
+
+  /** Unlatches and unpins the page, if any. */
+  void Release();
+
+ private:
+  /** The buffer pool the page was fetched from */
+  BufferPoolManager *bpm_{nullptr};
+  /** The guarded page, nullptr if none */
+  TablePage *page_{nullptr};
+};
+
+}  // namespace bustub
@@ -1,16 +1,18 @@
 #pragma once
 
+#include <vector>
+
 #include "storage/page/page.h"
 #include "storage/table/tmp_tuple.h"
 #include "storage/table/tuple.h"
 
 namespace bustub {
 
-// To pass the test cases for this class, you must follow the existing TmpTuplePage format and implement the
-// existing functions exactly as they are! It may be helpful to look at TablePage.
-// Remember that this task is optional, you get full credit if you finish the next task.
-
 /**
+ * TmpTuplePage holds tuples that an executor spills out of memory, e.g. the partitions of a Grace hash join. Tuples
+ * are appended from the end of the page towards the header and are never updated or deleted on their own; the whole
+ * page is deleted once it has been read back.
+ *
  * TmpTuplePage format:
  *
  * Sizes are in bytes.
@@ -20,14 +22,57 @@ namespace bustub {
  */
 class TmpTuplePage : public Page {
  public:
-  void Init(page_id_t page_id, uint32_t page_size) {}
+  /**
+   * Initializes an empty page.
+   * @param page_id the page ID of this page
+   * @param page_size the size of this page
+   */
+  void Init(page_id_t page_id, uint32_t page_size);
+
+  /** @return the page ID of this page */
+  page_id_t GetTablePageId() { return *reinterpret_cast<page_id_t *>(GetData()); }
+
+  /**
+   * Appends a tuple to the page.
+   * @param tuple the tuple to append
+   * @param[out] out where the tuple was stored
+   * @return false if the page does not have room for the tuple
+   */
+  bool Insert(const Tuple &tuple, TmpTuple *out);
 
-  page_id_t GetTablePageId() { return INVALID_PAGE_ID; }
+  /**
+   * Appends a record that was serialized without a schema. It is read back as a tuple whose data is the record.
+   * @param data the record
+   * @param size the size of the record in bytes
+   * @param[out] out where the record was stored
+   * @return false if the page does not have room for the record
+   */
+  bool Insert(const char *data, uint32_t size, TmpTuple *out);
 
-  bool Insert(const Tuple &tuple, TmpTuple *out) { return false; }
+  /**
+   * Reads a tuple back.
+   * @param tmp_tuple the location that Insert() returned
+   * @param[out] tuple the tuple
+   */
+  void Get(const TmpTuple &tmp_tuple, Tuple *tuple);
+
+  /**
+   * Reads every tuple on the page, the most recently inserted first.
+   * @param[out] tuples the vector to append the tuples to
+   */
+  void GetTuples(std::vector<Tuple> *tuples);
 
  private:
   static_assert(sizeof(page_id_t) == 4);
+
+  static constexpr size_t OFFSET_FREE_SPACE = 8;
+  static constexpr size_t SIZE_TMP_PAGE_HEADER = 12;
+
+  uint32_t GetFreeSpacePointer() { return *reinterpret_cast<uint32_t *>(GetData() + OFFSET_FREE_SPACE); }
+
+  void SetFreeSpacePointer(uint32_t free_space_pointer) {
+    memcpy(GetData() + OFFSET_FREE_SPACE, &free_space_pointer, sizeof(uint32_t));
+  }
 };
 
 }  // namespace bustub
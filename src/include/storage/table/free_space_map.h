@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.h
+//
+// Identification: src/include/storage/table/free_space_map.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "storage/page/free_space_map_page.h"
+
+namespace bustub {
+
+/**
+ * FreeSpaceMap tracks the free space of every page of a table heap in a list of FreeSpaceMapPages, so that an insert
+ * finds a page with room by reading map pages instead of table pages. It lives in the buffer pool like the table, so
+ * every TableHeap opened on the table shares it.
+ *
+ * Lookups are not constant time: a map page is searched entry by entry, up to MAX_ENTRIES of them. FindPage() skips
+ * the map pages whose largest free space is too small and usually stops at the first one it searches, and
+ * UpdatePage() searches the one map page that holds the entry, so an insert reads a handful of pages where walking
+ * the table read all of them.
+ *
+ * The map is a hint: it is updated after the table page is unlatched, so it may briefly be out of date, and a page
+ * it returns must be checked. Latches are only ever taken in the order root map page, last map page, table pages, and
+ * no table page latch is held while a map page is latched otherwise, so the map cannot deadlock with table accesses.
+ */
+class FreeSpaceMap {
+ public:
+  /**
+   * The callback of AppendPage(). It creates a table page after last_table_page_id, records map_page_id in its header
+   * and returns its id and free space, or INVALID_PAGE_ID if no page could be created.
+   */
+  using CreatePageFn =
+      std::function<page_id_t(page_id_t last_table_page_id, page_id_t map_page_id, uint32_t *free_space)>;
+
+  /**
+   * Opens the free space map with the given root page.
+   * @param buffer_pool_manager the buffer pool manager
+   * @param root_page_id the first map page
+   */
+  FreeSpaceMap(BufferPoolManager *buffer_pool_manager, page_id_t root_page_id)
+      : buffer_pool_manager_(buffer_pool_manager), root_page_id_(root_page_id), hint_page_id_(root_page_id) {}
+
+  /**
+   * Creates the free space map of a new table heap.
+   * @param buffer_pool_manager the buffer pool manager
+   * @param first_table_page_id the first page of the table
+   * @param free_space the free space of that page
+   * @return the root page id of the map, which also holds the entry of the first page
+   */
+  static page_id_t Create(BufferPoolManager *buffer_pool_manager, page_id_t first_table_page_id, uint32_t free_space);
+
+  /**
+   * Finds a table page with room, starting at the map page that last had some.
+   * @param space_needed the free space needed
+   * @return a table page that had at least space_needed bytes free, INVALID_PAGE_ID if there is none
+   */
+  page_id_t FindPage(uint32_t space_needed);
+
+  /**
+   * Records the free space of a table page.
+   * @param map_page_id the map page holding the entry of the table page
+   * @param table_page_id the table page
+   * @param free_space its free space
+   */
+  void UpdatePage(page_id_t map_page_id, page_id_t table_page_id, uint32_t free_space);
+
+  /**
+   * Appends a table page, created by create_page, and adds it to the map. Appends are serialized on the root page.
+   * @param create_page creates the table page
+   * @return false if create_page or the map failed to allocate a page
+   */
+  bool AppendPage(const CreatePageFn &create_page);
+
+  /**
+   * Lists the table pages that follow a page in the page chain. Pages are added to the map in the order they are
+   * appended to the chain, so the entries double as an index of the chain.
+   * @param table_page_id the page to list the successors of
+   * @param max_pages the maximum number of pages to list
+   * @param[out] page_ids the pages, in chain order
+   * @param[in,out] map_page_id the map page to look for table_page_id on first, INVALID_PAGE_ID to search from the
+   * root; set to the map page holding the last page listed, so that the next call can start there
+   */
+  void GetNextPages(page_id_t table_page_id, size_t max_pages, std::vector<page_id_t> *page_ids,
+                    page_id_t *map_page_id);
+
+ private:
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t root_page_id_;
+  /** The map page FindPage() starts at. */
+  std::atomic<page_id_t> hint_page_id_;
+};
+
+}  // namespace bustub
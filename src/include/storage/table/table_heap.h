@@ -12,17 +12,24 @@
 
 #pragma once
 
+#include <memory>
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
+#include "buffer/read_ahead.h"
 #include "recovery/log_manager.h"
 #include "storage/page/table_page.h"
+#include "storage/page/table_page_guard.h"
+#include "storage/table/free_space_map.h"
 #include "storage/table/table_iterator.h"
 #include "storage/table/tuple.h"
+#include "storage/table/tuple_view.h"
 
 namespace bustub {
 
 /**
  * TableHeap represents a physical table on disk.
- * This is just a doubly-linked list of pages.
+ * This is just a doubly-linked list of pages, plus a free space map that inserts use to find a page with room.
  */
 class TableHeap {
   friend class TableIterator;
@@ -51,7 +58,8 @@ class TableHeap {
             Transaction *txn);
 
   /**
-   * Insert a tuple into the table. If the tuple is too large (>= page_size), return false.
+   * Insert a tuple into a page the free space map has room on, or a new page at the end of the table. If the tuple is
+   * too large (>= page_size), return false.
    * @param tuple tuple to insert
    * @param[out] rid the rid of the inserted tuple
    * @param txn the transaction performing the insert
@@ -59,6 +67,16 @@ class TableHeap {
    */
   bool InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn);
 
+  /**
+   * Insert tuples into the table, filling each page with as many of them as fit under one latch acquisition. If a
+   * tuple is too large (>= page_size), nothing is inserted and false is returned.
+   * @param tuples tuples to insert
+   * @param[out] rids the rids of the inserted tuples are appended here, in the order of tuples
+   * @param txn the transaction performing the insert
+   * @return true iff all the tuples were inserted
+   */
+  bool InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn);
+
   /**
    * Mark the tuple as deleted. The actual delete will occur when ApplyDelete is called.
    * @param rid resource id of the tuple of delete
@@ -99,6 +117,71 @@ class TableHeap {
    */
   bool GetTuple(const RID &rid, Tuple *tuple, Transaction *txn);
 
+  /**
+   * Read every tuple on one page of the table, for scans that divide the table by page.
+   * @param page_id a page of this table
+   * @param[out] tuples the tuples on the page in slot order, appended
+   * @param txn transaction performing the read
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Read the tuples on one page of the table that a filter selects. Only the selected tuples are copied.
+   * @param page_id a page of this table
+   * @param filter picks the slots to read from the latched page
+   * @param[out] tuples the selected tuples in slot order, appended
+   * @param txn transaction performing the read
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t GetPageTuples(page_id_t page_id, const SlotFilter &filter, std::vector<Tuple> *tuples, Transaction *txn);
+
+  /**
+   * Read a tuple from the table in place. The guard is pointed at the page of the tuple unless it already holds it, so
+   * that lookups of several rids on the same page pin and latch it once.
+   * @param rid rid of the tuple to read
+   * @param guard holds the page of the tuple on return; the view is valid until it is released
+   * @param[out] view the view of the tuple
+   * @param txn transaction performing the read
+   * @return true if the read was successful (i.e. the tuple exists)
+   */
+  bool GetTupleView(const RID &rid, TablePageGuard *guard, TupleView *view, Transaction *txn);
+
+  /**
+   * Read every tuple on one page of the table in place.
+   * @param page_id a page of this table
+   * @param guard holds the page on return; the views are valid until it is released
+   * @param[out] views the tuples on the page in slot order, appended
+   * @param txn transaction performing the read
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t GetPageTupleViews(page_id_t page_id, TablePageGuard *guard, std::vector<TupleView> *views,
+                              Transaction *txn);
+
+  /**
+   * Read the tuples on one page of the table that a filter selects in place.
+   * @param page_id a page of this table
+   * @param filter picks the slots to read from the latched page
+   * @param guard holds the page on return; the views are valid until it is released
+   * @param[out] views the selected tuples in slot order, appended
+   * @param txn transaction performing the read
+   * @return the id of the next page of the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t GetPageTupleViews(page_id_t page_id, const SlotFilter &filter, TablePageGuard *guard,
+                              std::vector<TupleView> *views, Transaction *txn);
+
+  /**
+   * @param page_id a page of this table
+   * @return the id of the page that follows page_id in the table, INVALID_PAGE_ID after the last page
+   */
+  page_id_t GetNextPageId(page_id_t page_id);
+
+  /**
+   * @return a function listing the pages that follow a page of this table, for ReadAhead. It reads the free space
+   * map instead of the pages themselves, and remembers its place in the map between calls.
+   */
+  ReadAhead::NextPagesFn GetNextPagesFn();
+
   /** @return the begin iterator of this table */
   TableIterator Begin(Transaction *txn);
 
@@ -113,6 +196,7 @@ class TableHeap {
   LockManager *lock_manager_;
   LogManager *log_manager_;
   page_id_t first_page_id_{};
+  std::unique_ptr<FreeSpaceMap> free_space_map_;
 };
 
 }  // namespace bustub
@@ -0,0 +1,73 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view.h
+//
+// Identification: src/include/storage/table/tuple_view.h
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#pragma once
+
+#include <cstring>
+
+#include "storage/table/tuple.h"
+
+namespace bustub {
+
+/**
+ * TupleView refers to a tuple in place on a table page without copying it. It is valid only as long as the
+ * TablePageGuard that it was read through holds the page; a tuple that must outlive the guard is copied with
+ * Materialize().
+ */
+class TupleView {
+ public:
+  /** Creates an empty view. */
+  TupleView() = default;
+
+  /**
+   * Creates a view of a tuple in place.
+   * @param rid the rid of the tuple
+   * @param data the bytes of the tuple
+   * @param size the size of the tuple
+   */
+  TupleView(RID rid, const char *data, uint32_t size) {
+    tuple_.rid_ = rid;
+    tuple_.data_ = const_cast<char *>(data);
+    tuple_.size_ = size;
+  }
+
+  /** @return the tuple as a Tuple that does not own its data, for evaluating expressions on it in place */
+  const Tuple &AsTuple() const { return tuple_; }
+
+  /** @return the rid of the tuple */
+  RID GetRid() const { return tuple_.rid_; }
+
+  /** @return the bytes of the tuple */
+  const char *GetData() const { return tuple_.data_; }
+
+  /** @return the size of the tuple */
+  uint32_t GetLength() const { return tuple_.size_; }
+
+  /** @return the value of a column of the tuple */
+  Value GetValue(const Schema *schema, uint32_t column_idx) const { return tuple_.GetValue(schema, column_idx); }
+
+  /** @return a copy of the tuple that owns its data */
+  Tuple Materialize() const {
+    Tuple tuple(tuple_.rid_);
+    tuple.size_ = tuple_.size_;
+    tuple.data_ = new char[tuple.size_];
+    memcpy(tuple.data_, tuple_.data_, tuple.size_);
+    tuple.allocated_ = true;
+    return tuple;
+  }
+
+ private:
+  /** The tuple, not allocated, with its data on the page */
+  Tuple tuple_;
+};
+
+}  // namespace bustub
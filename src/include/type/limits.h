@@ -57,4 +57,28 @@ static constexpr uint32_t BUSTUB_TEXT_MAX_LEN = 1000000000;
 
 // Objects (i.e., VARCHAR) with length prefix of -1 are NULL
 static constexpr int OBJECTLENGTH_NULL = -1;
+
+/** @return the value that stands for NULL in a column stored as the machine type T */
+template <typename T>
+constexpr T NullOf();
+template <>
+constexpr int8_t NullOf<int8_t>() {
+  return BUSTUB_INT8_NULL;
+}
+template <>
+constexpr int16_t NullOf<int16_t>() {
+  return BUSTUB_INT16_NULL;
+}
+template <>
+constexpr int32_t NullOf<int32_t>() {
+  return BUSTUB_INT32_NULL;
+}
+template <>
+constexpr int64_t NullOf<int64_t>() {
+  return BUSTUB_INT64_NULL;
+}
+template <>
+constexpr double NullOf<double>() {
+  return BUSTUB_DECIMAL_NULL;
+}
 }  // namespace bustub
@@ -61,6 +61,8 @@ class Value {
 
   Value() : Value(TypeId::INVALID) {}
   Value(const Value &other);
+  // Takes over the variable-length data of other, which is left an invalid NULL
+  Value(Value &&other) noexcept;
   Value &operator=(Value other);
   ~Value();
   // NOLINTNEXTLINE
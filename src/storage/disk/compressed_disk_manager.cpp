@@ -0,0 +1,329 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager.cpp
+//
+// Identification: src/storage/disk/compressed_disk_manager.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/compressed_disk_manager.h"
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+#include "storage/disk/page_compressor.h"
+
+namespace bustub {
+
+namespace {
+
+/** The number of extent sizes, one per number of units up to a whole page. */
+constexpr size_t NUM_EXTENT_SIZES = PAGE_SIZE / COMPRESSED_EXTENT_UNIT + 1;
+
+/** Starts every .pmap file; bumped whenever its layout changes. */
+constexpr uint64_t PAGE_MAP_MAGIC = 0x70616d6270000002;
+
+/** A compressed page starts its extent with its compressed size. */
+using ExtentHeader = uint32_t;
+
+/** The largest compressed size worth storing: one that saves at least one unit, header included. */
+constexpr size_t MAX_COMPRESSED_SIZE = PAGE_SIZE - COMPRESSED_EXTENT_UNIT - sizeof(ExtentHeader);
+
+uint32_t RoundUpToUnit(uint32_t size) {
+  return (size + COMPRESSED_EXTENT_UNIT - 1) / COMPRESSED_EXTENT_UNIT * COMPRESSED_EXTENT_UNIT;
+}
+
+/** Writes size bytes to fd, retrying short writes. */
+bool WriteAll(int fd, const void *data, size_t size) {
+  const char *bytes = static_cast<const char *>(data);
+  while (size > 0) {
+    ssize_t written = write(fd, bytes, size);
+    if (written < 0 && errno == EINTR) {
+      continue;
+    }
+    if (written <= 0) {
+      return false;
+    }
+    bytes += written;
+    size -= static_cast<size_t>(written);
+  }
+  return true;
+}
+
+/** Fsyncs the directory holding file_name, which makes a rename within it durable. */
+bool SyncDirectory(const std::string &file_name) {
+  size_t slash = file_name.rfind('/');
+  std::string dir_name = slash == std::string::npos ? "." : file_name.substr(0, std::max<size_t>(slash, 1));
+  int fd = open(dir_name.c_str(), O_RDONLY | O_DIRECTORY);
+  if (fd < 0) {
+    return false;
+  }
+  bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+}
+
+}  // namespace
+
+CompressedDiskManager::CompressedDiskManager(const std::string &db_file, IOBackendType io_backend,
+                                             size_t io_queue_depth)
+    : DiskManager(db_file, io_backend, io_queue_depth), free_extents_(NUM_EXTENT_SIZES) {
+  map_name_ = db_file.substr(0, db_file.rfind('.')) + ".pmap";
+  LoadPageMap();
+  SavePageMap();
+  map_log_fd_ = open(map_name_.c_str(), O_WRONLY | O_APPEND);
+  if (map_log_fd_ < 0) {
+    throw Exception("can't open page map file");
+  }
+}
+
+CompressedDiskManager::~CompressedDiskManager() {
+  if (map_log_fd_ >= 0) {
+    close(map_log_fd_);
+  }
+}
+
+void CompressedDiskManager::ShutDown() {
+  {
+    std::scoped_lock map_latch(map_latch_);
+    if (map_log_fd_ >= 0) {
+      close(map_log_fd_);
+      map_log_fd_ = -1;
+    }
+  }
+  SavePageMap();
+  DiskManager::ShutDown();
+}
+
+void CompressedDiskManager::WritePage(page_id_t page_id, const char *page_data) { WritePages(page_id, page_data, 1); }
+
+void CompressedDiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  Extent extent{0, 0};
+  {
+    std::scoped_lock map_latch(map_latch_);
+    if (static_cast<size_t>(page_id) < page_map_.size()) {
+      extent = page_map_[page_id];
+    }
+  }
+  if (extent.capacity_ == 0) {
+    memset(page_data, 0, PAGE_SIZE);
+    return;
+  }
+  if (extent.capacity_ == PAGE_SIZE) {
+    ReadBytes(extent.offset_, page_data, PAGE_SIZE);
+    return;
+  }
+
+  char compressed[PAGE_SIZE];
+  ReadBytes(extent.offset_, compressed, extent.capacity_);
+  ExtentHeader size;
+  memcpy(&size, compressed, sizeof(size));
+  if (size > extent.capacity_ - sizeof(size) ||
+      PageCompressor::Decompress(compressed + sizeof(size), size, page_data, PAGE_SIZE) != PAGE_SIZE) {
+    throw Exception("corrupt compressed page " + std::to_string(page_id));
+  }
+}
+
+void CompressedDiskManager::WritePages(page_id_t first_page_id, const char *pages_data, size_t num_pages) {
+  // Only keep the compressed form of a page if it saves at least one unit. It goes out together with its size in one
+  // write.
+  std::vector<char> compressed(num_pages * PAGE_SIZE);
+  std::vector<const char *> bytes(num_pages);
+  std::vector<uint32_t> sizes(num_pages);
+  std::vector<Extent> extents(num_pages);
+  for (size_t i = 0; i < num_pages; i++) {
+    const char *page_data = pages_data + i * PAGE_SIZE;
+    char *out = &compressed[i * PAGE_SIZE];
+    auto size = static_cast<ExtentHeader>(
+        PageCompressor::Compress(page_data, PAGE_SIZE, out + sizeof(ExtentHeader), MAX_COMPRESSED_SIZE));
+    if (size == 0) {
+      bytes[i] = page_data;
+      sizes[i] = PAGE_SIZE;
+    } else {
+      memcpy(out, &size, sizeof(size));
+      bytes[i] = out;
+      sizes[i] = sizeof(size) + size;
+    }
+  }
+
+  {
+    std::scoped_lock map_latch(map_latch_);
+    for (size_t i = 0; i < num_pages; i++) {
+      uint32_t capacity = sizes[i] == PAGE_SIZE ? PAGE_SIZE : RoundUpToUnit(sizes[i]);
+      extents[i] = PlacePage(first_page_id + static_cast<page_id_t>(i), capacity);
+    }
+  }
+  for (size_t i = 0; i < num_pages; i++) {
+    WriteBytes(extents[i].offset_, bytes[i], sizes[i]);
+  }
+  std::scoped_lock map_latch(map_latch_);
+  CommitPages(first_page_id, extents);
+}
+
+std::future<void> CompressedDiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  WritePage(page_id, page_data);
+  std::promise<void> done;
+  done.set_value();
+  return done.get_future();
+}
+
+std::future<void> CompressedDiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  ReadPage(page_id, page_data);
+  std::promise<void> done;
+  done.set_value();
+  return done.get_future();
+}
+
+bool CompressedDiskManager::IsPageOnDisk(page_id_t page_id) {
+  std::scoped_lock map_latch(map_latch_);
+  return page_id >= 0 && static_cast<size_t>(page_id) < page_map_.size() && page_map_[page_id].capacity_ != 0;
+}
+
+uint64_t CompressedDiskManager::GetAllocatedBytes() {
+  std::scoped_lock map_latch(map_latch_);
+  return file_end_;
+}
+
+size_t CompressedDiskManager::GetNumCompressedPages() {
+  std::scoped_lock map_latch(map_latch_);
+  return std::count_if(page_map_.begin(), page_map_.end(),
+                       [](const Extent &extent) { return extent.capacity_ != 0 && extent.capacity_ != PAGE_SIZE; });
+}
+
+CompressedDiskManager::Extent CompressedDiskManager::PlacePage(page_id_t page_id, uint32_t capacity) {
+  Extent extent{0, 0};
+  if (static_cast<size_t>(page_id) < page_map_.size()) {
+    extent = page_map_[page_id];
+  }
+  // The capacity tells how a page is stored, so a page changing between compressed and uncompressed always moves.
+  bool fits = capacity == PAGE_SIZE ? extent.capacity_ == PAGE_SIZE
+                                    : extent.capacity_ >= capacity && extent.capacity_ < PAGE_SIZE;
+  if (!fits) {
+    auto &free = free_extents_[capacity / COMPRESSED_EXTENT_UNIT];
+    if (!free.empty()) {
+      extent.offset_ = free.back();
+      free.pop_back();
+    } else {
+      extent.offset_ = file_end_;
+      file_end_ += capacity;
+    }
+    extent.capacity_ = capacity;
+  }
+  return extent;
+}
+
+void CompressedDiskManager::CommitPages(page_id_t first_page_id, const std::vector<Extent> &extents) {
+  if (static_cast<size_t>(first_page_id) + extents.size() > page_map_.size()) {
+    page_map_.resize(first_page_id + extents.size(), Extent{0, 0});
+  }
+  std::vector<MapRecord> records;
+  for (size_t i = 0; i < extents.size(); i++) {
+    const Extent &old_extent = page_map_[first_page_id + i];
+    if (old_extent.offset_ != extents[i].offset_ || old_extent.capacity_ != extents[i].capacity_) {
+      records.push_back(MapRecord{first_page_id + i, extents[i]});
+    }
+  }
+
+  // The records must not reach the disk before the data they point at, so sync the data first, once for all of them.
+  // Until the records are on disk a crash leaves the pages in their old extents, which therefore cannot be handed out
+  // before.
+  bool durable = records.empty() ||
+                 (SyncBytes() && map_log_fd_ >= 0 &&
+                  WriteAll(map_log_fd_, records.data(), records.size() * sizeof(MapRecord)) && fsync(map_log_fd_) == 0);
+  if (!durable) {
+    LOG_DEBUG("could not append to the page map %s", map_name_.c_str());
+  }
+  for (const auto &record : records) {
+    Extent &extent = page_map_[record.page_id_];
+    if (durable && extent.capacity_ != 0 && extent.offset_ != record.extent_.offset_) {
+      free_extents_[extent.capacity_ / COMPRESSED_EXTENT_UNIT].push_back(extent.offset_);
+    }
+    extent = record.extent_;
+  }
+}
+
+void CompressedDiskManager::LoadPageMap() {
+  std::ifstream in(map_name_, std::ios::binary);
+  if (!in.is_open()) {
+    // Without a mapping table the pages of a non-empty database file cannot be found.
+    struct stat db_stat;
+    if (stat(GetFileName().c_str(), &db_stat) == 0 && db_stat.st_size > 0) {
+      throw Exception("page map " + map_name_ + " is missing");
+    }
+    return;
+  }
+  uint64_t magic = 0;
+  uint64_t num_pages = 0;
+  in.read(reinterpret_cast<char *>(&magic), sizeof(magic));
+  in.read(reinterpret_cast<char *>(&file_end_), sizeof(file_end_));
+  in.read(reinterpret_cast<char *>(&num_pages), sizeof(num_pages));
+  page_map_.resize(num_pages);
+  in.read(reinterpret_cast<char *>(page_map_.data()), num_pages * sizeof(Extent));
+  if (!in || magic != PAGE_MAP_MAGIC) {
+    // Leave the file alone, it may still be recovered by hand.
+    throw Exception("could not read the page map " + map_name_);
+  }
+
+  // Replay the changes appended since the table was saved. A torn record at the end was never acknowledged.
+  MapRecord record;
+  while (in.read(reinterpret_cast<char *>(&record), sizeof(record))) {
+    if (record.page_id_ >= page_map_.size()) {
+      page_map_.resize(record.page_id_ + 1, Extent{0, 0});
+    }
+    page_map_[record.page_id_] = record.extent_;
+    file_end_ = std::max(file_end_, record.extent_.offset_ + record.extent_.capacity_);
+  }
+
+  // Every gap between two extents in use becomes free extents of at most a page.
+  std::vector<Extent> used;
+  std::copy_if(page_map_.begin(), page_map_.end(), std::back_inserter(used),
+               [](const Extent &extent) { return extent.capacity_ != 0; });
+  std::sort(used.begin(), used.end(), [](const Extent &a, const Extent &b) { return a.offset_ < b.offset_; });
+  uint64_t gap_start = 0;
+  used.push_back(Extent{file_end_, 0});
+  for (const auto &extent : used) {
+    while (gap_start < extent.offset_) {
+      uint64_t capacity = std::min<uint64_t>(extent.offset_ - gap_start, PAGE_SIZE);
+      free_extents_[capacity / COMPRESSED_EXTENT_UNIT].push_back(gap_start);
+      gap_start += capacity;
+    }
+    gap_start = extent.offset_ + extent.capacity_;
+  }
+}
+
+void CompressedDiskManager::SavePageMap() {
+  std::scoped_lock map_latch(map_latch_);
+  // Write the table next to the old one and swap it in, so that a crash never leaves a half-written table behind.
+  std::string new_map_name = map_name_ + ".new";
+  int fd = open(new_map_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  uint64_t num_pages = page_map_.size();
+  bool written = fd >= 0 &&
+                 WriteAll(fd, &PAGE_MAP_MAGIC, sizeof(PAGE_MAP_MAGIC)) &&
+                 WriteAll(fd, &file_end_, sizeof(file_end_)) &&
+                 WriteAll(fd, &num_pages, sizeof(num_pages)) &&
+                 WriteAll(fd, page_map_.data(), num_pages * sizeof(Extent)) &&
+                 fsync(fd) == 0;
+  if (fd >= 0) {
+    close(fd);
+  }
+  if (!written || std::rename(new_map_name.c_str(), map_name_.c_str()) != 0 || !SyncDirectory(map_name_)) {
+    LOG_DEBUG("could not write the page map %s", map_name_.c_str());
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,307 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_io_backend.cpp
+//
+// Identification: src/storage/disk/disk_io_backend.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/disk_io_backend.h"
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <string>
+
+#include "common/exception.h"
+#include "common/logger.h"
+
+namespace bustub {
+
+namespace {
+
+std::exception_ptr MakeIOError(const char *what, int err) {
+  return std::make_exception_ptr(Exception(std::string(what) + ": " + strerror(err)));
+}
+
+}  // namespace
+
+std::unique_ptr<DiskIOBackend> DiskIOBackend::Create(IOBackendType type, int fd, size_t queue_depth) {
+  BUSTUB_ASSERT(type != IOBackendType::FSTREAM, "the fstream path does not use a backend");
+  queue_depth = std::max<size_t>(queue_depth, 1);
+  if (type == IOBackendType::IO_URING) {
+    auto backend = std::make_unique<IoUringIOBackend>(fd, queue_depth);
+    if (backend->IsValid()) {
+      return backend;
+    }
+    LOG_DEBUG("io_uring is not available, falling back to the thread pool backend");
+  }
+  return std::make_unique<ThreadPoolIOBackend>(fd, std::min<size_t>(queue_depth, 8));
+}
+
+/*****************************************************************************
+ * THREAD POOL
+ *****************************************************************************/
+
+ThreadPoolIOBackend::ThreadPoolIOBackend(int fd, size_t num_threads) : DiskIOBackend(fd) {
+  for (size_t i = 0; i < num_threads; i++) {
+    workers_.emplace_back(&ThreadPoolIOBackend::WorkerLoop, this);
+  }
+}
+
+ThreadPoolIOBackend::~ThreadPoolIOBackend() {
+  {
+    std::scoped_lock latch(latch_);
+    shutdown_ = true;
+  }
+  cv_.notify_all();
+  for (auto &worker : workers_) {
+    worker.join();
+  }
+}
+
+std::future<void> ThreadPoolIOBackend::SubmitRead(char *data, size_t size, size_t offset) {
+  return Enqueue(false, data, size, offset);
+}
+
+std::future<void> ThreadPoolIOBackend::SubmitWrite(const char *data, size_t size, size_t offset) {
+  return Enqueue(true, const_cast<char *>(data), size, offset);
+}
+
+std::future<void> ThreadPoolIOBackend::Enqueue(bool is_write, char *data, size_t size, size_t offset) {
+  std::future<void> future;
+  {
+    std::scoped_lock latch(latch_);
+    queue_.push_back(Request{is_write, data, size, offset, std::promise<void>()});
+    future = queue_.back().promise_.get_future();
+  }
+  cv_.notify_one();
+  return future;
+}
+
+void ThreadPoolIOBackend::WorkerLoop() {
+  while (true) {
+    Request request;
+    {
+      std::unique_lock latch(latch_);
+      cv_.wait(latch, [&] { return shutdown_ || !queue_.empty(); });
+      // Drain the queue before honoring a shutdown, outstanding futures must not be left broken.
+      if (queue_.empty()) {
+        return;
+      }
+      request = std::move(queue_.front());
+      queue_.pop_front();
+    }
+
+    size_t done = 0;
+    std::exception_ptr error;
+    while (done < request.size_) {
+      ssize_t ret = request.is_write_
+                        ? pwrite(fd_, request.data_ + done, request.size_ - done, request.offset_ + done)
+                        : pread(fd_, request.data_ + done, request.size_ - done, request.offset_ + done);
+      if (ret < 0) {
+        if (errno == EINTR) {
+          continue;
+        }
+        error = MakeIOError(request.is_write_ ? "pwrite failed" : "pread failed", errno);
+        break;
+      }
+      if (ret == 0) {
+        if (request.is_write_) {
+          error = MakeIOError("pwrite failed", EIO);
+        } else {
+          // End of file: the rest of the page was never written.
+          memset(request.data_ + done, 0, request.size_ - done);
+        }
+        break;
+      }
+      done += ret;
+    }
+    if (error) {
+      request.promise_.set_exception(error);
+    } else {
+      request.promise_.set_value();
+    }
+  }
+}
+
+/*****************************************************************************
+ * IO_URING
+ *****************************************************************************/
+
+IoUringIOBackend::IoUringIOBackend(int fd, size_t queue_depth) : DiskIOBackend(fd) {
+  io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = static_cast<int>(syscall(__NR_io_uring_setup, static_cast<unsigned>(queue_depth), &params));
+  if (ring_fd < 0) {
+    return;
+  }
+
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+  }
+  sq_ring_ =
+      mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring_ == MAP_FAILED) {
+    sq_ring_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+  if (single_mmap) {
+    cq_ring_ = sq_ring_;
+  } else {
+    cq_ring_ =
+        mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+  }
+  sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+  sqes_ = mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+  if (cq_ring_ == MAP_FAILED || sqes_ == MAP_FAILED) {
+    if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_) {
+      munmap(cq_ring_, cq_ring_size_);
+    }
+    if (sqes_ != MAP_FAILED) {
+      munmap(sqes_, sqes_size_);
+    }
+    munmap(sq_ring_, sq_ring_size_);
+    sq_ring_ = cq_ring_ = sqes_ = nullptr;
+    close(ring_fd);
+    return;
+  }
+
+  auto *sq = static_cast<char *>(sq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+  auto *cq = static_cast<char *>(cq_ring_);
+  cq_head_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+  cqes_ = cq + params.cq_off.cqes;
+
+  // The completion queue is at least as large as the submission queue, so capping the requests in flight at the
+  // submission queue size means completions can never overflow.
+  queue_depth_ = params.sq_entries;
+  ring_fd_ = ring_fd;
+  completion_thread_ = std::thread(&IoUringIOBackend::CompletionLoop, this);
+}
+
+IoUringIOBackend::~IoUringIOBackend() {
+  if (ring_fd_ < 0) {
+    return;
+  }
+  {
+    std::unique_lock latch(latch_);
+    cv_.wait(latch, [&] { return in_flight_ == 0; });
+    // A NOP without a request tells the completion thread to exit.
+    PushSqe(nullptr);
+  }
+  completion_thread_.join();
+  munmap(sqes_, sqes_size_);
+  if (cq_ring_ != sq_ring_) {
+    munmap(cq_ring_, cq_ring_size_);
+  }
+  munmap(sq_ring_, sq_ring_size_);
+  close(ring_fd_);
+}
+
+std::future<void> IoUringIOBackend::SubmitRead(char *data, size_t size, size_t offset) {
+  auto *request = new Request{false, data, size, offset, std::promise<void>()};
+  std::future<void> future = request->promise_.get_future();
+  std::unique_lock latch(latch_);
+  cv_.wait(latch, [&] { return in_flight_ < queue_depth_; });
+  in_flight_++;
+  PushSqe(request);
+  return future;
+}
+
+std::future<void> IoUringIOBackend::SubmitWrite(const char *data, size_t size, size_t offset) {
+  auto *request = new Request{true, const_cast<char *>(data), size, offset, std::promise<void>()};
+  std::future<void> future = request->promise_.get_future();
+  std::unique_lock latch(latch_);
+  cv_.wait(latch, [&] { return in_flight_ < queue_depth_; });
+  in_flight_++;
+  PushSqe(request);
+  return future;
+}
+
+void IoUringIOBackend::PushSqe(Request *request) {
+  // We are the only producer (latch_ is held), so the tail can be read without synchronization.
+  unsigned tail = *sq_tail_;
+  unsigned index = tail & *sq_mask_;
+  auto *sqe = static_cast<io_uring_sqe *>(sqes_) + index;
+  memset(sqe, 0, sizeof(*sqe));
+  if (request == nullptr) {
+    sqe->opcode = IORING_OP_NOP;
+  } else {
+    sqe->opcode = request->is_write_ ? IORING_OP_WRITE : IORING_OP_READ;
+    sqe->fd = fd_;
+    sqe->addr = reinterpret_cast<uint64_t>(request->data_);
+    sqe->len = static_cast<uint32_t>(request->size_);
+    sqe->off = request->offset_;
+  }
+  sqe->user_data = reinterpret_cast<uint64_t>(request);
+  sq_array_[index] = index;
+  __atomic_store_n(sq_tail_, tail + 1, __ATOMIC_RELEASE);
+  // Without SQPOLL the kernel consumes the entry inside io_uring_enter, so the submission queue never fills up.
+  while (syscall(__NR_io_uring_enter, ring_fd_, 1, 0, 0, nullptr, 0) < 0 && errno == EINTR) {
+  }
+}
+
+void IoUringIOBackend::CompletionLoop() {
+  while (true) {
+    unsigned head = *cq_head_;
+    if (head == __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE)) {
+      syscall(__NR_io_uring_enter, ring_fd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+      continue;
+    }
+    auto *cqe = static_cast<io_uring_cqe *>(cqes_) + (head & *cq_mask_);
+    auto *request = reinterpret_cast<Request *>(cqe->user_data);
+    int res = cqe->res;
+    __atomic_store_n(cq_head_, head + 1, __ATOMIC_RELEASE);
+    if (request == nullptr) {
+      return;
+    }
+
+    if (res < 0) {
+      request->promise_.set_exception(MakeIOError(request->is_write_ ? "io_uring write failed" : "io_uring read failed",
+                                                  -res));
+    } else if (static_cast<size_t>(res) < request->size_) {
+      if (res == 0 && !request->is_write_) {
+        // End of file: the rest of the page was never written.
+        memset(request->data_, 0, request->size_);
+        request->promise_.set_value();
+      } else if (res == 0) {
+        request->promise_.set_exception(MakeIOError("io_uring write failed", EIO));
+      } else {
+        // Short transfer: resubmit the remainder. The request keeps its slot in the queue.
+        request->data_ += res;
+        request->size_ -= res;
+        request->offset_ += res;
+        std::scoped_lock latch(latch_);
+        PushSqe(request);
+        continue;
+      }
+    } else {
+      request->promise_.set_value();
+    }
+    delete request;
+    {
+      std::scoped_lock latch(latch_);
+      in_flight_--;
+    }
+    cv_.notify_all();
+  }
+}
+
+}  // namespace bustub
@@ -10,7 +10,9 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <fcntl.h>
 #include <sys/stat.h>
+#include <unistd.h>
 #include <cassert>
 #include <cstring>
 #include <iostream>
@@ -30,7 +32,7 @@ static char *buffer_used;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
+DiskManager::DiskManager(const std::string &db_file, IOBackendType io_backend, size_t io_queue_depth)
     : file_name_(db_file), num_flushes_(0), num_writes_(0), flush_log_(false), flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.rfind('.');
   if (n == std::string::npos) {
@@ -68,12 +70,33 @@ DiskManager::DiskManager(const std::string &db_file)
     }
   }
   buffer_used = nullptr;
+
+  if (io_backend != IOBackendType::FSTREAM) {
+    db_fd_ = open(db_file.c_str(), O_RDWR);
+    if (db_fd_ < 0) {
+      throw Exception("can't open db file");
+    }
+    io_backend_ = DiskIOBackend::Create(io_backend, db_fd_, io_queue_depth);
+  }
+}
+
+DiskManager::~DiskManager() {
+  io_backend_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+  }
 }
 
 /**
  * Close all file streams
  */
 void DiskManager::ShutDown() {
+  // Destroying the backend waits for all outstanding requests.
+  io_backend_.reset();
+  if (db_fd_ >= 0) {
+    close(db_fd_);
+    db_fd_ = -1;
+  }
   {
     std::scoped_lock scoped_db_io_latch(db_io_latch_);
     db_io_.close();
@@ -85,12 +108,46 @@ void DiskManager::ShutDown() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
+  if (io_backend_ != nullptr) {
+    WritePageAsync(page_id, page_data).get();
+    return;
+  }
+  WriteBytes(static_cast<size_t>(page_id) * PAGE_SIZE, page_data, PAGE_SIZE);
+}
+
+/**
+ * Read the contents of the specified page into the given memory area
+ */
+void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+  if (io_backend_ != nullptr) {
+    ReadPageAsync(page_id, page_data).get();
+    return;
+  }
+  ReadBytes(static_cast<size_t>(page_id) * PAGE_SIZE, page_data, PAGE_SIZE);
+}
+
+/**
+ * Write the contents of a run of adjacent pages into disk file
+ */
+void DiskManager::WritePages(page_id_t first_page_id, const char *pages_data, size_t num_pages) {
+  WriteBytes(static_cast<size_t>(first_page_id) * PAGE_SIZE, pages_data, num_pages * PAGE_SIZE);
+}
+
+/**
+ * Write size bytes at the given offset of the db file with a single write
+ */
+void DiskManager::WriteBytes(size_t offset, const char *data, size_t size) {
+  num_bytes_written_ += size;
+  if (io_backend_ != nullptr) {
+    num_writes_ += 1;
+    io_backend_->SubmitWrite(data, size, offset).get();
+    return;
+  }
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  size_t offset = static_cast<size_t>(page_id) * PAGE_SIZE;
   // set write cursor to offset
   num_writes_ += 1;
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(data, size);
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -100,35 +157,83 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   db_io_.flush();
 }
 
+bool DiskManager::SyncBytes() {
+  if (db_fd_ >= 0) {
+    return fsync(db_fd_) == 0;
+  }
+  std::scoped_lock scoped_db_io_latch(db_io_latch_);
+  db_io_.flush();
+  // The stream does not expose its descriptor, but fsync flushes the file through any descriptor of it.
+  int fd = open(file_name_.c_str(), O_RDONLY);
+  if (fd < 0) {
+    return false;
+  }
+  bool synced = fsync(fd) == 0;
+  close(fd);
+  return synced;
+}
+
 /**
- * Read the contents of the specified page into the given memory area
+ * Read size bytes at the given offset of the db file, zero-filling whatever lies past the end of the file
  */
-void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
+void DiskManager::ReadBytes(size_t offset, char *data, size_t size) {
+  if (io_backend_ != nullptr) {
+    io_backend_->SubmitRead(data, size, offset).get();
+    return;
+  }
   std::scoped_lock scoped_db_io_latch(db_io_latch_);
-  int offset = page_id * PAGE_SIZE;
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (static_cast<int64_t>(offset) > GetFileSize(file_name_)) {
     LOG_DEBUG("I/O error reading past end of file");
     // std::cerr << "I/O error while reading" << std::endl;
-  } else {
-    // set read cursor to offset
-    db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    if (db_io_.bad()) {
-      LOG_DEBUG("I/O error while reading");
-      return;
-    }
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
-      LOG_DEBUG("Read less than a page");
-      db_io_.clear();
-      // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
-    }
+    memset(data, 0, size);
+    return;
+  }
+  // set read cursor to offset
+  db_io_.seekp(offset);
+  db_io_.read(data, size);
+  if (db_io_.bad()) {
+    LOG_DEBUG("I/O error while reading");
+    return;
+  }
+  // if file ends before reading size bytes
+  auto read_count = static_cast<size_t>(db_io_.gcount());
+  if (read_count < size) {
+    LOG_DEBUG("Read less than a page");
+    db_io_.clear();
+    // std::cerr << "Read less than a page" << std::endl;
+    memset(data + read_count, 0, size - read_count);
   }
 }
 
+/**
+ * Start writing the contents of the specified page through the I/O backend
+ */
+std::future<void> DiskManager::WritePageAsync(page_id_t page_id, const char *page_data) {
+  if (io_backend_ == nullptr) {
+    WritePage(page_id, page_data);
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future();
+  }
+  num_writes_ += 1;
+  num_bytes_written_ += PAGE_SIZE;
+  return io_backend_->SubmitWrite(page_data, PAGE_SIZE, static_cast<size_t>(page_id) * PAGE_SIZE);
+}
+
+/**
+ * Start reading the contents of the specified page through the I/O backend
+ */
+std::future<void> DiskManager::ReadPageAsync(page_id_t page_id, char *page_data) {
+  if (io_backend_ == nullptr) {
+    ReadPage(page_id, page_data);
+    std::promise<void> done;
+    done.set_value();
+    return done.get_future();
+  }
+  return io_backend_->SubmitRead(page_data, PAGE_SIZE, static_cast<size_t>(page_id) * PAGE_SIZE);
+}
+
 /**
  * Write the contents of the log into disk file
  * Only return when sync is done, and only perform sequence write
@@ -201,18 +306,27 @@ int DiskManager::GetNumFlushes() const { return num_flushes_; }
  */
 int DiskManager::GetNumWrites() const { return num_writes_; }
 
+/**
+ * Returns number of bytes written to the db file so far
+ */
+uint64_t DiskManager::GetNumBytesWritten() const { return num_bytes_written_; }
+
 /**
  * Returns true if the log is currently being flushed
  */
 bool DiskManager::GetFlushState() const { return flush_log_; }
 
+bool DiskManager::IsPageOnDisk(page_id_t page_id) {
+  return (static_cast<int64_t>(page_id) + 1) * PAGE_SIZE <= GetFileSize(file_name_);
+}
+
 /**
  * Private helper function to get disk file size
  */
-int DiskManager::GetFileSize(const std::string &file_name) {
+int64_t DiskManager::GetFileSize(const std::string &file_name) {
   struct stat stat_buf;
   int rc = stat(file_name.c_str(), &stat_buf);
-  return rc == 0 ? static_cast<int>(stat_buf.st_size) : -1;
+  return rc == 0 ? static_cast<int64_t>(stat_buf.st_size) : -1;
 }
 
 }  // namespace bustub
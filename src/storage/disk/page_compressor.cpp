@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compressor.cpp
+//
+// Identification: src/storage/disk/page_compressor.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/disk/page_compressor.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+namespace bustub {
+
+namespace {
+
+/** The shortest match worth encoding. */
+constexpr size_t MIN_MATCH = 4;
+/** The last bytes of the input are always literals. */
+constexpr size_t LAST_LITERALS = 5;
+/** No match starts in the last bytes of the input. */
+constexpr size_t MATCH_FIND_LIMIT = 12;
+/** The largest distance a match offset can express. */
+constexpr size_t MAX_OFFSET = 65535;
+constexpr int HASH_BITS = 12;
+/** A 4-bit length field holding this value continues in the following bytes. */
+constexpr size_t LENGTH_MASK = 15;
+
+uint32_t Read32(const char *p) {
+  uint32_t value;
+  memcpy(&value, p, sizeof(value));
+  return value;
+}
+
+uint32_t Hash(uint32_t sequence) { return (sequence * 2654435761U) >> (32 - HASH_BITS); }
+
+/** Appends the overflow of a length that did not fit into its 4-bit field. */
+void WriteLengthOverflow(size_t length, uint8_t **out) {
+  for (; length >= 255; length -= 255) {
+    *(*out)++ = 255;
+  }
+  *(*out)++ = static_cast<uint8_t>(length);
+}
+
+/** Reads the overflow of a length field, returns false if the input ends first. */
+bool ReadLengthOverflow(const uint8_t **in, const uint8_t *in_end, size_t *length) {
+  uint8_t byte;
+  do {
+    if (*in >= in_end) {
+      return false;
+    }
+    byte = *(*in)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+/**
+ * Appends a sequence: the literals, then a match of match_length bytes at distance offset. A match_length of 0 ends
+ * the block with literals only. Returns false if the sequence does not fit before out_end.
+ */
+bool WriteSequence(const char *literals, size_t literal_length, size_t offset, size_t match_length, uint8_t **out,
+                   const uint8_t *out_end) {
+  size_t needed = 1 + literal_length + literal_length / 255 + 1;
+  if (match_length != 0) {
+    needed += 2 + (match_length - MIN_MATCH) / 255 + 1;
+  }
+  if (static_cast<size_t>(out_end - *out) < needed) {
+    return false;
+  }
+
+  uint8_t *token = (*out)++;
+  *token = static_cast<uint8_t>(std::min(literal_length, LENGTH_MASK) << 4);
+  if (literal_length >= LENGTH_MASK) {
+    WriteLengthOverflow(literal_length - LENGTH_MASK, out);
+  }
+  memcpy(*out, literals, literal_length);
+  *out += literal_length;
+  if (match_length == 0) {
+    return true;
+  }
+
+  *(*out)++ = static_cast<uint8_t>(offset & 0xff);
+  *(*out)++ = static_cast<uint8_t>(offset >> 8);
+  size_t length_code = match_length - MIN_MATCH;
+  *token |= static_cast<uint8_t>(std::min(length_code, LENGTH_MASK));
+  if (length_code >= LENGTH_MASK) {
+    WriteLengthOverflow(length_code - LENGTH_MASK, out);
+  }
+  return true;
+}
+
+}  // namespace
+
+size_t PageCompressor::Compress(const char *src, size_t size, char *dst, size_t capacity) {
+  auto *out = reinterpret_cast<uint8_t *>(dst);
+  const uint8_t *out_end = out + capacity;
+  size_t anchor = 0;
+
+  if (size >= MATCH_FIND_LIMIT) {
+    // Positions are stored plus one, so that zero means empty.
+    std::array<uint32_t, 1 << HASH_BITS> table{};
+    size_t pos = 0;
+    while (pos + MATCH_FIND_LIMIT <= size) {
+      uint32_t sequence = Read32(src + pos);
+      uint32_t &slot = table[Hash(sequence)];
+      size_t candidate = slot;
+      slot = static_cast<uint32_t>(pos + 1);
+      if (candidate == 0 || pos - (candidate - 1) > MAX_OFFSET || Read32(src + candidate - 1) != sequence) {
+        pos++;
+        continue;
+      }
+      candidate--;
+
+      size_t match_length = MIN_MATCH;
+      while (pos + match_length < size - LAST_LITERALS && src[candidate + match_length] == src[pos + match_length]) {
+        match_length++;
+      }
+      if (!WriteSequence(src + anchor, pos - anchor, pos - candidate, match_length, &out, out_end)) {
+        return 0;
+      }
+      pos += match_length;
+      anchor = pos;
+    }
+  }
+
+  if (!WriteSequence(src + anchor, size - anchor, 0, 0, &out, out_end)) {
+    return 0;
+  }
+  return out - reinterpret_cast<uint8_t *>(dst);
+}
+
+size_t PageCompressor::Decompress(const char *src, size_t size, char *dst, size_t capacity) {
+  const auto *in = reinterpret_cast<const uint8_t *>(src);
+  const uint8_t *in_end = in + size;
+  char *out = dst;
+  const char *out_end = dst + capacity;
+
+  while (in < in_end) {
+    uint8_t token = *in++;
+    size_t literal_length = token >> 4;
+    if (literal_length == LENGTH_MASK && !ReadLengthOverflow(&in, in_end, &literal_length)) {
+      return 0;
+    }
+    if (literal_length > static_cast<size_t>(in_end - in) || literal_length > static_cast<size_t>(out_end - out)) {
+      return 0;
+    }
+    memcpy(out, in, literal_length);
+    in += literal_length;
+    out += literal_length;
+    if (in == in_end) {
+      // The last sequence has no match.
+      break;
+    }
+
+    if (in_end - in < 2) {
+      return 0;
+    }
+    size_t offset = in[0] | (static_cast<size_t>(in[1]) << 8);
+    in += 2;
+    size_t match_length = token & LENGTH_MASK;
+    if (match_length == LENGTH_MASK && !ReadLengthOverflow(&in, in_end, &match_length)) {
+      return 0;
+    }
+    match_length += MIN_MATCH;
+    if (offset == 0 || offset > static_cast<size_t>(out - dst) || match_length > static_cast<size_t>(out_end - out)) {
+      return 0;
+    }
+    // The match may overlap the bytes it produces, e.g. a run of one byte has offset 1, so copy byte by byte.
+    const char *match = out - offset;
+    for (size_t i = 0; i < match_length; i++) {
+      out[i] = match[i];
+    }
+    out += match_length;
+  }
+  return out - dst;
+}
+
+}  // namespace bustub
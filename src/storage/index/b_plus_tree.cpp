@@ -9,11 +9,16 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
+#include <iterator>
 #include <string>
+#include <type_traits>
 
 #include "common/exception.h"
 #include "common/rid.h"
 #include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_bulk_loader.h"
 #include "storage/page/header_page.h"
 
 namespace bustub {
@@ -25,13 +30,13 @@ BPLUSTREE_TYPE::BPlusTree(std::string name, BufferPoolManager *buffer_pool_manag
       buffer_pool_manager_(buffer_pool_manager),
       comparator_(comparator),
       leaf_max_size_(leaf_max_size),
-      internal_max_size_(internal_max_size) {}
+      internal_max_size_(std::min(internal_max_size, static_cast<int>(INTERNAL_PAGE_SIZE))) {}
 
 /*
  * Helper function to decide whether current b+tree is empty
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
+bool BPLUSTREE_TYPE::IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
 /*****************************************************************************
  * SEARCH
  *****************************************************************************/
@@ -42,7 +47,76 @@ bool BPLUSTREE_TYPE::IsEmpty() const { return true; }
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
-  return false;
+  while (true) {
+    uint64_t version;
+    Page *page = FindLeafOptimistic(key, false, &version);
+    if (page == nullptr) {
+      return false;
+    }
+    ValueType value;
+    bool found = reinterpret_cast<LeafPage *>(page->GetData())->Lookup(key, &value, comparator_);
+    bool valid = page->ValidateVersion(version);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    if (valid) {
+      if (found) {
+        result->push_back(value);
+      }
+      return found;
+    }
+  }
+}
+
+/*
+ * Return the values of every entry with the index key of key. In a tree over PostingKey, these are the record ids of
+ * the index key, whose posting lists may span several leaves: the scan descends to the first of them and decodes the
+ * posting lists of the index key in each leaf at once, following the leaf chain while they go on. Like the index
+ * iterator, it validates a leaf before it follows its next page id, and descends again after the last record id it
+ * returned if a writer changed the leaf. Any other tree holds one entry per key, which GetValue returns.
+ * @return : true means the key exists
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ScanKey(const KeyType &key, std::vector<ValueType> *result, Transaction *transaction) {
+  if constexpr (!IsPostingKey<KeyType>::value) {
+    return GetValue(key, result, transaction);
+  } else {
+    size_t begin = result->size();
+    KeyType low = key;
+    low.rid_ = 0;
+    bool restart = true;
+    while (restart) {
+      restart = false;
+      uint64_t version;
+      Page *page = FindLeafOptimistic(low, false, &version);
+      while (page != nullptr) {
+        auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+        size_t size = result->size();
+        bool more = leaf->ScanKey(low, comparator_, result);
+        page_id_t next_page_id = leaf->GetNextPageId();
+        Page *next = nullptr;
+        uint64_t next_version = 0;
+        if (more && next_page_id != INVALID_PAGE_ID && page->ValidateVersion(version)) {
+          next = FetchTreePage(next_page_id);
+          next_version = next->ReadVersion();
+        }
+        bool valid = page->ValidateVersion(version);
+        buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+        if (!valid) {
+          result->resize(size);
+          if (next != nullptr) {
+            buffer_pool_manager_->UnpinPage(next_page_id, false);
+          }
+          restart = true;
+          break;
+        }
+        if (result->size() > size) {
+          low.rid_ = RidToInteger(result->back()) + 1;
+        }
+        page = next;
+        version = next_version;
+      }
+    }
+    return result->size() > begin;
+  }
 }
 
 /*****************************************************************************
@@ -52,44 +126,301 @@ bool BPLUSTREE_TYPE::GetValue(const KeyType &key, std::vector<ValueType> *result
  * Insert constant key & value pair into b+ tree
  * if current tree is empty, start new tree, update root page id and insert
  * entry, otherwise insert into leaf page.
+ * An insert that does not split the leaf latches only the leaf; any other insert is left to InsertIntoLeaf.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) { return false; }
+bool BPLUSTREE_TYPE::Insert(const KeyType &key, const ValueType &value, Transaction *transaction) {
+  while (true) {
+    uint64_t version;
+    Page *page = FindLeafOptimistic(key, false, &version);
+    if (page == nullptr) {
+      if (StartNewTree(key, value)) {
+        return true;
+      }
+      continue;
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType existing;
+    if (leaf->Lookup(key, &existing, comparator_) && page->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return false;
+    }
+    if (!leaf->HasRoomFor(key)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      break;
+    }
+    // Upgrading only succeeds if the leaf has not changed since it was read, so the checks above still hold.
+    if (!page->TryUpgradeVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      continue;
+    }
+    page->WLatch();
+    int size = leaf->GetSize();
+    bool inserted = leaf->Insert(key, value, comparator_) > size;
+    page->WUnlatch();
+    page->VersionWUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), inserted);
+    return inserted;
+  }
+  return InsertIntoLeaf(key, value, transaction);
+}
 /*
  * Insert constant key & value pair into an empty tree
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
  * an "out of memory" exception if returned value is nullptr), then update b+
  * tree's root page id and insert entry directly into leaf page.
+ * @return: false if another writer started the tree first
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {}
+bool BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    root_latch_.WUnlock();
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to start a b+ tree");
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  leaf->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  leaf->Insert(key, value, comparator_);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  root_page_id_ = page_id;
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
+}
+
+/*****************************************************************************
+ * BULK LOAD
+ *****************************************************************************/
+/*
+ * Build the tree bottom-up instead of inserting the entries one at a time. The entries must come in increasing key
+ * order without duplicates. Every page is written once: the leaves are filled from left to right, and each level keeps
+ * only its rightmost page pinned, which gets a new child whenever a page below it starts. A page starts once the next
+ * entry would take it past the fill factor, in entries or in space; pages that are less than full leave room for later
+ * inserts. Since entries vary in length, the number of pages is not known in advance, so the last page on each level
+ * finally takes entries from its left sibling until both hold about as many.
+ * Readers wait on the root latch until the tree is complete.
+ * @return: false if the tree is not empty, in which case next_entry is never called
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::BulkLoad(const std::function<bool(MappingType *)> &next_entry, double fill_factor) {
+  root_latch_.WLock();
+  if (root_page_id_ != INVALID_PAGE_ID) {
+    root_latch_.WUnlock();
+    return false;
+  }
+  int leaf_fill = std::clamp(static_cast<int>(fill_factor * (leaf_max_size_ - 1)), 1, std::max(leaf_max_size_ - 1, 1));
+  // Three children let the last page on a level take one from its left sibling and still leave it two.
+  int internal_fill = std::clamp(static_cast<int>(fill_factor * internal_max_size_), std::min(3, internal_max_size_),
+                                 internal_max_size_);
+  std::vector<Page *> levels;
+  try {
+    MappingType entry;
+    KeyType last_key{};
+    while (next_entry(&entry)) {
+      auto *leaf = levels.empty() ? nullptr : reinterpret_cast<LeafPage *>(levels[0]->GetData());
+      if (leaf == nullptr || leaf->GetSize() >= leaf_fill || !leaf->HasRoomFor(entry.first, fill_factor)) {
+        Page *page = BulkLoadNewPage(0);
+        if (leaf != nullptr) {
+          try {
+            BulkLoadAddChild(&levels, 1, Separator(last_key, entry.first), page, internal_fill, fill_factor);
+          } catch (...) {
+            buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+            buffer_pool_manager_->DeletePage(page->GetPageId());
+            throw;
+          }
+          leaf->SetNextPageId(page->GetPageId());
+          buffer_pool_manager_->UnpinPage(levels[0]->GetPageId(), true);
+          levels[0] = page;
+        } else {
+          levels.push_back(page);
+        }
+        leaf = reinterpret_cast<LeafPage *>(page->GetData());
+      }
+      leaf->Append(entry);
+      last_key = entry.first;
+    }
+    if (!levels.empty()) {
+      BulkLoadBalance(levels);
+    }
+  } catch (...) {
+    for (Page *page : levels) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+    }
+    root_latch_.WUnlock();
+    throw;
+  }
+  if (levels.empty()) {
+    root_latch_.WUnlock();
+    return true;
+  }
+  for (Page *page : levels) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+  }
+  root_page_id_ = levels.back()->GetPageId();
+  UpdateRootPageId(1);
+  root_latch_.WUnlock();
+  return true;
+}
+
+/*
+ * Return a new page for the given level of a bulk load, height 0 being the leaves. Its parent is set once it is
+ * added to the level above.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::BulkLoadNewPage(size_t height) {
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to bulk load a b+ tree");
+  }
+  if (height == 0) {
+    reinterpret_cast<LeafPage *>(page->GetData())->Init(page_id, INVALID_PAGE_ID, leaf_max_size_);
+  } else {
+    reinterpret_cast<InternalPage *>(page->GetData())->Init(page_id, INVALID_PAGE_ID, internal_max_size_);
+  }
+  return page;
+}
+
+/*
+ * Add the child page, which follows the rightmost page on the level below, to the rightmost page on the given level
+ * of a bulk load, with key as its separator. If that page is full, start a new one with the child as its first: it
+ * becomes the next child of the level above, with the same key. The first time the level below gets a second page,
+ * the level itself starts as the new root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadAddChild(std::vector<Page *> *levels, size_t height, const KeyType &key, Page *child,
+                                      int fill, double fill_factor) {
+  Page *page = nullptr;
+  if (height == levels->size()) {
+    page = BulkLoadNewPage(height);
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    Page *first_child = (*levels)[height - 1];
+    root->Append(key, first_child->GetPageId());
+    reinterpret_cast<BPlusTreePage *>(first_child->GetData())->SetParentPageId(page->GetPageId());
+    levels->push_back(page);
+  } else {
+    page = (*levels)[height];
+    auto *internal = reinterpret_cast<InternalPage *>(page->GetData());
+    if (internal->GetSize() >= fill || !internal->HasRoomFor(key, fill_factor)) {
+      Page *new_page = BulkLoadNewPage(height);
+      try {
+        BulkLoadAddChild(levels, height + 1, key, new_page, fill, fill_factor);
+      } catch (...) {
+        buffer_pool_manager_->UnpinPage(new_page->GetPageId(), false);
+        buffer_pool_manager_->DeletePage(new_page->GetPageId());
+        throw;
+      }
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), true);
+      (*levels)[height] = new_page;
+      page = new_page;
+    }
+  }
+  reinterpret_cast<InternalPage *>(page->GetData())->Append(key, child->GetPageId());
+  reinterpret_cast<BPlusTreePage *>(child->GetData())->SetParentPageId(page->GetPageId());
+}
+
+/*
+ * Even out the last two pages on each level of a bulk loaded tree, from the top down, so that the parent of the last
+ * page on a level already has its left sibling as a child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::BulkLoadBalance(const std::vector<Page *> &levels) {
+  for (size_t height = levels.size() - 1; height-- > 0;) {
+    auto *parent = reinterpret_cast<InternalPage *>(levels[height + 1]->GetData());
+    int index = parent->GetSize() - 1;
+    if (index == 0) {
+      continue;
+    }
+    page_id_t neighbor_page_id = parent->ValueAt(index - 1);
+    Page *neighbor_page = FetchTreePage(neighbor_page_id);
+    auto *neighbor = reinterpret_cast<BPlusTreePage *>(neighbor_page->GetData());
+    auto *node = reinterpret_cast<BPlusTreePage *>(levels[height]->GetData());
+    bool moved = true;
+    // Entries vary in length, so the last page may run out of space before it holds as many as its sibling.
+    while (moved && node->GetSize() < neighbor->GetSize() - 1) {
+      if (height == 0) {
+        auto *leaf_neighbor = reinterpret_cast<LeafPage *>(neighbor);
+        auto *leaf = reinterpret_cast<LeafPage *>(node);
+        moved = leaf->HasRoomFor(leaf_neighbor->KeyAt(leaf_neighbor->GetSize() - 1)) &&
+                Redistribute(leaf_neighbor, leaf, parent, index);
+      } else {
+        auto *internal = reinterpret_cast<InternalPage *>(node);
+        moved = internal->HasRoomFor(parent->KeyAt(index)) &&
+                Redistribute(reinterpret_cast<InternalPage *>(neighbor), internal, parent, index);
+      }
+    }
+    buffer_pool_manager_->UnpinPage(neighbor_page_id, true);
+  }
+}
 
 /*
  * Insert constant key & value pair into leaf page
  * User needs to first find the right leaf page as insertion target, then look
  * through leaf page to see whether insert key exist or not. If exist, return
  * immdiately, otherwise insert entry. Remember to deal with split if necessary.
+ * This is the path for inserts that may split: every page that may change is latched on the way down.
  * @return: since we only support unique key, if user try to insert duplicate
  * keys return false, otherwise return true.
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value, Transaction *transaction) {
-  return false;
+  if (transaction == nullptr) {
+    Transaction local_transaction(INVALID_TXN_ID);
+    return InsertIntoLeaf(key, value, &local_transaction);
+  }
+  if (!FindLeafPessimistic(key, Operation::INSERT, transaction)) {
+    // The tree became empty since the optimistic descent.
+    ReleaseLatches(transaction, false);
+    return Insert(key, value, transaction);
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(transaction->GetPageSet()->back()->GetData());
+  ValueType existing;
+  if (leaf->Lookup(key, &existing, comparator_)) {
+    ReleaseLatches(transaction, false);
+    return false;
+  }
+  if (leaf->HasRoomFor(key)) {
+    leaf->Insert(key, value, comparator_);
+  } else {
+    LeafPage *new_leaf = Split(leaf);
+    leaf->InsertAndMoveHalfTo(key, value, new_leaf, comparator_);
+    // The new leaf becomes reachable once the latch of the old leaf is released.
+    new_leaf->SetNextPageId(leaf->GetNextPageId());
+    leaf->SetNextPageId(new_leaf->GetPageId());
+    InsertIntoParent(leaf, Separator(leaf->KeyAt(leaf->GetSize() - 1), new_leaf->KeyAt(0)), new_leaf, transaction);
+    buffer_pool_manager_->UnpinPage(new_leaf->GetPageId(), true);
+  }
+  ReleaseLatches(transaction, true);
+  return true;
 }
 
 /*
  * Split input page and return newly created page.
  * Using template N to represent either internal page or leaf page.
  * User needs to first ask for new page from buffer pool manager(NOTICE: throw
- * an "out of memory" exception if returned value is nullptr), then move half
- * of key & value pairs from input page to newly created page
+ * an "out of memory" exception if returned value is nullptr). The caller then
+ * moves half of the key & value pairs to it, along with the pair that did not
+ * fit into the input page.
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 N *BPLUSTREE_TYPE::Split(N *node) {
-  return nullptr;
+  page_id_t page_id;
+  Page *page = buffer_pool_manager_->NewPage(&page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to split a b+ tree page");
+  }
+  auto *new_node = reinterpret_cast<N *>(page->GetData());
+  new_node->Init(page_id, node->GetParentPageId(), node->GetMaxSize());
+  return new_node;
 }
 
 /*
@@ -100,10 +431,42 @@ N *BPLUSTREE_TYPE::Split(N *node) {
  * User needs to first find the parent page of old_node, parent node must be
  * adjusted to take info of new_node into account. Remember to deal with split
  * recursively if necessary.
+ * The parent was not safe when it was latched on the way down, so it is still latched; so is the root page id if
+ * old_node is the root.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &key, BPlusTreePage *new_node,
-                                      Transaction *transaction) {}
+                                      Transaction *transaction) {
+  if (old_node->IsRootPage()) {
+    page_id_t root_page_id;
+    Page *page = buffer_pool_manager_->NewPage(&root_page_id);
+    if (page == nullptr) {
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to grow a b+ tree");
+    }
+    auto *root = reinterpret_cast<InternalPage *>(page->GetData());
+    root->Init(root_page_id, INVALID_PAGE_ID, internal_max_size_);
+    root->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
+    old_node->SetParentPageId(root_page_id);
+    new_node->SetParentPageId(root_page_id);
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId(0);
+    return;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(LatchedParent(old_node, transaction)->GetData());
+  page_id_t parent_page_id = parent->GetPageId();
+  // The split adopts new_node into the new parent if it moves there.
+  new_node->SetParentPageId(parent_page_id);
+  if (parent->HasRoomFor(key)) {
+    parent->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
+  } else {
+    InternalPage *new_parent = Split(parent);
+    parent->InsertAndMoveHalfTo(old_node->GetPageId(), key, new_node->GetPageId(), new_parent, buffer_pool_manager_);
+    InsertIntoParent(parent, new_parent->KeyAt(0), new_parent, transaction);
+    buffer_pool_manager_->UnpinPage(new_parent->GetPageId(), true);
+  }
+}
 
 /*****************************************************************************
  * REMOVE
@@ -114,21 +477,128 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node, const KeyType &ke
  * If not, User needs to first find the right leaf page as deletion target, then
  * delete entry from leaf page. Remember to deal with redistribute or merge if
  * necessary.
+ * A remove that leaves the leaf at least half full latches only the leaf; any other remove is left to RemoveFromLeaf.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
+  while (true) {
+    uint64_t version;
+    Page *page = FindLeafOptimistic(key, false, &version);
+    if (page == nullptr) {
+      return;
+    }
+    auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+    ValueType existing;
+    if (!leaf->Lookup(key, &existing, comparator_) && page->ValidateVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      return;
+    }
+    if (leaf->IsRootPage() ? leaf->GetSize() - 1 < 1 : leaf->MayUnderflowAfterRemove()) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      break;
+    }
+    if (!page->TryUpgradeVersion(version)) {
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      continue;
+    }
+    page->WLatch();
+    int size = leaf->GetSize();
+    bool removed = leaf->RemoveAndDeleteRecord(key, comparator_) < size;
+    page->WUnlatch();
+    page->VersionWUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), removed);
+    return;
+  }
+  RemoveFromLeaf(key, transaction);
+}
+
+/*
+ * Delete key & value pair from its leaf page, which may underflow: every page that may change is latched on the way
+ * down. The pages emptied by merges are deleted once they are unlatched.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {}
+void BPLUSTREE_TYPE::RemoveFromLeaf(const KeyType &key, Transaction *transaction) {
+  if (transaction == nullptr) {
+    Transaction local_transaction(INVALID_TXN_ID);
+    RemoveFromLeaf(key, &local_transaction);
+    return;
+  }
+  if (!FindLeafPessimistic(key, Operation::REMOVE, transaction)) {
+    ReleaseLatches(transaction, false);
+    return;
+  }
+  auto *leaf = reinterpret_cast<LeafPage *>(transaction->GetPageSet()->back()->GetData());
+  int size = leaf->GetSize();
+  if (leaf->RemoveAndDeleteRecord(key, comparator_) == size) {
+    ReleaseLatches(transaction, false);
+    return;
+  }
+  if (CoalesceOrRedistribute(leaf, transaction)) {
+    transaction->AddIntoDeletedPageSet(leaf->GetPageId());
+  }
+  ReleaseLatches(transaction, true);
+}
 
 /*
  * User needs to first find the sibling of input page. If sibling's size + input
  * page's size > page's max size, then redistribute. Otherwise, merge.
  * Using template N to represent either internal page or leaf page.
+ * Pages merge if the entries of both fit into one page, in number and in space.
+ * The parent is still latched, since node was not safe; the sibling is latched here, after the parent.
  * @return: true means target leaf page should be deleted, false means no
  * deletion happens
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
 bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
-  return false;
+  if (node->IsRootPage()) {
+    return AdjustRoot(node);
+  }
+  if (!node->IsUnderflow()) {
+    return false;
+  }
+
+  auto *parent = reinterpret_cast<InternalPage *>(LatchedParent(node, transaction)->GetData());
+  page_id_t parent_page_id = parent->GetPageId();
+  if (parent->GetSize() < 2) {
+    // Only a bulk load with internal pages of two children leaves a page without siblings, at its right edge.
+    return false;
+  }
+  int index = parent->ValueIndex(node->GetPageId());
+  page_id_t neighbor_page_id = parent->ValueAt(index == 0 ? 1 : index - 1);
+  Page *neighbor_page = FetchTreePage(neighbor_page_id);
+  WLatchPage(neighbor_page);
+  auto *neighbor = reinterpret_cast<N *>(neighbor_page->GetData());
+
+  N *left = index == 0 ? node : neighbor;
+  N *right = index == 0 ? neighbor : node;
+  bool can_merge;
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    can_merge = left->CanMergeFrom(right);
+  } else {
+    can_merge = left->CanMergeFrom(right, parent->KeyAt(index == 0 ? 1 : index));
+  }
+  bool node_deleted = false;
+  bool parent_deleted = false;
+  if (can_merge) {
+    N *kept = neighbor;
+    N *emptied = node;
+    parent_deleted = Coalesce(&kept, &emptied, &parent, index, transaction);
+    if (emptied == node) {
+      node_deleted = true;
+    } else {
+      transaction->AddIntoDeletedPageSet(neighbor_page_id);
+    }
+  } else {
+    Redistribute(neighbor, node, parent, index);
+  }
+
+  WUnlatchPage(neighbor_page);
+  buffer_pool_manager_->UnpinPage(neighbor_page_id, true);
+  if (parent_deleted) {
+    transaction->AddIntoDeletedPageSet(parent_page_id);
+  }
+  return node_deleted;
 }
 
 /*
@@ -137,6 +607,8 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
  * take info of deletion into account. Remember to deal with coalesce or
  * redistribute recursively if necessary.
  * Using template N to represent either internal page or leaf page.
+ * The right page of the two is always emptied into the left one, so the leaf chain only loses the emptied page; on
+ * return, *neighbor_node is the left page and *node the emptied right page, which the caller deletes.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
  * @param   parent             parent page of input "node"
@@ -148,7 +620,17 @@ template <typename N>
 bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
                               BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> **parent, int index,
                               Transaction *transaction) {
-  return false;
+  if (index == 0) {
+    std::swap(*neighbor_node, *node);
+    index = 1;
+  }
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    (*node)->MoveAllTo(*neighbor_node);
+  } else {
+    (*node)->MoveAllTo(*neighbor_node, (*parent)->KeyAt(index), buffer_pool_manager_);
+  }
+  (*parent)->Remove(index);
+  return CoalesceOrRedistribute(*parent, transaction);
 }
 
 /*
@@ -157,12 +639,45 @@ bool BPLUSTREE_TYPE::Coalesce(N **neighbor_node, N **node,
  * otherwise move sibling page's last key & value pair into head of input
  * "node".
  * Using template N to represent either internal page or leaf page.
+ * The new separator key in the parent may be longer than the old one; if the parent has no room for it, nothing moves.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @param   parent             parent page of both, whose separator key moves along
+ * @return  true if a pair moved
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
+bool BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node,
+                                  BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *parent, int index) {
+  int size = neighbor_node->GetSize();
+  int separator_index = index == 0 ? 1 : index;
+  KeyType separator;
+  if constexpr (std::is_same_v<N, LeafPage>) {
+    separator = index == 0 ? Separator(neighbor_node->KeyAt(0), neighbor_node->KeyAt(1))
+                           : Separator(neighbor_node->KeyAt(size - 2), neighbor_node->KeyAt(size - 1));
+  } else {
+    separator = neighbor_node->KeyAt(index == 0 ? 1 : size - 1);
+  }
+  if (!parent->HasRoomToSetKeyAt(separator_index, separator)) {
+    return false;
+  }
+  KeyType middle_key = parent->KeyAt(separator_index);
+  if (index == 0) {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveFirstToEndOf(node);
+    } else {
+      neighbor_node->MoveFirstToEndOf(node, middle_key, buffer_pool_manager_);
+    }
+  } else {
+    if constexpr (std::is_same_v<N, LeafPage>) {
+      neighbor_node->MoveLastToFrontOf(node);
+    } else {
+      neighbor_node->MoveLastToFrontOf(node, middle_key, buffer_pool_manager_);
+    }
+  }
+  parent->SetKeyAt(separator_index, separator);
+  return true;
+}
 /*
  * Update root page if necessary
  * NOTE: size of root page can be less than min size and this method is only
@@ -170,11 +685,32 @@ void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {}
  * case 1: when you delete the last element in root page, but root page still
  * has one last child
  * case 2: when you delete the last element in whole b+ tree
+ * The root page id is still latched, since the root was not safe.
  * @return : true means root page should be deleted, false means no deletion
  * happend
  */
 INDEX_TEMPLATE_ARGUMENTS
-bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
+bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
+  if (old_root_node->IsLeafPage()) {
+    if (old_root_node->GetSize() > 0) {
+      return false;
+    }
+    root_page_id_ = INVALID_PAGE_ID;
+    UpdateRootPageId(0);
+    return true;
+  }
+  if (old_root_node->GetSize() > 1) {
+    return false;
+  }
+  // The only child is latched: it is the page a merge just emptied its sibling into.
+  page_id_t child_page_id = reinterpret_cast<InternalPage *>(old_root_node)->RemoveAndReturnOnlyChild();
+  Page *child_page = FetchTreePage(child_page_id);
+  reinterpret_cast<BPlusTreePage *>(child_page->GetData())->SetParentPageId(INVALID_PAGE_ID);
+  buffer_pool_manager_->UnpinPage(child_page_id, true);
+  root_page_id_ = child_page_id;
+  UpdateRootPageId(0);
+  return true;
+}
 
 /*****************************************************************************
  * INDEX ITERATOR
@@ -185,7 +721,11 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) { return false; }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
+  INDEXITERATOR_TYPE iterator(this, buffer_pool_manager_);
+  iterator.Seek(KeyType{}, true, true);
+  return iterator;
+}
 
 /*
  * Input parameter is low key, find the leaf page that contains the input key
@@ -193,7 +733,11 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() { return INDEXITERATOR_TYPE(); }
  * @return : index iterator
  */
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERATOR_TYPE(); }
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
+  INDEXITERATOR_TYPE iterator(this, buffer_pool_manager_);
+  iterator.Seek(key, true, false);
+  return iterator;
+}
 
 /*
  * Input parameter is void, construct an index iterator representing the end
@@ -203,16 +747,334 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) { return INDEXITERA
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_TYPE::End() { return INDEXITERATOR_TYPE(); }
 
+/*
+ * The leaves that follow a leaf are listed from the internal pages above it, so read-ahead never has to read a leaf to
+ * find the next one. The function remembers the parent of the last leaf it listed: the next call usually continues
+ * from that leaf, which may not have been read yet.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+ReadAhead::NextPagesFn BPLUSTREE_TYPE::GetNextLeavesFn() {
+  return [this, parent_page_id = INVALID_PAGE_ID](page_id_t page_id, size_t max_pages,
+                                                  std::vector<page_id_t> *page_ids) mutable {
+    GetNextLeaves(page_id, max_pages, page_ids, &parent_page_id);
+  };
+}
+
+/*
+ * List up to max_pages leaves that follow the leaf leaf_page_id, in key order: the right siblings of the leaf in its
+ * parent, then the leaves below the right siblings of the parent, and so on up the tree. Internal pages are read
+ * optimistically; the listing stops early if a writer changes one of them, which at worst prefetches a page that is not
+ * needed. parent_page_id may name the parent of the leaf, and is set to the parent of the last leaf listed.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetNextLeaves(page_id_t leaf_page_id, size_t max_pages, std::vector<page_id_t> *page_ids,
+                                   page_id_t *parent_page_id) {
+  page_id_t child_page_id = leaf_page_id;
+  page_id_t parent = *parent_page_id;
+  *parent_page_id = INVALID_PAGE_ID;
+  size_t child_height = 0;
+  std::vector<page_id_t> siblings;
+  while (page_ids->size() < max_pages) {
+    bool known_parent = parent != INVALID_PAGE_ID;
+    if (!known_parent && !ReadParentPageId(child_page_id, &parent)) {
+      return;
+    }
+    if (parent == INVALID_PAGE_ID || !ReadChildren(parent, &siblings)) {
+      return;
+    }
+    auto it = std::find(siblings.begin(), siblings.end(), child_page_id);
+    if (it == siblings.end()) {
+      if (!known_parent) {
+        return;
+      }
+      // The leaf moved since its parent was remembered.
+      parent = INVALID_PAGE_ID;
+      continue;
+    }
+    if (!CollectLeaves(parent, siblings, std::next(it) - siblings.begin(), child_height, max_pages, page_ids,
+                       parent_page_id)) {
+      return;
+    }
+    child_page_id = parent;
+    parent = INVALID_PAGE_ID;
+    child_height++;
+  }
+}
+
+/*
+ * Append the leaves below children[begin..] of page_id, which sit child_height levels above the leaves, until there are
+ * max_pages. leaf_parent_page_id is set to the page the last leaf was listed from.
+ * @return false if an internal page could not be read consistently
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::CollectLeaves(page_id_t page_id, const std::vector<page_id_t> &children, size_t begin,
+                                   size_t child_height, size_t max_pages, std::vector<page_id_t> *page_ids,
+                                   page_id_t *leaf_parent_page_id) {
+  std::vector<page_id_t> grandchildren;
+  for (size_t i = begin; i < children.size() && page_ids->size() < max_pages; i++) {
+    if (child_height == 0) {
+      page_ids->push_back(children[i]);
+      *leaf_parent_page_id = page_id;
+      continue;
+    }
+    if (!ReadChildren(children[i], &grandchildren) ||
+        !CollectLeaves(children[i], grandchildren, 0, child_height - 1, max_pages, page_ids, leaf_parent_page_id)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Read the child page ids of an internal page without latching it.
+ * @return false if page_id is not an internal page, or a writer changed it meanwhile
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReadChildren(page_id_t page_id, std::vector<page_id_t> *children) {
+  Page *page = FetchTreePage(page_id);
+  uint64_t version = page->ReadVersion();
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  bool is_internal = !node->IsLeafPage();
+  int size = node->GetSize();
+  // Only read as many children as the page held at the version read.
+  bool valid = is_internal && page->ValidateVersion(version);
+  if (valid) {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    children->clear();
+    for (int i = 0; i < size; i++) {
+      children->push_back(internal->ValueAt(i));
+    }
+    valid = page->ValidateVersion(version);
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return valid;
+}
+
+/*
+ * Read the parent page id of a tree page without latching it.
+ * @return false if a writer changed the page meanwhile
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::ReadParentPageId(page_id_t page_id, page_id_t *parent_page_id) {
+  Page *page = FetchTreePage(page_id);
+  uint64_t version = page->ReadVersion();
+  *parent_page_id = reinterpret_cast<BPlusTreePage *>(page->GetData())->GetParentPageId();
+  bool valid = page->ValidateVersion(version);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return valid;
+}
+
 /*****************************************************************************
  * UTILITIES AND DEBUG
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
  * the left most leaf page
+ * The leaf is pinned but not latched, so it may change under the caller.
  */
 INDEX_TEMPLATE_ARGUMENTS
 Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
-  throw Exception(ExceptionType::NOT_IMPLEMENTED, "Implement this for test");
+  uint64_t version;
+  return FindLeafOptimistic(key, leftMost, &version);
+}
+
+/*
+ * Descend to the leaf without latching. Each child page id is validated against the version of its page before it is
+ * followed, and again once the child is pinned and its version read, so the child was still reachable when its version
+ * was taken. Restarts from the root when a validation fails.
+ * @return: the pinned leaf and its version in *version, or nullptr if the tree is empty
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FindLeafOptimistic(const KeyType &key, bool left_most, uint64_t *version) {
+  while (true) {
+    uint64_t root_version = root_latch_.ReadVersion();
+    page_id_t page_id = root_page_id_;
+    if (!root_latch_.Validate(root_version)) {
+      continue;
+    }
+    if (page_id == INVALID_PAGE_ID) {
+      return nullptr;
+    }
+    Page *page = FetchTreePage(page_id);
+    uint64_t page_version = page->ReadVersion();
+    if (!root_latch_.Validate(root_version)) {
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      continue;
+    }
+
+    while (true) {
+      auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+      if (node->IsLeafPage()) {
+        break;
+      }
+      auto *internal = reinterpret_cast<InternalPage *>(node);
+      page_id_t child_page_id = left_most ? internal->ValueAt(0) : internal->Lookup(key, comparator_);
+      if (!page->ValidateVersion(page_version)) {
+        break;
+      }
+      Page *child = FetchTreePage(child_page_id);
+      uint64_t child_version = child->ReadVersion();
+      if (!page->ValidateVersion(page_version)) {
+        buffer_pool_manager_->UnpinPage(child_page_id, false);
+        break;
+      }
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+      page = child;
+      page_version = child_version;
+    }
+
+    // The page type is only trusted once validated as well.
+    if (page->ValidateVersion(page_version) && reinterpret_cast<BPlusTreePage *>(page->GetData())->IsLeafPage()) {
+      *version = page_version;
+      return page;
+    }
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+}
+
+/*
+ * Descend to the leaf latching every page exclusively. Once a page is safe, i.e. the operation cannot change its
+ * parent, the latches on its ancestors are released. The latched pages are kept in the page set of the transaction,
+ * from the root down; a nullptr entry stands for the latch on the root page id.
+ * @return: false if the tree is empty; the root page id is latched then
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::FindLeafPessimistic(const KeyType &key, Operation operation, Transaction *transaction) {
+  auto page_set = transaction->GetPageSet();
+  root_latch_.WLock();
+  page_set->push_back(nullptr);
+  if (root_page_id_ == INVALID_PAGE_ID) {
+    return false;
+  }
+  Page *page = FetchTreePage(root_page_id_);
+  WLatchPage(page);
+  while (true) {
+    auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+    if (IsSafe(node, operation)) {
+      ReleaseLatches(transaction, false);
+    }
+    page_set->push_back(page);
+    if (node->IsLeafPage()) {
+      return true;
+    }
+    page = FetchTreePage(reinterpret_cast<InternalPage *>(node)->Lookup(key, comparator_));
+    WLatchPage(page);
+  }
+}
+
+/*
+ * @return: true if the operation cannot split or merge the node, so it does not change the parent of node
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *node, Operation operation) const {
+  auto *leaf = reinterpret_cast<LeafPage *>(node);
+  auto *internal = reinterpret_cast<InternalPage *>(node);
+  if (operation == Operation::INSERT) {
+    return node->IsLeafPage() ? !leaf->IsFull() : !internal->IsFull();
+  }
+  if (node->IsRootPage()) {
+    return node->GetSize() > (node->IsLeafPage() ? 1 : 2);
+  }
+  return node->IsLeafPage() ? !leaf->MayUnderflowAfterRemove() : !internal->MayUnderflowAfterRemove();
+}
+
+/*
+ * Return the shortest key that separates two neighbouring keys, left < separator <= right, for internal pages, which
+ * store keys without their trailing zero bytes (see BPlusTreeInternalPage). The candidates are the first bytes of
+ * right followed by zeros. A comparator need not order keys by their bytes, so each candidate is checked against both
+ * keys; right itself always qualifies.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+KeyType BPLUSTREE_TYPE::Separator(const KeyType &left, const KeyType &right) const {
+  if (!comparator_.CanTruncateKeys()) {
+    return right;
+  }
+  KeyType separator;
+  memset(static_cast<void *>(&separator), 0, sizeof(KeyType));
+  auto *separator_bytes = reinterpret_cast<char *>(&separator);
+  auto *right_bytes = reinterpret_cast<const char *>(&right);
+  for (size_t length = 0; length < sizeof(KeyType); length++) {
+    // Only a nonzero byte makes a new candidate.
+    if ((length == 0 || right_bytes[length - 1] != 0) && comparator_(left, separator) < 0 &&
+        comparator_(separator, right) <= 0) {
+      return separator;
+    }
+    separator_bytes[length] = right_bytes[length];
+  }
+  return right;
+}
+
+/*
+ * Release the latches in the page set of the transaction, then delete the pages that were emptied.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::ReleaseLatches(Transaction *transaction, bool is_dirty) {
+  auto page_set = transaction->GetPageSet();
+  for (Page *page : *page_set) {
+    if (page == nullptr) {
+      root_latch_.WUnlock();
+      continue;
+    }
+    WUnlatchPage(page);
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+  page_set->clear();
+  // Optimistic readers may still hold a pin on a deleted page; they fail to validate its parent, or the page itself.
+  // The page is then left to the replacer.
+  auto deleted_page_set = transaction->GetDeletedPageSet();
+  for (page_id_t page_id : *deleted_page_set) {
+    buffer_pool_manager_->DeletePage(page_id);
+  }
+  deleted_page_set->clear();
+}
+
+/*
+ * Return the parent of node from the page set of the transaction, where it comes right before node: node was not safe,
+ * so its parent is still latched. The parent page id that node stores is not used, since a writer that moves node to
+ * another parent sets it without latching node.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::LatchedParent(BPlusTreePage *node, Transaction *transaction) {
+  auto page_set = transaction->GetPageSet();
+  auto it = std::find_if(page_set->rbegin(), page_set->rend(), [node](Page *page) {
+    return page != nullptr && page->GetData() == reinterpret_cast<char *>(node);
+  });
+  if (it == page_set->rend() || std::next(it) == page_set->rend() || *std::next(it) == nullptr) {
+    throw Exception("the parent of a b+ tree page that is not safe is not latched");
+  }
+  return *std::next(it);
+}
+
+/*
+ * Pin a page of the tree. page_id must come from a page whose version was validated after it was read, so it is never
+ * INVALID_PAGE_ID, which the buffer pool does not take.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+Page *BPLUSTREE_TYPE::FetchTreePage(page_id_t page_id) {
+  if (page_id == INVALID_PAGE_ID) {
+    throw Exception("a b+ tree page id is invalid");
+  }
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read a b+ tree page");
+  }
+  return page;
+}
+
+/*
+ * Writers hold the version latch, which stops optimistic readers, and the page latch, which stops the buffer pool from
+ * flushing a page that is half written.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WLatchPage(Page *page) {
+  page->VersionWLatch();
+  page->WLatch();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::WUnlatchPage(Page *page) {
+  page->WUnlatch();
+  page->VersionWUnlatch();
 }
 
 /*
@@ -226,32 +1088,33 @@ Page *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost) {
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::UpdateRootPageId(int insert_record) {
   HeaderPage *header_page = static_cast<HeaderPage *>(buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
-  if (insert_record != 0) {
-    // create a new record<index_name + root_page_id> in header_page
-    header_page->InsertRecord(index_name_, root_page_id_);
-  } else {
+  // Every index shares the header page.
+  header_page->WLatch();
+  // A tree that became empty and starts again already has its record.
+  if (insert_record == 0 || !header_page->InsertRecord(index_name_, root_page_id_)) {
     // update root_page_id in header_page
     header_page->UpdateRecord(index_name_, root_page_id_);
   }
+  header_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
 }
 
 /*
  * This method is used for test only
- * Read data from file and insert one by one
+ * Read data from file and bulk load it into an empty tree, or insert it one by one otherwise
  */
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::InsertFromFile(const std::string &file_name, Transaction *transaction) {
   int64_t key;
   std::ifstream input(file_name);
-  while (input) {
-    input >> key;
-
+  BPlusTreeBulkLoader<KeyType, ValueType, KeyComparator> loader(this, buffer_pool_manager_, comparator_);
+  while (input >> key) {
     KeyType index_key;
     index_key.SetFromInteger(key);
     RID rid(key);
-    Insert(index_key, rid, transaction);
+    loader.Add(index_key, rid);
   }
+  loader.Finish(transaction);
 }
 /*
  * This method is used for test only
@@ -400,5 +1263,12 @@ template class BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTree<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTree<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTree<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTree<IntegerKey, RID, IntegerComparator>;
+template class BPlusTree<PostingKey<GenericKey<4>>, RID, PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+template class BPlusTree<PostingKey<GenericKey<8>>, RID, PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+template class BPlusTree<PostingKey<GenericKey<16>>, RID, PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+template class BPlusTree<PostingKey<GenericKey<32>>, RID, PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+template class BPlusTree<PostingKey<GenericKey<64>>, RID, PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+template class BPlusTree<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
 
 }  // namespace bustub
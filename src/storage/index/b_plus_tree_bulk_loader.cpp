@@ -0,0 +1,227 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_loader.cpp
+//
+// Identification: src/storage/index/b_plus_tree_bulk_loader.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/index/b_plus_tree_bulk_loader.h"
+
+#include <algorithm>
+
+#include "common/exception.h"
+
+namespace bustub {
+
+/** The number of entries of a run on one page. */
+#define RUN_PAGE_SIZE (PAGE_SIZE / sizeof(MappingType))
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_BULK_LOADER_TYPE::BPlusTreeBulkLoader(Tree *tree, BufferPoolManager *buffer_pool_manager,
+                                                const KeyComparator &comparator, size_t memory_budget,
+                                                double fill_factor)
+    : tree_(tree),
+      buffer_pool_manager_(buffer_pool_manager),
+      comparator_(comparator),
+      memory_budget_(memory_budget),
+      fill_factor_(fill_factor) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+BPLUSTREE_BULK_LOADER_TYPE::~BPlusTreeBulkLoader() {
+  for (const auto &run : runs_) {
+    for (page_id_t page_id : run.page_ids_) {
+      buffer_pool_manager_->DeletePage(page_id);
+    }
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BULK_LOADER_TYPE::Add(const KeyType &key, const ValueType &value) {
+  entries_.emplace_back(key, value);
+  if (memory_budget_ != 0 && entries_.size() * sizeof(MappingType) >= memory_budget_) {
+    Spill();
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_BULK_LOADER_TYPE::Finish(Transaction *transaction) {
+  bool loaded;
+  if (runs_.empty()) {
+    SortEntries();
+    size_t next = 0;
+    loaded = tree_->BulkLoad(
+        [&](MappingType *entry) {
+          if (next == entries_.size()) {
+            return false;
+          }
+          *entry = entries_[next++];
+          return true;
+        },
+        fill_factor_);
+    if (!loaded) {
+      for (const auto &entry : entries_) {
+        tree_->Insert(entry.first, entry.second, transaction);
+      }
+    }
+    entries_.clear();
+    return loaded;
+  }
+
+  if (!entries_.empty()) {
+    Spill();
+  }
+  StartMerge();
+  loaded = tree_->BulkLoad([&](MappingType *entry) { return NextMerged(entry); }, fill_factor_);
+  if (!loaded) {
+    MappingType entry;
+    StartMerge();
+    while (NextMerged(&entry)) {
+      tree_->Insert(entry.first, entry.second, transaction);
+    }
+  }
+  return loaded;
+}
+
+/*
+ * The sort is stable, so the first entry added for a key is the one that stays.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BULK_LOADER_TYPE::SortEntries() {
+  std::stable_sort(entries_.begin(), entries_.end(), [&](const MappingType &a, const MappingType &b) {
+    return comparator_(a.first, b.first) < 0;
+  });
+  auto last = std::unique(entries_.begin(), entries_.end(), [&](const MappingType &a, const MappingType &b) {
+    return comparator_(a.first, b.first) == 0;
+  });
+  entries_.erase(last, entries_.end());
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BULK_LOADER_TYPE::Spill() {
+  SortEntries();
+  Run run{{}, entries_.size()};
+  for (size_t begin = 0; begin < entries_.size(); begin += RUN_PAGE_SIZE) {
+    page_id_t page_id;
+    Page *page = buffer_pool_manager_->NewPage(&page_id);
+    if (page == nullptr) {
+      for (page_id_t written_page_id : run.page_ids_) {
+        buffer_pool_manager_->DeletePage(written_page_id);
+      }
+      throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to write a run of a b+ tree bulk load");
+    }
+    size_t end = std::min(begin + RUN_PAGE_SIZE, entries_.size());
+    std::copy(entries_.begin() + begin, entries_.begin() + end, reinterpret_cast<MappingType *>(page->GetData()));
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    run.page_ids_.push_back(page_id);
+  }
+  runs_.push_back(std::move(run));
+  entries_.clear();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BULK_LOADER_TYPE::StartMerge() {
+  readers_.clear();
+  merge_heap_.clear();
+  merged_any_ = false;
+  for (const auto &run : runs_) {
+    readers_.push_back(RunReader{&run, 0, {}});
+  }
+  for (size_t i = 0; i < readers_.size(); i++) {
+    if (readers_[i].run_->size_ > 0) {
+      ReadRunPage(&readers_[i]);
+      merge_heap_.push_back(i);
+    }
+  }
+  std::make_heap(merge_heap_.begin(), merge_heap_.end(), [&](size_t a, size_t b) { return ComesAfter(a, b); });
+}
+
+/*
+ * Runs are written in the order the entries were added, so among equal keys the entry of the earliest run comes first
+ * and is the one that is kept.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_BULK_LOADER_TYPE::NextMerged(MappingType *entry) {
+  auto comes_after = [&](size_t a, size_t b) { return ComesAfter(a, b); };
+  while (!merge_heap_.empty()) {
+    std::pop_heap(merge_heap_.begin(), merge_heap_.end(), comes_after);
+    size_t index = merge_heap_.back();
+    RunReader &reader = readers_[index];
+    MappingType next = reader.page_entries_[reader.position_ % RUN_PAGE_SIZE];
+    reader.position_++;
+    if (reader.position_ < reader.run_->size_) {
+      if (reader.position_ % RUN_PAGE_SIZE == 0) {
+        ReadRunPage(&reader);
+      }
+      std::push_heap(merge_heap_.begin(), merge_heap_.end(), comes_after);
+    } else {
+      merge_heap_.pop_back();
+    }
+    if (merged_any_ && comparator_(next.first, last_merged_.first) == 0) {
+      continue;
+    }
+    last_merged_ = next;
+    merged_any_ = true;
+    *entry = next;
+    return true;
+  }
+  return false;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_BULK_LOADER_TYPE::ReadRunPage(RunReader *reader) {
+  size_t page_index = reader->position_ / RUN_PAGE_SIZE;
+  page_id_t page_id = reader->run_->page_ids_[page_index];
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to read a run of a b+ tree bulk load");
+  }
+  size_t size = std::min(RUN_PAGE_SIZE, reader->run_->size_ - page_index * RUN_PAGE_SIZE);
+  auto *entries = reinterpret_cast<MappingType *>(page->GetData());
+  reader->page_entries_.assign(entries, entries + size);
+  buffer_pool_manager_->UnpinPage(page_id, false);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_BULK_LOADER_TYPE::ComesAfter(size_t a, size_t b) const {
+  const RunReader &reader_a = readers_[a];
+  const RunReader &reader_b = readers_[b];
+  int cmp = comparator_(reader_a.page_entries_[reader_a.position_ % RUN_PAGE_SIZE].first,
+                        reader_b.page_entries_[reader_b.position_ % RUN_PAGE_SIZE].first);
+  return cmp != 0 ? cmp > 0 : a > b;
+}
+
+template class BPlusTreeBulkLoader<GenericKey<4>, RID, GenericComparator<4>>;
+
+template class BPlusTreeBulkLoader<GenericKey<8>, RID, GenericComparator<8>>;
+
+template class BPlusTreeBulkLoader<GenericKey<16>, RID, GenericComparator<16>>;
+
+template class BPlusTreeBulkLoader<GenericKey<32>, RID, GenericComparator<32>>;
+
+template class BPlusTreeBulkLoader<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeBulkLoader<IntegerKey, RID, IntegerComparator>;
+
+template class BPlusTreeBulkLoader<PostingKey<GenericKey<4>>, RID,
+                                   PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+
+template class BPlusTreeBulkLoader<PostingKey<GenericKey<8>>, RID,
+                                   PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+
+template class BPlusTreeBulkLoader<PostingKey<GenericKey<16>>, RID,
+                                   PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+
+template class BPlusTreeBulkLoader<PostingKey<GenericKey<32>>, RID,
+                                   PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+
+template class BPlusTreeBulkLoader<PostingKey<GenericKey<64>>, RID,
+                                   PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+
+template class BPlusTreeBulkLoader<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
+
+}  // namespace bustub
@@ -11,6 +11,9 @@
 
 #include "storage/index/b_plus_tree_index.h"
 
+#include "common/exception.h"
+#include "storage/index/b_plus_tree_bulk_loader.h"
+
 namespace bustub {
 /*
  * Constructor
@@ -19,22 +22,37 @@ INDEX_TEMPLATE_ARGUMENTS
 BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata, BufferPoolManager *buffer_pool_manager)
     : Index(std::move(metadata)),
       comparator_(GetMetadata()->GetKeySchema()),
+      buffer_pool_manager_(buffer_pool_manager),
       container_(GetMetadata()->GetName(), buffer_pool_manager, comparator_) {}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct insert index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  KeyType index_key = MakeKey(key, rid);
 
   container_.Insert(index_key, rid, transaction);
 }
 
+/*
+ * An empty tree is bulk loaded from the sorted entries instead.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::InsertEntries(const std::function<bool(Tuple *key, RID *rid)> &next_entry,
+                                         Transaction *transaction) {
+  BPlusTreeBulkLoader<KeyType, ValueType, KeyComparator> loader(&container_, buffer_pool_manager_, comparator_,
+                                                                INDEX_BUILD_MEMORY_BUDGET);
+  Tuple key;
+  RID rid;
+  while (next_entry(&key, &rid)) {
+    loader.Add(MakeKey(key, rid), rid);
+  }
+  loader.Finish(transaction);
+}
+
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::DeleteEntry(const Tuple &key, RID rid, Transaction *transaction) {
   // construct delete index key
-  KeyType index_key;
-  index_key.SetFromKey(key);
+  KeyType index_key = MakeKey(key, rid);
 
   container_.Remove(index_key, transaction);
 }
@@ -45,7 +63,17 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> *result, T
   KeyType index_key;
   index_key.SetFromKey(key);
 
-  container_.GetValue(index_key, result, transaction);
+  container_.ScanKey(index_key, result, transaction);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType BPLUSTREE_INDEX_TYPE::MakeKey(const Tuple &key, RID rid) {
+  KeyType index_key;
+  index_key.SetFromKey(key);
+  if constexpr (IsPostingKey<KeyType>::value) {
+    index_key.SetRid(rid);
+  }
+  return index_key;
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -57,10 +85,68 @@ INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetEndIterator() { return container_.End(); }
 
+/*
+ * An index over keys of the given type, or over posting keys of that type if the index keys are not unique.
+ */
+template <typename KeyType, typename KeyComparator>
+static std::unique_ptr<Index> MakeBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                                 BufferPoolManager *buffer_pool_manager, bool unique_keys) {
+  if (unique_keys) {
+    return std::make_unique<BPlusTreeIndex<KeyType, RID, KeyComparator>>(std::move(metadata), buffer_pool_manager);
+  }
+  return std::make_unique<BPlusTreeIndex<PostingKey<KeyType>, RID, PostingComparator<KeyType, KeyComparator>>>(
+      std::move(metadata), buffer_pool_manager);
+}
+
+/*
+ * Integer keys are compared as machine integers and searched with vector comparisons; other keys take the smallest
+ * generic key that holds them.
+ */
+std::unique_ptr<Index> CreateBPlusTreeIndex(std::unique_ptr<IndexMetadata> &&metadata,
+                                            BufferPoolManager *buffer_pool_manager, bool unique_keys) {
+  const Schema &key_schema = *metadata->GetKeySchema();
+  if (IntegerComparator::SupportsKeySchema(key_schema)) {
+    return MakeBPlusTreeIndex<IntegerKey, IntegerComparator>(std::move(metadata), buffer_pool_manager, unique_keys);
+  }
+  // Columns stored out of line follow the inlined part of the key, so such keys take the largest size.
+  uint32_t key_size = key_schema.IsInlined() ? key_schema.GetLength() : 64;
+  if (key_size <= 4) {
+    return MakeBPlusTreeIndex<GenericKey<4>, GenericComparator<4>>(std::move(metadata), buffer_pool_manager,
+                                                                   unique_keys);
+  }
+  if (key_size <= 8) {
+    return MakeBPlusTreeIndex<GenericKey<8>, GenericComparator<8>>(std::move(metadata), buffer_pool_manager,
+                                                                   unique_keys);
+  }
+  if (key_size <= 16) {
+    return MakeBPlusTreeIndex<GenericKey<16>, GenericComparator<16>>(std::move(metadata), buffer_pool_manager,
+                                                                     unique_keys);
+  }
+  if (key_size <= 32) {
+    return MakeBPlusTreeIndex<GenericKey<32>, GenericComparator<32>>(std::move(metadata), buffer_pool_manager,
+                                                                     unique_keys);
+  }
+  if (key_size <= 64) {
+    return MakeBPlusTreeIndex<GenericKey<64>, GenericComparator<64>>(std::move(metadata), buffer_pool_manager,
+                                                                     unique_keys);
+  }
+  throw Exception(ExceptionType::OUT_OF_RANGE, "b+ tree index keys take at most 64 bytes");
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+template class BPlusTreeIndex<IntegerKey, RID, IntegerComparator>;
+template class BPlusTreeIndex<PostingKey<GenericKey<4>>, RID, PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+template class BPlusTreeIndex<PostingKey<GenericKey<8>>, RID, PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+template class BPlusTreeIndex<PostingKey<GenericKey<16>>, RID,
+                              PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+template class BPlusTreeIndex<PostingKey<GenericKey<32>>, RID,
+                              PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+template class BPlusTreeIndex<PostingKey<GenericKey<64>>, RID,
+                              PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+template class BPlusTreeIndex<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
 
 }  // namespace bustub
@@ -1,30 +1,167 @@
 /**
  * index_iterator.cpp
  */
+#include <algorithm>
 #include <cassert>
+#include <utility>
 
+#include "storage/index/b_plus_tree.h"
 #include "storage/index/index_iterator.h"
 
 namespace bustub {
 
-/*
- * NOTE: you can change the destructor/constructor method here
- * set your own input parameters
- */
 INDEX_TEMPLATE_ARGUMENTS
 INDEXITERATOR_TYPE::IndexIterator() = default;
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::~IndexIterator() = default;
+INDEXITERATOR_TYPE::IndexIterator(Tree *tree, BufferPoolManager *buffer_pool_manager)
+    : tree_(tree),
+      buffer_pool_manager_(buffer_pool_manager),
+      read_ahead_(buffer_pool_manager, tree->GetNextLeavesFn()) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::~IndexIterator() { Release(); }
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other) noexcept
+    : tree_(other.tree_),
+      buffer_pool_manager_(other.buffer_pool_manager_),
+      page_(std::exchange(other.page_, nullptr)),
+      version_(other.version_),
+      entries_(std::move(other.entries_)),
+      next_page_id_(other.next_page_id_),
+      index_(std::exchange(other.index_, 0)),
+      resume_key_(other.resume_key_),
+      resume_inclusive_(other.resume_inclusive_),
+      resume_left_most_(other.resume_left_most_),
+      read_ahead_(std::move(other.read_ahead_)) {}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator=(IndexIterator &&other) noexcept {
+  if (this != &other) {
+    Release();
+    tree_ = other.tree_;
+    buffer_pool_manager_ = other.buffer_pool_manager_;
+    page_ = std::exchange(other.page_, nullptr);
+    version_ = other.version_;
+    entries_ = std::move(other.entries_);
+    next_page_id_ = other.next_page_id_;
+    index_ = std::exchange(other.index_, 0);
+    resume_key_ = other.resume_key_;
+    resume_inclusive_ = other.resume_inclusive_;
+    resume_left_most_ = other.resume_left_most_;
+    read_ahead_ = std::move(other.read_ahead_);
+  }
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool INDEXITERATOR_TYPE::IsEnd() { return page_ == nullptr; }
+
+INDEX_TEMPLATE_ARGUMENTS
+const MappingType &INDEXITERATOR_TYPE::operator*() {
+  assert(page_ != nullptr);
+  return entries_[index_];
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-bool INDEXITERATOR_TYPE::IsEnd() { throw std::runtime_error("unimplemented"); }
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
+  index_++;
+  SkipExhaustedLeaves();
+  return *this;
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &INDEXITERATOR_TYPE::operator*() { throw std::runtime_error("unimplemented"); }
+void INDEXITERATOR_TYPE::Seek(const KeyType &key, bool inclusive, bool left_most) {
+  const KeyComparator &comparator = tree_->comparator_;
+  resume_key_ = key;
+  resume_inclusive_ = inclusive;
+  resume_left_most_ = left_most;
+  while (true) {
+    uint64_t version;
+    Page *page = tree_->FindLeafOptimistic(key, left_most, &version);
+    if (page == nullptr) {
+      Release();
+      return;
+    }
+    if (!Load(page, version)) {
+      continue;
+    }
+    if (!left_most) {
+      // Drop the entries out of range, so that every entry left is returned before the iterator moves on.
+      entries_.erase(entries_.begin(),
+                     std::partition_point(entries_.begin(), entries_.end(), [&](const MappingType &entry) {
+                       int cmp = comparator(entry.first, key);
+                       return inclusive ? cmp < 0 : cmp <= 0;
+                     }));
+    }
+    SkipExhaustedLeaves();
+    return;
+  }
+}
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() { throw std::runtime_error("unimplemented"); }
+bool INDEXITERATOR_TYPE::Load(Page *page, uint64_t version) {
+  auto *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  std::vector<MappingType> entries;
+  leaf->GetItems(&entries);
+  page_id_t next_page_id = leaf->GetNextPageId();
+  if (!page->ValidateVersion(version)) {
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+    return false;
+  }
+  Release();
+  page_ = page;
+  version_ = version;
+  entries_ = std::move(entries);
+  next_page_id_ = next_page_id;
+  index_ = 0;
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipExhaustedLeaves() {
+  while (page_ != nullptr && index_ >= entries_.size()) {
+    if (!entries_.empty()) {
+      resume_key_ = entries_.back().first;
+      resume_inclusive_ = false;
+      resume_left_most_ = false;
+    }
+    // The next page id is only followed while the current leaf is unchanged, and so still its left sibling.
+    if (page_->ValidateVersion(version_)) {
+      if (next_page_id_ == INVALID_PAGE_ID) {
+        Release();
+        return;
+      }
+      page_id_t next_page_id = next_page_id_;
+      read_ahead_.OnPageAccess(next_page_id);
+      Page *next = tree_->FetchTreePage(next_page_id);
+      uint64_t next_version = next->ReadVersion();
+      if (page_->ValidateVersion(version_)) {
+        if (Load(next, next_version)) {
+          continue;
+        }
+      } else {
+        buffer_pool_manager_->UnpinPage(next_page_id, false);
+      }
+    }
+    // A writer changed the current leaf: continue after the last key returned, as found in the tree now.
+    KeyType resume_key = resume_key_;
+    Seek(resume_key, resume_inclusive_, resume_left_most_);
+    return;
+  }
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::Release() {
+  if (page_ != nullptr) {
+    buffer_pool_manager_->UnpinPage(page_->GetPageId(), false);
+    page_ = nullptr;
+  }
+  entries_.clear();
+  next_page_id_ = INVALID_PAGE_ID;
+  index_ = 0;
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 
@@ -36,4 +173,18 @@ template class IndexIterator<GenericKey<32>, RID, GenericComparator<32>>;
 
 template class IndexIterator<GenericKey<64>, RID, GenericComparator<64>>;
 
+template class IndexIterator<IntegerKey, RID, IntegerComparator>;
+
+template class IndexIterator<PostingKey<GenericKey<4>>, RID, PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+
+template class IndexIterator<PostingKey<GenericKey<8>>, RID, PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+
+template class IndexIterator<PostingKey<GenericKey<16>>, RID, PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+
+template class IndexIterator<PostingKey<GenericKey<32>>, RID, PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+
+template class IndexIterator<PostingKey<GenericKey<64>>, RID, PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+
+template class IndexIterator<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
+
 }  // namespace bustub
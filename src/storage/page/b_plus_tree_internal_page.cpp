@@ -9,10 +9,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 
 #include "common/exception.h"
+#include "storage/index/posting_key.h"
 #include "storage/page/b_plus_tree_internal_page.h"
 
 namespace bustub {
@@ -25,34 +28,135 @@ namespace bustub {
  * max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetLSN();
+  SetMaxSize(max_size);
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+  Reset();
+}
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
  * array offset)
+ * Optimistic readers may call KeyAt while a writer changes the page, so the key is clamped to the page.
  */
 INDEX_TEMPLATE_ARGUMENTS
 KeyType B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code
-  KeyType key{};
+  KeyType key;
+  memset(static_cast<void *>(&key), 0, sizeof(KeyType));
+  size_t length = std::min<size_t>(slots_[index].key_length_, sizeof(KeyType));
+  size_t offset = std::min<size_t>(slots_[index].key_offset_, PAGE_SIZE - length);
+  memcpy(static_cast<void *>(&key), reinterpret_cast<const char *>(this) + offset, length);
   return key;
 }
 
+/*
+ * The caller makes sure the key fits (see HasRoomToSetKeyAt).
+ */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::SetKeyAt(int index, const KeyType &key) {
+  EraseKey(index);
+  WriteKey(index, key);
+}
 
 /*
  * Helper method to find and return array index(or offset), so that its value
  * equals to input "value"
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const { return 0; }
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueIndex(const ValueType &value) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (slots_[i].value_ == value) {
+      return i;
+    }
+  }
+  return -1;
+}
 
 /*
  * Helper method to get the value associated with input "index"(a.k.a array
  * offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return 0; }
+ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return slots_[index].value_; }
+
+/*
+ * @return: the length of the key without its trailing zero bytes
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_INTERNAL_PAGE_TYPE::KeyLength(const KeyType &key) {
+  auto *bytes = reinterpret_cast<const char *>(&key);
+  size_t length = sizeof(KeyType);
+  while (length > 0 && bytes[length - 1] == 0) {
+    length--;
+  }
+  return length;
+}
+
+/*
+ * @return: the bytes taken by the slots and the keys
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetUsedSpace() const {
+  return GetSize() * sizeof(Slot) + (PAGE_SIZE - keys_begin_);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_INTERNAL_PAGE_TYPE::GetFreeSpace() const { return INTERNAL_PAGE_CAPACITY - GetUsedSpace(); }
+
+/*****************************************************************************
+ * SPACE ACCOUNTING
+ *****************************************************************************/
+/*
+ * @return: true if the key and a child fit without exceeding the max size or the given share of the space of the page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomFor(const KeyType &key, double fill_factor) const {
+  return GetSize() < GetMaxSize() &&
+         GetUsedSpace() + sizeof(Slot) + KeyLength(key) <= fill_factor * INTERNAL_PAGE_CAPACITY;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::HasRoomToSetKeyAt(int index, const KeyType &key) const {
+  return static_cast<int>(KeyLength(key)) <= slots_[index].key_length_ + GetFreeSpace();
+}
+
+/*
+ * @return: true if the next insert may split the page, whatever its key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsFull() const {
+  return GetSize() >= GetMaxSize() || GetFreeSpace() < static_cast<int>(sizeof(Slot) + sizeof(KeyType));
+}
+
+/*
+ * A page underflows once it has fewer children than its min size and uses less than half of its space, so pages of
+ * short keys are not merged while they are still half full.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::IsUnderflow() const {
+  return GetSize() < GetMinSize() && GetUsedSpace() < static_cast<int>(INTERNAL_PAGE_CAPACITY / 2);
+}
+
+/*
+ * @return: true if removing any one child may make the page underflow
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::MayUnderflowAfterRemove() const {
+  return GetSize() - 1 < GetMinSize() &&
+         GetUsedSpace() < static_cast<int>(INTERNAL_PAGE_CAPACITY / 2 + sizeof(Slot) + sizeof(KeyType));
+}
+
+/*
+ * @return: true if the children of other fit into me, with the middle key in place of its invalid KEY(0)
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_INTERNAL_PAGE_TYPE::CanMergeFrom(const BPlusTreeInternalPage *other, const KeyType &middle_key) const {
+  return GetSize() + other->GetSize() <= GetMaxSize() &&
+         other->GetUsedSpace() - other->slots_[0].key_length_ + static_cast<int>(KeyLength(middle_key)) <=
+             GetFreeSpace();
+}
 
 /*****************************************************************************
  * LOOKUP
@@ -61,10 +165,23 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::ValueAt(int index) const { return 0; }
  * Find and return the child pointer(page_id) which points to the child page
  * that contains input "key"
  * Start the search from the second key(the first key should always be invalid)
+ * Optimistic readers may call this while a writer changes the page, so the size is clamped to the page: the result is
+ * garbage then, but the reader throws it away once it fails to validate the page version.
  */
 INDEX_TEMPLATE_ARGUMENTS
 ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyComparator &comparator) const {
-  return INVALID_PAGE_ID;
+  // Find the last key that is <= key; KEY(0) counts as smaller than every key.
+  int low = 1;
+  int high = std::clamp(GetSize(), 1, static_cast<int>(INTERNAL_PAGE_SIZE)) - 1;
+  while (low <= high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(KeyAt(mid), key) <= 0) {
+      low = mid + 1;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return slots_[low - 1].value_;
 }
 
 /*****************************************************************************
@@ -78,34 +195,144 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::Lookup(const KeyType &key, const KeyCo
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
-                                                     const ValueType &new_value) {}
+                                                     const ValueType &new_value) {
+  KeyType empty_key;
+  memset(static_cast<void *>(&empty_key), 0, sizeof(KeyType));
+  Reset();
+  InsertAt(0, empty_key, old_value);
+  InsertAt(1, new_key, new_value);
+}
+/*
+ * Add key & value pair after the last pair, for filling a page in key order. The key of the first pair is ignored, as
+ * always. The caller sets the parent page id of the child.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Append(const KeyType &key, const ValueType &value) {
+  InsertAt(GetSize(), key, value);
+}
 /*
  * Insert new_key & new_value pair right after the pair with its value ==
  * old_value
+ * The caller makes sure the key fits (see HasRoomFor).
  * @return:  new size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(const ValueType &old_value, const KeyType &new_key,
                                                     const ValueType &new_value) {
-  return 0;
+  InsertAt(ValueIndex(old_value) + 1, new_key, new_value);
+  return GetSize();
+}
+
+/*
+ * Remove every key & value pair.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Reset() {
+  SetSize(0);
+  keys_begin_ = PAGE_SIZE;
+}
+
+/*
+ * Put a slot for the key & value pair at the index.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  memmove(static_cast<void *>(slots_ + index + 1), static_cast<void *>(slots_ + index),
+          (GetSize() - index) * sizeof(Slot));
+  slots_[index].value_ = value;
+  IncreaseSize(1);
+  WriteKey(index, key);
+}
+
+/*
+ * Write the key without its trailing zero bytes at the start of the keys, for the slot at the index.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::WriteKey(int index, const KeyType &key) {
+  auto length = static_cast<uint16_t>(KeyLength(key));
+  keys_begin_ -= length;
+  memcpy(reinterpret_cast<char *>(this) + keys_begin_, static_cast<const void *>(&key), length);
+  slots_[index].key_offset_ = keys_begin_;
+  slots_[index].key_length_ = length;
+}
+
+/*
+ * Free the space of the key of the slot at the index. The keys stay packed at the end of the page, so the ones in
+ * front of it move back over it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::EraseKey(int index) {
+  uint16_t offset = slots_[index].key_offset_;
+  uint16_t length = slots_[index].key_length_;
+  auto *data = reinterpret_cast<char *>(this);
+  memmove(data + keys_begin_ + length, data + keys_begin_, offset - keys_begin_);
+  keys_begin_ += length;
+  for (int i = 0; i < GetSize(); i++) {
+    if (slots_[i].key_offset_ < offset) {
+      slots_[i].key_offset_ += length;
+    }
+  }
+  slots_[index].key_offset_ = keys_begin_;
+  slots_[index].key_length_ = 0;
 }
 
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Split the page together with the new_key & new_value pair that did not fit, which goes right after the pair with
+ * its value == old_value: the upper half of the pairs moves to "recipient". Halves are counted in pairs, unless they
+ * take more space than a page.
+ * The first key moved ends up as the invalid KEY(0) of recipient; it is the key to push up into the parent.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(BPlusTreeInternalPage *recipient,
-                                                BufferPoolManager *buffer_pool_manager) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertAndMoveHalfTo(const ValueType &old_value, const KeyType &new_key,
+                                                         const ValueType &new_value, BPlusTreeInternalPage *recipient,
+                                                         BufferPoolManager *buffer_pool_manager) {
+  std::vector<std::pair<KeyType, ValueType>> items;
+  items.reserve(GetSize() + 1);
+  for (int i = 0; i < GetSize(); i++) {
+    items.emplace_back(KeyAt(i), ValueAt(i));
+  }
+  items.emplace(items.begin() + ValueIndex(old_value) + 1, new_key, new_value);
+  auto space = [&](size_t begin, size_t end) {
+    size_t bytes = 0;
+    for (size_t i = begin; i < end; i++) {
+      bytes += sizeof(Slot) + KeyLength(items[i].first);
+    }
+    return bytes;
+  };
+  size_t keep = (items.size() + 1) / 2;
+  while (keep > 2 && space(0, keep) > INTERNAL_PAGE_CAPACITY) {
+    keep--;
+  }
+  while (keep + 2 < items.size() && space(keep, items.size()) > INTERNAL_PAGE_CAPACITY) {
+    keep++;
+  }
+  Reset();
+  for (size_t i = 0; i < keep; i++) {
+    InsertAt(GetSize(), items[i].first, items[i].second);
+  }
+  for (size_t i = keep; i < items.size(); i++) {
+    recipient->InsertAt(recipient->GetSize(), items[i].first, items[i].second);
+    recipient->Adopt(items[i].second, buffer_pool_manager);
+  }
+}
 
-/* Copy entries into me, starting from {items} and copy {size} entries.
- * Since it is an internal page, for all entries (pages) moved, their parents page now changes to me.
- * So I need to 'adopt' them by changing their parent page id, which needs to be persisted with BufferPoolManger
+/*
+ * Set the parent page id of the child to me.
+ * The caller holds the latch of the old and the new parent, which are the only pages that lead to the child. Nobody
+ * else changes the parent page id of the child meanwhile, and readers do not use it, so the child is not latched.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager) {
+  Page *page = buffer_pool_manager->FetchPage(child_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to adopt a b+ tree page");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child_page_id, true);
+}
 
 /*****************************************************************************
  * REMOVE
@@ -116,14 +343,23 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyNFrom(MappingType *items, int size, Buf
  * NOTE: store key&value pair continuously after deletion
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {}
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Remove(int index) {
+  EraseKey(index);
+  memmove(static_cast<void *>(slots_ + index), static_cast<void *>(slots_ + index + 1),
+          (GetSize() - index - 1) * sizeof(Slot));
+  IncreaseSize(-1);
+}
 
 /*
  * Remove the only key & value pair in internal page and return the value
  * NOTE: only call this method within AdjustRoot()(in b_plus_tree.cpp)
  */
 INDEX_TEMPLATE_ARGUMENTS
-ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() { return INVALID_PAGE_ID; }
+ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
+  ValueType value = ValueAt(0);
+  Reset();
+  return value;
+}
 /*****************************************************************************
  * MERGE
  *****************************************************************************/
@@ -133,10 +369,17 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() { return IN
  * to make sure the middle key is added to the recipient to maintain the invariant.
  * You also need to use BufferPoolManager to persist changes to the parent page id for those
  * pages that are moved to the recipient
+ * The caller makes sure they fit (see CanMergeFrom).
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                                               BufferPoolManager *buffer_pool_manager) {}
+                                               BufferPoolManager *buffer_pool_manager) {
+  for (int i = 0; i < GetSize(); i++) {
+    recipient->InsertAt(recipient->GetSize(), i == 0 ? middle_key : KeyAt(i), ValueAt(i));
+    recipient->Adopt(ValueAt(i), buffer_pool_manager);
+  }
+  Reset();
+}
 
 /*****************************************************************************
  * REDISTRIBUTE
@@ -151,14 +394,12 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(BPlusTreeInternalPage *recipient,
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                                                      BufferPoolManager *buffer_pool_manager) {}
-
-/* Append an entry at the end.
- * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
- * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
- */
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {}
+                                                      BufferPoolManager *buffer_pool_manager) {
+  recipient->InsertAt(recipient->GetSize(), middle_key, ValueAt(0));
+  recipient->Adopt(ValueAt(0), buffer_pool_manager);
+  // KEY(1) becomes the invalid KEY(0); it is the new separator for the parent.
+  Remove(0);
+}
 
 /*
  * Remove the last key & value pair from this page to head of "recipient" page.
@@ -169,14 +410,179 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair, Buffe
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const KeyType &middle_key,
-                                                       BufferPoolManager *buffer_pool_manager) {}
+                                                       BufferPoolManager *buffer_pool_manager) {
+  KeyType last_key = KeyAt(GetSize() - 1);
+  ValueType last_value = ValueAt(GetSize() - 1);
+  Remove(GetSize() - 1);
+  // The old KEY(0) of recipient becomes a real key; the moved key becomes the new separator for the parent.
+  recipient->SetKeyAt(0, middle_key);
+  recipient->InsertAt(0, last_key, last_value);
+  recipient->Adopt(last_value, buffer_pool_manager);
+}
+
+/*****************************************************************************
+ * INTEGER KEYS
+ *****************************************************************************/
+using IntegerInternalPage = BPlusTreeInternalPage<IntegerKey, page_id_t, IntegerComparator>;
+
+void IntegerInternalPage::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::INTERNAL_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetMaxSize(std::min(max_size, static_cast<int>(INTEGER_INTERNAL_PAGE_SIZE)));
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+}
+
+IntegerKey IntegerInternalPage::KeyAt(int index) const { return IntegerKey{keys_[index]}; }
+
+void IntegerInternalPage::SetKeyAt(int index, const IntegerKey &key) { keys_[index] = key.value_; }
 
-/* Append an entry at the beginning.
- * Since it is an internal page, the moved entry(page)'s parent needs to be updated.
- * So I need to 'adopt' it by changing its parent page id, which needs to be persisted with BufferPoolManger
+int IntegerInternalPage::ValueIndex(const page_id_t &value) const {
+  for (int i = 0; i < GetSize(); i++) {
+    if (values_[i] == value) {
+      return i;
+    }
+  }
+  return -1;
+}
+
+page_id_t IntegerInternalPage::ValueAt(int index) const { return values_[index]; }
+
+bool IntegerInternalPage::HasRoomFor(const IntegerKey &key, double fill_factor) const {
+  return GetSize() < GetMaxSize() && GetSize() + 1 <= fill_factor * INTEGER_INTERNAL_PAGE_SIZE;
+}
+
+bool IntegerInternalPage::HasRoomToSetKeyAt(int index, const IntegerKey &key) const { return true; }
+
+bool IntegerInternalPage::IsFull() const { return GetSize() >= GetMaxSize(); }
+
+bool IntegerInternalPage::IsUnderflow() const { return GetSize() < GetMinSize(); }
+
+bool IntegerInternalPage::MayUnderflowAfterRemove() const { return GetSize() - 1 < GetMinSize(); }
+
+bool IntegerInternalPage::CanMergeFrom(const BPlusTreeInternalPage *other, const IntegerKey &middle_key) const {
+  return GetSize() + other->GetSize() <= GetMaxSize();
+}
+
+/*
+ * The child is the one after the keys <= key, not counting the invalid KEY(0). Optimistic readers may call this while
+ * a writer changes the page, so the size is clamped to the page.
  */
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair, BufferPoolManager *buffer_pool_manager) {}
+page_id_t IntegerInternalPage::Lookup(const IntegerKey &key, const IntegerComparator &comparator) const {
+  int size = std::clamp(GetSize(), 1, static_cast<int>(INTEGER_INTERNAL_PAGE_SIZE));
+  return values_[IntegerKeyRank<true>(keys_ + 1, size - 1, key.value_)];
+}
+
+void IntegerInternalPage::PopulateNewRoot(const page_id_t &old_value, const IntegerKey &new_key,
+                                          const page_id_t &new_value) {
+  SetSize(0);
+  InsertAt(0, IntegerKey{0}, old_value);
+  InsertAt(1, new_key, new_value);
+}
+
+int IntegerInternalPage::InsertNodeAfter(const page_id_t &old_value, const IntegerKey &new_key,
+                                         const page_id_t &new_value) {
+  InsertAt(ValueIndex(old_value) + 1, new_key, new_value);
+  return GetSize();
+}
+
+void IntegerInternalPage::Append(const IntegerKey &key, const page_id_t &value) { InsertAt(GetSize(), key, value); }
+
+void IntegerInternalPage::InsertAt(int index, const IntegerKey &key, const page_id_t &value) {
+  int count = GetSize() - index;
+  memmove(keys_ + index + 1, keys_ + index, count * sizeof(int64_t));
+  memmove(values_ + index + 1, values_ + index, count * sizeof(page_id_t));
+  keys_[index] = key.value_;
+  values_[index] = value;
+  IncreaseSize(1);
+}
+
+void IntegerInternalPage::Remove(int index) {
+  int count = GetSize() - index - 1;
+  memmove(keys_ + index, keys_ + index + 1, count * sizeof(int64_t));
+  memmove(values_ + index, values_ + index + 1, count * sizeof(page_id_t));
+  IncreaseSize(-1);
+}
+
+page_id_t IntegerInternalPage::RemoveAndReturnOnlyChild() {
+  page_id_t value = values_[0];
+  SetSize(0);
+  return value;
+}
+
+/*
+ * Move the pairs from the index on to the end of recipient, which adopts their children.
+ */
+void IntegerInternalPage::MoveRangeTo(int begin, BPlusTreeInternalPage *recipient,
+                                      BufferPoolManager *buffer_pool_manager) {
+  int count = GetSize() - begin;
+  memcpy(recipient->keys_ + recipient->GetSize(), keys_ + begin, count * sizeof(int64_t));
+  memcpy(recipient->values_ + recipient->GetSize(), values_ + begin, count * sizeof(page_id_t));
+  recipient->IncreaseSize(count);
+  SetSize(begin);
+  for (int i = recipient->GetSize() - count; i < recipient->GetSize(); i++) {
+    recipient->Adopt(recipient->values_[i], buffer_pool_manager);
+  }
+}
+
+/*
+ * Split the page together with the new_key & new_value pair that did not fit, which goes right after the pair with
+ * its value == old_value: the upper half of the pairs moves to the empty "recipient". The first key moved ends up as
+ * the invalid KEY(0) of recipient; it is the key to push up into the parent.
+ */
+void IntegerInternalPage::InsertAndMoveHalfTo(const page_id_t &old_value, const IntegerKey &new_key,
+                                              const page_id_t &new_value, BPlusTreeInternalPage *recipient,
+                                              BufferPoolManager *buffer_pool_manager) {
+  int index = ValueIndex(old_value) + 1;
+  int keep = (GetSize() + 2) / 2;
+  if (index < keep) {
+    MoveRangeTo(keep - 1, recipient, buffer_pool_manager);
+    InsertAt(index, new_key, new_value);
+  } else {
+    MoveRangeTo(keep, recipient, buffer_pool_manager);
+    recipient->InsertAt(index - keep, new_key, new_value);
+    recipient->Adopt(new_value, buffer_pool_manager);
+  }
+}
+
+/*
+ * Set the parent page id of the child to me; see the generic page for why the child is not latched.
+ */
+void IntegerInternalPage::Adopt(page_id_t child_page_id, BufferPoolManager *buffer_pool_manager) {
+  Page *page = buffer_pool_manager->FetchPage(child_page_id);
+  if (page == nullptr) {
+    throw Exception(ExceptionType::OUT_OF_MEMORY, "no free frame to adopt a b+ tree page");
+  }
+  reinterpret_cast<BPlusTreePage *>(page->GetData())->SetParentPageId(GetPageId());
+  buffer_pool_manager->UnpinPage(child_page_id, true);
+}
+
+/*
+ * The middle key from the parent takes the place of my invalid KEY(0).
+ */
+void IntegerInternalPage::MoveAllTo(BPlusTreeInternalPage *recipient, const IntegerKey &middle_key,
+                                    BufferPoolManager *buffer_pool_manager) {
+  keys_[0] = middle_key.value_;
+  MoveRangeTo(0, recipient, buffer_pool_manager);
+}
+
+void IntegerInternalPage::MoveFirstToEndOf(BPlusTreeInternalPage *recipient, const IntegerKey &middle_key,
+                                           BufferPoolManager *buffer_pool_manager) {
+  recipient->InsertAt(recipient->GetSize(), middle_key, values_[0]);
+  recipient->Adopt(values_[0], buffer_pool_manager);
+  Remove(0);
+}
+
+void IntegerInternalPage::MoveLastToFrontOf(BPlusTreeInternalPage *recipient, const IntegerKey &middle_key,
+                                            BufferPoolManager *buffer_pool_manager) {
+  IntegerKey last_key = KeyAt(GetSize() - 1);
+  page_id_t last_value = values_[GetSize() - 1];
+  Remove(GetSize() - 1);
+  recipient->keys_[0] = middle_key.value_;
+  recipient->InsertAt(0, last_key, last_value);
+  recipient->Adopt(last_value, buffer_pool_manager);
+}
 
 // valuetype for internalNode should be page id_t
 template class BPlusTreeInternalPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
@@ -184,4 +590,16 @@ template class BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator
 template class BPlusTreeInternalPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
 template class BPlusTreeInternalPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
 template class BPlusTreeInternalPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+template class BPlusTreeInternalPage<PostingKey<GenericKey<4>>, page_id_t,
+                                     PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+template class BPlusTreeInternalPage<PostingKey<GenericKey<8>>, page_id_t,
+                                     PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+template class BPlusTreeInternalPage<PostingKey<GenericKey<16>>, page_id_t,
+                                     PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+template class BPlusTreeInternalPage<PostingKey<GenericKey<32>>, page_id_t,
+                                     PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+template class BPlusTreeInternalPage<PostingKey<GenericKey<64>>, page_id_t,
+                                     PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+template class BPlusTreeInternalPage<PostingKey<IntegerKey>, page_id_t,
+                                     PostingComparator<IntegerKey, IntegerComparator>>;
 }  // namespace bustub
@@ -9,6 +9,8 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <cstring>
 #include <sstream>
 
 #include "common/exception.h"
@@ -17,6 +19,9 @@
 
 namespace bustub {
 
+// the longest entry: a key that differs from the base key in every byte
+#define LEAF_MAX_ENTRY_SIZE (LEAF_KEY_MASK_SIZE + sizeof(KeyType) + sizeof(ValueType))
+
 /*****************************************************************************
  * HELPER METHODS AND UTILITIES
  *****************************************************************************/
@@ -27,43 +32,212 @@ namespace bustub {
  * next page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetMaxSize(max_size);
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  Reset(KeyType{});
+}
 
 /**
  * Helper methods to set/get next page id
  */
 INDEX_TEMPLATE_ARGUMENTS
-page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return INVALID_PAGE_ID; }
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const { return next_page_id_; }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
 
 /**
  * Helper method to find the first index i so that array[i].first >= key
- * NOTE: This method is only used when generating index iterator
+ * Optimistic readers may call this while a writer changes the page, so the size is clamped to the page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const { return 0; }
+int B_PLUS_TREE_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  int low = 0;
+  int high = std::clamp(GetSize(), 0, static_cast<int>(LEAF_PAGE_SIZE));
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    if (comparator(EntryKey(Entry(mid)), key) < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
 
 /*
  * Helper method to find and return the key associated with input "index"(a.k.a
  * array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const {
-  // replace with your own code
-  KeyType key{};
-  return key;
-}
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::KeyAt(int index) const { return EntryKey(Entry(index)); }
 
 /*
  * Helper method to find and return the key & value pair associated with input
  * "index"(a.k.a array offset)
  */
 INDEX_TEMPLATE_ARGUMENTS
-const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
-  // replace with your own code
-  return array_[0];
+MappingType B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) const {
+  const char *entry = Entry(index);
+  return {EntryKey(entry), EntryValue(entry)};
+}
+
+/*
+ * Append the entries of the page to items, in key order. Optimistic readers may call this while a writer changes the
+ * page, so the size is clamped to the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::GetItems(std::vector<MappingType> *items) const {
+  int size = std::clamp(GetSize(), 0, static_cast<int>(LEAF_PAGE_SIZE));
+  items->reserve(items->size() + size);
+  for (int i = 0; i < size; i++) {
+    items->push_back(GetItem(i));
+  }
+}
+
+/*
+ * @return: the bytes an entry with the key takes on a page with the base key, not counting its slot
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_LEAF_PAGE_TYPE::EntrySize(const KeyType &key, const KeyType &base_key) {
+  auto *key_bytes = reinterpret_cast<const char *>(&key);
+  auto *base_bytes = reinterpret_cast<const char *>(&base_key);
+  size_t size = LEAF_KEY_MASK_SIZE + sizeof(ValueType);
+  for (size_t i = 0; i < sizeof(KeyType); i++) {
+    size += key_bytes[i] != base_bytes[i] ? 1 : 0;
+  }
+  return size;
+}
+
+/*
+ * @return: the bytes the items in [begin, end) take on a page with the base key, slots included
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_LEAF_PAGE_TYPE::EntriesSize(const std::vector<MappingType> &items, size_t begin, size_t end,
+                                               const KeyType &base_key) {
+  size_t size = 0;
+  for (size_t i = begin; i < end; i++) {
+    size += sizeof(uint16_t) + EntrySize(items[i].first, base_key);
+  }
+  return size;
+}
+
+/*
+ * Return the entry in the given slot. The offset is only out of bounds for optimistic readers that raced a writer;
+ * it is clamped so that they read within the page.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+const char *B_PLUS_TREE_LEAF_PAGE_TYPE::Entry(int index) const {
+  auto *data = reinterpret_cast<const char *>(this);
+  size_t offset = std::min<size_t>(slots_[index], PAGE_SIZE - LEAF_KEY_MASK_SIZE - sizeof(ValueType));
+  return data + std::min<size_t>(offset, PAGE_SIZE - EntrySize(data + offset));
+}
+
+/*
+ * @return: the bytes the entry takes, as its mask tells
+ */
+INDEX_TEMPLATE_ARGUMENTS
+size_t B_PLUS_TREE_LEAF_PAGE_TYPE::EntrySize(const char *entry) {
+  size_t size = LEAF_KEY_MASK_SIZE + sizeof(ValueType);
+  for (size_t i = 0; i < LEAF_KEY_MASK_SIZE; i++) {
+    size += __builtin_popcount(static_cast<uint8_t>(entry[i]));
+  }
+  return size;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+KeyType B_PLUS_TREE_LEAF_PAGE_TYPE::EntryKey(const char *entry) const {
+  KeyType key = base_key_;
+  auto *key_bytes = reinterpret_cast<char *>(&key);
+  const char *diff = entry + LEAF_KEY_MASK_SIZE;
+  for (size_t i = 0; i < LEAF_KEY_MASK_SIZE; i++) {
+    for (unsigned bits = static_cast<uint8_t>(entry[i]); bits != 0; bits &= bits - 1) {
+      size_t byte = i * 8 + __builtin_ctz(bits);
+      if (byte < sizeof(KeyType)) {
+        key_bytes[byte] = *diff;
+      }
+      diff++;
+    }
+  }
+  return key;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+ValueType B_PLUS_TREE_LEAF_PAGE_TYPE::EntryValue(const char *entry) const {
+  ValueType value;
+  memcpy(static_cast<void *>(&value), entry + EntrySize(entry) - sizeof(ValueType), sizeof(ValueType));
+  return value;
+}
+
+/*
+ * @return: the bytes taken by the slots and the entries
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int B_PLUS_TREE_LEAF_PAGE_TYPE::GetUsedSpace() const {
+  return GetSize() * sizeof(uint16_t) + (PAGE_SIZE - entries_begin_);
+}
+
+/*****************************************************************************
+ * SPACE ACCOUNTING
+ *****************************************************************************/
+/*
+ * @return: true if the key fits without reaching the max size or the given share of the space of the page
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key, double fill_factor) const {
+  size_t size = sizeof(uint16_t) + EntrySize(key, GetSize() == 0 ? key : base_key_);
+  return GetSize() + 1 < GetMaxSize() && GetUsedSpace() + size <= fill_factor * LEAF_PAGE_CAPACITY;
+}
+
+/*
+ * @return: true if the next insert may split the page, whatever its key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsFull() const {
+  return GetSize() + 1 >= GetMaxSize() || GetUsedSpace() + sizeof(uint16_t) + LEAF_MAX_ENTRY_SIZE > LEAF_PAGE_CAPACITY;
+}
+
+/*
+ * A page underflows once it has fewer entries than its min size and uses less than half of its space, so pages of
+ * short entries are not merged while they are still half full.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::IsUnderflow() const {
+  return GetSize() < GetMinSize() && GetUsedSpace() < static_cast<int>(LEAF_PAGE_CAPACITY / 2);
+}
+
+/*
+ * @return: true if removing any one entry may make the page underflow
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::MayUnderflowAfterRemove() const {
+  return GetSize() - 1 < GetMinSize() &&
+         GetUsedSpace() < static_cast<int>(LEAF_PAGE_CAPACITY / 2 + sizeof(uint16_t) + LEAF_MAX_ENTRY_SIZE);
+}
+
+/*
+ * @return: true if the entries of other fit into me, compressed against my base key
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool B_PLUS_TREE_LEAF_PAGE_TYPE::CanMergeFrom(const BPlusTreeLeafPage *other) const {
+  if (GetSize() + other->GetSize() >= GetMaxSize()) {
+    return false;
+  }
+  if (other->GetSize() == 0) {
+    return true;
+  }
+  KeyType base_key = GetSize() == 0 ? other->KeyAt(0) : base_key_;
+  size_t size = GetUsedSpace();
+  for (int i = 0; i < other->GetSize(); i++) {
+    size += sizeof(uint16_t) + EntrySize(other->KeyAt(i), base_key);
+  }
+  return size <= LEAF_PAGE_CAPACITY;
 }
 
 /*****************************************************************************
@@ -71,27 +245,129 @@ const MappingType &B_PLUS_TREE_LEAF_PAGE_TYPE::GetItem(int index) {
  *****************************************************************************/
 /*
  * Insert key & value pair into leaf page ordered by key
+ * The page is left unchanged if it already holds the key. The caller makes sure the key fits (see HasRoomFor).
  * @return  page size after insertion
  */
 INDEX_TEMPLATE_ARGUMENTS
 int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
-  return 0;
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && comparator(KeyAt(index), key) == 0) {
+    return GetSize();
+  }
+  if (GetSize() == 0) {
+    Reset(key);
+  }
+  InsertAt(index, key, value);
+  return GetSize();
+}
+
+/*
+ * Add the item after the last one, for filling a page in key order.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Append(const MappingType &item) {
+  if (GetSize() == 0) {
+    Reset(item.first);
+  }
+  InsertAt(GetSize(), item.first, item.second);
+}
+
+/*
+ * Empty the page and compress the keys added from now on against the base key.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Reset(const KeyType &base_key) {
+  SetSize(0);
+  entries_begin_ = PAGE_SIZE;
+  base_key_ = base_key;
+}
+
+/*
+ * Write the entry at the start of the entries and put its slot at the index.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAt(int index, const KeyType &key, const ValueType &value) {
+  entries_begin_ -= EntrySize(key, base_key_);
+  char *entry = reinterpret_cast<char *>(this) + entries_begin_;
+  auto *key_bytes = reinterpret_cast<const char *>(&key);
+  auto *base_bytes = reinterpret_cast<const char *>(&base_key_);
+  memset(entry, 0, LEAF_KEY_MASK_SIZE);
+  char *diff = entry + LEAF_KEY_MASK_SIZE;
+  for (size_t i = 0; i < sizeof(KeyType); i++) {
+    if (key_bytes[i] != base_bytes[i]) {
+      entry[i / 8] = static_cast<char>(entry[i / 8] | (1 << (i % 8)));
+      *diff++ = key_bytes[i];
+    }
+  }
+  memcpy(diff, static_cast<const void *>(&value), sizeof(ValueType));
+  memmove(slots_ + index + 1, slots_ + index, (GetSize() - index) * sizeof(uint16_t));
+  slots_[index] = entries_begin_;
+  IncreaseSize(1);
+}
+
+/*
+ * Remove the entry in the slot at the index. The entries stay packed at the end of the page, so the ones in front of
+ * it move back over it.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAt(int index) {
+  uint16_t offset = slots_[index];
+  auto *data = reinterpret_cast<char *>(this);
+  auto size = static_cast<uint16_t>(EntrySize(data + offset));
+  memmove(data + entries_begin_ + size, data + entries_begin_, offset - entries_begin_);
+  entries_begin_ += size;
+  memmove(slots_ + index, slots_ + index + 1, (GetSize() - index - 1) * sizeof(uint16_t));
+  IncreaseSize(-1);
+  for (int i = 0; i < GetSize(); i++) {
+    if (slots_[i] < offset) {
+      slots_[i] += size;
+    }
+  }
 }
 
 /*****************************************************************************
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Split the page together with the key & value pair that did not fit: the upper half of the entries moves to
+ * "recipient". Halves are counted in entries, unless they take more space than a page.
+ * Each half is compressed against its own first key if that takes less space than the base key of the page; the base
+ * key of the page always fits, since the entries took no more than a page and an entry with it.
+ * The caller links recipient into the leaf chain.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::InsertAndMoveHalfTo(const KeyType &key, const ValueType &value,
+                                                     BPlusTreeLeafPage *recipient, const KeyComparator &comparator) {
+  std::vector<MappingType> items;
+  items.reserve(GetSize() + 1);
+  for (int i = 0; i < GetSize(); i++) {
+    items.push_back(GetItem(i));
+  }
+  items.insert(items.begin() + KeyIndex(key, comparator), MappingType{key, value});
+  size_t keep = items.size() / 2;
+  while (keep > 1 && EntriesSize(items, 0, keep, base_key_) > LEAF_PAGE_CAPACITY) {
+    keep--;
+  }
+  while (keep + 1 < items.size() && EntriesSize(items, keep, items.size(), base_key_) > LEAF_PAGE_CAPACITY) {
+    keep++;
+  }
+  KeyType base_key = base_key_;
+  recipient->Fill(items, keep, items.size(), base_key);
+  Fill(items, 0, keep, base_key);
+}
 
 /*
- * Copy starting from items, and copy {size} number of elements into me.
+ * Replace the entries of the page with the items in [begin, end), which fit with the given base key.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Fill(const std::vector<MappingType> &items, size_t begin, size_t end,
+                                      const KeyType &base_key) {
+  const KeyType &first_key = items[begin].first;
+  Reset(EntriesSize(items, begin, end, first_key) <= EntriesSize(items, begin, end, base_key) ? first_key : base_key);
+  for (size_t i = begin; i < end; i++) {
+    InsertAt(GetSize(), items[i].first, items[i].second);
+  }
+}
 
 /*****************************************************************************
  * LOOKUP
@@ -103,7 +379,16 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyNFrom(MappingType *items, int size) {}
  */
 INDEX_TEMPLATE_ARGUMENTS
 bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
-  return false;
+  int index = KeyIndex(key, comparator);
+  if (index >= std::clamp(GetSize(), 0, static_cast<int>(LEAF_PAGE_SIZE))) {
+    return false;
+  }
+  const char *entry = Entry(index);
+  if (comparator(EntryKey(entry), key) != 0) {
+    return false;
+  }
+  *value = EntryValue(entry);
+  return true;
 }
 
 /*****************************************************************************
@@ -116,7 +401,14 @@ bool B_PLUS_TREE_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, co
  * @return   page size after deletion
  */
 INDEX_TEMPLATE_ARGUMENTS
-int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) { return 0; }
+int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index >= GetSize() || comparator(KeyAt(index), key) != 0) {
+    return GetSize();
+  }
+  RemoveAt(index);
+  return GetSize();
+}
 
 /*****************************************************************************
  * MERGE
@@ -124,9 +416,17 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const
 /*
  * Remove all of key & value pairs from this page to "recipient" page. Don't forget
  * to update the next_page id in the sibling page
+ * The caller makes sure they fit (see CanMergeFrom).
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  for (int i = 0; i < GetSize(); i++) {
+    MappingType item = GetItem(i);
+    recipient->Append(item);
+  }
+  recipient->SetNextPageId(GetNextPageId());
+  Reset(base_key_);
+}
 
 /*****************************************************************************
  * REDISTRIBUTE
@@ -135,29 +435,820 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {}
  * Remove the first key & value pair from this page to "recipient" page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->Append(GetItem(0));
+  RemoveAt(0);
+}
 
 /*
- * Copy the item into the end of my item list. (Append item to my array)
+ * Remove the last key & value pair from this page to "recipient" page.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {}
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  MappingType item = GetItem(GetSize() - 1);
+  if (recipient->GetSize() == 0) {
+    recipient->Reset(item.first);
+  }
+  recipient->InsertAt(0, item.first, item.second);
+  RemoveAt(GetSize() - 1);
+}
+
+/*****************************************************************************
+ * INTEGER KEYS
+ *****************************************************************************/
+using IntegerLeafPage = BPlusTreeLeafPage<IntegerKey, RID, IntegerComparator>;
+
+void IntegerLeafPage::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetLSN();
+  SetSize(0);
+  SetMaxSize(std::min(max_size, static_cast<int>(INTEGER_LEAF_PAGE_SIZE) + 1));
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+}
+
+page_id_t IntegerLeafPage::GetNextPageId() const { return next_page_id_; }
+
+void IntegerLeafPage::SetNextPageId(page_id_t next_page_id) { next_page_id_ = next_page_id; }
+
+IntegerKey IntegerLeafPage::KeyAt(int index) const { return IntegerKey{keys_[index]}; }
 
 /*
- * Remove the last key & value pair from this page to "recipient" page.
+ * Optimistic readers may call this while a writer changes the page, so the size is clamped to the page.
  */
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {}
+int IntegerLeafPage::KeyIndex(const IntegerKey &key, const IntegerComparator &comparator) const {
+  return IntegerKeyRank<false>(keys_, GetClampedSize(), key.value_);
+}
 
 /*
- * Insert item at the front of my items. Move items accordingly.
+ * The index is clamped to the page for optimistic readers, which read as many entries as a page of generic keys holds.
  */
-INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {}
+std::pair<IntegerKey, RID> IntegerLeafPage::GetItem(int index) const {
+  index = std::min(index, static_cast<int>(INTEGER_LEAF_PAGE_SIZE) - 1);
+  return {IntegerKey{keys_[index]}, values_[index]};
+}
+
+void IntegerLeafPage::GetItems(std::vector<std::pair<IntegerKey, RID>> *items) const {
+  int size = GetClampedSize();
+  items->reserve(items->size() + size);
+  for (int i = 0; i < size; i++) {
+    items->emplace_back(IntegerKey{keys_[i]}, values_[i]);
+  }
+}
+
+int IntegerLeafPage::GetClampedSize() const {
+  return std::clamp(GetSize(), 0, static_cast<int>(INTEGER_LEAF_PAGE_SIZE));
+}
+
+bool IntegerLeafPage::HasRoomFor(const IntegerKey &key, double fill_factor) const {
+  return GetSize() + 1 < GetMaxSize() && GetSize() + 1 <= fill_factor * INTEGER_LEAF_PAGE_SIZE;
+}
+
+bool IntegerLeafPage::IsFull() const { return GetSize() + 1 >= GetMaxSize(); }
+
+bool IntegerLeafPage::IsUnderflow() const { return GetSize() < GetMinSize(); }
+
+bool IntegerLeafPage::MayUnderflowAfterRemove() const { return GetSize() - 1 < GetMinSize(); }
+
+bool IntegerLeafPage::CanMergeFrom(const BPlusTreeLeafPage *other) const {
+  return GetSize() + other->GetSize() < GetMaxSize();
+}
+
+int IntegerLeafPage::Insert(const IntegerKey &key, const RID &value, const IntegerComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && keys_[index] == key.value_) {
+    return GetSize();
+  }
+  InsertAt(index, key, value);
+  return GetSize();
+}
+
+void IntegerLeafPage::Append(const std::pair<IntegerKey, RID> &item) { InsertAt(GetSize(), item.first, item.second); }
+
+bool IntegerLeafPage::Lookup(const IntegerKey &key, RID *value, const IntegerComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index >= GetClampedSize() || keys_[index] != key.value_) {
+    return false;
+  }
+  *value = values_[index];
+  return true;
+}
+
+int IntegerLeafPage::RemoveAndDeleteRecord(const IntegerKey &key, const IntegerComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  if (index < GetSize() && keys_[index] == key.value_) {
+    RemoveAt(index);
+  }
+  return GetSize();
+}
+
+void IntegerLeafPage::InsertAt(int index, const IntegerKey &key, const RID &value) {
+  int count = GetSize() - index;
+  memmove(keys_ + index + 1, keys_ + index, count * sizeof(int64_t));
+  memmove(static_cast<void *>(values_ + index + 1), static_cast<void *>(values_ + index), count * sizeof(RID));
+  keys_[index] = key.value_;
+  values_[index] = value;
+  IncreaseSize(1);
+}
+
+void IntegerLeafPage::RemoveAt(int index) {
+  int count = GetSize() - index - 1;
+  memmove(keys_ + index, keys_ + index + 1, count * sizeof(int64_t));
+  memmove(static_cast<void *>(values_ + index), static_cast<void *>(values_ + index + 1), count * sizeof(RID));
+  IncreaseSize(-1);
+}
+
+/*
+ * Move the entries from the index on to the end of recipient.
+ */
+void IntegerLeafPage::MoveRangeTo(int begin, BPlusTreeLeafPage *recipient) {
+  int count = GetSize() - begin;
+  memcpy(recipient->keys_ + recipient->GetSize(), keys_ + begin, count * sizeof(int64_t));
+  memcpy(static_cast<void *>(recipient->values_ + recipient->GetSize()), static_cast<void *>(values_ + begin),
+         count * sizeof(RID));
+  recipient->IncreaseSize(count);
+  SetSize(begin);
+}
+
+/*
+ * Split the page together with the key & value pair that did not fit: the upper half of the entries moves to the
+ * empty "recipient". The caller links recipient into the leaf chain.
+ */
+void IntegerLeafPage::InsertAndMoveHalfTo(const IntegerKey &key, const RID &value, BPlusTreeLeafPage *recipient,
+                                          const IntegerComparator &comparator) {
+  int index = KeyIndex(key, comparator);
+  int keep = (GetSize() + 1) / 2;
+  if (index < keep) {
+    MoveRangeTo(keep - 1, recipient);
+    InsertAt(index, key, value);
+  } else {
+    MoveRangeTo(keep, recipient);
+    recipient->InsertAt(index - keep, key, value);
+  }
+}
+
+void IntegerLeafPage::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  MoveRangeTo(0, recipient);
+  recipient->SetNextPageId(GetNextPageId());
+}
+
+void IntegerLeafPage::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(recipient->GetSize(), KeyAt(0), values_[0]);
+  RemoveAt(0);
+}
+
+void IntegerLeafPage::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  recipient->InsertAt(0, KeyAt(GetSize() - 1), values_[GetSize() - 1]);
+  RemoveAt(GetSize() - 1);
+}
+
+/*****************************************************************************
+ * POSTING LISTS
+ *****************************************************************************/
+#define POSTING_TEMPLATE_ARGUMENTS template <typename IndexKey, typename IndexComparator>
+// bytes of a run before its record ids
+#define POSTING_RUN_HEADER_SIZE (sizeof(IndexKey) + 2 * sizeof(uint16_t))
+// the most bytes a varint of a 32-bit integer takes
+#define POSTING_MAX_VARINT_SIZE 5
+// the most bytes an insert adds: a new run of one record id. An insert into a run adds at most two varints.
+#define POSTING_MAX_ENTRY_SIZE (POSTING_RUN_HEADER_SIZE + 2 * POSTING_MAX_VARINT_SIZE)
+// the most runs a page holds
+#define POSTING_MAX_RUNS (POSTING_LEAF_PAGE_CAPACITY / (POSTING_RUN_HEADER_SIZE + 2))
+
+static size_t VarintSize(uint32_t value) {
+  size_t size = 1;
+  for (; value >= 0x80; value >>= 7) {
+    size++;
+  }
+  return size;
+}
+
+static char *EncodeVarint(char *out, uint32_t value) {
+  for (; value >= 0x80; value >>= 7) {
+    *out++ = static_cast<char>(value | 0x80);
+  }
+  *out++ = static_cast<char>(value);
+  return out;
+}
+
+/*
+ * Decode the varint at in. Optimistic readers may see bytes that a writer is changing, so no more than a varint of a
+ * 32-bit integer is read, and nothing at or past end.
+ */
+static const char *DecodeVarint(const char *in, const char *end, uint32_t *value) {
+  uint32_t result = 0;
+  for (int shift = 0; in < end && shift < 7 * POSTING_MAX_VARINT_SIZE; shift += 7) {
+    auto byte = static_cast<uint8_t>(*in++);
+    result |= static_cast<uint32_t>(byte & 0x7F) << shift;
+    if ((byte & 0x80) == 0) {
+      break;
+    }
+  }
+  *value = result;
+  return in;
+}
+
+/*
+ * Split a record id into the two integers it is stored as after the previous one: the difference of their page ids,
+ * and the slot, or the difference of their slots if the page ids are equal. Posting lists are sorted, so neither
+ * difference is negative.
+ */
+static void PostingDelta(uint64_t rid, uint64_t previous, uint32_t *page_delta, uint32_t *slot) {
+  *page_delta = static_cast<uint32_t>(rid >> 32) - static_cast<uint32_t>(previous >> 32);
+  *slot = static_cast<uint32_t>(rid) - (*page_delta == 0 ? static_cast<uint32_t>(previous) : 0);
+}
+
+static size_t PostingRidSize(uint64_t rid, uint64_t previous) {
+  uint32_t page_delta;
+  uint32_t slot;
+  PostingDelta(rid, previous, &page_delta, &slot);
+  return VarintSize(page_delta) + VarintSize(slot);
+}
+
+static char *EncodePostingRid(char *out, uint64_t rid, uint64_t previous) {
+  uint32_t page_delta;
+  uint32_t slot;
+  PostingDelta(rid, previous, &page_delta, &slot);
+  return EncodeVarint(EncodeVarint(out, page_delta), slot);
+}
+
+/*
+ * Decode the record id that follows the one in *rid, and store it there.
+ */
+static const char *DecodePostingRid(const char *in, const char *end, uint64_t *rid) {
+  uint32_t page_delta;
+  uint32_t slot;
+  in = DecodeVarint(DecodeVarint(in, end, &page_delta), end, &slot);
+  uint32_t page = static_cast<uint32_t>(*rid >> 32) + page_delta;
+  if (page_delta == 0) {
+    slot += static_cast<uint32_t>(*rid);
+  }
+  *rid = static_cast<uint64_t>(page) << 32 | slot;
+  return in;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id, int max_size) {
+  SetPageType(IndexPageType::LEAF_PAGE);
+  SetLSN();
+  SetMaxSize(std::min(max_size, MAX_SIZE));
+  SetParentPageId(parent_id);
+  SetPageId(page_id);
+  SetNextPageId(INVALID_PAGE_ID);
+  Reset();
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+page_id_t POSTING_LEAF_PAGE_TYPE::GetNextPageId() const {
+  return next_page_id_;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+/*
+ * @return: the bytes a run of the sorted record ids takes
+ */
+POSTING_TEMPLATE_ARGUMENTS
+size_t POSTING_LEAF_PAGE_TYPE::RunSize(const std::vector<uint64_t> &rids) {
+  size_t size = POSTING_RUN_HEADER_SIZE;
+  uint64_t previous = 0;
+  for (uint64_t rid : rids) {
+    size += PostingRidSize(rid, previous);
+    previous = rid;
+  }
+  return size;
+}
+
+/*
+ * @return: the bytes the items in [begin, end) take once appended to an empty page (see Append)
+ */
+POSTING_TEMPLATE_ARGUMENTS
+size_t POSTING_LEAF_PAGE_TYPE::EntriesSize(const std::vector<MappingType> &items, size_t begin, size_t end) {
+  size_t size = 0;
+  for (size_t i = begin; i < end; i++) {
+    const KeyType &key = items[i].first;
+    if (i > begin && memcmp(&key.key_, &items[i - 1].first.key_, sizeof(IndexKey)) == 0) {
+      size += PostingRidSize(key.rid_, items[i - 1].first.rid_);
+    } else {
+      size += POSTING_RUN_HEADER_SIZE + PostingRidSize(key.rid_, 0);
+    }
+  }
+  return size;
+}
+
+/*
+ * @return: the bytes taken by the runs
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::GetUsedSpace() const {
+  return runs_end_ - POSTING_LEAF_PAGE_HEADER_SIZE;
+}
+
+/*
+ * The end of the runs, clamped to the page for optimistic readers that raced a writer.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+const char *POSTING_LEAF_PAGE_TYPE::RunsEnd() const {
+  return reinterpret_cast<const char *>(this) + std::min<size_t>(runs_end_, PAGE_SIZE);
+}
+
+/*
+ * Store the offsets of the runs in key order and return how many there are. Every run takes at least its header, so
+ * the walk stays within the page even while a writer changes it.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::RunOffsets(uint16_t *offsets) const {
+  size_t end = RunsEnd() - reinterpret_cast<const char *>(this);
+  int runs = 0;
+  for (size_t offset = POSTING_LEAF_PAGE_HEADER_SIZE;
+       offset + POSTING_RUN_HEADER_SIZE <= end && runs < static_cast<int>(POSTING_MAX_RUNS);
+       offset += RunSize(offset)) {
+    offsets[runs++] = static_cast<uint16_t>(offset);
+  }
+  return runs;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+size_t POSTING_LEAF_PAGE_TYPE::RunSize(size_t offset) const {
+  uint16_t length;
+  memcpy(&length, reinterpret_cast<const char *>(this) + offset + sizeof(IndexKey) + sizeof(uint16_t), sizeof(length));
+  return POSTING_RUN_HEADER_SIZE + length;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+IndexKey POSTING_LEAF_PAGE_TYPE::RunKey(size_t offset) const {
+  IndexKey key;
+  memcpy(static_cast<void *>(&key), reinterpret_cast<const char *>(this) + offset, sizeof(IndexKey));
+  return key;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::RunCount(size_t offset) const {
+  uint16_t count;
+  memcpy(&count, reinterpret_cast<const char *>(this) + offset + sizeof(IndexKey), sizeof(count));
+  return count;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+uint64_t POSTING_LEAF_PAGE_TYPE::RunFirstRid(size_t offset) const {
+  const char *in = reinterpret_cast<const char *>(this) + offset + POSTING_RUN_HEADER_SIZE;
+  uint64_t rid = 0;
+  DecodePostingRid(in, RunsEnd(), &rid);
+  return rid;
+}
+
+/*
+ * Decode the record ids of the run, without reading past its end or the end of the runs.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::DecodeRun(size_t offset, std::vector<uint64_t> *rids) const {
+  const char *in = reinterpret_cast<const char *>(this) + offset + POSTING_RUN_HEADER_SIZE;
+  const char *end = std::min(reinterpret_cast<const char *>(this) + offset + RunSize(offset), RunsEnd());
+  int count = RunCount(offset);
+  rids->reserve(count);
+  uint64_t rid = 0;
+  for (int i = 0; i < count && in < end; i++) {
+    in = DecodePostingRid(in, end, &rid);
+    rids->push_back(rid);
+  }
+}
+
+/*
+ * @return: the last run whose first entry is not greater than key, or -1 if there is none. The index keys of the runs
+ * are compared first, so only the runs of the index key of key decode their first record id.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::FindRun(const KeyType &key, const KeyComparator &comparator, const uint16_t *offsets,
+                                    int runs) const {
+  int low = 0;
+  int high = runs;
+  while (low < high) {
+    int mid = low + (high - low) / 2;
+    int cmp = comparator.CompareKeys(RunKey(offsets[mid]), key.key_);
+    if (cmp == 0) {
+      cmp = RunFirstRid(offsets[mid]) > key.rid_ ? 1 : -1;
+    }
+    if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low - 1;
+}
+
+/*
+ * @return: the run that holds the entry at the index, whose record id goes to *rid, or -1 if the page is empty. The
+ * index is clamped to the last entry for optimistic readers.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::FindEntry(int index, const uint16_t *offsets, int runs, uint64_t *rid) const {
+  *rid = 0;
+  for (int run = 0; run < runs; run++) {
+    int count = RunCount(offsets[run]);
+    if (index < count || run == runs - 1) {
+      const char *in = reinterpret_cast<const char *>(this) + offsets[run] + POSTING_RUN_HEADER_SIZE;
+      const char *end = std::min(in + RunSize(offsets[run]) - POSTING_RUN_HEADER_SIZE, RunsEnd());
+      for (int i = 0; i <= std::min(index, count - 1) && in < end; i++) {
+        in = DecodePostingRid(in, end, rid);
+      }
+      return run;
+    }
+    index -= count;
+  }
+  return -1;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+PostingKey<IndexKey> POSTING_LEAF_PAGE_TYPE::KeyAt(int index) const {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  KeyType key{};
+  int run = FindEntry(index, offsets, runs, &key.rid_);
+  if (run >= 0) {
+    key.key_ = RunKey(offsets[run]);
+  }
+  return key;
+}
+
+/*
+ * The value of an entry is the record id of its key.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+std::pair<PostingKey<IndexKey>, RID> POSTING_LEAF_PAGE_TYPE::GetItem(int index) const {
+  KeyType key = KeyAt(index);
+  return {key, key.GetRid()};
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::GetItems(std::vector<MappingType> *items) const {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  std::vector<uint64_t> rids;
+  for (int run = 0; run < runs; run++) {
+    KeyType key;
+    key.key_ = RunKey(offsets[run]);
+    rids.clear();
+    DecodeRun(offsets[run], &rids);
+    for (uint64_t rid : rids) {
+      key.rid_ = rid;
+      items->emplace_back(key, key.GetRid());
+    }
+  }
+}
+
+/*
+ * @return: the number of entries before the first one that is not less than key
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key, const KeyComparator &comparator) const {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  int run = FindRun(key, comparator, offsets, runs);
+  int index = 0;
+  for (int i = 0; i < run; i++) {
+    index += RunCount(offsets[i]);
+  }
+  if (run >= 0) {
+    if (comparator.CompareKeys(RunKey(offsets[run]), key.key_) < 0) {
+      index += RunCount(offsets[run]);
+    } else {
+      std::vector<uint64_t> rids;
+      DecodeRun(offsets[run], &rids);
+      index += std::lower_bound(rids.begin(), rids.end(), key.rid_) - rids.begin();
+    }
+  }
+  return index;
+}
+
+/*
+ * Append the values of the entries from key on that have the index key of key, decoding their posting lists instead
+ * of looking up one entry at a time.
+ * @return: true if such entries may go on in the next page, as no entry with another index key follows them here
+ */
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::ScanKey(const KeyType &key, const KeyComparator &comparator,
+                                     std::vector<RID> *result) const {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  int run = FindRun(key, comparator, offsets, runs);
+  if (run < 0 || comparator.CompareKeys(RunKey(offsets[run]), key.key_) < 0) {
+    run++;
+  }
+  for (; run < runs; run++) {
+    if (comparator.CompareKeys(RunKey(offsets[run]), key.key_) != 0) {
+      return false;
+    }
+    const char *in = reinterpret_cast<const char *>(this) + offsets[run] + POSTING_RUN_HEADER_SIZE;
+    const char *end = std::min(in + RunSize(offsets[run]) - POSTING_RUN_HEADER_SIZE, RunsEnd());
+    int count = RunCount(offsets[run]);
+    uint64_t rid = 0;
+    for (int i = 0; i < count && in < end; i++) {
+      in = DecodePostingRid(in, end, &rid);
+      if (rid >= key.rid_) {
+        result->push_back(IntegerToRid(rid));
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Inserts take at most a new run of one record id, so that is the room they need.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::HasRoomFor(const KeyType &key, double fill_factor) const {
+  return GetSize() + 1 < GetMaxSize() &&
+         GetUsedSpace() + POSTING_MAX_ENTRY_SIZE <= fill_factor * POSTING_LEAF_PAGE_CAPACITY;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::IsFull() const {
+  return GetSize() + 1 >= GetMaxSize() || GetUsedSpace() + POSTING_MAX_ENTRY_SIZE > POSTING_LEAF_PAGE_CAPACITY;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::IsUnderflow() const {
+  return GetSize() < GetMinSize() && GetUsedSpace() < static_cast<int>(POSTING_LEAF_PAGE_CAPACITY / 2);
+}
+
+/*
+ * Removing an entry frees at most a run of one record id; it never grows a run, since the varints of two differences
+ * never take less space than the varints of their sum.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::MayUnderflowAfterRemove() const {
+  return GetSize() - 1 < GetMinSize() &&
+         GetUsedSpace() < static_cast<int>(POSTING_LEAF_PAGE_CAPACITY / 2 + POSTING_MAX_ENTRY_SIZE);
+}
+
+/*
+ * Appending the runs of other takes at most the space they take now: the first one either stays a run of its own or
+ * joins my last run, where its first record id follows a nearer one.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::CanMergeFrom(const BPlusTreeLeafPage *other) const {
+  return GetSize() + other->GetSize() < GetMaxSize() &&
+         GetUsedSpace() + other->GetUsedSpace() <= static_cast<int>(POSTING_LEAF_PAGE_CAPACITY);
+}
+
+/*
+ * The key joins the run of an equal index key next to where it belongs, or starts a run of its own. The page is left
+ * unchanged if it already holds the key; the value is the record id of the key.
+ * @return  page size after insertion
+ */
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value, const KeyComparator &comparator) {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  int run = FindRun(key, comparator, offsets, runs);
+  if (run >= 0 && comparator.CompareKeys(RunKey(offsets[run]), key.key_) == 0) {
+    InsertIntoRun(offsets[run], key.rid_);
+  } else if (run + 1 < runs && comparator.CompareKeys(RunKey(offsets[run + 1]), key.key_) == 0) {
+    InsertIntoRun(offsets[run + 1], key.rid_);
+  } else {
+    WriteRun(run + 1 < runs ? offsets[run + 1] : runs_end_, 0, key.key_, {key.rid_});
+  }
+  return GetSize();
+}
+
+/*
+ * Add the item after the last one, for filling a page in key order. It joins the last run if their index keys have
+ * the same bytes, which takes no more than the bytes of its record id.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::Append(const MappingType &item) {
+  const KeyType &key = item.first;
+  auto *data = reinterpret_cast<char *>(this);
+  if (GetSize() == 0 || key.rid_ <= last_rid_ || memcmp(data + last_run_, &key.key_, sizeof(IndexKey)) != 0) {
+    WriteRun(runs_end_, 0, key.key_, {key.rid_});
+    return;
+  }
+  char *end = EncodePostingRid(data + runs_end_, key.rid_, last_rid_);
+  auto count = static_cast<uint16_t>(RunCount(last_run_) + 1);
+  auto length = static_cast<uint16_t>(RunSize(last_run_) - POSTING_RUN_HEADER_SIZE + (end - data - runs_end_));
+  memcpy(data + last_run_ + sizeof(IndexKey), &count, sizeof(count));
+  memcpy(data + last_run_ + sizeof(IndexKey) + sizeof(uint16_t), &length, sizeof(length));
+  runs_end_ = static_cast<uint16_t>(end - data);
+  last_rid_ = key.rid_;
+  IncreaseSize(1);
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::Reset() {
+  SetSize(0);
+  runs_end_ = POSTING_LEAF_PAGE_HEADER_SIZE;
+  last_run_ = POSTING_LEAF_PAGE_HEADER_SIZE;
+  last_rid_ = 0;
+}
+
+/*
+ * Replace the entries of the page with the items in [begin, end), which fit.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::Fill(const std::vector<MappingType> &items, size_t begin, size_t end) {
+  Reset();
+  for (size_t i = begin; i < end; i++) {
+    Append(items[i]);
+  }
+}
+
+/*
+ * Replace the run of old_size bytes at the offset with a run of the record ids under the key, moving the runs after it.
+ * An old size of 0 inserts a new run there, and no record ids remove the run. The last run and its last record id are
+ * kept track of for Append.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::WriteRun(size_t offset, size_t old_size, const IndexKey &key,
+                                      const std::vector<uint64_t> &rids) {
+  auto *data = reinterpret_cast<char *>(this);
+  size_t new_size = rids.empty() ? 0 : RunSize(rids);
+  size_t old_end = runs_end_;
+  int old_count = old_size == 0 ? 0 : RunCount(offset);
+  memmove(data + offset + new_size, data + offset + old_size, old_end - offset - old_size);
+  runs_end_ = static_cast<uint16_t>(old_end + new_size - old_size);
+  if (new_size > 0) {
+    auto count = static_cast<uint16_t>(rids.size());
+    auto length = static_cast<uint16_t>(new_size - POSTING_RUN_HEADER_SIZE);
+    char *out = data + offset;
+    memcpy(out, static_cast<const void *>(&key), sizeof(IndexKey));
+    memcpy(out + sizeof(IndexKey), &count, sizeof(count));
+    memcpy(out + sizeof(IndexKey) + sizeof(uint16_t), &length, sizeof(length));
+    out += POSTING_RUN_HEADER_SIZE;
+    uint64_t previous = 0;
+    for (uint64_t rid : rids) {
+      out = EncodePostingRid(out, rid, previous);
+      previous = rid;
+    }
+  }
+  IncreaseSize(static_cast<int>(rids.size()) - old_count);
+
+  if (old_size == 0 && offset == old_end) {
+    // a new last run
+    last_run_ = static_cast<uint16_t>(offset);
+    last_rid_ = rids.back();
+  } else if (offset < last_run_ || (old_size == 0 && offset == last_run_)) {
+    last_run_ = static_cast<uint16_t>(last_run_ + new_size - old_size);
+  } else if (new_size > 0) {
+    last_rid_ = rids.back();
+  } else {
+    // The last run was removed: the one before it is the last now.
+    uint16_t offsets[POSTING_MAX_RUNS];
+    int runs = RunOffsets(offsets);
+    last_run_ = runs == 0 ? POSTING_LEAF_PAGE_HEADER_SIZE : offsets[runs - 1];
+    std::vector<uint64_t> last_rids;
+    if (runs > 0) {
+      DecodeRun(last_run_, &last_rids);
+    }
+    last_rid_ = last_rids.empty() ? 0 : last_rids.back();
+  }
+}
+
+/*
+ * Add the record id to the run at the offset, which has the room for it.
+ * @return: false if the run already holds it
+ */
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::InsertIntoRun(size_t offset, uint64_t rid) {
+  std::vector<uint64_t> rids;
+  DecodeRun(offset, &rids);
+  auto position = std::lower_bound(rids.begin(), rids.end(), rid);
+  if (position != rids.end() && *position == rid) {
+    return false;
+  }
+  rids.insert(position, rid);
+  WriteRun(offset, RunSize(offset), RunKey(offset), rids);
+  return true;
+}
+
+/*
+ * Remove the record id at the position in the run at the offset, and the run along with its last one.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::RemoveFromRun(size_t offset, int position) {
+  std::vector<uint64_t> rids;
+  DecodeRun(offset, &rids);
+  rids.erase(rids.begin() + position);
+  WriteRun(offset, RunSize(offset), RunKey(offset), rids);
+}
+
+/*
+ * Split the page together with the key that did not fit: the upper half of the entries moves to "recipient". Halves
+ * are counted in entries, unless they take more space than a page. The caller links recipient into the leaf chain.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::InsertAndMoveHalfTo(const KeyType &key, const ValueType &value,
+                                                 BPlusTreeLeafPage *recipient, const KeyComparator &comparator) {
+  std::vector<MappingType> items;
+  items.reserve(GetSize() + 1);
+  GetItems(&items);
+  items.insert(items.begin() + KeyIndex(key, comparator), MappingType{key, key.GetRid()});
+  size_t keep = items.size() / 2;
+  while (keep > 1 && EntriesSize(items, 0, keep) > POSTING_LEAF_PAGE_CAPACITY) {
+    keep--;
+  }
+  while (keep + 1 < items.size() && EntriesSize(items, keep, items.size()) > POSTING_LEAF_PAGE_CAPACITY) {
+    keep++;
+  }
+  recipient->Fill(items, keep, items.size());
+  Fill(items, 0, keep);
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+bool POSTING_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType *value, const KeyComparator &comparator) const {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  int run = FindRun(key, comparator, offsets, runs);
+  if (run < 0 || comparator.CompareKeys(RunKey(offsets[run]), key.key_) != 0) {
+    return false;
+  }
+  const char *in = reinterpret_cast<const char *>(this) + offsets[run] + POSTING_RUN_HEADER_SIZE;
+  const char *end = std::min(in + RunSize(offsets[run]) - POSTING_RUN_HEADER_SIZE, RunsEnd());
+  int count = RunCount(offsets[run]);
+  uint64_t rid = 0;
+  for (int i = 0; i < count && in < end && rid < key.rid_; i++) {
+    in = DecodePostingRid(in, end, &rid);
+  }
+  if (rid != key.rid_) {
+    return false;
+  }
+  *value = IntegerToRid(rid);
+  return true;
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+int POSTING_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(const KeyType &key, const KeyComparator &comparator) {
+  uint16_t offsets[POSTING_MAX_RUNS];
+  int runs = RunOffsets(offsets);
+  int run = FindRun(key, comparator, offsets, runs);
+  if (run < 0 || comparator.CompareKeys(RunKey(offsets[run]), key.key_) != 0) {
+    return GetSize();
+  }
+  std::vector<uint64_t> rids;
+  DecodeRun(offsets[run], &rids);
+  auto position = std::lower_bound(rids.begin(), rids.end(), key.rid_);
+  if (position != rids.end() && *position == key.rid_) {
+    RemoveFromRun(offsets[run], position - rids.begin());
+  }
+  return GetSize();
+}
+
+/*
+ * The caller makes sure the entries fit (see CanMergeFrom).
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient) {
+  std::vector<MappingType> items;
+  GetItems(&items);
+  for (const auto &item : items) {
+    recipient->Append(item);
+  }
+  recipient->SetNextPageId(GetNextPageId());
+  Reset();
+}
+
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient) {
+  recipient->Append(GetItem(0));
+  RemoveFromRun(POSTING_LEAF_PAGE_HEADER_SIZE, 0);
+}
+
+/*
+ * The last entry joins the first run of recipient if their index keys have the same bytes.
+ */
+POSTING_TEMPLATE_ARGUMENTS
+void POSTING_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient) {
+  IndexKey key = RunKey(last_run_);
+  uint64_t rid = last_rid_;
+  auto *recipient_data = reinterpret_cast<char *>(recipient);
+  if (recipient->GetSize() > 0 &&
+      memcmp(recipient_data + POSTING_LEAF_PAGE_HEADER_SIZE, static_cast<const void *>(&key), sizeof(IndexKey)) == 0) {
+    recipient->InsertIntoRun(POSTING_LEAF_PAGE_HEADER_SIZE, rid);
+  } else {
+    recipient->WriteRun(POSTING_LEAF_PAGE_HEADER_SIZE, 0, key, {rid});
+  }
+  RemoveFromRun(last_run_, RunCount(last_run_) - 1);
+}
 
 template class BPlusTreeLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
 template class BPlusTreeLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
 template class BPlusTreeLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+template class BPlusTreeLeafPage<PostingKey<GenericKey<4>>, RID,
+                                 PostingComparator<GenericKey<4>, GenericComparator<4>>>;
+template class BPlusTreeLeafPage<PostingKey<GenericKey<8>>, RID,
+                                 PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+template class BPlusTreeLeafPage<PostingKey<GenericKey<16>>, RID,
+                                 PostingComparator<GenericKey<16>, GenericComparator<16>>>;
+template class BPlusTreeLeafPage<PostingKey<GenericKey<32>>, RID,
+                                 PostingComparator<GenericKey<32>, GenericComparator<32>>>;
+template class BPlusTreeLeafPage<PostingKey<GenericKey<64>>, RID,
+                                 PostingComparator<GenericKey<64>, GenericComparator<64>>>;
+template class BPlusTreeLeafPage<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
 }  // namespace bustub
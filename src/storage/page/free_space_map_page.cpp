@@ -0,0 +1,74 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map_page.cpp
+//
+// Identification: src/storage/page/free_space_map_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/free_space_map_page.h"
+
+#include <algorithm>
+
+#include "common/macros.h"
+
+namespace bustub {
+
+void FreeSpaceMapPage::Init(page_id_t page_id) {
+  next_page_id_ = INVALID_PAGE_ID;
+  last_map_page_id_ = page_id;
+  last_table_page_id_ = INVALID_PAGE_ID;
+  num_entries_ = 0;
+  max_category_ = 0;
+}
+
+void FreeSpaceMapPage::AddEntry(page_id_t table_page_id, uint32_t free_space) {
+  BUSTUB_ASSERT(!IsFull(), "Free space map page is full.");
+  uint32_t category = ToCategory(free_space);
+  table_page_ids_[num_entries_] = table_page_id;
+  categories_[num_entries_] = static_cast<uint8_t>(category);
+  num_entries_++;
+  max_category_ = std::max(max_category_, category);
+}
+
+bool FreeSpaceMapPage::UpdateEntry(page_id_t table_page_id, uint32_t free_space) {
+  int index = FindEntry(table_page_id);
+  if (index < 0) {
+    return false;
+  }
+  uint32_t category = ToCategory(free_space);
+  uint32_t old_category = categories_[index];
+  categories_[index] = static_cast<uint8_t>(category);
+  if (category >= max_category_) {
+    max_category_ = category;
+  } else if (old_category == max_category_) {
+    max_category_ = *std::max_element(categories_, categories_ + num_entries_);
+  }
+  return true;
+}
+
+page_id_t FreeSpaceMapPage::FindTablePage(uint32_t space_needed) const {
+  uint32_t category = ToRequiredCategory(space_needed);
+  if (category > max_category_) {
+    return INVALID_PAGE_ID;
+  }
+  // The most recently added pages are the likeliest to have room, so search from the back.
+  for (uint32_t i = num_entries_; i > 0; i--) {
+    if (categories_[i - 1] >= category) {
+      return table_page_ids_[i - 1];
+    }
+  }
+  return INVALID_PAGE_ID;
+}
+
+int FreeSpaceMapPage::FindEntry(page_id_t table_page_id) const {
+  const page_id_t *end = table_page_ids_ + num_entries_;
+  const page_id_t *entry = std::find(table_page_ids_, end, table_page_id);
+  return entry == end ? -1 : static_cast<int>(entry - table_page_ids_);
+}
+
+}  // namespace bustub
@@ -33,6 +33,9 @@ void TablePage::Init(page_id_t page_id, uint32_t page_size, page_id_t prev_page_
   SetNextPageId(INVALID_PAGE_ID);
   SetFreeSpacePointer(page_size);
   SetTupleCount(0);
+  uint32_t format_version = FORMAT_VERSION;
+  memcpy(GetData() + OFFSET_FORMAT_VERSION, &format_version, sizeof(uint32_t));
+  SetFreeSpaceMapPageId(INVALID_PAGE_ID);
 }
 
 bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, LockManager *lock_manager,
@@ -85,6 +88,50 @@ bool TablePage::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn, Lock
   return true;
 }
 
+uint32_t TablePage::InsertTuples(const std::vector<Tuple> &tuples, uint32_t first, std::vector<RID> *rids,
+                                 Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
+  // Empty slots are reused in order, so one pass over the slot array finds all of them.
+  uint32_t slot = 0;
+  uint32_t end = first;
+  for (; end < tuples.size(); end++) {
+    const Tuple &tuple = tuples[end];
+    BUSTUB_ASSERT(tuple.size_ > 0, "Cannot have empty tuples.");
+    if (GetFreeSpaceRemaining() < tuple.size_ + SIZE_TUPLE) {
+      break;
+    }
+    while (slot < GetTupleCount() && GetTupleSize(slot) != 0) {
+      slot++;
+    }
+
+    SetFreeSpacePointer(GetFreeSpacePointer() - tuple.size_);
+    memcpy(GetData() + GetFreeSpacePointer(), tuple.data_, tuple.size_);
+    SetTupleOffsetAtSlot(slot, GetFreeSpacePointer());
+    SetTupleSize(slot, tuple.size_);
+    rids->emplace_back(GetTablePageId(), slot);
+    if (slot == GetTupleCount()) {
+      SetTupleCount(GetTupleCount() + 1);
+    }
+    slot++;
+  }
+
+  // Write one log record for the whole batch.
+  uint32_t num_inserted = end - first;
+  if (enable_logging && num_inserted > 0) {
+    std::vector<RID> batch_rids(rids->end() - num_inserted, rids->end());
+    for (const auto &rid : batch_rids) {
+      BUSTUB_ASSERT(!txn->IsSharedLocked(rid) && !txn->IsExclusiveLocked(rid), "A new tuple should not be locked.");
+      bool locked = lock_manager->LockExclusive(txn, rid);
+      BUSTUB_ASSERT(locked, "Locking a new tuple should always work.");
+    }
+    LogRecord log_record(txn->GetTransactionId(), txn->GetPrevLSN(), LogRecordType::BATCHINSERT, std::move(batch_rids),
+                         std::vector<Tuple>(tuples.begin() + first, tuples.begin() + end));
+    lsn_t lsn = log_manager->AppendLogRecord(&log_record);
+    SetLSN(lsn);
+    txn->SetPrevLSN(lsn);
+  }
+  return num_inserted;
+}
+
 bool TablePage::MarkDelete(const RID &rid, Transaction *txn, LockManager *lock_manager, LogManager *log_manager) {
   uint32_t slot_num = rid.GetSlotNum();
   // If the slot number is invalid, abort the transaction.
@@ -265,7 +312,7 @@ void TablePage::RollbackDelete(const RID &rid, Transaction *txn, LogManager *log
   }
 }
 
-bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+bool TablePage::GetTupleView(const RID &rid, TupleView *view, Transaction *txn, LockManager *lock_manager) {
   // Get the current slot number.
   uint32_t slot_num = rid.GetSlotNum();
   // If somehow we have more slots than tuples, abort the transaction.
@@ -292,16 +339,18 @@ bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockMan
     }
   }
 
-  // At this point, we have at least a shared lock on the RID. Copy the tuple data into our result.
-  uint32_t tuple_offset = GetTupleOffsetAtSlot(slot_num);
-  tuple->size_ = tuple_size;
-  if (tuple->allocated_) {
-    delete[] tuple->data_;
+  // At this point, we have at least a shared lock on the RID.
+  *view = TupleView(rid, GetData() + GetTupleOffsetAtSlot(slot_num), tuple_size);
+  return true;
+}
+
+bool TablePage::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn, LockManager *lock_manager) {
+  TupleView view;
+  if (!GetTupleView(rid, &view, txn, lock_manager)) {
+    return false;
   }
-  tuple->data_ = new char[tuple->size_];
-  memcpy(tuple->data_, GetData() + tuple_offset, tuple->size_);
-  tuple->rid_ = rid;
-  tuple->allocated_ = true;
+  // Copy the tuple data into our result.
+  *tuple = view.Materialize();
   return true;
 }
 
@@ -330,4 +379,18 @@ bool TablePage::GetNextTupleRid(const RID &cur_rid, RID *next_rid) {
   next_rid->Set(INVALID_PAGE_ID, 0);
   return false;
 }
+
+uint32_t TablePage::GatherColumn(uint32_t column_offset, uint32_t width, uint32_t *slots, char *values) {
+  uint32_t num_live = 0;
+  uint32_t tuple_count = GetTupleCount();
+  for (uint32_t i = 0; i < tuple_count; ++i) {
+    if (IsDeleted(GetTupleSize(i))) {
+      continue;
+    }
+    slots[num_live] = i;
+    memcpy(values + num_live * width, GetData() + GetTupleOffsetAtSlot(i) + column_offset, width);
+    num_live++;
+  }
+  return num_live;
+}
 }  // namespace bustub
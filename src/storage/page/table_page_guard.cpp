@@ -0,0 +1,49 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_page_guard.cpp
+//
+// Identification: src/storage/page/table_page_guard.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/table_page_guard.h"
+
+namespace bustub {
+
+TablePageGuard::TablePageGuard(BufferPoolManager *bpm, page_id_t page_id)
+    : bpm_(bpm), page_(static_cast<TablePage *>(bpm->FetchPage(page_id))) {
+  BUSTUB_ASSERT(page_ != nullptr, "Could not fetch a table page.");
+  // Views read the page under this one pin, which stands for the fetch per tuple that reading tuples used to take.
+  bpm_->MarkPageReferenced(page_id);
+  page_->RLatch();
+}
+
+TablePageGuard::TablePageGuard(TablePageGuard &&other) noexcept : bpm_(other.bpm_), page_(other.page_) {
+  other.page_ = nullptr;
+}
+
+TablePageGuard &TablePageGuard::operator=(TablePageGuard &&other) noexcept {
+  if (this != &other) {
+    Release();
+    bpm_ = other.bpm_;
+    page_ = other.page_;
+    other.page_ = nullptr;
+  }
+  return *this;
+}
+
+void TablePageGuard::Release() {
+  if (page_ == nullptr) {
+    return;
+  }
+  page_id_t page_id = page_->GetTablePageId();
+  page_->RUnlatch();
+  bpm_->UnpinPage(page_id, false);
+  page_ = nullptr;
+}
+
+}  // namespace bustub
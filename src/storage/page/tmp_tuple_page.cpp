@@ -0,0 +1,50 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tmp_tuple_page.cpp
+//
+// Identification: src/storage/page/tmp_tuple_page.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/page/tmp_tuple_page.h"
+
+namespace bustub {
+
+void TmpTuplePage::Init(page_id_t page_id, uint32_t page_size) {
+  memcpy(GetData(), &page_id, sizeof(page_id));
+  SetLSN(INVALID_LSN);
+  SetFreeSpacePointer(page_size);
+}
+
+bool TmpTuplePage::Insert(const Tuple &tuple, TmpTuple *out) { return Insert(tuple.GetData(), tuple.GetLength(), out); }
+
+bool TmpTuplePage::Insert(const char *data, uint32_t size, TmpTuple *out) {
+  uint32_t free_space_pointer = GetFreeSpacePointer();
+  if (free_space_pointer < SIZE_TMP_PAGE_HEADER + sizeof(uint32_t) + size) {
+    return false;
+  }
+  free_space_pointer -= sizeof(uint32_t) + size;
+  SetFreeSpacePointer(free_space_pointer);
+  memcpy(GetData() + free_space_pointer, &size, sizeof(uint32_t));
+  memcpy(GetData() + free_space_pointer + sizeof(uint32_t), data, size);
+  *out = TmpTuple(GetTablePageId(), free_space_pointer);
+  return true;
+}
+
+void TmpTuplePage::Get(const TmpTuple &tmp_tuple, Tuple *tuple) {
+  tuple->DeserializeFrom(GetData() + tmp_tuple.GetOffset());
+}
+
+void TmpTuplePage::GetTuples(std::vector<Tuple> *tuples) {
+  for (uint32_t offset = GetFreeSpacePointer(); offset < PAGE_SIZE;
+       offset += sizeof(uint32_t) + *reinterpret_cast<uint32_t *>(GetData() + offset)) {
+    tuples->emplace_back();
+    tuples->back().DeserializeFrom(GetData() + offset);
+  }
+}
+
+}  // namespace bustub
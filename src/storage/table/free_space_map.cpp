@@ -0,0 +1,186 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// free_space_map.cpp
+//
+// Identification: src/storage/table/free_space_map.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include "storage/table/free_space_map.h"
+
+#include "common/macros.h"
+
+namespace bustub {
+
+namespace {
+
+FreeSpaceMapPage *AsMapPage(Page *page) { return reinterpret_cast<FreeSpaceMapPage *>(page->GetData()); }
+
+}  // namespace
+
+page_id_t FreeSpaceMap::Create(BufferPoolManager *buffer_pool_manager, page_id_t first_table_page_id,
+                               uint32_t free_space) {
+  page_id_t root_page_id;
+  Page *root_page = buffer_pool_manager->NewPage(&root_page_id);
+  BUSTUB_ASSERT(root_page != nullptr, "Couldn't create a page for the free space map.");
+  auto *root = AsMapPage(root_page);
+  root->Init(root_page_id);
+  root->SetLastTablePageId(first_table_page_id);
+  root->AddEntry(first_table_page_id, free_space);
+  buffer_pool_manager->UnpinPage(root_page_id, true);
+  return root_page_id;
+}
+
+page_id_t FreeSpaceMap::FindPage(uint32_t space_needed) {
+  // Search from the hint to the end of the list, then from the root up to the hint.
+  page_id_t start_page_id = hint_page_id_;
+  page_id_t map_page_id = start_page_id;
+  do {
+    Page *page = buffer_pool_manager_->FetchPage(map_page_id);
+    if (page == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+    page->RLatch();
+    page_id_t table_page_id = AsMapPage(page)->FindTablePage(space_needed);
+    page_id_t next_page_id = AsMapPage(page)->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_id, false);
+    if (table_page_id != INVALID_PAGE_ID) {
+      hint_page_id_ = map_page_id;
+      return table_page_id;
+    }
+    map_page_id = next_page_id == INVALID_PAGE_ID ? root_page_id_ : next_page_id;
+  } while (map_page_id != start_page_id);
+  return INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::UpdatePage(page_id_t map_page_id, page_id_t table_page_id, uint32_t free_space) {
+  Page *page = buffer_pool_manager_->FetchPage(map_page_id);
+  if (page == nullptr) {
+    return;
+  }
+  page->WLatch();
+  bool updated = AsMapPage(page)->UpdateEntry(table_page_id, free_space);
+  page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(map_page_id, updated);
+}
+
+bool FreeSpaceMap::AppendPage(const CreatePageFn &create_page) {
+  Page *root_page = buffer_pool_manager_->FetchPage(root_page_id_);
+  if (root_page == nullptr) {
+    return false;
+  }
+  root_page->WLatch();
+  auto *root = AsMapPage(root_page);
+
+  // The new entry goes to the last map page, or to a new one if that is full.
+  page_id_t map_page_id = root->GetLastMapPageId();
+  Page *map_page = root_page;
+  if (map_page_id != root_page_id_) {
+    map_page = buffer_pool_manager_->FetchPage(map_page_id);
+    if (map_page == nullptr) {
+      root_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(root_page_id_, false);
+      return false;
+    }
+    map_page->WLatch();
+  }
+  if (AsMapPage(map_page)->IsFull()) {
+    page_id_t new_map_page_id;
+    Page *new_map_page = buffer_pool_manager_->NewPage(&new_map_page_id);
+    if (new_map_page != nullptr) {
+      new_map_page->WLatch();
+      AsMapPage(new_map_page)->Init(new_map_page_id);
+      AsMapPage(map_page)->SetNextPageId(new_map_page_id);
+      root->SetLastMapPageId(new_map_page_id);
+    }
+    if (map_page != root_page) {
+      map_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(map_page_id, true);
+    }
+    if (new_map_page == nullptr) {
+      root_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(root_page_id_, true);
+      return false;
+    }
+    map_page = new_map_page;
+    map_page_id = new_map_page_id;
+  }
+
+  uint32_t free_space = 0;
+  page_id_t table_page_id = create_page(root->GetLastTablePageId(), map_page_id, &free_space);
+  if (table_page_id != INVALID_PAGE_ID) {
+    AsMapPage(map_page)->AddEntry(table_page_id, free_space);
+    root->SetLastTablePageId(table_page_id);
+    hint_page_id_ = map_page_id;
+  }
+
+  if (map_page != root_page) {
+    map_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(map_page_id, true);
+  }
+  root_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(root_page_id_, true);
+  return table_page_id != INVALID_PAGE_ID;
+}
+
+void FreeSpaceMap::GetNextPages(page_id_t table_page_id, size_t max_pages, std::vector<page_id_t> *page_ids,
+                                page_id_t *map_page_id) {
+  // Find the entry of table_page_id, on the given map page or else on any of them.
+  page_id_t cur_page_id = *map_page_id == INVALID_PAGE_ID ? root_page_id_ : *map_page_id;
+  bool searching_from_root = cur_page_id == root_page_id_;
+  int index = -1;
+  Page *page = nullptr;
+  while (cur_page_id != INVALID_PAGE_ID) {
+    page = buffer_pool_manager_->FetchPage(cur_page_id);
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    index = AsMapPage(page)->FindEntry(table_page_id);
+    if (index >= 0) {
+      break;
+    }
+    page_id_t next_page_id = AsMapPage(page)->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    page = nullptr;
+    if (next_page_id == INVALID_PAGE_ID && !searching_from_root) {
+      next_page_id = root_page_id_;
+      searching_from_root = true;
+    }
+    cur_page_id = next_page_id;
+  }
+  if (page == nullptr) {
+    return;
+  }
+
+  // Copy the entries after it, following the map pages.
+  auto next_index = static_cast<uint32_t>(index + 1);
+  while (true) {
+    auto *map_page = AsMapPage(page);
+    for (; next_index < map_page->GetNumEntries() && page_ids->size() < max_pages; next_index++) {
+      page_ids->push_back(map_page->GetTablePageId(next_index));
+    }
+    *map_page_id = cur_page_id;
+    page_id_t next_page_id = map_page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(cur_page_id, false);
+    if (page_ids->size() == max_pages || next_page_id == INVALID_PAGE_ID) {
+      return;
+    }
+    cur_page_id = next_page_id;
+    page = buffer_pool_manager_->FetchPage(cur_page_id);
+    if (page == nullptr) {
+      return;
+    }
+    page->RLatch();
+    next_index = 0;
+  }
+}
+
+}  // namespace bustub
@@ -12,6 +12,7 @@
 
 #include <cassert>
 
+#include "common/exception.h"
 #include "common/logger.h"
 #include "storage/table/table_heap.h"
 
@@ -22,7 +23,21 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
     : buffer_pool_manager_(buffer_pool_manager),
       lock_manager_(lock_manager),
       log_manager_(log_manager),
-      first_page_id_(first_page_id) {}
+      first_page_id_(first_page_id) {
+  // The first page knows where the free space map starts. Tables written before the map existed have no map and a
+  // different page layout, and must be reloaded.
+  auto first_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
+  BUSTUB_ASSERT(first_page != nullptr, "Couldn't fetch the first page of the table heap.");
+  first_page->RLatch();
+  uint32_t format_version = first_page->GetFormatVersion();
+  page_id_t map_page_id = first_page->GetFreeSpaceMapPageId();
+  first_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  if (format_version != TablePage::FORMAT_VERSION) {
+    throw Exception("table pages are in an unsupported format, the table must be reloaded");
+  }
+  free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_, map_page_id);
+}
 
 TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_manager, LogManager *log_manager,
                      Transaction *txn)
@@ -32,62 +47,150 @@ TableHeap::TableHeap(BufferPoolManager *buffer_pool_manager, LockManager *lock_m
   BUSTUB_ASSERT(first_page != nullptr, "Couldn't create a page for the table heap.");
   first_page->WLatch();
   first_page->Init(first_page_id_, PAGE_SIZE, INVALID_LSN, log_manager_, txn);
+  // Its entry is on the root page of the free space map.
+  page_id_t map_page_id =
+      FreeSpaceMap::Create(buffer_pool_manager_, first_page_id_, first_page->GetFreeSpaceRemaining());
+  first_page->SetFreeSpaceMapPageId(map_page_id);
   first_page->WUnlatch();
   buffer_pool_manager_->UnpinPage(first_page_id_, true);
+  free_space_map_ = std::make_unique<FreeSpaceMap>(buffer_pool_manager_, map_page_id);
 }
 
 bool TableHeap::InsertTuple(const Tuple &tuple, RID *rid, Transaction *txn) {
-  if (tuple.size_ + 32 > PAGE_SIZE) {  // larger than one page size
+  if (tuple.size_ > TablePage::GetMaxTupleSize()) {  // larger than one page size
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
 
-  auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  if (cur_page == nullptr) {
+  // Insert into a page the free space map says has enough space. The map is only a hint, so if the page turns out to
+  // be full, correct the map and ask again.
+  uint32_t space_needed = TablePage::GetSpaceNeeded(tuple.size_);
+  for (page_id_t page_id = free_space_map_->FindPage(space_needed); page_id != INVALID_PAGE_ID;
+       page_id = free_space_map_->FindPage(space_needed)) {
+    auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    if (cur_page == nullptr) {
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+    cur_page->WLatch();
+    bool inserted = cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    uint32_t free_space = cur_page->GetFreeSpaceRemaining();
+    page_id_t map_page_id = cur_page->GetFreeSpaceMapPageId();
+    cur_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, inserted);
+    free_space_map_->UpdatePage(map_page_id, page_id, free_space);
+    if (inserted) {
+      // Update the transaction's write set.
+      txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+      return true;
+    }
+  }
+
+  // No page has enough space. We need to create a new page after the last one and insert into that.
+  bool appended = free_space_map_->AppendPage([&](page_id_t last_page_id, page_id_t map_page_id, uint32_t *free_space) {
+    auto last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+    if (last_page == nullptr) {
+      return INVALID_PAGE_ID;
+    }
+    page_id_t new_page_id;
+    auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&new_page_id));
+    // If we could not create a new page, then life sucks and we abort the transaction.
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+      return INVALID_PAGE_ID;
+    }
+    // Otherwise we were able to create a new page. We initialize it now.
+    last_page->WLatch();
+    new_page->WLatch();
+    last_page->SetNextPageId(new_page_id);
+    new_page->Init(new_page_id, PAGE_SIZE, last_page_id, log_manager_, txn);
+    new_page->SetFreeSpaceMapPageId(map_page_id);
+    last_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(last_page_id, true);
+    // The tuple fits into an empty page.
+    new_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_);
+    *free_space = new_page->GetFreeSpaceRemaining();
+    new_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+    return new_page_id;
+  });
+  if (!appended) {
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
+  // Update the transaction's write set.
+  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
+  return true;
+}
 
-  cur_page->WLatch();
-  // Insert into the first page with enough space. If no such page exists, create a new page and insert into that.
-  // INVARIANT: cur_page is WLatched if you leave the loop normally.
-  while (!cur_page->InsertTuple(tuple, rid, txn, lock_manager_, log_manager_)) {
-    auto next_page_id = cur_page->GetNextPageId();
-    // If the next page is a valid page,
-    if (next_page_id != INVALID_PAGE_ID) {
-      // Unlatch and unpin the current page.
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-      // And repeat the process with the next page.
-      cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(next_page_id));
+bool TableHeap::InsertTuples(const std::vector<Tuple> &tuples, std::vector<RID> *rids, Transaction *txn) {
+  for (const auto &tuple : tuples) {
+    if (tuple.size_ > TablePage::GetMaxTupleSize()) {  // larger than one page size
+      txn->SetState(TransactionState::ABORTED);
+      return false;
+    }
+  }
+
+  size_t first_rid = rids->size();
+  auto next = static_cast<uint32_t>(0);
+  bool inserted = true;
+  while (inserted && next < tuples.size()) {
+    // Fill a page with room for the next tuple as far as it goes, like InsertTuple() would for one.
+    uint32_t space_needed = TablePage::GetSpaceNeeded(tuples[next].size_);
+    page_id_t page_id = free_space_map_->FindPage(space_needed);
+    if (page_id != INVALID_PAGE_ID) {
+      auto cur_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+      if (cur_page == nullptr) {
+        inserted = false;
+        break;
+      }
       cur_page->WLatch();
-    } else {
-      // Otherwise we have run out of valid pages. We need to create a new page.
-      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&next_page_id));
-      // If we could not create a new page,
+      uint32_t num_inserted = cur_page->InsertTuples(tuples, next, rids, txn, lock_manager_, log_manager_);
+      uint32_t free_space = cur_page->GetFreeSpaceRemaining();
+      page_id_t map_page_id = cur_page->GetFreeSpaceMapPageId();
+      cur_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(page_id, num_inserted > 0);
+      free_space_map_->UpdatePage(map_page_id, page_id, free_space);
+      next += num_inserted;
+      continue;
+    }
+
+    // No page has enough space, append one and fill it.
+    inserted = free_space_map_->AppendPage([&](page_id_t last_page_id, page_id_t map_page_id, uint32_t *free_space) {
+      auto last_page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(last_page_id));
+      if (last_page == nullptr) {
+        return INVALID_PAGE_ID;
+      }
+      page_id_t new_page_id;
+      auto new_page = static_cast<TablePage *>(buffer_pool_manager_->NewPage(&new_page_id));
       if (new_page == nullptr) {
-        // Then life sucks and we abort the transaction.
-        cur_page->WUnlatch();
-        buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), false);
-        txn->SetState(TransactionState::ABORTED);
-        return false;
+        buffer_pool_manager_->UnpinPage(last_page_id, false);
+        return INVALID_PAGE_ID;
       }
-      // Otherwise we were able to create a new page. We initialize it now.
+      last_page->WLatch();
       new_page->WLatch();
-      cur_page->SetNextPageId(next_page_id);
-      new_page->Init(next_page_id, PAGE_SIZE, cur_page->GetTablePageId(), log_manager_, txn);
-      cur_page->WUnlatch();
-      buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-      cur_page = new_page;
-    }
+      last_page->SetNextPageId(new_page_id);
+      new_page->Init(new_page_id, PAGE_SIZE, last_page_id, log_manager_, txn);
+      new_page->SetFreeSpaceMapPageId(map_page_id);
+      last_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+      next += new_page->InsertTuples(tuples, next, rids, txn, lock_manager_, log_manager_);
+      *free_space = new_page->GetFreeSpaceRemaining();
+      new_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(new_page_id, true);
+      return new_page_id;
+    });
   }
-  // This line has caused most of us to double-take and "whoa double unlatch".
-  // We are not, in fact, double unlatching. See the invariant above.
-  cur_page->WUnlatch();
-  buffer_pool_manager_->UnpinPage(cur_page->GetTablePageId(), true);
-  // Update the transaction's write set.
-  txn->GetWriteSet()->emplace_back(*rid, WType::INSERT, Tuple{}, this);
-  return true;
+
+  // Update the transaction's write set, also with the tuples inserted before a failure, so that they are rolled back.
+  auto write_set = txn->GetWriteSet();
+  for (size_t i = first_rid; i < rids->size(); i++) {
+    write_set->emplace_back((*rids)[i], WType::INSERT, Tuple{}, this);
+  }
+  if (!inserted) {
+    txn->SetState(TransactionState::ABORTED);
+  }
+  return inserted;
 }
 
 bool TableHeap::MarkDelete(const RID &rid, Transaction *txn) {
@@ -121,8 +224,13 @@ bool TableHeap::UpdateTuple(const Tuple &tuple, const RID &rid, Transaction *txn
   Tuple old_tuple;
   page->WLatch();
   bool is_updated = page->UpdateTuple(tuple, &old_tuple, rid, txn, lock_manager_, log_manager_);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
+  page_id_t map_page_id = page->GetFreeSpaceMapPageId();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), is_updated);
+  if (is_updated) {
+    free_space_map_->UpdatePage(map_page_id, rid.GetPageId(), free_space);
+  }
   // Update the transaction's write set.
   if (is_updated && txn->GetState() != TransactionState::ABORTED) {
     txn->GetWriteSet()->emplace_back(rid, WType::UPDATE, old_tuple, this);
@@ -138,8 +246,12 @@ void TableHeap::ApplyDelete(const RID &rid, Transaction *txn) {
   page->WLatch();
   page->ApplyDelete(rid, txn, log_manager_);
   lock_manager_->Unlock(txn, rid);
+  uint32_t free_space = page->GetFreeSpaceRemaining();
+  page_id_t map_page_id = page->GetFreeSpaceMapPageId();
   page->WUnlatch();
   buffer_pool_manager_->UnpinPage(page->GetTablePageId(), true);
+  // The space of the tuple can now be reused.
+  free_space_map_->UpdatePage(map_page_id, rid.GetPageId(), free_space);
 }
 
 void TableHeap::RollbackDelete(const RID &rid, Transaction *txn) {
@@ -169,6 +281,80 @@ bool TableHeap::GetTuple(const RID &rid, Tuple *tuple, Transaction *txn) {
   return res;
 }
 
+page_id_t TableHeap::GetPageTuples(page_id_t page_id, std::vector<Tuple> *tuples, Transaction *txn) {
+  TablePageGuard guard;
+  std::vector<TupleView> views;
+  page_id_t next_page_id = GetPageTupleViews(page_id, &guard, &views, txn);
+  for (const auto &view : views) {
+    tuples->push_back(view.Materialize());
+  }
+  return next_page_id;
+}
+
+page_id_t TableHeap::GetPageTuples(page_id_t page_id, const SlotFilter &filter, std::vector<Tuple> *tuples,
+                                   Transaction *txn) {
+  TablePageGuard guard;
+  std::vector<TupleView> views;
+  page_id_t next_page_id = GetPageTupleViews(page_id, filter, &guard, &views, txn);
+  for (const auto &view : views) {
+    tuples->push_back(view.Materialize());
+  }
+  return next_page_id;
+}
+
+bool TableHeap::GetTupleView(const RID &rid, TablePageGuard *guard, TupleView *view, Transaction *txn) {
+  if (guard->GetPageId() != rid.GetPageId()) {
+    *guard = TablePageGuard(buffer_pool_manager_, rid.GetPageId());
+  }
+  return guard->GetPage()->GetTupleView(rid, view, txn, lock_manager_);
+}
+
+page_id_t TableHeap::GetPageTupleViews(page_id_t page_id, TablePageGuard *guard, std::vector<TupleView> *views,
+                                       Transaction *txn) {
+  *guard = TablePageGuard(buffer_pool_manager_, page_id);
+  TablePage *page = guard->GetPage();
+  RID rid;
+  for (bool found = page->GetFirstTupleRid(&rid); found; found = page->GetNextTupleRid(rid, &rid)) {
+    views->emplace_back();
+    if (!page->GetTupleView(rid, &views->back(), txn, lock_manager_)) {
+      views->pop_back();
+    }
+  }
+  return page->GetNextPageId();
+}
+
+page_id_t TableHeap::GetPageTupleViews(page_id_t page_id, const SlotFilter &filter, TablePageGuard *guard,
+                                       std::vector<TupleView> *views, Transaction *txn) {
+  *guard = TablePageGuard(buffer_pool_manager_, page_id);
+  TablePage *page = guard->GetPage();
+  std::vector<uint32_t> slots;
+  filter.Filter(page, &slots);
+  for (uint32_t slot : slots) {
+    views->emplace_back();
+    if (!page->GetTupleView(RID(page_id, slot), &views->back(), txn, lock_manager_)) {
+      views->pop_back();
+    }
+  }
+  return page->GetNextPageId();
+}
+
+page_id_t TableHeap::GetNextPageId(page_id_t page_id) {
+  auto page = static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  BUSTUB_ASSERT(page != nullptr, "Could not fetch a table page.");
+  page->RLatch();
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
+ReadAhead::NextPagesFn TableHeap::GetNextPagesFn() {
+  return [free_space_map = free_space_map_.get(), map_page_id = INVALID_PAGE_ID](
+             page_id_t page_id, size_t max_pages, std::vector<page_id_t> *page_ids) mutable {
+    free_space_map->GetNextPages(page_id, max_pages, page_ids, &map_page_id);
+  };
+}
+
 TableIterator TableHeap::Begin(Transaction *txn) {
   // Start an iterator from the first page.
   // TODO(Wuwen): Hacky fix for now. Removing empty pages is a better way to handle this.
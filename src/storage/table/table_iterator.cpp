@@ -17,7 +17,10 @@
 namespace bustub {
 
 TableIterator::TableIterator(TableHeap *table_heap, RID rid, Transaction *txn)
-    : table_heap_(table_heap), tuple_(new Tuple(rid)), txn_(txn) {
+    : table_heap_(table_heap),
+      tuple_(new Tuple(rid)),
+      txn_(txn),
+      read_ahead_(table_heap->buffer_pool_manager_, table_heap->GetNextPagesFn()) {
   if (rid.GetPageId() != INVALID_PAGE_ID) {
     table_heap_->GetTuple(tuple_->rid_, tuple_, txn_);
   }
@@ -43,6 +46,7 @@ TableIterator &TableIterator::operator++() {
   if (!cur_page->GetNextTupleRid(tuple_->rid_,
                                  &next_tuple_rid)) {  // end of this page
     while (cur_page->GetNextPageId() != INVALID_PAGE_ID) {
+      read_ahead_.OnPageAccess(cur_page->GetNextPageId());
       auto next_page = static_cast<TablePage *>(buffer_pool_manager->FetchPage(cur_page->GetNextPageId()));
       cur_page->RUnlatch();
       buffer_pool_manager->UnpinPage(cur_page->GetTablePageId(), false);
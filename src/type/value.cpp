@@ -41,6 +41,16 @@ Value::Value(const Value &other) {
   }
 }
 
+Value::Value(Value &&other) noexcept {
+  type_id_ = other.type_id_;
+  size_ = other.size_;
+  manage_data_ = other.manage_data_;
+  value_ = other.value_;
+  other.type_id_ = TypeId::INVALID;
+  other.size_.len_ = BUSTUB_VALUE_NULL;
+  other.manage_data_ = false;
+}
+
 Value &Value::operator=(Value other) {
   Swap(*this, other);
   return *this;
@@ -0,0 +1,131 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// buffer_pool_manager_instance_benchmark_test.cpp
+//
+// Identification: test/buffer/buffer_pool_manager_instance_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// Fetch/unpin throughput on pages that are all resident, i.e. the hit path only.
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceBenchmarkTest, DISABLED_HitPathScaling) {
+  const std::string db_name = "bpm_bench.db";
+  const size_t buffer_pool_size = 1024;
+  const int num_resident_pages = 512;
+  const auto duration = std::chrono::milliseconds(200);
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, disk_manager);
+
+  page_id_t page_id;
+  for (int i = 0; i < num_resident_pages; i++) {
+    ASSERT_NE(nullptr, bpm->NewPage(&page_id));
+    ASSERT_TRUE(bpm->UnpinPage(page_id, false));
+  }
+
+  for (int num_threads : {1, 2, 4, 8, 16}) {
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> total_ops{0};
+    std::atomic<uint64_t> failures{0};
+    std::vector<std::thread> threads;
+    for (int tid = 0; tid < num_threads; tid++) {
+      threads.emplace_back([&, tid] {
+        std::mt19937 rng(tid);
+        std::uniform_int_distribution<page_id_t> dist(0, num_resident_pages - 1);
+        uint64_t ops = 0;
+        while (!stop.load(std::memory_order_relaxed)) {
+          page_id_t pid = dist(rng);
+          Page *page = bpm->FetchPage(pid);
+          if (page == nullptr || page->GetPageId() != pid || !bpm->UnpinPage(pid, false)) {
+            failures++;
+          }
+          ops++;
+        }
+        total_ops += ops;
+      });
+    }
+    auto start = std::chrono::steady_clock::now();
+    std::this_thread::sleep_for(duration);
+    stop = true;
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(0, failures.load());
+    printf("[bpm hit path] threads=%2d  ops/sec=%12.0f\n", num_threads, total_ops.load() / seconds);
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  delete bpm;
+  delete disk_manager;
+}
+
+// Random fetches over a pool far larger than the TLB reach of regular pages, each touching a few cache lines spread
+// over the page, with the frames on regular and on huge pages. Huge pages cut the TLB misses of the page data itself.
+// NOLINTNEXTLINE
+TEST(BufferPoolManagerInstanceBenchmarkTest, DISABLED_HugePageFrames) {
+  const std::string db_name = "bpm_tlb_bench.db";
+  const size_t buffer_pool_size = 16384;
+  const int num_fetches = 2000000;
+
+  for (bool use_huge_pages : {false, true}) {
+    auto *disk_manager = new DiskManager(db_name);
+    auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, 1, 0, disk_manager, nullptr, ReplacerType::LRU,
+                                              use_huge_pages);
+    page_id_t page_id;
+    for (size_t i = 0; i < buffer_pool_size; i++) {
+      Page *page = bpm->NewPage(&page_id);
+      ASSERT_NE(nullptr, page);
+      memcpy(page->GetData(), &page_id, sizeof(page_id));
+      ASSERT_TRUE(bpm->UnpinPage(page_id, true));
+    }
+
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<page_id_t> dist(0, buffer_pool_size - 1);
+    uint64_t failures = 0;
+    uint64_t checksum = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_fetches; i++) {
+      page_id_t pid = dist(rng);
+      Page *page = bpm->FetchPage(pid);
+      page_id_t stored;
+      memcpy(&stored, page->GetData(), sizeof(stored));
+      failures += stored != pid ? 1 : 0;
+      for (size_t offset = PAGE_SIZE / 4; offset < PAGE_SIZE; offset += PAGE_SIZE / 4) {
+        checksum += page->GetData()[offset];
+      }
+      bpm->UnpinPage(pid, false);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    EXPECT_EQ(0, failures);
+    EXPECT_EQ(0, checksum);
+    printf("[bpm frames] huge pages requested=%-3s in use=%-3s  fetches/sec=%12.0f\n", use_huge_pages ? "yes" : "no",
+           bpm->UsesHugePages() ? "yes" : "no", num_fetches / seconds);
+
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+    remove("bpm_tlb_bench.log");
+    delete bpm;
+    delete disk_manager;
+  }
+}
+
+}  // namespace bustub
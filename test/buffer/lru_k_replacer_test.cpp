@@ -0,0 +1,120 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// lru_k_replacer_test.cpp
+//
+// Identification: test/buffer/lru_k_replacer_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/lru_k_replacer.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+TEST(LRUKReplacerTest, SampleTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: unpin six frames without references. They are evicted in unpin order.
+  for (int i = 1; i <= 6; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ(6, lru_k_replacer.Size());
+  int value;
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(1, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(2, value);
+
+  // Scenario: pinned frames are not victimized.
+  lru_k_replacer.Pin(2);
+  lru_k_replacer.Pin(3);
+  EXPECT_EQ(3, lru_k_replacer.Size());
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(4, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(5, value);
+  lru_k_replacer.Victim(&value);
+  EXPECT_EQ(6, value);
+  EXPECT_FALSE(lru_k_replacer.Victim(&value));
+}
+
+TEST(LRUKReplacerTest, ScanResistanceTest) {
+  LRUKReplacer lru_k_replacer(7, 2);
+
+  // Scenario: frames 0 and 1 are referenced twice, frames 2 to 5 once each, after 0 and 1.
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.RecordAccess(1);
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.RecordAccess(1);
+  for (int i = 2; i <= 5; i++) {
+    lru_k_replacer.RecordAccess(i);
+    // Back-to-back references to the same frame are correlated and count once.
+    lru_k_replacer.RecordAccess(i);
+  }
+  for (int i = 0; i <= 5; i++) {
+    lru_k_replacer.Unpin(i);
+  }
+
+  // Scenario: the frames referenced once go first, although they were used more recently.
+  EXPECT_EQ((std::vector<frame_id_t>{2, 3, 4, 5, 0, 1}), lru_k_replacer.PeekVictims(10));
+  int value;
+  for (int expected : {2, 3, 4, 5, 0, 1}) {
+    ASSERT_TRUE(lru_k_replacer.Victim(&value));
+    EXPECT_EQ(expected, value);
+  }
+
+  // Scenario: a victim keeps its history, so a frame that is unpinned again without being evicted goes back behind
+  // the frames with fewer references.
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(2);
+  EXPECT_EQ((std::vector<frame_id_t>{2, 0}), lru_k_replacer.PeekVictims(10));
+  lru_k_replacer.Pin(0);
+  lru_k_replacer.Pin(2);
+
+  // Scenario: a frame whose page was evicted forgets its history.
+  lru_k_replacer.ForgetHistory(1);
+  lru_k_replacer.RecordAccess(0);
+  lru_k_replacer.RecordAccess(1);
+  lru_k_replacer.Unpin(0);
+  lru_k_replacer.Unpin(1);
+  EXPECT_EQ((std::vector<frame_id_t>{1, 0}), lru_k_replacer.PeekVictims(10));
+}
+
+TEST(LRUKReplacerTest, ReorderTest) {
+  const int num_frames = 1000;
+  LRUKReplacer lru_k_replacer(num_frames, 2);
+
+  // Scenario: frames referenced while they are evictable are moved back, however the references interleave.
+  for (int i = 0; i < num_frames; i++) {
+    lru_k_replacer.RecordAccess(i);
+    lru_k_replacer.Unpin(i);
+  }
+  for (int i = 1; i < num_frames; i += 2) {
+    lru_k_replacer.RecordAccess(i);
+  }
+  std::vector<frame_id_t> expected;
+  for (int i = 0; i < num_frames; i += 2) {
+    expected.push_back(i);
+  }
+  for (int i = 1; i < num_frames; i += 2) {
+    expected.push_back(i);
+  }
+  EXPECT_EQ(std::vector<frame_id_t>(expected.begin(), expected.begin() + 10), lru_k_replacer.PeekVictims(10));
+  EXPECT_EQ(expected, lru_k_replacer.PeekVictims(num_frames));
+  int value;
+  for (frame_id_t frame_id : expected) {
+    ASSERT_TRUE(lru_k_replacer.Victim(&value));
+    EXPECT_EQ(frame_id, value);
+  }
+  EXPECT_EQ(0, lru_k_replacer.Size());
+}
+
+}  // namespace bustub
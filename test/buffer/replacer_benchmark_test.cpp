@@ -0,0 +1,169 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// replacer_benchmark_test.cpp
+//
+// Identification: test/buffer/replacer_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+const size_t BUFFER_POOL_SIZE_FOR_REPLAY = 64;
+
+const char *ReplacerName(ReplacerType type) {
+  switch (type) {
+    case ReplacerType::LRU:
+      return "lru";
+    case ReplacerType::CLOCK:
+      return "clock";
+    case ReplacerType::LRU_K:
+      return "lru-k";
+  }
+  return "unknown";
+}
+
+/**
+ * Index lookups (root, one of 15 internal pages, one of 400 leaves) interleaved with a sequential scan that reads
+ * every page 20 times, once per tuple.
+ */
+std::vector<page_id_t> ScanWithIndexLookupsTrace() {
+  const page_id_t num_internal = 15;
+  const page_id_t num_leaves = 400;
+  const page_id_t num_scan_pages = 2000;
+  std::mt19937 rng(0);
+  std::uniform_int_distribution<page_id_t> internal(1, num_internal);
+  std::uniform_int_distribution<page_id_t> leaf(1 + num_internal, num_internal + num_leaves);
+  std::vector<page_id_t> trace;
+  page_id_t first_scan_page = 1 + num_internal + num_leaves;
+  for (page_id_t page = 0; page < num_scan_pages; page++) {
+    for (int tuple = 0; tuple < 20; tuple++) {
+      trace.push_back(first_scan_page + page);
+    }
+    for (int lookup = 0; lookup < 2; lookup++) {
+      trace.push_back(0);
+      trace.push_back(internal(rng));
+      trace.push_back(leaf(rng));
+    }
+  }
+  return trace;
+}
+
+/** Random accesses to 1000 pages with Zipfian (s = 1) popularity. */
+std::vector<page_id_t> ZipfTrace() {
+  const int num_pages = 1000;
+  const int num_accesses = 50000;
+  std::vector<double> weights(num_pages);
+  for (int i = 0; i < num_pages; i++) {
+    weights[i] = 1.0 / (i + 1);
+  }
+  std::mt19937 rng(0);
+  std::discrete_distribution<page_id_t> dist(weights.begin(), weights.end());
+  std::vector<page_id_t> trace;
+  trace.reserve(num_accesses);
+  for (int i = 0; i < num_accesses; i++) {
+    trace.push_back(dist(rng));
+  }
+  return trace;
+}
+
+/** Repeated sequential scans over a table slightly larger than the pool, the worst case for LRU. */
+std::vector<page_id_t> LoopingScanTrace() {
+  const auto num_pages = static_cast<page_id_t>(BUFFER_POOL_SIZE_FOR_REPLAY * 3 / 2);
+  std::vector<page_id_t> trace;
+  for (int loop = 0; loop < 50; loop++) {
+    for (page_id_t page = 0; page < num_pages; page++) {
+      trace.push_back(page);
+    }
+  }
+  return trace;
+}
+
+/** Reads a recorded trace, one page id per line. */
+std::vector<page_id_t> LoadTrace(const std::string &file_name) {
+  std::ifstream in(file_name);
+  std::vector<page_id_t> trace;
+  page_id_t page_id;
+  while (in >> page_id) {
+    trace.push_back(page_id);
+  }
+  return trace;
+}
+
+/** Replays trace (fetch and unpin of every page) through a buffer pool using the given policy. */
+double ReplayHitRatio(const std::vector<page_id_t> &trace, ReplacerType type) {
+  const std::string db_name = "replacer_bench.db";
+  page_id_t max_page_id = 0;
+  for (auto page_id : trace) {
+    max_page_id = std::max(max_page_id, page_id);
+  }
+
+  auto *disk_manager = new DiskManager(db_name);
+  auto *bpm = new BufferPoolManagerInstance(BUFFER_POOL_SIZE_FOR_REPLAY, disk_manager, nullptr, type);
+  page_id_t page_id;
+  for (page_id_t i = 0; i <= max_page_id; i++) {
+    EXPECT_NE(nullptr, bpm->NewPage(&page_id));
+    bpm->UnpinPage(page_id, false);
+  }
+
+  uint64_t misses_before = bpm->GetNumFetchMisses();
+  for (auto pid : trace) {
+    EXPECT_NE(nullptr, bpm->FetchPage(pid));
+    bpm->UnpinPage(pid, false);
+  }
+  uint64_t misses = bpm->GetNumFetchMisses() - misses_before;
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("replacer_bench.log");
+  delete bpm;
+  delete disk_manager;
+  return 1.0 - static_cast<double>(misses) / trace.size();
+}
+
+}  // namespace
+
+// Replays page-access traces through a buffer pool with every replacement policy and reports the hit ratio. Set
+// BUSTUB_REPLACER_TRACE to a file with one page id per line to replay a recorded trace as well.
+// NOLINTNEXTLINE
+TEST(ReplacerBenchmarkTest, DISABLED_TraceReplayHitRatio) {
+  std::map<std::string, std::vector<page_id_t>> traces{{"scan+index", ScanWithIndexLookupsTrace()},
+                                                       {"zipf", ZipfTrace()},
+                                                       {"looping scan", LoopingScanTrace()}};
+  const char *trace_file = std::getenv("BUSTUB_REPLACER_TRACE");
+  if (trace_file != nullptr) {
+    traces.emplace(trace_file, LoadTrace(trace_file));
+  }
+
+  std::map<std::string, std::map<ReplacerType, double>> hit_ratios;
+  for (const auto &[name, trace] : traces) {
+    for (auto type : {ReplacerType::LRU, ReplacerType::CLOCK, ReplacerType::LRU_K}) {
+      double hit_ratio = ReplayHitRatio(trace, type);
+      hit_ratios[name][type] = hit_ratio;
+      printf("[replacer] trace=%-14s policy=%-6s accesses=%8zu  hit ratio=%.4f\n", name.c_str(), ReplacerName(type),
+             trace.size(), hit_ratio);
+    }
+  }
+
+  // A scan must not push the index pages out of the pool.
+  EXPECT_GT(hit_ratios["scan+index"][ReplacerType::LRU_K], hit_ratios["scan+index"][ReplacerType::LRU]);
+}
+
+}  // namespace bustub
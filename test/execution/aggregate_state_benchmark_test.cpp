@@ -0,0 +1,95 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregate_state_benchmark_test.cpp
+//
+// Identification: test/execution/aggregate_state_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "execution/aggregate_state.h"
+#include "execution/expressions/column_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Computes SUM, MIN and MAX of num_values values, a batch of values repeated, once through Value arithmetic, as the
+ * aggregation hash table used to, and once through the typed accumulators of Aggregator, and reports the input values
+ * per second of both.
+ */
+void RunSumMinMax(TypeId type_id, const std::vector<Value> &batch, size_t num_values) {
+  size_t num_batches = num_values / batch.size();
+
+  auto start = std::chrono::steady_clock::now();
+  Value sum = ValueFactory::GetZeroValueByType(type_id);
+  Value min = batch[0];
+  Value max = batch[0];
+  for (size_t b = 0; b < num_batches; b++) {
+    for (const auto &value : batch) {
+      sum = sum.Add(value);
+      min = min.Min(value);
+      max = max.Max(value);
+    }
+  }
+  double value_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  ColumnValueExpression input{0, 0, type_id};
+  Aggregator aggregator{{&input, &input, &input},
+                        {AggregationType::SumAggregate, AggregationType::MinAggregate, AggregationType::MaxAggregate}};
+  std::vector<std::vector<Value>> columns{batch, batch, batch};
+  start = std::chrono::steady_clock::now();
+  AggregateState state;
+  aggregator.Init(&state);
+  for (size_t b = 0; b < num_batches; b++) {
+    for (uint32_t row = 0; row < batch.size(); row++) {
+      aggregator.Combine(&state, columns, row);
+    }
+  }
+  std::vector<Value> results;
+  aggregator.Finalize(state, &results);
+  double typed_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  // Both ways add up the same values in the same order.
+  EXPECT_EQ(CmpBool::CmpTrue, sum.CompareEquals(results[0]));
+  EXPECT_EQ(CmpBool::CmpTrue, min.CompareEquals(results[1]));
+  EXPECT_EQ(CmpBool::CmpTrue, max.CompareEquals(results[2]));
+  double total = static_cast<double>(num_batches * batch.size());
+  printf("[aggregate state] %-7s SUM/MIN/MAX of %zu values  Value arithmetic values/sec=%11.0f  typed accumulators "
+         "values/sec=%11.0f  speedup=%.2fx\n",
+         Type::TypeIdToString(type_id).c_str(), num_batches * batch.size(), total / value_seconds,
+         total / typed_seconds, value_seconds / typed_seconds);
+}
+
+}  // namespace
+
+// SUM, MIN and MAX over about 10M BIGINT and 10M DECIMAL values, fed a batch of EXECUTION_BATCH_SIZE values at a time.
+// NOLINTNEXTLINE
+TEST(AggregateStateBenchmarkTest, DISABLED_SumMinMax) {
+  const size_t num_values = 10000000;
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<int64_t> integers(0, 1000000);
+  std::uniform_real_distribution<double> decimals(0, 1000);
+
+  std::vector<Value> bigints;
+  std::vector<Value> decimal_values;
+  for (int i = 0; i < EXECUTION_BATCH_SIZE; i++) {
+    bigints.push_back(ValueFactory::GetBigIntValue(integers(generator)));
+    decimal_values.push_back(ValueFactory::GetDecimalValue(decimals(generator)));
+  }
+  RunSumMinMax(TypeId::BIGINT, bigints, num_values);
+  RunSumMinMax(TypeId::DECIMAL, decimal_values, num_values);
+}
+
+}  // namespace bustub
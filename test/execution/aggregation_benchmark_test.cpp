@@ -0,0 +1,124 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// aggregation_benchmark_test.cpp
+//
+// Identification: test/execution/aggregation_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// SELECT <group>, COUNT(colC), SUM(colC) FROM agg_bench GROUP BY <group>, with 10 groups (colB) and with one group per
+// row (colA), on one thread and on 2 to 16 threads. The last run of the high-cardinality aggregation has a memory
+// budget of about a fifth of its partial aggregates (some 128 bytes each) and spills them to temporary pages. Every run
+// must return the same number of groups.
+// NOLINTNEXTLINE
+TEST(AggregationBenchmarkTest, DISABLED_GroupByScaling) {
+  const std::string db_name = "aggregation_bench.db";
+  const uint32_t num_rows = 100000;
+  const size_t pool_size = 4096;
+  const int num_runs = 2;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *table_info = gen.GenerateTest1Table("agg_bench", num_rows);
+  ExecutionEngine engine{bpm.get(), txn_mgr.get(), catalog.get()};
+
+  const Schema &schema = table_info->schema_;
+  ColumnValueExpression col_a{0, schema.GetColIdx("colA"), TypeId::INTEGER};
+  ColumnValueExpression col_b{0, schema.GetColIdx("colB"), TypeId::INTEGER};
+  ColumnValueExpression col_c{0, schema.GetColIdx("colC"), TypeId::INTEGER};
+  Schema scan_schema{{Column("colA", TypeId::INTEGER, &col_a), Column("colB", TypeId::INTEGER, &col_b),
+                      Column("colC", TypeId::INTEGER, &col_c)}};
+  SeqScanPlanNode scan_plan{&scan_schema, nullptr, table_info->oid_};
+
+  ColumnValueExpression scan_col_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression scan_col_b{0, 1, TypeId::INTEGER};
+  ColumnValueExpression scan_col_c{0, 2, TypeId::INTEGER};
+  AggregateValueExpression group{true, 0, TypeId::INTEGER};
+  AggregateValueExpression count_c{false, 0, TypeId::INTEGER};
+  AggregateValueExpression sum_c{false, 1, TypeId::INTEGER};
+  Schema agg_schema{{Column("group", TypeId::INTEGER, &group), Column("countC", TypeId::INTEGER, &count_c),
+                     Column("sumC", TypeId::INTEGER, &sum_c)}};
+  auto make_aggregation = [&](const AbstractExpression *group_by) {
+    return std::make_unique<AggregationPlanNode>(
+        &agg_schema, &scan_plan, nullptr, std::vector<const AbstractExpression *>{group_by},
+        std::vector<const AbstractExpression *>{&scan_col_c, &scan_col_c},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate});
+  };
+  auto low_cardinality = make_aggregation(&scan_col_b);
+  auto high_cardinality = make_aggregation(&scan_col_a);
+
+  auto run = [&](const char *name, const AbstractPlanNode *plan, size_t num_threads, size_t memory_budget,
+                 size_t expected_groups, double *base_rows_per_sec) {
+    exec_ctx->SetParallelism(num_threads);
+    exec_ctx->SetMemoryBudget(memory_budget);
+    std::vector<Tuple> result_set;
+    engine.Execute(plan, &result_set, txn, exec_ctx.get());
+    ASSERT_EQ(expected_groups, result_set.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_runs; i++) {
+      engine.Execute(plan, nullptr, txn, exec_ctx.get());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rows_per_sec = num_rows * num_runs / seconds;
+    if (*base_rows_per_sec == 0) {
+      *base_rows_per_sec = rows_per_sec;
+    }
+    printf("[aggregation] %-16s threads=%2zu%-9s  budget=%8zu  input rows/sec=%11.0f  speedup=%.2fx  (%u hardware "
+           "threads)\n",
+           name, num_threads, num_threads == 1 && memory_budget == 0 ? " (serial)" : "", memory_budget, rows_per_sec,
+           rows_per_sec / *base_rows_per_sec, std::thread::hardware_concurrency());
+  };
+
+  exec_ctx->SetBatchExecution(true);
+  double low_base = 0;
+  double high_base = 0;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    run("10 groups", low_cardinality.get(), num_threads, 0, 10, &low_base);
+  }
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    run("100000 groups", high_cardinality.get(), num_threads, 0, num_rows, &high_base);
+  }
+  run("100000 groups", high_cardinality.get(), 4, num_rows * 128 / 5, num_rows, &high_base);
+  exec_ctx->SetMemoryBudget(0);
+  exec_ctx->SetParallelism(1);
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("aggregation_bench.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,122 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// batch_execution_benchmark_test.cpp
+//
+// Identification: test/execution/batch_execution_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "execution/plans/aggregation_plan.h"
+#include "execution/plans/hash_join_plan.h"
+#include "executor_test_util.h"  // NOLINT
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+/** Runs the same plans tuple-at-a-time and a batch at a time over the generated test tables. */
+class BatchExecutionBenchmarkTest : public ExecutorTest {
+ protected:
+  /** SELECT colA, colB FROM test_1 WHERE colA < 500 */
+  std::unique_ptr<AbstractPlanNode> MakeTest1Scan() {
+    auto *table_info = GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+    auto *predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(500)),
+                                               ComparisonType::LessThan);
+    return std::make_unique<SeqScanPlanNode>(MakeOutputSchema({{"colA", col_a}, {"colB", col_b}}), predicate,
+                                             table_info->oid_);
+  }
+
+  /** SELECT col1, col2 FROM test_2 */
+  std::unique_ptr<AbstractPlanNode> MakeTest2Scan() {
+    auto *table_info = GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto *col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto *col2 = MakeColumnValueExpression(schema, 0, "col2");
+    return std::make_unique<SeqScanPlanNode>(MakeOutputSchema({{"col1", col1}, {"col2", col2}}), nullptr,
+                                             table_info->oid_);
+  }
+
+  /** SELECT test_1.colA, test_1.colB, test_2.col1 FROM <left> JOIN <right> ON test_1.colB = test_2.col2 */
+  std::unique_ptr<AbstractPlanNode> MakeJoin(const AbstractPlanNode *left, const AbstractPlanNode *right) {
+    const Schema *left_schema = left->OutputSchema();
+    const Schema *right_schema = right->OutputSchema();
+    auto *col_a = MakeColumnValueExpression(*left_schema, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(*left_schema, 0, "colB");
+    auto *col1 = MakeColumnValueExpression(*right_schema, 1, "col1");
+    auto *col2 = MakeColumnValueExpression(*right_schema, 1, "col2");
+    return std::make_unique<HashJoinPlanNode>(MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"col1", col1}}),
+                                              std::vector<const AbstractPlanNode *>{left, right}, col_b, col2);
+  }
+
+  /** SELECT colB, COUNT(colA), SUM(colA), MAX(colA) FROM <child> GROUP BY colB */
+  std::unique_ptr<AbstractPlanNode> MakeAggregation(const AbstractPlanNode *child) {
+    auto *col_a = MakeColumnValueExpression(*child->OutputSchema(), 0, "colA");
+    auto *col_b = MakeColumnValueExpression(*child->OutputSchema(), 0, "colB");
+    const Schema *schema = MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                             {"countA", MakeAggregateValueExpression(false, 0)},
+                                             {"sumA", MakeAggregateValueExpression(false, 1)},
+                                             {"maxA", MakeAggregateValueExpression(false, 2)}});
+    return std::make_unique<AggregationPlanNode>(
+        schema, child, nullptr, std::vector<const AbstractExpression *>{col_b},
+        std::vector<const AbstractExpression *>{col_a, col_a, col_a},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MaxAggregate});
+  }
+
+  /**
+   * Runs plan num_runs times without collecting the result, so that the timing covers the executors but not the
+   * materialization of the result set, and reports the output rows per second.
+   */
+  void Run(const char *name, const AbstractPlanNode *plan, int num_runs) {
+    size_t num_rows[2];
+    double rows_per_sec[2];
+    for (bool batch_execution : {false, true}) {
+      GetExecutorContext()->SetBatchExecution(batch_execution);
+      std::vector<Tuple> result_set;
+      GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+      num_rows[batch_execution] = result_set.size();
+      auto start = std::chrono::steady_clock::now();
+      for (int run = 0; run < num_runs; run++) {
+        GetExecutionEngine()->Execute(plan, nullptr, GetTxn(), GetExecutorContext());
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      rows_per_sec[batch_execution] = result_set.size() * num_runs / seconds;
+    }
+    GetExecutorContext()->SetBatchExecution(false);
+    ASSERT_EQ(num_rows[0], num_rows[1]);
+    printf("[batch] %-26s rows=%6zu  tuple-at-a-time rows/sec=%11.0f  batch rows/sec=%11.0f  speedup=%.2fx\n", name,
+           num_rows[0], rows_per_sec[0], rows_per_sec[1], rows_per_sec[1] / rows_per_sec[0]);
+  }
+};
+
+// Scan with a filter, hash join and grouped aggregation over test_1 and test_2, tuple-at-a-time versus a batch at a
+// time. Every plan must produce the same number of rows both ways.
+// NOLINTNEXTLINE
+TEST_F(BatchExecutionBenchmarkTest, DISABLED_TupleVersusBatch) {
+  const int num_runs = 20;
+  auto scan1 = MakeTest1Scan();
+  auto scan2 = MakeTest2Scan();
+  auto join = MakeJoin(scan1.get(), scan2.get());
+  auto scan_aggregation = MakeAggregation(scan1.get());
+  auto join_aggregation = MakeAggregation(join.get());
+
+  Run("scan test_1 (filter)", scan1.get(), num_runs);
+  Run("scan test_2", scan2.get(), num_runs);
+  Run("test_1 join test_2", join.get(), num_runs);
+  Run("aggregate test_1", scan_aggregation.get(), num_runs);
+  Run("aggregate test_1 join test_2", join_aggregation.get(), num_runs);
+}
+
+}  // namespace bustub
@@ -0,0 +1,132 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_filter_benchmark_test.cpp
+//
+// Identification: test/execution/column_filter_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/column_filter.h"
+#include "execution/compiled_predicate.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Filters every page of a 100000-row table in the buffer pool with colC < k, k picked from the data for 1%, 10% and 90%
+// selectivity, three ways: copying every tuple of the page and evaluating the compiled predicate on it, and
+// selecting the slots with a column filter before copying only the matching tuples, with the scalar loop and with
+// vector comparisons. All three must select the same rows.
+// NOLINTNEXTLINE
+TEST(ColumnFilterBenchmarkTest, DISABLED_Selectivity) {
+  const std::string db_name = "column_filter_bench.db";
+  const uint32_t num_rows = 100000;
+  const size_t pool_size = 2048;
+  const int num_scans = 10;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *table_info = gen.GenerateTest1Table("filter_bench", num_rows);
+  TableHeap *table = table_info->table_.get();
+  const Schema &schema = table_info->schema_;
+
+  ColumnValueExpression col_c{0, schema.GetColIdx("colC"), TypeId::INTEGER};
+  std::vector<int32_t> col_c_values;
+  for (auto it = table->Begin(txn); it != table->End(); ++it) {
+    col_c_values.push_back(it->GetValue(&schema, col_c.GetColIdx()).GetAs<int32_t>());
+  }
+  std::sort(col_c_values.begin(), col_c_values.end());
+
+  for (double selectivity : {0.01, 0.1, 0.9}) {
+    int32_t bound = col_c_values[static_cast<size_t>(selectivity * num_rows)];
+    ConstantValueExpression constant{ValueFactory::GetIntegerValue(bound)};
+    ComparisonExpression predicate{&col_c, &constant, ComparisonType::LessThan};
+    CompiledPredicate compiled = CompiledPredicate::Compile(&predicate, &schema);
+    ASSERT_NE(nullptr, compiled.GetColumnComparison());
+    ColumnFilter scalar_filter{*compiled.GetColumnComparison(), false};
+    ColumnFilter simd_filter{*compiled.GetColumnComparison(), true};
+
+    // Runs num_scans scans with a function that filters one page; returns the rows per second and the selected rows.
+    auto run = [&](auto &&filter_page, size_t *num_selected) {
+      std::vector<Tuple> tuples;
+      *num_selected = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (int scan = 0; scan < num_scans; scan++) {
+        for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+          tuples.clear();
+          page_id = filter_page(page_id, &tuples);
+          *num_selected += tuples.size();
+        }
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      return num_rows * num_scans / seconds;
+    };
+
+    size_t copy_selected;
+    double copy_rate = run(
+        [&](page_id_t page_id, std::vector<Tuple> *tuples) {
+          std::vector<Tuple> page_tuples;
+          page_id_t next_page_id = table->GetPageTuples(page_id, &page_tuples, txn);
+          for (auto &tuple : page_tuples) {
+            if (compiled.Evaluate(&tuple)) {
+              tuples->push_back(std::move(tuple));
+            }
+          }
+          return next_page_id;
+        },
+        &copy_selected);
+    size_t scalar_selected;
+    double scalar_rate = run(
+        [&](page_id_t page_id, std::vector<Tuple> *tuples) {
+          return table->GetPageTuples(page_id, scalar_filter, tuples, txn);
+        },
+        &scalar_selected);
+    size_t simd_selected;
+    double simd_rate = run(
+        [&](page_id_t page_id, std::vector<Tuple> *tuples) {
+          return table->GetPageTuples(page_id, simd_filter, tuples, txn);
+        },
+        &simd_selected);
+
+    ASSERT_EQ(copy_selected, scalar_selected);
+    ASSERT_EQ(copy_selected, simd_selected);
+    printf("[column filter] selectivity=%5.3f  copy+predicate rows/sec=%11.0f  scalar filter rows/sec=%11.0f (%.2fx)  "
+           "simd filter rows/sec=%11.0f (%.2fx)\n",
+           static_cast<double>(copy_selected) / (num_rows * num_scans), copy_rate, scalar_rate,
+           scalar_rate / copy_rate, simd_rate, simd_rate / copy_rate);
+  }
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("column_filter_bench.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,146 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// column_filter_test.cpp
+//
+// Identification: test/execution/column_filter_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction.h"
+#include "execution/column_filter.h"
+#include "execution/compiled_predicate.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/** @return a value of the type with a small magnitude, so that comparisons are often equal, or sometimes NULL */
+Value RandomValue(TypeId type_id, std::mt19937 *generator) {
+  int32_t integer = std::uniform_int_distribution<int32_t>(-4, 4)(*generator);
+  if (std::uniform_int_distribution<int32_t>(0, 9)(*generator) == 0) {
+    return ValueFactory::GetNullValueByType(type_id);
+  }
+  switch (type_id) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(integer);
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(integer);
+    default:
+      return ValueFactory::GetDecimalValue(integer / 2.0);
+  }
+}
+
+}  // namespace
+
+// Filtering the pages of a table, with and without vector comparisons, must select exactly the live tuples on which the
+// compiled predicate holds, for every type, every comparison and the constant on either side.
+// NOLINTNEXTLINE
+TEST(ColumnFilterTest, FilterTablePages) {
+  const std::vector<TypeId> types = {TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER, TypeId::BIGINT,
+                                     TypeId::DECIMAL};
+  const std::vector<ComparisonType> comp_types = {
+      ComparisonType::Equal,           ComparisonType::NotEqual,    ComparisonType::LessThan,
+      ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual};
+  std::vector<Column> columns;
+  for (size_t i = 0; i < types.size(); i++) {
+    columns.emplace_back("c" + std::to_string(i), types[i]);
+  }
+  Schema schema{columns};
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("column_filter_test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *table = new TableHeap(bpm, lock_manager, nullptr, transaction);
+
+  // Several pages of tuples, with every seventh tuple deleted again.
+  std::mt19937 generator(13);
+  for (int i = 0; i < 2000; i++) {
+    std::vector<Value> values;
+    for (TypeId type_id : types) {
+      values.push_back(RandomValue(type_id, &generator));
+    }
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(Tuple(values, &schema), &rid, transaction));
+    if (i % 7 == 0) {
+      ASSERT_TRUE(table->MarkDelete(rid, transaction));
+      table->ApplyDelete(rid, transaction);
+    }
+  }
+  std::vector<Tuple> tuples;
+  for (auto it = table->Begin(transaction); it != table->End(); ++it) {
+    tuples.push_back(*it);
+  }
+
+  for (uint32_t i = 0; i < types.size(); i++) {
+    ColumnValueExpression column{0, i, types[i]};
+    ConstantValueExpression constant{types[i] == TypeId::DECIMAL ? ValueFactory::GetDecimalValue(0.5)
+                                                                 : ValueFactory::GetIntegerValue(1)};
+    for (ComparisonType comp_type : comp_types) {
+      ComparisonExpression column_constant{&column, &constant, comp_type};
+      ComparisonExpression constant_column{&constant, &column, comp_type};
+      for (const ComparisonExpression *predicate : {&column_constant, &constant_column}) {
+        CompiledPredicate compiled = CompiledPredicate::Compile(predicate, &schema);
+        ASSERT_NE(nullptr, compiled.GetColumnComparison());
+        std::vector<RID> expected;
+        for (const auto &tuple : tuples) {
+          if (compiled.Evaluate(&tuple)) {
+            expected.push_back(tuple.GetRid());
+          }
+        }
+        for (bool use_simd : {false, true}) {
+          ColumnFilter filter{*compiled.GetColumnComparison(), use_simd};
+          std::vector<Tuple> selected;
+          for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+            page_id = table->GetPageTuples(page_id, filter, &selected, transaction);
+          }
+          ASSERT_EQ(expected.size(), selected.size());
+          for (size_t j = 0; j < expected.size(); j++) {
+            EXPECT_EQ(expected[j], selected[j].GetRid());
+          }
+        }
+      }
+    }
+  }
+
+  // A comparison of two columns, or of a VARCHAR column, has no column filter.
+  Schema varchar_schema{{Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 8)}};
+  ColumnValueExpression col_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression col_b{0, 1, TypeId::VARCHAR};
+  ConstantValueExpression varchar_constant{ValueFactory::GetVarcharValue("x")};
+  ComparisonExpression a_eq_a{&col_a, &col_a, ComparisonType::Equal};
+  ComparisonExpression b_eq_x{&col_b, &varchar_constant, ComparisonType::Equal};
+  EXPECT_EQ(nullptr, CompiledPredicate::Compile(&a_eq_a, &varchar_schema).GetColumnComparison());
+  EXPECT_EQ(nullptr, CompiledPredicate::Compile(&b_eq_x, &varchar_schema).GetColumnComparison());
+
+  disk_manager->ShutDown();
+  remove("column_filter_test.db");
+  remove("column_filter_test.log");
+  delete table;
+  delete lock_manager;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate_benchmark_test.cpp
+//
+// Identification: test/execution/compiled_predicate_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "execution/compiled_predicate.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+/**
+ * Evaluates a predicate on every tuple num_passes times, once through ComparisonExpression::Evaluate() and once
+ * through the compiled predicate, and reports the tuples per second of both.
+ */
+void RunPredicate(const char *name, const AbstractExpression *predicate, const Schema &schema,
+                  const std::vector<Tuple> &tuples, int num_passes) {
+  size_t interpreted_matches = 0;
+  auto start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; pass++) {
+    for (const auto &tuple : tuples) {
+      interpreted_matches += predicate->Evaluate(&tuple, &schema).GetAs<bool>() ? 1 : 0;
+    }
+  }
+  double interpreted_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  CompiledPredicate compiled = CompiledPredicate::Compile(predicate, &schema);
+  ASSERT_TRUE(compiled.IsSpecialized());
+  size_t compiled_matches = 0;
+  start = std::chrono::steady_clock::now();
+  for (int pass = 0; pass < num_passes; pass++) {
+    for (const auto &tuple : tuples) {
+      compiled_matches += compiled.Evaluate(&tuple) ? 1 : 0;
+    }
+  }
+  double compiled_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  EXPECT_EQ(interpreted_matches, compiled_matches);
+  double total = static_cast<double>(tuples.size()) * num_passes;
+  printf("[compiled predicate] %-22s selectivity=%4.2f  interpreted tuples/sec=%11.0f  compiled tuples/sec=%11.0f  "
+         "speedup=%.2fx\n",
+         name, static_cast<double>(compiled_matches) / total, total / interpreted_seconds, total / compiled_seconds,
+         interpreted_seconds / compiled_seconds);
+}
+
+}  // namespace
+
+// Predicates over 100000 tuples of (INTEGER, BIGINT, DECIMAL, INTEGER), evaluated 20 times: each column against a
+// constant, a constant against a column, and two columns against each other.
+// NOLINTNEXTLINE
+TEST(CompiledPredicateBenchmarkTest, DISABLED_EvaluationRate) {
+  const int num_tuples = 100000;
+  const int num_passes = 20;
+  Schema schema{{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT), Column("c", TypeId::DECIMAL),
+                 Column("d", TypeId::INTEGER)}};
+  std::mt19937_64 generator(42);
+  std::uniform_int_distribution<int32_t> integers(0, 9999);
+  std::vector<Tuple> tuples;
+  tuples.reserve(num_tuples);
+  for (int i = 0; i < num_tuples; i++) {
+    std::vector<Value> values{ValueFactory::GetIntegerValue(integers(generator)),
+                              ValueFactory::GetBigIntValue(integers(generator)),
+                              ValueFactory::GetDecimalValue(integers(generator) / 10.0),
+                              ValueFactory::GetIntegerValue(integers(generator))};
+    tuples.emplace_back(values, &schema);
+  }
+
+  ColumnValueExpression col_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression col_b{0, 1, TypeId::BIGINT};
+  ColumnValueExpression col_c{0, 2, TypeId::DECIMAL};
+  ColumnValueExpression col_d{0, 3, TypeId::INTEGER};
+  ConstantValueExpression const_5000{ValueFactory::GetIntegerValue(5000)};
+  ConstantValueExpression const_100{ValueFactory::GetBigIntValue(100)};
+  ConstantValueExpression const_900{ValueFactory::GetDecimalValue(900.0)};
+  ComparisonExpression a_lt_5000{&col_a, &const_5000, ComparisonType::LessThan};
+  ComparisonExpression b_ge_100{&col_b, &const_100, ComparisonType::GreaterThanOrEqual};
+  ComparisonExpression c_gt_900{&col_c, &const_900, ComparisonType::GreaterThan};
+  ComparisonExpression const_5000_eq_a{&const_5000, &col_a, ComparisonType::Equal};
+  ComparisonExpression a_lt_d{&col_a, &col_d, ComparisonType::LessThan};
+
+  RunPredicate("INTEGER a < 5000", &a_lt_5000, schema, tuples, num_passes);
+  RunPredicate("BIGINT b >= 100", &b_ge_100, schema, tuples, num_passes);
+  RunPredicate("DECIMAL c > 900", &c_gt_900, schema, tuples, num_passes);
+  RunPredicate("INTEGER 5000 = a", &const_5000_eq_a, schema, tuples, num_passes);
+  RunPredicate("INTEGER a < d", &a_lt_d, schema, tuples, num_passes);
+}
+
+}  // namespace bustub
@@ -0,0 +1,203 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compiled_predicate_test.cpp
+//
+// Identification: test/execution/compiled_predicate_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "execution/compiled_predicate.h"
+#include "execution/expressions/aggregate_value_expression.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+namespace {
+
+const std::vector<ComparisonType> COMPARISON_TYPES = {
+    ComparisonType::Equal,           ComparisonType::NotEqual,    ComparisonType::LessThan,
+    ComparisonType::LessThanOrEqual, ComparisonType::GreaterThan, ComparisonType::GreaterThanOrEqual};
+
+/** @return a value of the type with a small magnitude, so that comparisons are often equal */
+Value RandomValue(TypeId type_id, std::mt19937 *generator) {
+  int32_t integer = std::uniform_int_distribution<int32_t>(-4, 4)(*generator);
+  switch (type_id) {
+    case TypeId::TINYINT:
+      return ValueFactory::GetTinyIntValue(static_cast<int8_t>(integer));
+    case TypeId::SMALLINT:
+      return ValueFactory::GetSmallIntValue(static_cast<int16_t>(integer));
+    case TypeId::INTEGER:
+      return ValueFactory::GetIntegerValue(integer);
+    case TypeId::BIGINT:
+      return ValueFactory::GetBigIntValue(integer);
+    case TypeId::DECIMAL:
+      return ValueFactory::GetDecimalValue(integer / 2.0);
+    default:
+      return ValueFactory::GetVarcharValue(std::string(1, static_cast<char>('e' + integer)));
+  }
+}
+
+}  // namespace
+
+// Every comparison of a column with a constant, with the constant on either side, and of two columns of the same type,
+// must agree with the interpreter on non-null rows and must not hold on rows where an operand is NULL.
+// NOLINTNEXTLINE
+TEST(CompiledPredicateTest, ScanPredicates) {
+  const std::vector<TypeId> types = {TypeId::TINYINT, TypeId::SMALLINT, TypeId::INTEGER,
+                                     TypeId::BIGINT,  TypeId::DECIMAL,  TypeId::VARCHAR};
+  std::vector<Column> columns;
+  for (size_t i = 0; i < types.size(); i++) {
+    columns.emplace_back(types[i] == TypeId::VARCHAR ? Column("c" + std::to_string(i), types[i], 8)
+                                                     : Column("c" + std::to_string(i), types[i]));
+    columns.emplace_back(types[i] == TypeId::VARCHAR ? Column("d" + std::to_string(i), types[i], 8)
+                                                     : Column("d" + std::to_string(i), types[i]));
+  }
+  Schema schema{columns};
+
+  std::mt19937 generator(7);
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 200; i++) {
+    std::vector<Value> values;
+    for (TypeId type_id : types) {
+      values.push_back(RandomValue(type_id, &generator));
+      values.push_back(RandomValue(type_id, &generator));
+    }
+    tuples.emplace_back(values, &schema);
+  }
+  std::vector<Value> null_values;
+  for (TypeId type_id : types) {
+    // Tuples cannot hold a NULL VARCHAR.
+    null_values.push_back(type_id == TypeId::VARCHAR ? RandomValue(type_id, &generator)
+                                                     : ValueFactory::GetNullValueByType(type_id));
+    null_values.push_back(RandomValue(type_id, &generator));
+  }
+  Tuple null_tuple{null_values, &schema};
+
+  for (uint32_t i = 0; i < types.size(); i++) {
+    ColumnValueExpression column{0, 2 * i, types[i]};
+    ColumnValueExpression other_column{0, 2 * i + 1, types[i]};
+    ConstantValueExpression constant{RandomValue(types[i], &generator)};
+    bool machine_type = types[i] != TypeId::VARCHAR;
+    for (ComparisonType comp_type : COMPARISON_TYPES) {
+      ComparisonExpression column_constant{&column, &constant, comp_type};
+      ComparisonExpression constant_column{&constant, &column, comp_type};
+      ComparisonExpression column_column{&column, &other_column, comp_type};
+      for (const ComparisonExpression *predicate : {&column_constant, &constant_column, &column_column}) {
+        CompiledPredicate compiled = CompiledPredicate::Compile(predicate, &schema);
+        EXPECT_EQ(machine_type, compiled.IsSpecialized());
+        for (const auto &tuple : tuples) {
+          EXPECT_EQ(predicate->Evaluate(&tuple, &schema).GetAs<bool>(), compiled.Evaluate(&tuple));
+        }
+        if (machine_type) {
+          EXPECT_FALSE(compiled.Evaluate(&null_tuple));
+        }
+      }
+    }
+  }
+
+  // An INTEGER column compared with a BIGINT constant in its range is specialized; with a DECIMAL constant it is not.
+  ColumnValueExpression integer_column{0, 4, TypeId::INTEGER};
+  ConstantValueExpression bigint_constant{ValueFactory::GetBigIntValue(2)};
+  ConstantValueExpression decimal_constant{ValueFactory::GetDecimalValue(1.5)};
+  ComparisonExpression bigint_predicate{&integer_column, &bigint_constant, ComparisonType::LessThan};
+  ComparisonExpression decimal_predicate{&integer_column, &decimal_constant, ComparisonType::LessThan};
+  CompiledPredicate compiled_bigint = CompiledPredicate::Compile(&bigint_predicate, &schema);
+  CompiledPredicate compiled_decimal = CompiledPredicate::Compile(&decimal_predicate, &schema);
+  EXPECT_TRUE(compiled_bigint.IsSpecialized());
+  EXPECT_FALSE(compiled_decimal.IsSpecialized());
+  for (const auto &tuple : tuples) {
+    EXPECT_EQ(bigint_predicate.Evaluate(&tuple, &schema).GetAs<bool>(), compiled_bigint.Evaluate(&tuple));
+    EXPECT_EQ(decimal_predicate.Evaluate(&tuple, &schema).GetAs<bool>(), compiled_decimal.Evaluate(&tuple));
+  }
+
+  CompiledPredicate none = CompiledPredicate::Compile(nullptr, &schema);
+  EXPECT_TRUE(none.IsEmpty());
+  EXPECT_TRUE(none.Evaluate(&tuples[0]));
+}
+
+// Join predicates read each operand from the tuple of its side.
+// NOLINTNEXTLINE
+TEST(CompiledPredicateTest, JoinPredicates) {
+  Schema left_schema{{Column("a", TypeId::INTEGER), Column("b", TypeId::BIGINT)}};
+  Schema right_schema{{Column("x", TypeId::BIGINT), Column("y", TypeId::INTEGER), Column("z", TypeId::INTEGER)}};
+  std::mt19937 generator(11);
+  std::vector<Tuple> left_tuples;
+  std::vector<Tuple> right_tuples;
+  for (int i = 0; i < 30; i++) {
+    left_tuples.emplace_back(
+        std::vector<Value>{RandomValue(TypeId::INTEGER, &generator), RandomValue(TypeId::BIGINT, &generator)},
+        &left_schema);
+    right_tuples.emplace_back(
+        std::vector<Value>{RandomValue(TypeId::BIGINT, &generator), RandomValue(TypeId::INTEGER, &generator),
+                           RandomValue(TypeId::INTEGER, &generator)},
+        &right_schema);
+  }
+
+  ColumnValueExpression left_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression left_b{0, 1, TypeId::BIGINT};
+  ColumnValueExpression right_x{1, 0, TypeId::BIGINT};
+  ColumnValueExpression right_z{1, 2, TypeId::INTEGER};
+  ConstantValueExpression constant{ValueFactory::GetIntegerValue(1)};
+  for (ComparisonType comp_type : COMPARISON_TYPES) {
+    ComparisonExpression a_z{&left_a, &right_z, comp_type};
+    ComparisonExpression x_b{&right_x, &left_b, comp_type};
+    ComparisonExpression z_constant{&right_z, &constant, comp_type};
+    ComparisonExpression a_x{&left_a, &right_x, comp_type};
+    for (const ComparisonExpression *predicate : {&a_z, &x_b, &z_constant, &a_x}) {
+      CompiledPredicate compiled = CompiledPredicate::CompileJoin(predicate, &left_schema, &right_schema);
+      // Columns of different types are left to the interpreter.
+      EXPECT_EQ(predicate != &a_x, compiled.IsSpecialized());
+      for (const auto &left_tuple : left_tuples) {
+        for (const auto &right_tuple : right_tuples) {
+          EXPECT_EQ(predicate->EvaluateJoin(&left_tuple, &left_schema, &right_tuple, &right_schema).GetAs<bool>(),
+                    compiled.EvaluateJoin(&left_tuple, &right_tuple));
+        }
+      }
+    }
+  }
+}
+
+// HAVING clauses over group-by terms and aggregates, including groups whose values do not have the declared type.
+// NOLINTNEXTLINE
+TEST(CompiledPredicateTest, HavingClauses) {
+  AggregateValueExpression group{true, 0, TypeId::INTEGER};
+  AggregateValueExpression count{false, 0, TypeId::INTEGER};
+  AggregateValueExpression average{false, 1, TypeId::DECIMAL};
+  ConstantValueExpression constant{ValueFactory::GetIntegerValue(2)};
+  std::mt19937 generator(13);
+  for (ComparisonType comp_type : COMPARISON_TYPES) {
+    ComparisonExpression count_constant{&count, &constant, comp_type};
+    ComparisonExpression constant_average{&constant, &average, comp_type};
+    ComparisonExpression group_count{&group, &count, comp_type};
+    for (const ComparisonExpression *having : {&count_constant, &constant_average, &group_count}) {
+      CompiledPredicate compiled = CompiledPredicate::CompileAggregate(having);
+      EXPECT_TRUE(compiled.IsSpecialized());
+      for (int i = 0; i < 100; i++) {
+        std::vector<Value> group_bys{RandomValue(TypeId::INTEGER, &generator)};
+        // Every tenth group has a BIGINT count, which the closure hands to the interpreter.
+        std::vector<Value> aggregates{RandomValue(i % 10 == 0 ? TypeId::BIGINT : TypeId::INTEGER, &generator),
+                                      RandomValue(TypeId::DECIMAL, &generator)};
+        EXPECT_EQ(having->EvaluateAggregate(group_bys, aggregates).GetAs<bool>(),
+                  compiled.EvaluateAggregate(group_bys, aggregates));
+      }
+      std::vector<Value> null_aggregates{ValueFactory::GetNullValueByType(TypeId::INTEGER),
+                                         ValueFactory::GetNullValueByType(TypeId::DECIMAL)};
+      EXPECT_FALSE(compiled.EvaluateAggregate({ValueFactory::GetIntegerValue(1)}, null_aggregates));
+    }
+  }
+  EXPECT_TRUE(CompiledPredicate::CompileAggregate(nullptr).EvaluateAggregate({}, {}));
+}
+
+}  // namespace bustub
@@ -10,9 +10,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <algorithm>
+#include <map>
 #include <memory>
 #include <numeric>
+#include <set>
 #include <string>
+#include <tuple>
 #include <unordered_set>
 #include <utility>
 #include <vector>
@@ -24,6 +28,8 @@
 #include "execution/executors/aggregation_executor.h"
 #include "execution/executors/insert_executor.h"
 #include "execution/executors/nested_loop_join_executor.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
 #include "execution/expressions/aggregate_value_expression.h"
 #include "execution/expressions/column_value_expression.h"
 #include "execution/expressions/comparison_expression.h"
@@ -33,6 +39,8 @@
 #include "execution/plans/hash_join_plan.h"
 #include "execution/plans/limit_plan.h"
 #include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
 #include "execution/plans/update_plan.h"
 #include "executor_test_util.h"  // NOLINT
 #include "gtest/gtest.h"
@@ -87,7 +95,7 @@ using ComparatorType = GenericComparator<8>;
 using HashFunctionType = HashFunction<KeyType>;
 
 // SELECT col_a, col_b FROM test_1 WHERE col_a < 500
-TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
+TEST_F(ExecutorTest, SimpleSeqScanTest) {
   // Construct query plan
   TableInfo *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
   const Schema &schema = table_info->schema_;
@@ -111,7 +119,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleSeqScanTest) {
 }
 
 // INSERT INTO empty_table2 VALUES (100, 10), (101, 11), (102, 12)
-TEST_F(ExecutorTest, DISABLED_SimpleRawInsertTest) {
+TEST_F(ExecutorTest, SimpleRawInsertTest) {
   // Create Values to insert
   std::vector<Value> val1{ValueFactory::GetIntegerValue(100), ValueFactory::GetIntegerValue(10)};
   std::vector<Value> val2{ValueFactory::GetIntegerValue(101), ValueFactory::GetIntegerValue(11)};
@@ -153,7 +161,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleRawInsertTest) {
 }
 
 // INSERT INTO empty_table2 SELECT col_a, col_b FROM test_1 WHERE col_a < 500
-TEST_F(ExecutorTest, DISABLED_SimpleSelectInsertTest) {
+TEST_F(ExecutorTest, SimpleSelectInsertTest) {
   const Schema *out_schema1;
   std::unique_ptr<AbstractPlanNode> scan_plan1;
   {
@@ -374,7 +382,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleDeleteTest) {
 }
 
 // SELECT test_1.col_a, test_1.col_b, test_2.col1, test_2.col3 FROM test_1 JOIN test_2 ON test_1.col_a = test_2.col1;
-TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
+TEST_F(ExecutorTest, SimpleNestedLoopJoinTest) {
   const Schema *out_schema1;
   std::unique_ptr<AbstractPlanNode> scan_plan1;
   {
@@ -418,7 +426,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleNestedLoopJoinTest) {
 }
 
 // SELECT test_4.colA, test_4.colB, test_6.colA, test_6.colB FROM test_4 JOIN test_6 ON test_4.colA = test_6.colA;
-TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
+TEST_F(ExecutorTest, SimpleHashJoinTest) {
   // Construct sequential scan of table test_4
   const Schema *out_schema1{};
   std::unique_ptr<AbstractPlanNode> scan_plan1{};
@@ -487,7 +495,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleHashJoinTest) {
 }
 
 // SELECT COUNT(col_a), SUM(col_a), min(col_a), max(col_a) from test_1;
-TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
+TEST_F(ExecutorTest, SimpleAggregationTest) {
   const Schema *scan_schema;
   std::unique_ptr<AbstractPlanNode> scan_plan;
   {
@@ -537,7 +545,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleAggregationTest) {
 }
 
 // SELECT count(col_a), col_b, sum(col_c) FROM test_1 Group By col_b HAVING count(col_a) > 100
-TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
+TEST_F(ExecutorTest, SimpleGroupByAggregation) {
   const Schema *scan_schema;
   std::unique_ptr<AbstractPlanNode> scan_plan;
   {
@@ -590,7 +598,7 @@ TEST_F(ExecutorTest, DISABLED_SimpleGroupByAggregation) {
 }
 
 // SELECT colA, colB FROM test_3 LIMIT 10
-TEST_F(ExecutorTest, DISABLED_SimpleLimitTest) {
+TEST_F(ExecutorTest, SimpleLimitTest) {
   auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_3");
   auto &schema = table_info->schema_;
 
@@ -653,4 +661,751 @@ TEST_F(ExecutorTest, DISABLED_SimpleDistinctTest) {
   ASSERT_TRUE(std::equal(results.cbegin(), results.cend(), expected.cbegin()));
 }
 
+// SELECT colA FROM big_table; INSERT INTO empty_table2 SELECT colA, colB FROM big_table, through a buffer ring
+TEST_F(ExecutorTest, BufferRingTest) {
+  auto *bpm = dynamic_cast<BufferPoolManagerInstance *>(GetBPM());
+  TableGenerator gen{GetExecutorContext()};
+  // About 50 pages, more than the buffer pool can hold.
+  const uint32_t num_rows = 8000;
+  TableInfo *big_table = gen.GenerateTest1Table("big_table", num_rows);
+  TableInfo *small_table = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+
+  auto make_scan = [&](TableInfo *table_info) {
+    auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(table_info->schema_, 0, "colB");
+    auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+    return std::make_unique<SeqScanPlanNode>(out_schema, nullptr, table_info->oid_);
+  };
+
+  // Scenario: scanning test_1 makes it the working set of the buffer pool.
+  auto small_scan = make_scan(small_table);
+  std::vector<Tuple> result_set{};
+  GetExecutionEngine()->Execute(small_scan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(TEST1_SIZE, result_set.size());
+
+  // Scenario: a scan through a ring of 4 frames recycles its own frames.
+  GetExecutorContext()->SetBufferRingSize(4);
+  auto big_scan = make_scan(big_table);
+  result_set.clear();
+  GetExecutionEngine()->Execute(big_scan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(num_rows, result_set.size());
+  uint64_t evictions_avoided = GetExecutorContext()->GetNumRingEvictionsAvoided();
+  EXPECT_GT(evictions_avoided, 0);
+
+  // Scenario: the working set survived the scan.
+  uint64_t misses = bpm->GetNumFetchMisses();
+  result_set.clear();
+  GetExecutionEngine()->Execute(small_scan.get(), &result_set, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(TEST1_SIZE, result_set.size());
+  EXPECT_EQ(misses, bpm->GetNumFetchMisses());
+
+  // Scenario: a bulk insert through the ring writes back its pages as it recycles them.
+  TableInfo *target_table = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  InsertPlanNode insert_plan{big_scan.get(), target_table->oid_};
+  GetExecutionEngine()->Execute(&insert_plan, nullptr, GetTxn(), GetExecutorContext());
+  EXPECT_GT(GetExecutorContext()->GetNumRingEvictionsAvoided(), evictions_avoided);
+
+  GetExecutorContext()->SetBufferRingSize(0);
+  auto target_scan = make_scan(target_table);
+  std::vector<Tuple> inserted{};
+  GetExecutionEngine()->Execute(target_scan.get(), &inserted, GetTxn(), GetExecutorContext());
+  ASSERT_EQ(num_rows, inserted.size());
+  const Schema *out_schema = target_scan->OutputSchema();
+  for (uint32_t i = 0; i < num_rows; ++i) {
+    ASSERT_EQ(static_cast<int32_t>(i), inserted[i].GetValue(out_schema, 0).GetAs<int32_t>());
+  }
+}
+
+// SELECT test_1.colA, test_1.colB, test_2.col1 FROM test_1 JOIN test_2 ON test_1.colB = test_2.col2
+//   WHERE test_1.colA < 500, and SELECT colB, COUNT(colA), SUM(colA) over that join GROUP BY colB, a batch at a time
+TEST_F(ExecutorTest, BatchExecutionTest) {
+  const Schema *scan_schema1;
+  std::unique_ptr<AbstractPlanNode> scan_plan1;
+  {
+    auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+    auto &schema = table_info->schema_;
+    auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+    auto *predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(500)),
+                                               ComparisonType::LessThan);
+    scan_schema1 = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}});
+    scan_plan1 = std::make_unique<SeqScanPlanNode>(scan_schema1, predicate, table_info->oid_);
+  }
+  const Schema *scan_schema2;
+  std::unique_ptr<AbstractPlanNode> scan_plan2;
+  {
+    auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_2");
+    auto &schema = table_info->schema_;
+    auto *col1 = MakeColumnValueExpression(schema, 0, "col1");
+    auto *col2 = MakeColumnValueExpression(schema, 0, "col2");
+    scan_schema2 = MakeOutputSchema({{"col1", col1}, {"col2", col2}});
+    scan_plan2 = std::make_unique<SeqScanPlanNode>(scan_schema2, nullptr, table_info->oid_);
+  }
+  const Schema *join_schema;
+  std::unique_ptr<AbstractPlanNode> join_plan;
+  {
+    auto *col_a = MakeColumnValueExpression(*scan_schema1, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(*scan_schema1, 0, "colB");
+    auto *col1 = MakeColumnValueExpression(*scan_schema2, 1, "col1");
+    auto *col2 = MakeColumnValueExpression(*scan_schema2, 1, "col2");
+    join_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"col1", col1}});
+    join_plan = std::make_unique<HashJoinPlanNode>(
+        join_schema, std::vector<const AbstractPlanNode *>{scan_plan1.get(), scan_plan2.get()}, col_b, col2);
+  }
+  const Schema *agg_schema;
+  std::unique_ptr<AbstractPlanNode> agg_plan;
+  {
+    auto *col_a = MakeColumnValueExpression(*join_schema, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(*join_schema, 0, "colB");
+    agg_schema = MakeOutputSchema({{"colB", MakeAggregateValueExpression(true, 0)},
+                                   {"countA", MakeAggregateValueExpression(false, 0)},
+                                   {"sumA", MakeAggregateValueExpression(false, 1)}});
+    agg_plan = std::make_unique<AggregationPlanNode>(
+        agg_schema, join_plan.get(), nullptr, std::vector<const AbstractExpression *>{col_b},
+        std::vector<const AbstractExpression *>{col_a, col_a},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate});
+  }
+
+  auto run = [&](const AbstractPlanNode *plan, bool batch_execution) {
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // Scenario: the join produces several batches and the same rows either way.
+  auto join_rows = run(join_plan.get(), false);
+  EXPECT_GT(join_rows.size(), static_cast<size_t>(EXECUTION_BATCH_SIZE));
+  EXPECT_EQ(join_rows, run(join_plan.get(), true));
+
+  // Scenario: aggregating the join a batch at a time gives the same groups.
+  auto agg_rows = run(agg_plan.get(), false);
+  EXPECT_EQ(10, agg_rows.size());
+  EXPECT_EQ(agg_rows, run(agg_plan.get(), true));
+
+  // Scenario: a join whose last output batch is not full stays at its end, even though the probe side resets its
+  // batch when it runs out, as the aggregation does.
+  const Schema *group_schema;
+  std::unique_ptr<AbstractPlanNode> group_plan;
+  {
+    auto *col2 = MakeColumnValueExpression(*scan_schema2, 0, "col2");
+    group_schema = MakeOutputSchema({{"col2", MakeAggregateValueExpression(true, 0)}});
+    group_plan = std::make_unique<AggregationPlanNode>(
+        group_schema, scan_plan2.get(), nullptr, std::vector<const AbstractExpression *>{col2},
+        std::vector<const AbstractExpression *>{}, std::vector<AggregationType>{});
+  }
+  std::unique_ptr<AbstractPlanNode> group_join_plan;
+  {
+    auto *col_a = MakeColumnValueExpression(*scan_schema1, 0, "colA");
+    auto *col_b = MakeColumnValueExpression(*scan_schema1, 0, "colB");
+    auto *col2 = MakeColumnValueExpression(*group_schema, 1, "col2");
+    group_join_plan = std::make_unique<HashJoinPlanNode>(
+        MakeOutputSchema({{"colA", col_a}, {"col2", col2}}),
+        std::vector<const AbstractPlanNode *>{scan_plan1.get(), group_plan.get()}, col_b, col2);
+  }
+  auto group_join_rows = run(group_join_plan.get(), false);
+  EXPECT_EQ(500, group_join_rows.size());
+  EXPECT_EQ(group_join_rows, run(group_join_plan.get(), true));
+
+  // Scenario: an executor without a batch path at the root of a batch plan goes through the Next() adapter.
+  TableInfo *target_table = GetExecutorContext()->GetCatalog()->GetTable("empty_table2");
+  InsertPlanNode insert_plan{scan_plan1.get(), target_table->oid_};
+  GetExecutorContext()->SetBatchExecution(true);
+  GetExecutionEngine()->Execute(&insert_plan, nullptr, GetTxn(), GetExecutorContext());
+  auto *col_a = MakeColumnValueExpression(target_table->schema_, 0, "colA");
+  SeqScanPlanNode target_scan{MakeOutputSchema({{"colA", col_a}}), nullptr, target_table->oid_};
+  EXPECT_EQ(500, run(&target_scan, true).size());
+  GetExecutorContext()->SetBatchExecution(false);
+}
+
+// SELECT colA, colB FROM big_table WHERE colA < 6000, scanned by four threads
+TEST_F(ExecutorTest, ParallelSeqScanTest) {
+  TableGenerator gen{GetExecutorContext()};
+  const uint32_t num_rows = 8000;
+  TableInfo *table_info = gen.GenerateTest1Table("big_table", num_rows);
+  auto *col_a = MakeColumnValueExpression(table_info->schema_, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(table_info->schema_, 0, "colB");
+  auto *predicate = MakeComparisonExpression(col_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(6000)),
+                                             ComparisonType::LessThan);
+  SeqScanPlanNode scan_plan{MakeOutputSchema({{"colA", col_a}, {"colB", col_b}}), predicate, table_info->oid_};
+
+  auto run = [&](size_t num_threads, bool batch_execution) {
+    GetExecutorContext()->SetParallelism(num_threads);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&scan_plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> col_a_values;
+    for (const auto &tuple : result_set) {
+      col_a_values.push_back(tuple.GetValue(scan_plan.OutputSchema(), 0).GetAs<int32_t>());
+    }
+    std::sort(col_a_values.begin(), col_a_values.end());
+    return col_a_values;
+  };
+
+  // Scenario: the workers together return every matching row exactly once, tuple-at-a-time and in batches.
+  std::vector<int32_t> expected(6000);
+  std::iota(expected.begin(), expected.end(), 0);
+  EXPECT_EQ(expected, run(1, false));
+  EXPECT_EQ(expected, run(4, false));
+  EXPECT_EQ(expected, run(4, true));
+
+  // Scenario: a consumer that stops after one row does not wait for the workers to scan the whole table.
+  GetExecutorContext()->SetParallelism(4);
+  GetExecutorContext()->SetBatchExecution(false);
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(executor->Next(&tuple, &rid));
+  }
+  GetExecutorContext()->SetParallelism(1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelHashJoinTest) {
+  TableGenerator gen{GetExecutorContext()};
+  TableInfo *build_info = gen.GenerateTest1Table("build_table", 3000);
+  TableInfo *probe_info = gen.GenerateTest1Table("probe_table", 8000);
+  auto *build_col_a = MakeColumnValueExpression(build_info->schema_, 0, "colA");
+  SeqScanPlanNode build_plan{MakeOutputSchema({{"colA", build_col_a}}), nullptr, build_info->oid_};
+  auto *probe_col_a = MakeColumnValueExpression(probe_info->schema_, 0, "colA");
+  auto *probe_col_c = MakeColumnValueExpression(probe_info->schema_, 0, "colC");
+  SeqScanPlanNode probe_plan{MakeOutputSchema({{"colA", probe_col_a}, {"colC", probe_col_c}}), nullptr,
+                             probe_info->oid_};
+
+  // SELECT build_table.colA, probe_table.colA FROM build_table JOIN probe_table ON build_table.colA = probe_table.colC
+  auto *left_col_a = MakeColumnValueExpression(*build_plan.OutputSchema(), 0, "colA");
+  auto *right_col_a = MakeColumnValueExpression(*probe_plan.OutputSchema(), 1, "colA");
+  auto *right_col_c = MakeColumnValueExpression(*probe_plan.OutputSchema(), 1, "colC");
+  HashJoinPlanNode join_plan{MakeOutputSchema({{"build_colA", left_col_a}, {"probe_colA", right_col_a}}),
+                             std::vector<const AbstractPlanNode *>{&build_plan, &probe_plan}, left_col_a,
+                             right_col_c};
+
+  auto run = [&](size_t num_threads, bool batch_execution) {
+    GetExecutorContext()->SetParallelism(num_threads);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::pair<int32_t, int32_t>> pairs;
+    for (const auto &tuple : result_set) {
+      pairs.emplace_back(tuple.GetValue(join_plan.OutputSchema(), 0).GetAs<int32_t>(),
+                         tuple.GetValue(join_plan.OutputSchema(), 1).GetAs<int32_t>());
+    }
+    std::sort(pairs.begin(), pairs.end());
+    return pairs;
+  };
+
+  // Scenario: the partitioned join returns the same pairs as the serial join, tuple-at-a-time and in batches.
+  auto expected = run(1, false);
+  ASSERT_FALSE(expected.empty());
+  for (const auto &[build_col_a_value, probe_col_a_value] : expected) {
+    ASSERT_LT(build_col_a_value, 3000);
+  }
+  EXPECT_EQ(expected, run(4, false));
+  EXPECT_EQ(expected, run(4, true));
+  EXPECT_EQ(expected, run(3, true));
+
+  // Scenario: a consumer that stops after one row does not wait for the workers to join every partition.
+  GetExecutorContext()->SetParallelism(4);
+  GetExecutorContext()->SetBatchExecution(false);
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(executor->Next(&tuple, &rid));
+  }
+  GetExecutorContext()->SetParallelism(1);
+}
+
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, GraceHashJoinTest) {
+  TableGenerator gen{GetExecutorContext()};
+  const uint32_t num_build_rows = 4000;
+  TableInfo *build_info = gen.GenerateTest1Table("build_table", num_build_rows);
+  TableInfo *probe_info = gen.GenerateTest1Table("probe_table", 6000);
+  auto *build_col_a = MakeColumnValueExpression(build_info->schema_, 0, "colA");
+  auto *build_col_d = MakeColumnValueExpression(build_info->schema_, 0, "colD");
+  SeqScanPlanNode build_plan{MakeOutputSchema({{"colA", build_col_a}, {"colD", build_col_d}}), nullptr,
+                             build_info->oid_};
+  auto *probe_col_a = MakeColumnValueExpression(probe_info->schema_, 0, "colA");
+  auto *probe_col_c = MakeColumnValueExpression(probe_info->schema_, 0, "colC");
+  SeqScanPlanNode probe_plan{MakeOutputSchema({{"colA", probe_col_a}, {"colC", probe_col_c}}), nullptr,
+                             probe_info->oid_};
+
+  // SELECT build_table.colA, build_table.colD, probe_table.colA
+  // FROM build_table JOIN probe_table ON build_table.colA = probe_table.colC
+  auto *left_col_a = MakeColumnValueExpression(*build_plan.OutputSchema(), 0, "colA");
+  auto *left_col_d = MakeColumnValueExpression(*build_plan.OutputSchema(), 0, "colD");
+  auto *right_col_a = MakeColumnValueExpression(*probe_plan.OutputSchema(), 1, "colA");
+  auto *right_col_c = MakeColumnValueExpression(*probe_plan.OutputSchema(), 1, "colC");
+  HashJoinPlanNode join_plan{
+      MakeOutputSchema({{"build_colA", left_col_a}, {"build_colD", left_col_d}, {"probe_colA", right_col_a}}),
+      std::vector<const AbstractPlanNode *>{&build_plan, &probe_plan}, left_col_a, right_col_c};
+
+  auto run = [&](size_t memory_budget, bool batch_execution) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&join_plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::tuple<int32_t, int32_t, int32_t>> rows;
+    for (const auto &tuple : result_set) {
+      rows.emplace_back(tuple.GetValue(join_plan.OutputSchema(), 0).GetAs<int32_t>(),
+                        tuple.GetValue(join_plan.OutputSchema(), 1).GetAs<int32_t>(),
+                        tuple.GetValue(join_plan.OutputSchema(), 2).GetAs<int32_t>());
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // Scenario: with a budget of a tenth of the left rows (two columns of four bytes each), the join spills both sides
+  // to temporary pages and still returns the same rows as the join that fits in memory, in both execution modes.
+  const size_t memory_budget = num_build_rows * 8 / 10;
+  auto expected = run(0, false);
+  ASSERT_FALSE(expected.empty());
+  EXPECT_EQ(expected, run(memory_budget, false));
+  EXPECT_EQ(expected, run(memory_budget, true));
+
+  // Scenario: a spilled join that is abandoned after one row releases its temporary pages.
+  GetExecutorContext()->SetMemoryBudget(memory_budget);
+  GetExecutorContext()->SetBatchExecution(false);
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &join_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(executor->Next(&tuple, &rid));
+  }
+  GetExecutorContext()->SetMemoryBudget(0);
+
+  // Scenario: no frame is left pinned by the spilled joins.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (int i = 0; i < 32; i++) {
+    ASSERT_NE(nullptr, GetBPM()->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t id : page_ids) {
+    GetBPM()->UnpinPage(id, false);
+  }
+}
+
+// SELECT colA, colB, colD FROM test_1 ORDER BY colB ASC, colD DESC
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, SortTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_d = MakeColumnValueExpression(schema, 0, "colD");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"colD", col_d}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  auto *sort_col_b = MakeColumnValueExpression(*out_schema, 0, "colB");
+  auto *sort_col_d = MakeColumnValueExpression(*out_schema, 0, "colD");
+  SortPlanNode sort_plan{out_schema, &scan_plan, {{OrderByType::ASC, sort_col_b}, {OrderByType::DESC, sort_col_d}}};
+
+  auto run = [&](size_t memory_budget, bool batch_execution, size_t *num_spilled_runs) {
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    std::vector<std::tuple<int32_t, int32_t, int32_t>> rows;
+    Tuple tuple;
+    RID rid;
+    while (executor->Next(&tuple, &rid)) {
+      rows.emplace_back(tuple.GetValue(out_schema, 1).GetAs<int32_t>(), -tuple.GetValue(out_schema, 2).GetAs<int32_t>(),
+                        tuple.GetValue(out_schema, 0).GetAs<int32_t>());
+    }
+    *num_spilled_runs = dynamic_cast<SortExecutor *>(executor.get())->GetNumSpilledRuns();
+    GetExecutorContext()->SetMemoryBudget(0);
+    GetExecutorContext()->SetBatchExecution(false);
+    return rows;
+  };
+
+  // Scenario: a sort that fits in memory orders by colB, then by colD descending. Ties keep the input order, colA.
+  size_t num_spilled_runs;
+  auto in_memory = run(0, false, &num_spilled_runs);
+  EXPECT_EQ(0, num_spilled_runs);
+  ASSERT_EQ(TEST1_SIZE, in_memory.size());
+  auto expected = in_memory;
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, in_memory);
+
+  // Scenario: with a budget of about a hundred rows, the sort merges runs from temporary pages to the same order.
+  EXPECT_EQ(in_memory, run(10000, false, &num_spilled_runs));
+  EXPECT_GT(num_spilled_runs, 5);
+  EXPECT_EQ(in_memory, run(10000, true, &num_spilled_runs));
+  EXPECT_GT(num_spilled_runs, 5);
+
+  // Scenario: a sort that is abandoned before the merge is done leaves no frame pinned.
+  GetExecutorContext()->SetMemoryBudget(10000);
+  {
+    auto executor = ExecutorFactory::CreateExecutor(GetExecutorContext(), &sort_plan);
+    executor->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(executor->Next(&tuple, &rid));
+  }
+  GetExecutorContext()->SetMemoryBudget(0);
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (int i = 0; i < 32; i++) {
+    ASSERT_NE(nullptr, GetBPM()->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t id : page_ids) {
+    GetBPM()->UnpinPage(id, false);
+  }
+}
+
+// SELECT colA, colD FROM test_1 ORDER BY colD DESC LIMIT 10
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, TopNTest) {
+  auto *table_info = GetExecutorContext()->GetCatalog()->GetTable("test_1");
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_d = MakeColumnValueExpression(schema, 0, "colD");
+  auto *out_schema = MakeOutputSchema({{"colA", col_a}, {"colD", col_d}});
+  SeqScanPlanNode scan_plan{out_schema, nullptr, table_info->oid_};
+  auto *sort_col_d = MakeColumnValueExpression(*out_schema, 0, "colD");
+  SortPlanNode sort_plan{out_schema, &scan_plan, {{OrderByType::DESC, sort_col_d}}};
+  LimitPlanNode limit_plan{out_schema, &sort_plan, 10};
+  TopNPlanNode topn_plan{out_schema, &scan_plan, {{OrderByType::DESC, sort_col_d}}, 10};
+
+  auto col_d_values = [&](const AbstractPlanNode *plan) {
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<int32_t> values;
+    for (const auto &tuple : result_set) {
+      values.push_back(tuple.GetValue(out_schema, 1).GetAs<int32_t>());
+    }
+    return values;
+  };
+
+  // Scenario: top-n returns what a full sort followed by a limit returns.
+  auto expected = col_d_values(&limit_plan);
+  ASSERT_EQ(10, expected.size());
+  EXPECT_TRUE(std::is_sorted(expected.rbegin(), expected.rend()));
+  EXPECT_EQ(expected, col_d_values(&topn_plan));
+  GetExecutorContext()->SetBatchExecution(true);
+  EXPECT_EQ(expected, col_d_values(&topn_plan));
+  GetExecutorContext()->SetBatchExecution(false);
+
+  // Scenario: top-n holds at most n rows, the sort holds all of them.
+  SortExecutor sort_executor{GetExecutorContext(), &sort_plan,
+                             ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan)};
+  TopNExecutor topn_executor{GetExecutorContext(), &topn_plan,
+                             ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan)};
+  sort_executor.Init();
+  topn_executor.Init();
+  EXPECT_EQ(topn_executor.GetPeakMemoryUsage() * TEST1_SIZE / 10, sort_executor.GetPeakMemoryUsage());
+}
+
+// SELECT colC, COUNT(colA), SUM(colA), MIN(colD), MAX(colD) FROM agg_table GROUP BY colC HAVING COUNT(colA) > 1
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, ParallelAggregationTest) {
+  TableGenerator gen{GetExecutorContext()};
+  TableInfo *table_info = gen.GenerateTest1Table("agg_table", 20000);
+  auto &schema = table_info->schema_;
+  auto *col_a = MakeColumnValueExpression(schema, 0, "colA");
+  auto *col_b = MakeColumnValueExpression(schema, 0, "colB");
+  auto *col_c = MakeColumnValueExpression(schema, 0, "colC");
+  auto *col_d = MakeColumnValueExpression(schema, 0, "colD");
+  SeqScanPlanNode scan_plan{MakeOutputSchema({{"colA", col_a}, {"colB", col_b}, {"colC", col_c}, {"colD", col_d}}),
+                            nullptr, table_info->oid_};
+
+  auto make_aggregation = [&](const char *group_by_column) {
+    const Schema *scan_schema = scan_plan.OutputSchema();
+    auto *count_a = MakeAggregateValueExpression(false, 0);
+    auto *having = MakeComparisonExpression(count_a, MakeConstantValueExpression(ValueFactory::GetIntegerValue(1)),
+                                            ComparisonType::GreaterThan);
+    const Schema *agg_schema = MakeOutputSchema({{group_by_column, MakeAggregateValueExpression(true, 0)},
+                                                 {"countA", count_a},
+                                                 {"sumA", MakeAggregateValueExpression(false, 1)},
+                                                 {"minD", MakeAggregateValueExpression(false, 2)},
+                                                 {"maxD", MakeAggregateValueExpression(false, 3)}});
+    auto *agg_col_a = MakeColumnValueExpression(*scan_schema, 0, "colA");
+    auto *agg_col_d = MakeColumnValueExpression(*scan_schema, 0, "colD");
+    return std::make_unique<AggregationPlanNode>(
+        agg_schema, &scan_plan, having,
+        std::vector<const AbstractExpression *>{MakeColumnValueExpression(*scan_schema, 0, group_by_column)},
+        std::vector<const AbstractExpression *>{agg_col_a, agg_col_a, agg_col_d, agg_col_d},
+        std::vector<AggregationType>{AggregationType::CountAggregate, AggregationType::SumAggregate,
+                                     AggregationType::MinAggregate, AggregationType::MaxAggregate});
+  };
+  auto low_cardinality = make_aggregation("colB");
+  auto high_cardinality = make_aggregation("colC");
+
+  auto run = [&](const AbstractPlanNode *plan, size_t num_threads, size_t memory_budget, bool batch_execution) {
+    GetExecutorContext()->SetParallelism(num_threads);
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(plan, &result_set, GetTxn(), GetExecutorContext());
+    std::vector<std::string> rows;
+    for (const auto &tuple : result_set) {
+      rows.push_back(tuple.ToString(plan->OutputSchema()));
+    }
+    std::sort(rows.begin(), rows.end());
+    return rows;
+  };
+
+  // Scenario: a few frequent groups, which stay in the pre-aggregation tables, and many groups, which are evicted
+  // from them, give the same groups in parallel as on one thread, in both execution modes.
+  for (const auto *plan : {low_cardinality.get(), high_cardinality.get()}) {
+    auto expected = run(plan, 1, 0, false);
+    ASSERT_FALSE(expected.empty());
+    EXPECT_EQ(expected, run(plan, 4, 0, false));
+    EXPECT_EQ(expected, run(plan, 4, 0, true));
+
+    // Scenario: with a small budget the partial aggregates are written to temporary pages and merged back.
+    EXPECT_EQ(expected, run(plan, 1, 64 * 1024, true));
+    EXPECT_EQ(expected, run(plan, 4, 64 * 1024, false));
+  }
+  AggregationExecutor executor{GetExecutorContext(), high_cardinality.get(),
+                               ExecutorFactory::CreateExecutor(GetExecutorContext(), &scan_plan)};
+  executor.Init();
+  EXPECT_GT(executor.GetNumSpilledPages(), 0);
+
+  // Scenario: a spilled aggregation that is abandoned after one group releases its temporary pages.
+  {
+    auto abandoned = ExecutorFactory::CreateExecutor(GetExecutorContext(), high_cardinality.get());
+    abandoned->Init();
+    Tuple tuple;
+    RID rid;
+    ASSERT_TRUE(abandoned->Next(&tuple, &rid));
+  }
+
+  // Scenario: with a budget smaller than a partition of distinct groups, the partitions are split again while they
+  // are merged, and still give every group once.
+  TableInfo *split_info = gen.GenerateTest1Table("split_table", 4000);
+  auto *split_col_a = MakeColumnValueExpression(split_info->schema_, 0, "colA");
+  SeqScanPlanNode split_scan_plan{MakeOutputSchema({{"colA", split_col_a}}), nullptr, split_info->oid_};
+  AggregationPlanNode split_plan{MakeOutputSchema({{"colA", MakeAggregateValueExpression(true, 0)},
+                                                   {"countA", MakeAggregateValueExpression(false, 0)}}),
+                                 &split_scan_plan,
+                                 nullptr,
+                                 {split_col_a},
+                                 {split_col_a},
+                                 {AggregationType::CountAggregate}};
+  auto expected_groups = run(&split_plan, 1, 0, false);
+  ASSERT_EQ(4000, expected_groups.size());
+  EXPECT_EQ(expected_groups, run(&split_plan, 1, 8 * 1024, true));
+  AggregationExecutor split_executor{GetExecutorContext(), &split_plan,
+                                     ExecutorFactory::CreateExecutor(GetExecutorContext(), &split_scan_plan)};
+  split_executor.Init();
+  TupleBatch batch;
+  while (split_executor.NextBatch(&batch)) {
+  }
+  EXPECT_GT(split_executor.GetNumSplitPartitions(), 0);
+  GetExecutorContext()->SetParallelism(1);
+  GetExecutorContext()->SetMemoryBudget(0);
+  GetExecutorContext()->SetBatchExecution(false);
+
+  // Scenario: no frame is left pinned by the spilled aggregations.
+  std::vector<page_id_t> page_ids;
+  page_id_t page_id;
+  for (int i = 0; i < 32; i++) {
+    ASSERT_NE(nullptr, GetBPM()->NewPage(&page_id));
+    page_ids.push_back(page_id);
+  }
+  for (page_id_t id : page_ids) {
+    GetBPM()->UnpinPage(id, false);
+  }
+}
+
+// SELECT grp, COUNT(big), COUNT(DISTINCT name), SUM(big), AVG(dec), MIN(dec), MAX(name) FROM agg_types GROUP BY grp
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, AggregateTypesTest) {
+  Schema table_schema{{Column("grp", TypeId::INTEGER), Column("big", TypeId::BIGINT), Column("dec", TypeId::DECIMAL),
+                       Column("name", TypeId::VARCHAR, 8)}};
+  TableInfo *table_info = GetCatalog()->CreateTable(GetTxn(), "agg_types", table_schema);
+
+  // The big and dec columns have NULLs, and the dec column of group 5 only has NULLs. Tuples cannot hold NULL VARCHARs.
+  struct Expected {
+    int32_t count_big_{0};
+    std::set<std::string> names_;
+    int64_t sum_big_{0};
+    double sum_dec_{0};
+    int32_t count_dec_{0};
+    double min_dec_{0};
+    std::string max_name_;
+  };
+  std::map<int32_t, Expected> expected;
+  for (int32_t i = 0; i < 3000; i++) {
+    int32_t grp = i % 6;
+    Value big = ValueFactory::GetNullValueByType(TypeId::BIGINT);
+    Value dec = ValueFactory::GetNullValueByType(TypeId::DECIMAL);
+    Expected &group = expected[grp];
+    if (i % 5 != 0) {
+      big = ValueFactory::GetBigIntValue(static_cast<int64_t>(i % 1000) * 10000000000);
+      group.count_big_++;
+      group.sum_big_ += big.GetAs<int64_t>();
+    }
+    if (i % 7 != 0 && grp != 5) {
+      dec = ValueFactory::GetDecimalValue((i % 400) * 0.25);
+      group.min_dec_ = group.count_dec_ == 0 ? dec.GetAs<double>() : std::min(group.min_dec_, dec.GetAs<double>());
+      group.count_dec_++;
+      group.sum_dec_ += dec.GetAs<double>();
+    }
+    std::string name = "n" + std::to_string(i % 37);
+    group.names_.insert(name);
+    group.max_name_ = std::max(group.max_name_, name);
+    Tuple tuple{{ValueFactory::GetIntegerValue(grp), big, dec, ValueFactory::GetVarcharValue(name)}, &table_schema};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+
+  auto *col_grp = MakeColumnValueExpression(table_schema, 0, "grp");
+  auto *col_big = MakeColumnValueExpression(table_schema, 0, "big");
+  auto *col_dec = MakeColumnValueExpression(table_schema, 0, "dec");
+  auto *col_name = MakeColumnValueExpression(table_schema, 0, "name");
+  SeqScanPlanNode scan_plan{
+      MakeOutputSchema({{"grp", col_grp}, {"big", col_big}, {"dec", col_dec}, {"name", col_name}}), nullptr,
+      table_info->oid_};
+  const Schema *agg_schema =
+      MakeOutputSchema({{"grp", MakeAggregateValueExpression(true, 0, TypeId::INTEGER)},
+                        {"countBig", MakeAggregateValueExpression(false, 0, TypeId::INTEGER)},
+                        {"distinctName", MakeAggregateValueExpression(false, 1, TypeId::INTEGER)},
+                        {"sumBig", MakeAggregateValueExpression(false, 2, TypeId::BIGINT)},
+                        {"avgDec", MakeAggregateValueExpression(false, 3, TypeId::DECIMAL)},
+                        {"minDec", MakeAggregateValueExpression(false, 4, TypeId::DECIMAL)},
+                        {"maxName", MakeAggregateValueExpression(false, 5, TypeId::VARCHAR)}});
+  AggregationPlanNode agg_plan{
+      agg_schema,
+      &scan_plan,
+      nullptr,
+      {col_grp},
+      {col_big, col_name, col_big, col_dec, col_dec, col_name},
+      {AggregationType::CountAggregate, AggregationType::CountDistinctAggregate, AggregationType::SumAggregate,
+       AggregationType::AvgAggregate, AggregationType::MinAggregate, AggregationType::MaxAggregate}};
+
+  auto check = [&](size_t num_threads, size_t memory_budget, bool batch_execution) {
+    GetExecutorContext()->SetParallelism(num_threads);
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(expected.size(), result_set.size());
+    for (const auto &tuple : result_set) {
+      const Expected &group = expected.at(tuple.GetValue(agg_schema, 0).GetAs<int32_t>());
+      EXPECT_EQ(group.count_big_, tuple.GetValue(agg_schema, 1).GetAs<int32_t>());
+      EXPECT_EQ(group.names_.size(), tuple.GetValue(agg_schema, 2).GetAs<int32_t>());
+      EXPECT_EQ(group.sum_big_, tuple.GetValue(agg_schema, 3).GetAs<int64_t>());
+      Value avg_dec = tuple.GetValue(agg_schema, 4);
+      Value min_dec = tuple.GetValue(agg_schema, 5);
+      if (group.count_dec_ == 0) {
+        EXPECT_TRUE(avg_dec.IsNull());
+        EXPECT_TRUE(min_dec.IsNull());
+      } else {
+        EXPECT_NEAR(group.sum_dec_ / group.count_dec_, avg_dec.GetAs<double>(), 1e-9);
+        EXPECT_EQ(group.min_dec_, min_dec.GetAs<double>());
+      }
+      EXPECT_EQ(group.max_name_, tuple.GetValue(agg_schema, 6).ToString());
+    }
+  };
+
+  // Scenario: every aggregation type over BIGINT, DECIMAL and VARCHAR inputs with NULLs, on one thread and in
+  // parallel, with the partial aggregates in memory and spilled to temporary pages.
+  check(1, 0, false);
+  check(1, 0, true);
+  check(4, 0, true);
+  check(4, 16 * 1024, false);
+  GetExecutorContext()->SetParallelism(1);
+  GetExecutorContext()->SetMemoryBudget(0);
+  GetExecutorContext()->SetBatchExecution(false);
+
+  // Scenario: a BIGINT sum or average that leaves the range of BIGINT fails instead of wrapping around, on one thread
+  // and in parallel.
+  TableInfo *big_info = GetCatalog()->CreateTable(GetTxn(), "big_sums", Schema{{Column("big", TypeId::BIGINT)}});
+  for (int32_t i = 0; i < 8; i++) {
+    Tuple tuple{{ValueFactory::GetBigIntValue(int64_t{1} << 61)}, &big_info->schema_};
+    RID rid;
+    ASSERT_TRUE(big_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+  auto *col_sum_big = MakeColumnValueExpression(big_info->schema_, 0, "big");
+  SeqScanPlanNode big_scan_plan{MakeOutputSchema({{"big", col_sum_big}}), nullptr, big_info->oid_};
+  for (auto agg_type : {AggregationType::SumAggregate, AggregationType::AvgAggregate}) {
+    AggregationPlanNode big_agg_plan{MakeOutputSchema({{"sumBig", MakeAggregateValueExpression(false, 0)}}),
+                                     &big_scan_plan,
+                                     nullptr,
+                                     {},
+                                     {col_sum_big},
+                                     {agg_type}};
+    for (size_t num_threads : {1, 4}) {
+      GetExecutorContext()->SetParallelism(num_threads);
+      AggregationExecutor executor{GetExecutorContext(), &big_agg_plan,
+                                   ExecutorFactory::CreateExecutor(GetExecutorContext(), &big_scan_plan)};
+      EXPECT_THROW(executor.Init(), Exception);
+    }
+  }
+  GetExecutorContext()->SetParallelism(1);
+}
+
+// SELECT grp, COUNT(val), SUM(val) FROM nullable_groups GROUP BY grp
+// NOLINTNEXTLINE
+TEST_F(ExecutorTest, GroupByNullTest) {
+  Schema table_schema{{Column("grp", TypeId::INTEGER), Column("val", TypeId::INTEGER)}};
+  TableInfo *table_info = GetCatalog()->CreateTable(GetTxn(), "nullable_groups", table_schema);
+
+  // Every fourth row has a NULL group, the others fall into groups 0 to 4.
+  std::map<int32_t, std::pair<int32_t, int32_t>> expected;
+  std::pair<int32_t, int32_t> expected_null{0, 0};
+  for (int32_t i = 0; i < 2000; i++) {
+    Value grp = i % 4 == 0 ? ValueFactory::GetNullValueByType(TypeId::INTEGER) : ValueFactory::GetIntegerValue(i % 5);
+    auto &group = grp.IsNull() ? expected_null : expected[i % 5];
+    group.first++;
+    group.second += i;
+    Tuple tuple{{grp, ValueFactory::GetIntegerValue(i)}, &table_schema};
+    RID rid;
+    ASSERT_TRUE(table_info->table_->InsertTuple(tuple, &rid, GetTxn()));
+  }
+
+  auto *col_grp = MakeColumnValueExpression(table_schema, 0, "grp");
+  auto *col_val = MakeColumnValueExpression(table_schema, 0, "val");
+  SeqScanPlanNode scan_plan{MakeOutputSchema({{"grp", col_grp}, {"val", col_val}}), nullptr, table_info->oid_};
+  const Schema *agg_schema = MakeOutputSchema({{"grp", MakeAggregateValueExpression(true, 0)},
+                                               {"countVal", MakeAggregateValueExpression(false, 0)},
+                                               {"sumVal", MakeAggregateValueExpression(false, 1)}});
+  AggregationPlanNode agg_plan{agg_schema,
+                               &scan_plan,
+                               nullptr,
+                               {col_grp},
+                               {col_val, col_val},
+                               {AggregationType::CountAggregate, AggregationType::SumAggregate}};
+
+  auto check = [&](size_t num_threads, size_t memory_budget, bool batch_execution) {
+    GetExecutorContext()->SetParallelism(num_threads);
+    GetExecutorContext()->SetMemoryBudget(memory_budget);
+    GetExecutorContext()->SetBatchExecution(batch_execution);
+    std::vector<Tuple> result_set{};
+    GetExecutionEngine()->Execute(&agg_plan, &result_set, GetTxn(), GetExecutorContext());
+    ASSERT_EQ(expected.size() + 1, result_set.size());
+    size_t num_null_groups = 0;
+    for (const auto &tuple : result_set) {
+      Value grp = tuple.GetValue(agg_schema, 0);
+      const auto &group = grp.IsNull() ? expected_null : expected.at(grp.GetAs<int32_t>());
+      num_null_groups += grp.IsNull() ? 1 : 0;
+      EXPECT_EQ(group.first, tuple.GetValue(agg_schema, 1).GetAs<int32_t>());
+      EXPECT_EQ(group.second, tuple.GetValue(agg_schema, 2).GetAs<int32_t>());
+    }
+    EXPECT_EQ(1, num_null_groups);
+  };
+
+  // Scenario: all rows with a NULL group-by value form a single group, however the rows reach the hash table.
+  check(1, 0, false);
+  check(1, 0, true);
+  check(4, 0, true);
+  check(4, 16 * 1024, false);
+  GetExecutorContext()->SetParallelism(1);
+  GetExecutorContext()->SetMemoryBudget(0);
+  GetExecutorContext()->SetBatchExecution(false);
+}
+
 }  // namespace bustub
@@ -185,6 +185,18 @@ class ExecutorTest : public ::testing::Test {
     return allocated_exprs_.back().get();
   }
 
+  /**
+   * Make an aggregate value expression with the type of the aggregate.
+   * @param is_group_by_term `true` if the expression is a group-by term, `false` otherwise
+   * @param term_idx The index of the term in the aggregates or group-bys
+   * @param ret_type The type of the aggregate
+   * @return A non-owning pointer to the AggregateValueExpression
+   */
+  const AbstractExpression *MakeAggregateValueExpression(bool is_group_by_term, uint32_t term_idx, TypeId ret_type) {
+    allocated_exprs_.emplace_back(std::make_unique<AggregateValueExpression>(is_group_by_term, term_idx, ret_type));
+    return allocated_exprs_.back().get();
+  }
+
   /**
    * Allocate an aggregate value expression and return it to the caller.
    * @param is_group_by_term `true` if the expression is a group-by term, `false` otherwise
@@ -0,0 +1,105 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// hash_join_benchmark_test.cpp
+//
+// Identification: test/execution/hash_join_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/hash_join_plan.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+// Joins a build table of 10,000 rows (colA = 0 to 9999) with a probe table of 200,000 rows on build.colA = probe.colC,
+// so that every probe row finds exactly one partner. One thread is the serial join, which builds an unordered_map and
+// probes as the probe side streams in; from two threads on, both inputs are radix partitioned and the workers build and
+// probe one partition at a time. The throughput counts the input rows of both sides. Every join must return one row
+// per probe row.
+// NOLINTNEXTLINE
+TEST(HashJoinBenchmarkTest, DISABLED_JoinScaling) {
+  const std::string db_name = "hash_join_bench.db";
+  const uint32_t num_build_rows = 10000;
+  const uint32_t num_probe_rows = 200000;
+  const size_t pool_size = 4096;
+  const int num_joins = 3;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *build_info = gen.GenerateTest1Table("build_table", num_build_rows);
+  TableInfo *probe_info = gen.GenerateTest1Table("probe_table", num_probe_rows);
+  ExecutionEngine engine{bpm.get(), txn_mgr.get(), catalog.get()};
+
+  ColumnValueExpression build_col_a{0, build_info->schema_.GetColIdx("colA"), TypeId::INTEGER};
+  ColumnValueExpression build_col_b{0, build_info->schema_.GetColIdx("colB"), TypeId::INTEGER};
+  Schema build_schema{{Column("colA", TypeId::INTEGER, &build_col_a), Column("colB", TypeId::INTEGER, &build_col_b)}};
+  SeqScanPlanNode build_plan{&build_schema, nullptr, build_info->oid_};
+  ColumnValueExpression probe_col_a{0, probe_info->schema_.GetColIdx("colA"), TypeId::INTEGER};
+  ColumnValueExpression probe_col_c{0, probe_info->schema_.GetColIdx("colC"), TypeId::INTEGER};
+  Schema probe_schema{{Column("colA", TypeId::INTEGER, &probe_col_a), Column("colC", TypeId::INTEGER, &probe_col_c)}};
+  SeqScanPlanNode probe_plan{&probe_schema, nullptr, probe_info->oid_};
+
+  ColumnValueExpression left_col_a{0, 0, TypeId::INTEGER};
+  ColumnValueExpression left_col_b{0, 1, TypeId::INTEGER};
+  ColumnValueExpression right_col_a{1, 0, TypeId::INTEGER};
+  ColumnValueExpression right_col_c{1, 1, TypeId::INTEGER};
+  Schema join_schema{{Column("build_colA", TypeId::INTEGER, &left_col_a),
+                      Column("build_colB", TypeId::INTEGER, &left_col_b),
+                      Column("probe_colA", TypeId::INTEGER, &right_col_a)}};
+  HashJoinPlanNode join_plan{&join_schema, {&build_plan, &probe_plan}, &left_col_a, &right_col_c};
+
+  exec_ctx->SetBatchExecution(true);
+  double base_rows_per_sec = 0;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    exec_ctx->SetParallelism(num_threads);
+    std::vector<Tuple> result_set;
+    engine.Execute(&join_plan, &result_set, txn, exec_ctx.get());
+    ASSERT_EQ(num_probe_rows, result_set.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int join = 0; join < num_joins; join++) {
+      engine.Execute(&join_plan, nullptr, txn, exec_ctx.get());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rows_per_sec = (num_build_rows + num_probe_rows) * num_joins / seconds;
+    if (num_threads == 1) {
+      base_rows_per_sec = rows_per_sec;
+    }
+    printf("[hash join] threads=%2zu%-9s  input rows/sec=%12.0f  speedup=%.2fx  (%u hardware threads)\n", num_threads,
+           num_threads == 1 ? " (serial)" : "", rows_per_sec, rows_per_sec / base_rows_per_sec,
+           std::thread::hardware_concurrency());
+  }
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("hash_join_bench.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,97 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// parallel_scan_benchmark_test.cpp
+//
+// Identification: test/execution/parallel_scan_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Full scans with a predicate (colC < 5000, about half of the rows) of a table that fits in the buffer pool, with 1 to
+// 16 scan threads feeding the exchange. One thread is the serial scan through the table iterator; from two threads on,
+// workers read whole pages of their morsels. Every scan must return the same number of rows.
+// NOLINTNEXTLINE
+TEST(ParallelScanBenchmarkTest, DISABLED_ScanScaling) {
+  const std::string db_name = "parallel_scan_bench.db";
+  const uint32_t num_rows = 100000;
+  const size_t pool_size = 2048;
+  const int num_scans = 5;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *table_info = gen.GenerateTest1Table("scan_bench", num_rows);
+  ExecutionEngine engine{bpm.get(), txn_mgr.get(), catalog.get()};
+
+  const Schema &schema = table_info->schema_;
+  ColumnValueExpression col_a{0, schema.GetColIdx("colA"), TypeId::INTEGER};
+  ColumnValueExpression col_c{0, schema.GetColIdx("colC"), TypeId::INTEGER};
+  ConstantValueExpression const_5000{ValueFactory::GetIntegerValue(5000)};
+  ComparisonExpression predicate{&col_c, &const_5000, ComparisonType::LessThan};
+  Schema out_schema{{Column("colA", TypeId::INTEGER, &col_a), Column("colC", TypeId::INTEGER, &col_c)}};
+  SeqScanPlanNode scan_plan{&out_schema, &predicate, table_info->oid_};
+
+  exec_ctx->SetBatchExecution(true);
+  size_t expected_rows = 0;
+  double base_rows_per_sec = 0;
+  for (size_t num_threads : {1, 2, 4, 8, 16}) {
+    exec_ctx->SetParallelism(num_threads);
+    std::vector<Tuple> result_set;
+    engine.Execute(&scan_plan, &result_set, txn, exec_ctx.get());
+    if (num_threads == 1) {
+      expected_rows = result_set.size();
+    }
+    ASSERT_EQ(expected_rows, result_set.size());
+
+    auto start = std::chrono::steady_clock::now();
+    for (int scan = 0; scan < num_scans; scan++) {
+      engine.Execute(&scan_plan, nullptr, txn, exec_ctx.get());
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double rows_per_sec = num_rows * num_scans / seconds;
+    if (num_threads == 1) {
+      base_rows_per_sec = rows_per_sec;
+    }
+    printf("[parallel scan] threads=%2zu%-9s  scanned rows/sec=%12.0f  speedup=%.2fx  (%u hardware threads)\n",
+           num_threads, num_threads == 1 ? " (serial)" : "", rows_per_sec, rows_per_sec / base_rows_per_sec,
+           std::thread::hardware_concurrency());
+  }
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("parallel_scan_bench.log");
+}
+
+}  // namespace bustub
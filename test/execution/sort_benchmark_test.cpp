@@ -0,0 +1,110 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// sort_benchmark_test.cpp
+//
+// Identification: test/execution/sort_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executor_context.h"
+#include "execution/executor_factory.h"
+#include "execution/executors/sort_executor.h"
+#include "execution/executors/topn_executor.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "execution/plans/sort_plan.h"
+#include "execution/plans/topn_plan.h"
+#include "gtest/gtest.h"
+
+namespace bustub {
+
+namespace {
+
+/** Runs an executor to completion and returns the number of rows it produced and the seconds it took. */
+size_t Drain(AbstractExecutor *executor, double *seconds) {
+  auto start = std::chrono::steady_clock::now();
+  executor->Init();
+  size_t num_rows = 0;
+  Tuple tuple;
+  RID rid;
+  while (executor->Next(&tuple, &rid)) {
+    num_rows++;
+  }
+  *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return num_rows;
+}
+
+}  // namespace
+
+// ORDER BY colD DESC over a generated table with the columns of test_1: a full sort in memory, the same sort as an
+// external merge sort with a budget of a tenth of its memory, and ORDER BY ... LIMIT 100 as a top-n. Reports the
+// input rows per second and the peak memory that each holds for rows.
+// NOLINTNEXTLINE
+TEST(SortBenchmarkTest, DISABLED_SortAndTopN) {
+  const std::string db_name = "sort_bench.db";
+  const uint32_t num_rows = 200000;
+  const size_t pool_size = 4096;
+  const size_t limit = 100;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *table_info = gen.GenerateTest1Table("sort_bench", num_rows);
+
+  const Schema &schema = table_info->schema_;
+  ColumnValueExpression col_a{0, schema.GetColIdx("colA"), TypeId::INTEGER};
+  ColumnValueExpression col_d{0, schema.GetColIdx("colD"), TypeId::INTEGER};
+  Schema out_schema{{Column("colA", TypeId::INTEGER, &col_a), Column("colD", TypeId::INTEGER, &col_d)}};
+  SeqScanPlanNode scan_plan{&out_schema, nullptr, table_info->oid_};
+  ColumnValueExpression sort_col_d{0, 1, TypeId::INTEGER};
+  std::vector<OrderBy> order_bys{{OrderByType::DESC, &sort_col_d}};
+  SortPlanNode sort_plan{&out_schema, &scan_plan, order_bys};
+  TopNPlanNode topn_plan{&out_schema, &scan_plan, order_bys, limit};
+
+  double seconds;
+  SortExecutor sort{exec_ctx.get(), &sort_plan, ExecutorFactory::CreateExecutor(exec_ctx.get(), &scan_plan)};
+  ASSERT_EQ(num_rows, Drain(&sort, &seconds));
+  size_t sort_memory = sort.GetPeakMemoryUsage();
+  printf("[sort] %-22s rows/sec=%10.0f  peak row memory=%9zu bytes\n", "in-memory sort", num_rows / seconds,
+         sort_memory);
+
+  exec_ctx->SetMemoryBudget(sort_memory / 10);
+  SortExecutor external_sort{exec_ctx.get(), &sort_plan,
+                             ExecutorFactory::CreateExecutor(exec_ctx.get(), &scan_plan)};
+  ASSERT_EQ(num_rows, Drain(&external_sort, &seconds));
+  printf("[sort] %-22s rows/sec=%10.0f  peak row memory=%9zu bytes  runs=%zu\n", "external merge sort",
+         num_rows / seconds, external_sort.GetPeakMemoryUsage(), external_sort.GetNumSpilledRuns());
+  exec_ctx->SetMemoryBudget(0);
+
+  TopNExecutor topn{exec_ctx.get(), &topn_plan, ExecutorFactory::CreateExecutor(exec_ctx.get(), &scan_plan)};
+  ASSERT_EQ(limit, Drain(&topn, &seconds));
+  printf("[sort] %-22s rows/sec=%10.0f  peak row memory=%9zu bytes\n", "top-n (LIMIT 100)", num_rows / seconds,
+         topn.GetPeakMemoryUsage());
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("sort_bench.log");
+}
+
+}  // namespace bustub
@@ -0,0 +1,340 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_bulk_load_test.cpp
+//
+// Identification: test/storage/b_plus_tree_bulk_load_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_bulk_loader.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "storage/page/header_page.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using BulkLoadTree = BPlusTree<GenericKey<8>, RID, GenericComparator<8>>;
+using BulkLoadInternalPage = BPlusTreeInternalPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+using BulkLoadLeafPage = BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+
+GenericKey<8> BulkLoadKey(int64_t key) {
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// Check the page and its subtree: parent page ids, sizes, separator keys, and the depth of the leaves. Keys in the
+// subtree must be >= lower and < upper where given. Returns the number of pages of the subtree.
+int CheckBulkLoadedSubtree(BufferPoolManager *bpm, const GenericComparator<8> &comparator, page_id_t page_id,
+                           page_id_t parent_page_id, const GenericKey<8> *lower, const GenericKey<8> *upper, int depth,
+                           int *leaf_depth) {
+  Page *page = bpm->FetchPage(page_id);
+  EXPECT_NE(nullptr, page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  EXPECT_EQ(parent_page_id, node->GetParentPageId());
+  EXPECT_GT(node->GetSize(), 0);
+  int num_pages = 1;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<BulkLoadLeafPage *>(node);
+    EXPECT_LT(leaf->GetSize(), leaf->GetMaxSize());
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      EXPECT_TRUE(i == 0 || comparator(leaf->KeyAt(i - 1), leaf->KeyAt(i)) < 0);
+      EXPECT_TRUE(lower == nullptr || comparator(leaf->KeyAt(i), *lower) >= 0);
+      EXPECT_TRUE(upper == nullptr || comparator(leaf->KeyAt(i), *upper) < 0);
+    }
+    if (*leaf_depth < 0) {
+      *leaf_depth = depth;
+    }
+    EXPECT_EQ(*leaf_depth, depth);
+  } else {
+    auto *internal = reinterpret_cast<BulkLoadInternalPage *>(node);
+    EXPECT_LE(internal->GetSize(), internal->GetMaxSize());
+    EXPECT_GE(internal->GetSize(), 2);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      GenericKey<8> child_lower = internal->KeyAt(i);
+      GenericKey<8> child_upper = i + 1 < internal->GetSize() ? internal->KeyAt(i + 1) : GenericKey<8>{};
+      num_pages += CheckBulkLoadedSubtree(bpm, comparator, internal->ValueAt(i), page_id, i == 0 ? lower : &child_lower,
+                                          i + 1 < internal->GetSize() ? &child_upper : upper, depth + 1, leaf_depth);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return num_pages;
+}
+
+// Check the whole tree named index_name and return its number of pages.
+int CheckBulkLoadedTree(BufferPoolManager *bpm, const GenericComparator<8> &comparator, const std::string &index_name) {
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  EXPECT_TRUE(header_page->GetRootId(index_name, &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  int leaf_depth = -1;
+  return CheckBulkLoadedSubtree(bpm, comparator, root_page_id, INVALID_PAGE_ID, nullptr, nullptr, 0, &leaf_depth);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, BulkLoadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  // Every key twice, shuffled; the rid of the first copy of key k has slot k and the second slot k + 1000000.
+  const int64_t num_keys = 3000;
+  std::vector<int64_t> keys;
+  for (int64_t key = 0; key < 2 * num_keys; key++) {
+    keys.push_back(key % num_keys);
+  }
+  std::shuffle(keys.begin(), keys.end(), std::mt19937(7));
+  std::vector<bool> seen(num_keys, false);
+  std::vector<RID> rids;
+  for (auto key : keys) {
+    rids.emplace_back(0, seen[key] ? key + 1000000 : key);
+    seen[key] = true;
+  }
+
+  int tree_number = 0;
+  // Scenario: all entries sorted in memory, and entries spilled in runs of 500, with full and half full pages.
+  for (size_t memory_budget : {static_cast<size_t>(0), 500 * sizeof(std::pair<GenericKey<8>, RID>)}) {
+    for (double fill_factor : {1.0, 0.5}) {
+      std::string name = "bulk_" + std::to_string(tree_number++);
+      BulkLoadTree tree(name, bpm.get(), comparator, 6, 5);
+      {
+        BPlusTreeBulkLoader<GenericKey<8>, RID, GenericComparator<8>> loader(&tree, bpm.get(), comparator,
+                                                                             memory_budget, fill_factor);
+        for (size_t i = 0; i < keys.size(); i++) {
+          loader.Add(BulkLoadKey(keys[i]), rids[i]);
+        }
+        EXPECT_EQ(memory_budget == 0 ? 0 : 12, loader.GetNumRuns());
+        ASSERT_TRUE(loader.Finish());
+      }
+      int num_pages = CheckBulkLoadedTree(bpm.get(), comparator, name);
+      // 3000 keys in leaves of 5, and internal pages of 5 children. With half full pages, leaves of 2 keys, and
+      // internal pages of 3 children, the fewest that let the last page on a level take one from its sibling.
+      EXPECT_EQ(fill_factor == 1.0 ? 600 + 120 + 24 + 5 + 1 : 1500 + 500 + 167 + 56 + 19 + 7 + 3 + 1, num_pages);
+
+      // The first rid of each key was kept, and the leaf chain holds all keys in order.
+      for (int64_t key = 0; key < num_keys; key++) {
+        std::vector<RID> result;
+        ASSERT_TRUE(tree.GetValue(BulkLoadKey(key), &result));
+        EXPECT_EQ(key, result[0].GetSlotNum());
+      }
+      int64_t expected = 0;
+      for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+        EXPECT_EQ(expected, (*it).second.GetSlotNum());
+        expected++;
+      }
+      EXPECT_EQ(num_keys, expected);
+
+      // Scenario: the tree takes inserts and removes like any other.
+      for (int64_t key = num_keys; key < num_keys + 500; key++) {
+        EXPECT_TRUE(tree.Insert(BulkLoadKey(key), RID(0, key)));
+      }
+      for (int64_t key = 0; key < num_keys + 500; key += 2) {
+        tree.Remove(BulkLoadKey(key));
+      }
+      CheckBulkLoadedTree(bpm.get(), comparator, name);
+      expected = 1;
+      for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+        EXPECT_EQ(expected, (*it).second.GetSlotNum());
+        expected += 2;
+      }
+      EXPECT_EQ(num_keys + 501, expected);
+      for (int64_t key = 1; key < num_keys + 500; key += 2) {
+        tree.Remove(BulkLoadKey(key));
+      }
+      EXPECT_TRUE(tree.IsEmpty());
+    }
+  }
+
+  // Scenario: a tree that is not empty takes the entries one at a time.
+  BulkLoadTree tree("bulk_nonempty", bpm.get(), comparator, 6, 5);
+  tree.Insert(BulkLoadKey(5), RID(0, 5));
+  BPlusTreeBulkLoader<GenericKey<8>, RID, GenericComparator<8>> loader(&tree, bpm.get(), comparator);
+  for (int64_t key = 0; key < 100; key++) {
+    loader.Add(BulkLoadKey(key), RID(0, key + 1000));
+  }
+  EXPECT_FALSE(loader.Finish());
+  CheckBulkLoadedTree(bpm.get(), comparator, "bulk_nonempty");
+  for (int64_t key = 0; key < 100; key++) {
+    std::vector<RID> result;
+    ASSERT_TRUE(tree.GetValue(BulkLoadKey(key), &result));
+    EXPECT_EQ(key == 5 ? 5 : key + 1000, result[0].GetSlotNum());
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, IndexInsertEntriesTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  Schema table_schema({Column("a", TypeId::BIGINT), Column("b", TypeId::INTEGER)});
+  auto metadata = std::make_unique<IndexMetadata>("bulk_index", "bulk_table", &table_schema, std::vector<uint32_t>{0});
+  BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> index(std::move(metadata), bpm.get());
+
+  // Scenario: filling an empty index from a table builds the tree from the sorted keys.
+  const int64_t num_rows = 20000;
+  int64_t row = 0;
+  index.InsertEntries(
+      [&](Tuple *key, RID *rid) {
+        if (row == num_rows) {
+          return false;
+        }
+        *key = Tuple({ValueFactory::GetBigIntValue((row * 7919) % num_rows)}, index.GetKeySchema());
+        *rid = RID(1, row);
+        row++;
+        return true;
+      },
+      nullptr);
+  for (int64_t key = 0; key < num_rows; key += 97) {
+    std::vector<RID> result;
+    index.ScanKey(Tuple({ValueFactory::GetBigIntValue(key)}, index.GetKeySchema()), &result, nullptr);
+    ASSERT_EQ(1, result.size());
+    EXPECT_EQ(key, (result[0].GetSlotNum() * 7919) % num_rows);
+  }
+  int64_t expected = 0;
+  for (auto it = index.GetBeginIterator(); !it.IsEnd(); ++it) {
+    expected++;
+  }
+  EXPECT_EQ(num_rows, expected);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, LeafReadAheadTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("test.db", IOBackendType::IO_URING);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  // 600 leaves under four levels of internal pages, ten times the pool.
+  const int64_t num_keys = 3000;
+  BulkLoadTree tree("read_ahead", bpm.get(), comparator, 6, 5);
+  int64_t next_key = 0;
+  ASSERT_TRUE(tree.BulkLoad([&](std::pair<GenericKey<8>, RID> *entry) {
+    if (next_key == num_keys) {
+      return false;
+    }
+    *entry = {BulkLoadKey(next_key), RID(0, next_key)};
+    next_key++;
+    return true;
+  }));
+  bpm->FlushAllPages();
+
+  // Scenario: a full scan prefetches the leaves ahead of it, listed from the internal pages across subtrees, and still
+  // returns every key in order.
+  for (bool read_ahead : {false, true}) {
+    enable_read_ahead = read_ahead;
+    uint64_t prefetches = bpm->GetNumPrefetches();
+    int64_t expected = 0;
+    for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+      EXPECT_EQ(expected, (*it).second.GetSlotNum());
+      expected++;
+    }
+    EXPECT_EQ(num_keys, expected);
+    if (read_ahead) {
+      EXPECT_GT(bpm->GetNumPrefetches(), prefetches + 500);
+    } else {
+      EXPECT_EQ(prefetches, bpm->GetNumPrefetches());
+    }
+  }
+  enable_read_ahead = true;
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// Build time of a tree over shuffled keys: inserting them one at a time, and bulk loading them with the sort in memory
+// and with the sort writing runs of 64k entries to the buffer pool. The pool holds a fraction of the tree, so pages
+// are written back to disk during the build.
+// NOLINTNEXTLINE
+TEST(BPlusTreeBulkLoadTest, DISABLED_BuildBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema.get());
+
+  for (int64_t num_keys : {100000, 1000000}) {
+    std::vector<int64_t> keys(num_keys);
+    for (int64_t i = 0; i < num_keys; i++) {
+      keys[i] = i;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(42));
+
+    double insert_seconds = 0;
+    for (int method = 0; method < 3; method++) {
+      auto disk_manager = std::make_unique<DiskManager>("bulk_load_bench.db");
+      auto bpm = std::make_unique<BufferPoolManagerInstance>(1024, disk_manager.get());
+      page_id_t header_page_id;
+      bpm->NewPage(&header_page_id);
+      bpm->UnpinPage(header_page_id, true);
+      BulkLoadTree tree("bench", bpm.get(), comparator);
+
+      auto start = std::chrono::steady_clock::now();
+      size_t num_runs = 0;
+      if (method == 0) {
+        for (auto key : keys) {
+          tree.Insert(BulkLoadKey(key), RID(0, key));
+        }
+      } else {
+        size_t memory_budget = method == 1 ? 0 : 65536 * sizeof(std::pair<GenericKey<8>, RID>);
+        BPlusTreeBulkLoader<GenericKey<8>, RID, GenericComparator<8>> loader(&tree, bpm.get(), comparator,
+                                                                             memory_budget);
+        for (auto key : keys) {
+          loader.Add(BulkLoadKey(key), RID(0, key));
+        }
+        ASSERT_TRUE(loader.Finish());
+        num_runs = loader.GetNumRuns();
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      if (method == 0) {
+        insert_seconds = seconds;
+      }
+      int num_pages = CheckBulkLoadedTree(bpm.get(), comparator, "bench");
+
+      std::vector<RID> result;
+      ASSERT_TRUE(tree.GetValue(BulkLoadKey(num_keys / 2), &result));
+      const char *method_name = method == 0   ? "insert one at a time"
+                                : method == 1 ? "bulk load, in-memory sort"
+                                              : "bulk load, 64k-entry runs";
+      printf("[bulk load] keys=%8ld  %-25s  build seconds=%7.3f  speedup=%5.2fx  tree pages=%6d  runs=%3zu\n",
+             static_cast<long>(num_keys),  // NOLINT
+             method_name, seconds, insert_seconds / seconds, num_pages, num_runs);
+
+      disk_manager->ShutDown();
+      remove("bulk_load_bench.db");
+      remove("bulk_load_bench.log");
+    }
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,315 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_duplicate_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_duplicate_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using PostingTree = BPlusTree<PostingKey<GenericKey<8>>, RID, PostingComparator<GenericKey<8>, GenericComparator<8>>>;
+using IntegerPostingIndex =
+    BPlusTreeIndex<PostingKey<IntegerKey>, RID, PostingComparator<IntegerKey, IntegerComparator>>;
+
+template <typename KeyType>
+PostingKey<KeyType> MakePostingKey(int64_t key, const RID &rid) {
+  PostingKey<KeyType> index_key;
+  index_key.SetFromInteger(key);
+  index_key.SetRid(rid);
+  return index_key;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, InsertRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  PostingComparator<GenericKey<8>, GenericComparator<8>> comparator(key_schema.get());
+  for (int max_size : {5, 0}) {
+    auto disk_manager = std::make_unique<DiskManager>("test.db");
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    bpm->UnpinPage(header_page_id, true);
+    auto tree = max_size == 0 ? std::make_unique<PostingTree>("posting", bpm.get(), comparator)
+                              : std::make_unique<PostingTree>("posting", bpm.get(), comparator, max_size, max_size);
+
+    // Scenario: a few keys each take many rows, some on the same page and some far apart, so posting lists span
+    // leaves, split, borrow from their neighbours and merge.
+    const int num_keys = 7;
+    const int num_rows = 6000;
+    std::mt19937 rng(41);
+    std::map<int64_t, std::set<uint64_t>> expected;
+    std::vector<std::pair<int64_t, RID>> rows;
+    for (int i = 0; i < num_rows; i++) {
+      int64_t key = static_cast<int64_t>(rng() % num_keys) - 3;
+      RID rid(static_cast<page_id_t>(rng() % 50), rng() % (i % 2 == 0 ? 4 : 100000));
+      if (expected[key].insert(RidToInteger(rid)).second) {
+        rows.emplace_back(key, rid);
+      }
+    }
+    for (const auto &[key, rid] : rows) {
+      ASSERT_TRUE(tree->Insert(MakePostingKey<GenericKey<8>>(key, rid), rid));
+    }
+    // A row is indexed once per key, but it may take several keys.
+    EXPECT_FALSE(tree->Insert(MakePostingKey<GenericKey<8>>(rows[0].first, rows[0].second), rows[0].second));
+    EXPECT_TRUE(tree->Insert(MakePostingKey<GenericKey<8>>(100, rows[0].second), rows[0].second));
+    tree->Remove(MakePostingKey<GenericKey<8>>(100, rows[0].second));
+
+    auto check = [&]() {
+      std::vector<RID> result;
+      for (int64_t key = -5; key < num_keys; key++) {
+        result.clear();
+        PostingKey<GenericKey<8>> index_key;
+        index_key.SetFromInteger(key);
+        EXPECT_EQ(!expected[key].empty(), tree->ScanKey(index_key, &result));
+        ASSERT_EQ(expected[key].size(), result.size());
+        auto rid = expected[key].begin();
+        for (const RID &value : result) {
+          EXPECT_EQ(*rid++, RidToInteger(value));
+        }
+      }
+      size_t count = 0;
+      for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+        EXPECT_EQ((*it).first.rid_, RidToInteger((*it).second));
+        count++;
+      }
+      size_t total = 0;
+      for (const auto &[key, rids] : expected) {
+        total += rids.size();
+      }
+      EXPECT_EQ(total, count);
+    };
+    check();
+
+    std::shuffle(rows.begin(), rows.end(), rng);
+    for (size_t n = 0; n < rows.size(); n++) {
+      tree->Remove(MakePostingKey<GenericKey<8>>(rows[n].first, rows[n].second));
+      expected[rows[n].first].erase(RidToInteger(rows[n].second));
+      if (n == rows.size() / 2) {
+        check();
+      }
+    }
+    EXPECT_TRUE(tree->IsEmpty());
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, ConcurrentInsertTest) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  PostingComparator<GenericKey<8>, GenericComparator<8>> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  PostingTree tree("posting", bpm.get(), comparator, 8, 8);
+
+  // Scenario: threads insert interleaved rows of the same few keys, growing the same posting lists.
+  const int num_threads = 4;
+  const int rows_per_thread = 3000;
+  const int num_keys = 3;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int i = 0; i < rows_per_thread; i++) {
+        uint32_t row = i * num_threads + t;
+        RID rid(static_cast<page_id_t>(row / 8), row % 8);
+        tree.Insert(MakePostingKey<GenericKey<8>>(row % num_keys, rid), rid);
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  for (int key = 0; key < num_keys; key++) {
+    std::vector<RID> result;
+    PostingKey<GenericKey<8>> index_key;
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.ScanKey(index_key, &result));
+    ASSERT_EQ(num_threads * rows_per_thread / num_keys, result.size());
+    for (size_t i = 0; i < result.size(); i++) {
+      uint32_t row = i * num_keys + key;
+      EXPECT_EQ(RID(static_cast<page_id_t>(row / 8), row % 8), result[i]);
+    }
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, CreateIndexTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Schema table_schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 20)});
+
+  // Scenario: an index without unique keys returns every row of a key, and deletes only the row it is given.
+  auto index = CreateBPlusTreeIndex(
+      std::make_unique<IndexMetadata>("a_index", "table", &table_schema, std::vector<uint32_t>{0}), bpm.get(), false);
+  ASSERT_NE(nullptr, dynamic_cast<IntegerPostingIndex *>(index.get()));
+  auto make_key = [&](int32_t value) { return Tuple({ValueFactory::GetIntegerValue(value)}, index->GetKeySchema()); };
+  for (uint32_t row = 0; row < 1000; row++) {
+    index->InsertEntry(make_key(row % 10), RID(static_cast<page_id_t>(row / 100), row % 100), nullptr);
+  }
+  std::vector<RID> result;
+  index->ScanKey(make_key(4), &result, nullptr);
+  ASSERT_EQ(100, result.size());
+  for (uint32_t i = 0; i < 100; i++) {
+    EXPECT_EQ(RID(static_cast<page_id_t>(i / 10), i % 10 * 10 + 4), result[i]);
+  }
+  index->DeleteEntry(make_key(4), RID(3, 54), nullptr);
+  result.clear();
+  index->ScanKey(make_key(4), &result, nullptr);
+  EXPECT_EQ(99, result.size());
+  EXPECT_EQ(result.end(), std::find(result.begin(), result.end(), RID(3, 54)));
+  result.clear();
+  index->ScanKey(make_key(10), &result, nullptr);
+  EXPECT_TRUE(result.empty());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+struct DuplicateKeyBenchmark {
+  size_t leaf_pages_;
+  size_t pages_;
+  double rows_per_second_;
+};
+
+// Bulk loads a tree over the rows of the sorted column, the record id of a row being its position, and measures its
+// size and how fast scans for each distinct value return their rows. Trees over plain keys hold (value, record id)
+// pairs, the way an index had to make keys unique before, and scan them with the iterator.
+template <typename KeyType, typename KeyComparator>
+DuplicateKeyBenchmark MeasureDuplicateKeys(const KeyComparator &comparator, const std::vector<int64_t> &column,
+                                           int num_values, int num_scans) {
+  auto disk_manager = std::make_unique<DiskManager>("duplicate_key_bench.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(16384, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  BPlusTree<KeyType, RID, KeyComparator> tree("bench", bpm.get(), comparator);
+  auto pair_schema = ParseCreateStatement("a bigint,b bigint");
+  auto make_key = [&](int64_t value, const RID &rid) {
+    KeyType key;
+    if constexpr (IsPostingKey<KeyType>::value) {
+      key.SetFromInteger(value);
+      key.SetRid(rid);
+    } else {
+      std::vector<Value> values{ValueFactory::GetBigIntValue(value),
+                                ValueFactory::GetBigIntValue(static_cast<int64_t>(RidToInteger(rid)))};
+      key.SetFromKey(Tuple(values, pair_schema.get()));
+    }
+    return key;
+  };
+  size_t next = 0;
+  tree.BulkLoad([&](std::pair<KeyType, RID> *entry) {
+    if (next == column.size()) {
+      return false;
+    }
+    RID rid(static_cast<page_id_t>(next / 64), next % 64);
+    *entry = {make_key(column[next], rid), rid};
+    next++;
+    return true;
+  });
+
+  DuplicateKeyBenchmark result{};
+  page_id_t next_page_id;
+  bpm->NewPage(&next_page_id);
+  bpm->UnpinPage(next_page_id, false);
+  result.pages_ = next_page_id - header_page_id - 1;
+  RID min_rid(0, 0);
+  Page *page = tree.FindLeafPage(make_key(0, min_rid), true);
+  while (page != nullptr) {
+    result.leaf_pages_++;
+    page_id_t next_leaf_id = reinterpret_cast<BPlusTreeLeafPage<KeyType, RID, KeyComparator> *>(page->GetData())
+                                 ->GetNextPageId();
+    bpm->UnpinPage(page->GetPageId(), false);
+    page = next_leaf_id == INVALID_PAGE_ID ? nullptr : bpm->FetchPage(next_leaf_id);
+  }
+
+  size_t rows = 0;
+  std::vector<RID> rids;
+  auto start = std::chrono::steady_clock::now();
+  for (int scan = 0; scan < num_scans; scan++) {
+    int64_t value = scan % num_values;
+    rids.clear();
+    if constexpr (IsPostingKey<KeyType>::value) {
+      tree.ScanKey(make_key(value, min_rid), &rids);
+    } else {
+      KeyType end = make_key(value + 1, min_rid);
+      for (auto it = tree.Begin(make_key(value, min_rid)); !it.IsEnd() && comparator((*it).first, end) < 0; ++it) {
+        rids.push_back((*it).second);
+      }
+    }
+    rows += rids.size();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  EXPECT_EQ(column.size() * num_scans / num_values, rows);
+  result.rows_per_second_ = rows / seconds;
+
+  disk_manager->ShutDown();
+  remove("duplicate_key_bench.db");
+  remove("duplicate_key_bench.log");
+  return result;
+}
+
+// Index size and equality scan throughput for a bigint column with few distinct values, indexed with (value, record
+// id) keys and with posting lists.
+// NOLINTNEXTLINE
+TEST(BPlusTreeDuplicateKeyTest, DISABLED_PostingListBenchmark) {
+  const int num_values = 100;
+  const int64_t num_rows = 1000000;
+  const int num_scans = 200;
+  std::vector<int64_t> column(num_rows);
+  for (int64_t i = 0; i < num_rows; i++) {
+    column[i] = i * num_values / num_rows;
+  }
+  auto key_schema = ParseCreateStatement("a bigint");
+  auto pair_schema = ParseCreateStatement("a bigint,b bigint");
+  auto report = [&](const char *name, const DuplicateKeyBenchmark &result) {
+    printf("[posting list] %-16s rows=%lld  leaves=%6zu  pages=%6zu  bytes/row=%5.2f  scan=%10.0f rows/s\n", name,
+           static_cast<long long>(num_rows), result.leaf_pages_, result.pages_,  // NOLINT
+           static_cast<double>(result.pages_ * PAGE_SIZE) / num_rows, result.rows_per_second_);
+  };
+  report("(value, rid) key", MeasureDuplicateKeys<GenericKey<16>>(GenericComparator<16>(pair_schema.get()), column,
+                                                                    num_values, num_scans));
+  report("generic posting",
+         MeasureDuplicateKeys<PostingKey<GenericKey<8>>>(
+             PostingComparator<GenericKey<8>, GenericComparator<8>>(key_schema.get()), column, num_values, num_scans));
+  report("integer posting",
+         MeasureDuplicateKeys<PostingKey<IntegerKey>>(
+             PostingComparator<IntegerKey, IntegerComparator>(key_schema.get()), column, num_values, num_scans));
+}
+
+}  // namespace bustub
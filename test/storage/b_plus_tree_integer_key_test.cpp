@@ -0,0 +1,284 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_integer_key_test.cpp
+//
+// Identification: test/storage/b_plus_tree_integer_key_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>  // NOLINT
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/index/b_plus_tree_index.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+using IntegerTree = BPlusTree<IntegerKey, RID, IntegerComparator>;
+using IntegerIndex = BPlusTreeIndex<IntegerKey, RID, IntegerComparator>;
+using GenericIndex16 = BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+
+IntegerKey MakeIntegerKey(int64_t key) {
+  IntegerKey index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIntegerKeyTest, RankTest) {
+  // Scenario: the search matches a plain lower and upper bound for every size, spread of keys and probe.
+  std::mt19937_64 rng(3);
+  for (int size = 0; size <= 300; size += size < 40 ? 1 : 37) {
+    for (int spread : {1, 3, 1000, 0}) {
+      std::vector<int64_t> keys(size);
+      for (int i = 0; i < size; i++) {
+        keys[i] = spread == 0 ? static_cast<int64_t>(rng()) : 100 + static_cast<int64_t>(i) * spread;
+      }
+      std::sort(keys.begin(), keys.end());
+      keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+      std::vector<int64_t> probes{std::numeric_limits<int64_t>::min(), std::numeric_limits<int64_t>::max(), 0, 99};
+      for (int64_t key : keys) {
+        probes.push_back(key);
+        probes.push_back(key - 1);
+        probes.push_back(key + 1);
+      }
+      for (int64_t probe : probes) {
+        int n = static_cast<int>(keys.size());
+        EXPECT_EQ(std::lower_bound(keys.begin(), keys.end(), probe) - keys.begin(),
+                  IntegerKeyRank<false>(keys.data(), n, probe));
+        EXPECT_EQ(std::upper_bound(keys.begin(), keys.end(), probe) - keys.begin(),
+                  IntegerKeyRank<true>(keys.data(), n, probe));
+      }
+    }
+  }
+  // Keys spanning the whole range must not overflow the interpolation.
+  std::vector<int64_t> extremes{std::numeric_limits<int64_t>::min(), -5, 0, 7, std::numeric_limits<int64_t>::max()};
+  for (int i = 0; i < 20; i++) {
+    extremes.push_back(std::numeric_limits<int64_t>::max() / 2 + i);
+  }
+  std::sort(extremes.begin(), extremes.end());
+  for (int64_t probe : extremes) {
+    EXPECT_EQ(std::lower_bound(extremes.begin(), extremes.end(), probe) - extremes.begin(),
+              IntegerKeyRank<false>(extremes.data(), static_cast<int>(extremes.size()), probe));
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIntegerKeyTest, InsertRemoveTest) {
+  for (int max_size : {4, 0}) {
+    auto disk_manager = std::make_unique<DiskManager>("test.db");
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+    page_id_t header_page_id;
+    bpm->NewPage(&header_page_id);
+    bpm->UnpinPage(header_page_id, true);
+    IntegerComparator comparator;
+    auto tree = max_size == 0 ? std::make_unique<IntegerTree>("integer", bpm.get(), comparator)
+                              : std::make_unique<IntegerTree>("integer", bpm.get(), comparator, max_size, max_size);
+
+    // Scenario: pages of integer keys split, redistribute and merge, with negative keys sorting first.
+    const int64_t num_keys = 5000;
+    std::vector<int64_t> keys(num_keys);
+    for (int64_t i = 0; i < num_keys; i++) {
+      keys[i] = (i - num_keys / 2) * 3;
+    }
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(11));
+    for (int64_t key : keys) {
+      ASSERT_TRUE(tree->Insert(MakeIntegerKey(key), RID(static_cast<int32_t>(key >> 32), static_cast<uint32_t>(key))));
+    }
+    EXPECT_FALSE(tree->Insert(MakeIntegerKey(keys[0]), RID()));
+    int64_t expected = -num_keys / 2 * 3;
+    for (auto it = tree->Begin(); !it.IsEnd(); ++it) {
+      EXPECT_EQ(expected, (*it).first.value_);
+      EXPECT_EQ(static_cast<uint32_t>(expected), (*it).second.GetSlotNum());
+      expected += 3;
+    }
+    EXPECT_EQ(num_keys / 2 * 3, expected);
+
+    std::vector<RID> result;
+    for (int64_t key = -num_keys * 2; key < num_keys * 2; key++) {
+      result.clear();
+      bool present = key % 3 == 0 && key >= -num_keys / 2 * 3 && key < num_keys / 2 * 3;
+      EXPECT_EQ(present, tree->GetValue(MakeIntegerKey(key), &result));
+    }
+    auto it = tree->Begin(MakeIntegerKey(1));
+    ASSERT_FALSE(it.IsEnd());
+    EXPECT_EQ(3, (*it).first.value_);
+
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(12));
+    for (int64_t n = 0; n < num_keys; n++) {
+      tree->Remove(MakeIntegerKey(keys[n]));
+      if (n == num_keys / 2) {
+        for (int64_t m = 0; m < num_keys; m++) {
+          result.clear();
+          EXPECT_EQ(m > n, tree->GetValue(MakeIntegerKey(keys[m]), &result));
+        }
+      }
+    }
+    EXPECT_TRUE(tree->IsEmpty());
+
+    disk_manager->ShutDown();
+    remove("test.db");
+    remove("test.log");
+  }
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIntegerKeyTest, ConcurrentInsertTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  IntegerComparator comparator;
+  IntegerTree tree("integer", bpm.get(), comparator, 8, 8);
+
+  // Scenario: threads insert interleaved keys, splitting the same pages.
+  const int num_threads = 4;
+  const int64_t keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t] {
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        int64_t key = i * num_threads + t;
+        tree.Insert(MakeIntegerKey(key), RID(0, static_cast<uint32_t>(key)));
+      }
+    });
+  }
+  for (auto &thread : threads) {
+    thread.join();
+  }
+  int64_t expected = 0;
+  for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+    EXPECT_EQ(expected, (*it).first.value_);
+    expected++;
+  }
+  EXPECT_EQ(num_threads * keys_per_thread, expected);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeIntegerKeyTest, CreateIndexTest) {
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(64, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Schema table_schema({Column("a", TypeId::SMALLINT), Column("b", TypeId::BIGINT), Column("c", TypeId::INTEGER)});
+
+  // Scenario: an index on one integer column gets integer keys; any other index gets generic keys that fit.
+  auto index = CreateBPlusTreeIndex(
+      std::make_unique<IndexMetadata>("a_index", "table", &table_schema, std::vector<uint32_t>{0}), bpm.get());
+  EXPECT_NE(nullptr, dynamic_cast<IntegerIndex *>(index.get()));
+  auto composite = CreateBPlusTreeIndex(
+      std::make_unique<IndexMetadata>("bc_index", "table", &table_schema, std::vector<uint32_t>{1, 2}), bpm.get());
+  EXPECT_NE(nullptr, dynamic_cast<GenericIndex16 *>(composite.get()));
+
+  // Keys narrower than 64 bits keep their sign.
+  for (int16_t value = -300; value <= 300; value += 3) {
+    index->InsertEntry(Tuple({ValueFactory::GetSmallIntValue(value)}, index->GetKeySchema()),
+                       RID(0, static_cast<uint32_t>(value + 300)), nullptr);
+  }
+  auto *integer_index = dynamic_cast<IntegerIndex *>(index.get());
+  int16_t expected = -300;
+  for (auto it = integer_index->GetBeginIterator(); !it.IsEnd(); ++it) {
+    EXPECT_EQ(expected, (*it).first.value_);
+    expected += 3;
+  }
+  EXPECT_EQ(303, expected);
+  std::vector<RID> result;
+  index->ScanKey(Tuple({ValueFactory::GetSmallIntValue(-3)}, index->GetKeySchema()), &result, nullptr);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(297, result[0].GetSlotNum());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// Bulk loads a tree over the sorted keys and returns how many of the point lookups of probes it serves per second.
+template <typename KeyType, typename KeyComparator>
+double MeasureLookups(const KeyComparator &comparator, const std::vector<int64_t> &keys,
+                      const std::vector<int64_t> &probes) {
+  auto disk_manager = std::make_unique<DiskManager>("integer_key_bench.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4096, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  BPlusTree<KeyType, RID, KeyComparator> tree("bench", bpm.get(), comparator);
+  size_t next = 0;
+  tree.BulkLoad([&](std::pair<KeyType, RID> *entry) {
+    if (next == keys.size()) {
+      return false;
+    }
+    entry->first.SetFromInteger(keys[next]);
+    entry->second = RID(0, static_cast<uint32_t>(keys[next]));
+    next++;
+    return true;
+  });
+
+  std::vector<KeyType> probe_keys(probes.size());
+  for (size_t i = 0; i < probes.size(); i++) {
+    probe_keys[i].SetFromInteger(probes[i]);
+  }
+  std::vector<RID> result;
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < probes.size(); i++) {
+    result.clear();
+    tree.GetValue(probe_keys[i], &result);
+    EXPECT_EQ(1, result.size());
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  disk_manager->ShutDown();
+  remove("integer_key_bench.db");
+  remove("integer_key_bench.log");
+  return probes.size() / seconds;
+}
+
+// Point lookups per second on a tree of one bigint column, with integer keys and with generic keys, for keys that are
+// dense (sequential ids) and sparse (random values).
+// NOLINTNEXTLINE
+TEST(BPlusTreeIntegerKeyTest, DISABLED_LookupBenchmark) {
+  auto key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> generic_comparator(key_schema.get());
+  IntegerComparator integer_comparator(key_schema.get());
+  const int64_t num_keys = 500000;
+  const int64_t num_probes = 200000;
+  std::mt19937_64 rng(29);
+  for (bool dense : {true, false}) {
+    std::vector<int64_t> keys(num_keys);
+    for (int64_t i = 0; i < num_keys; i++) {
+      keys[i] = dense ? i : static_cast<int64_t>(rng() >> 1);
+    }
+    std::sort(keys.begin(), keys.end());
+    keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    std::vector<int64_t> probes(num_probes);
+    for (auto &probe : probes) {
+      probe = keys[rng() % keys.size()];
+    }
+    double generic = MeasureLookups<GenericKey<8>>(generic_comparator, keys, probes);
+    double integer = MeasureLookups<IntegerKey>(integer_comparator, keys, probes);
+    printf("[integer key] %s keys=%zu  generic=%9.0f lookups/s  integer=%9.0f lookups/s  speedup=%.1fx\n",
+           dense ? "dense " : "sparse", keys.size(), generic, integer, integer / generic);
+  }
+}
+
+}  // namespace bustub
@@ -0,0 +1,230 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// b_plus_tree_key_compression_test.cpp
+//
+// Identification: test/storage/b_plus_tree_key_compression_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "gtest/gtest.h"
+#include "storage/index/b_plus_tree.h"
+#include "storage/page/header_page.h"
+#include "test_util.h"  // NOLINT
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// The shape of a tree: its height and the number of its leaf and internal pages.
+struct TreeShape {
+  int height_{0};
+  int leaf_pages_{0};
+  int internal_pages_{0};
+};
+
+template <size_t KeySize>
+void MeasureTreeShape(BufferPoolManager *bpm, page_id_t page_id, int depth, TreeShape *shape) {
+  using InternalPage = BPlusTreeInternalPage<GenericKey<KeySize>, page_id_t, GenericComparator<KeySize>>;
+  Page *page = bpm->FetchPage(page_id);
+  ASSERT_NE(nullptr, page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  shape->height_ = std::max(shape->height_, depth);
+  if (node->IsLeafPage()) {
+    shape->leaf_pages_++;
+  } else {
+    shape->internal_pages_++;
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      MeasureTreeShape<KeySize>(bpm, internal->ValueAt(i), depth + 1, shape);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+}
+
+// A composite key of bigint columns, like (region, customer, order, id) followed by payload columns for wider keys.
+template <size_t KeySize>
+GenericKey<KeySize> CompositeKey(int64_t i, Schema *key_schema) {
+  std::vector<Value> values{ValueFactory::GetBigIntValue(i / 10000), ValueFactory::GetBigIntValue(i / 100 % 100),
+                            ValueFactory::GetBigIntValue(i % 100), ValueFactory::GetBigIntValue(i)};
+  for (size_t column = values.size(); column < KeySize / 8; column++) {
+    values.push_back(ValueFactory::GetBigIntValue(i % (column + 3)));
+  }
+  GenericKey<KeySize> key;
+  key.SetFromKey(Tuple(values, key_schema));
+  return key;
+}
+
+// Check the keys of the page and its subtree against the bounds its parent sets, and return the number of keys.
+template <size_t KeySize>
+int64_t CheckCompressedSubtree(BufferPoolManager *bpm, const GenericComparator<KeySize> &comparator, page_id_t page_id,
+                               const GenericKey<KeySize> *lower, const GenericKey<KeySize> *upper) {
+  using LeafPage = BPlusTreeLeafPage<GenericKey<KeySize>, RID, GenericComparator<KeySize>>;
+  using InternalPage = BPlusTreeInternalPage<GenericKey<KeySize>, page_id_t, GenericComparator<KeySize>>;
+  Page *page = bpm->FetchPage(page_id);
+  EXPECT_NE(nullptr, page);
+  auto *node = reinterpret_cast<BPlusTreePage *>(page->GetData());
+  int64_t num_keys = 0;
+  if (node->IsLeafPage()) {
+    auto *leaf = reinterpret_cast<LeafPage *>(node);
+    for (int i = 0; i < leaf->GetSize(); i++) {
+      EXPECT_TRUE(i == 0 || comparator(leaf->KeyAt(i - 1), leaf->KeyAt(i)) < 0);
+      EXPECT_TRUE(lower == nullptr || comparator(leaf->KeyAt(i), *lower) >= 0);
+      EXPECT_TRUE(upper == nullptr || comparator(leaf->KeyAt(i), *upper) < 0);
+    }
+    num_keys = leaf->GetSize();
+  } else {
+    auto *internal = reinterpret_cast<InternalPage *>(node);
+    EXPECT_GE(internal->GetSize(), 2);
+    for (int i = 0; i < internal->GetSize(); i++) {
+      GenericKey<KeySize> child_lower = internal->KeyAt(i);
+      GenericKey<KeySize> child_upper = i + 1 < internal->GetSize() ? internal->KeyAt(i + 1) : GenericKey<KeySize>{};
+      num_keys += CheckCompressedSubtree(bpm, comparator, internal->ValueAt(i), i == 0 ? lower : &child_lower,
+                                         i + 1 < internal->GetSize() ? &child_upper : upper);
+    }
+  }
+  bpm->UnpinPage(page_id, false);
+  return num_keys;
+}
+
+// Check the whole tree named index_name and return its number of keys.
+template <size_t KeySize>
+int64_t CheckCompressedTree(BufferPoolManager *bpm, const GenericComparator<KeySize> &comparator,
+                            const std::string &index_name) {
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  EXPECT_TRUE(header_page->GetRootId(index_name, &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  if (root_page_id == INVALID_PAGE_ID) {
+    return 0;
+  }
+  return CheckCompressedSubtree<KeySize>(bpm, comparator, root_page_id, nullptr, nullptr);
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeyCompressionTest, InsertRemoveTest) {
+  auto key_schema = ParseCreateStatement("a bigint,b bigint,c bigint,d bigint,e bigint,f bigint,g bigint,h bigint");
+  GenericComparator<64> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("test.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(256, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("compressed", bpm.get(), comparator);
+
+  // Scenario: pages split and merge once their entries of varying length no longer fit or use less than half a page.
+  const int64_t num_keys = 5000;
+  std::vector<int64_t> order(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    order[i] = i * 7;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(5));
+  for (auto i : order) {
+    ASSERT_TRUE(tree.Insert(CompositeKey<64>(i, key_schema.get()), RID(0, static_cast<uint32_t>(i))));
+  }
+  EXPECT_FALSE(tree.Insert(CompositeKey<64>(order[0], key_schema.get()), RID(1, 1)));
+  EXPECT_EQ(num_keys, CheckCompressedTree<64>(bpm.get(), comparator, "compressed"));
+  int64_t expected = 0;
+  for (auto it = tree.Begin(); !it.IsEnd(); ++it) {
+    EXPECT_EQ(expected, (*it).second.GetSlotNum());
+    EXPECT_EQ(0, comparator((*it).first, CompositeKey<64>(expected, key_schema.get())));
+    expected += 7;
+  }
+  EXPECT_EQ(num_keys * 7, expected);
+
+  // Keys between the existing ones end up on either side of the shortened separators.
+  std::vector<RID> result;
+  for (int64_t i = 0; i < num_keys * 7; i++) {
+    result.clear();
+    EXPECT_EQ(i % 7 == 0, tree.GetValue(CompositeKey<64>(i, key_schema.get()), &result));
+  }
+
+  std::shuffle(order.begin(), order.end(), std::mt19937(6));
+  for (int64_t n = 0; n < num_keys; n++) {
+    tree.Remove(CompositeKey<64>(order[n], key_schema.get()));
+    if (n == num_keys * 3 / 4) {
+      EXPECT_EQ(num_keys - n - 1, CheckCompressedTree<64>(bpm.get(), comparator, "compressed"));
+      for (int64_t m = 0; m < num_keys; m++) {
+        result.clear();
+        EXPECT_EQ(m > n, tree.GetValue(CompositeKey<64>(order[m], key_schema.get()), &result));
+      }
+    }
+  }
+  EXPECT_TRUE(tree.IsEmpty());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+}
+
+// Builds a tree over composite keys of KeySize bytes by inserting them in random order, and reports its shape and the
+// latency of point lookups in random order.
+template <size_t KeySize>
+void RunKeyCompressionBenchmark(const std::string &create_statement) {
+  auto key_schema = ParseCreateStatement(create_statement);
+  GenericComparator<KeySize> comparator(key_schema.get());
+  auto disk_manager = std::make_unique<DiskManager>("key_compression_bench.db");
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(4096, disk_manager.get());
+  page_id_t header_page_id;
+  bpm->NewPage(&header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  BPlusTree<GenericKey<KeySize>, RID, GenericComparator<KeySize>> tree("bench", bpm.get(), comparator);
+
+  const int64_t num_keys = 200000;
+  std::vector<int64_t> order(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    order[i] = i;
+  }
+  std::shuffle(order.begin(), order.end(), std::mt19937(17));
+  std::vector<GenericKey<KeySize>> keys(num_keys);
+  for (int64_t i = 0; i < num_keys; i++) {
+    keys[i] = CompositeKey<KeySize>(i, key_schema.get());
+  }
+  for (auto i : order) {
+    ASSERT_TRUE(tree.Insert(keys[i], RID(static_cast<int32_t>(i >> 16), static_cast<uint32_t>(i & 0xFFFF))));
+  }
+
+  auto *header_page = reinterpret_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  ASSERT_TRUE(header_page->GetRootId("bench", &root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  TreeShape shape;
+  MeasureTreeShape<KeySize>(bpm.get(), root_page_id, 1, &shape);
+
+  std::shuffle(order.begin(), order.end(), std::mt19937(23));
+  auto start = std::chrono::steady_clock::now();
+  std::vector<RID> result;
+  for (auto i : order) {
+    result.clear();
+    tree.GetValue(keys[i], &result);
+    ASSERT_EQ(1, result.size());
+    ASSERT_EQ(i & 0xFFFF, result[0].GetSlotNum());
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  printf("[key compression] key=%2zu bytes  keys=%ld  height=%d  leaf pages=%5d  internal pages=%4d  lookup=%6.0f ns\n",
+         KeySize, static_cast<long>(num_keys), shape.height_, shape.leaf_pages_,  // NOLINT
+         shape.internal_pages_, seconds * 1e9 / num_keys);
+
+  disk_manager->ShutDown();
+  remove("key_compression_bench.db");
+  remove("key_compression_bench.log");
+}
+
+// NOLINTNEXTLINE
+TEST(BPlusTreeKeyCompressionTest, DISABLED_ShapeBenchmark) {
+  RunKeyCompressionBenchmark<32>("a bigint,b bigint,c bigint,d bigint");
+  RunKeyCompressionBenchmark<64>("a bigint,b bigint,c bigint,d bigint,e bigint,f bigint,g bigint,h bigint");
+}
+
+}  // namespace bustub
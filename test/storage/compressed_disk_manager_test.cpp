@@ -0,0 +1,276 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// compressed_disk_manager_test.cpp
+//
+// Identification: test/storage/compressed_disk_manager_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_disk_manager.h"
+#include "storage/disk/page_compressor.h"
+
+namespace bustub {
+
+namespace {
+
+/** A page of 16-byte records that differ only in a counter, like a table page with repetitive columns. */
+std::vector<char> RepetitivePage(int seed) {
+  std::vector<char> page(PAGE_SIZE, 0);
+  for (int offset = 0; offset + 16 <= PAGE_SIZE / 2; offset += 16) {
+    int counter = seed + offset;
+    memcpy(&page[offset], "record:", 7);
+    memcpy(&page[offset + 8], &counter, sizeof(counter));
+  }
+  return page;
+}
+
+std::vector<char> RandomPage(int seed) {
+  std::mt19937 rng(seed);
+  std::vector<char> page(PAGE_SIZE);
+  for (auto &c : page) {
+    c = static_cast<char>(rng());
+  }
+  return page;
+}
+
+}  // namespace
+
+class CompressedDiskManagerTest : public ::testing::Test {
+ protected:
+  // This function is called before every test.
+  void SetUp() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test.pmap");
+  }
+
+  // This function is called after every test.
+  void TearDown() override {
+    remove("test.db");
+    remove("test.log");
+    remove("test.pmap");
+  };
+};
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, CompressorRoundTripTest) {
+  std::vector<char> out(PAGE_SIZE);
+  std::vector<char> compressed(PAGE_SIZE);
+
+  // Scenario: repetitive data shrinks and comes back unchanged.
+  auto repetitive = RepetitivePage(0);
+  size_t size = PageCompressor::Compress(repetitive.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE);
+  ASSERT_GT(size, 0);
+  EXPECT_LT(size, PAGE_SIZE / 4);
+  EXPECT_EQ(PAGE_SIZE, PageCompressor::Decompress(compressed.data(), size, out.data(), PAGE_SIZE));
+  EXPECT_EQ(repetitive, out);
+
+  // Scenario: random data does not fit into less than a page.
+  auto random = RandomPage(0);
+  EXPECT_EQ(0, PageCompressor::Compress(random.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE - 1));
+
+  // Scenario: short inputs are all literals.
+  for (size_t length : {0, 1, 11, 12, 13}) {
+    size = PageCompressor::Compress(random.data(), length, compressed.data(), PAGE_SIZE);
+    ASSERT_GT(size, 0);
+    EXPECT_EQ(length, PageCompressor::Decompress(compressed.data(), size, out.data(), PAGE_SIZE));
+    EXPECT_EQ(0, memcmp(random.data(), out.data(), length));
+  }
+
+  // Scenario: a truncated block is rejected, not read past.
+  size = PageCompressor::Compress(repetitive.data(), PAGE_SIZE, compressed.data(), PAGE_SIZE);
+  EXPECT_NE(PAGE_SIZE, PageCompressor::Decompress(compressed.data(), size / 2, out.data(), PAGE_SIZE));
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, ReadWritePageTest) {
+  std::vector<char> buf(PAGE_SIZE);
+  auto *dm = new CompressedDiskManager("test.db");
+
+  // Scenario: a page that was never written reads as zeros.
+  dm->ReadPage(3, buf.data());
+  EXPECT_EQ(std::vector<char>(PAGE_SIZE, 0), buf);
+
+  // Scenario: compressible pages take a fraction of a page on disk.
+  for (int i = 0; i < 8; i++) {
+    dm->WritePage(i, RepetitivePage(i).data());
+  }
+  EXPECT_EQ(8, dm->GetNumCompressedPages());
+  EXPECT_LE(dm->GetAllocatedBytes(), 8 * PAGE_SIZE / 2);
+  EXPECT_LE(dm->GetNumBytesWritten(), 8 * PAGE_SIZE / 2);
+
+  // Scenario: a page that grows moves to a new extent, one that does not compress is stored as it is. Its old extent
+  // is reused by the next page of that size.
+  uint64_t allocated = dm->GetAllocatedBytes();
+  dm->WritePage(2, RandomPage(2).data());
+  EXPECT_EQ(allocated + PAGE_SIZE, dm->GetAllocatedBytes());
+  EXPECT_EQ(7, dm->GetNumCompressedPages());
+  dm->WritePage(8, RepetitivePage(8).data());
+  EXPECT_EQ(allocated + PAGE_SIZE, dm->GetAllocatedBytes());
+
+  for (int i = 0; i < 9; i++) {
+    dm->ReadPage(i, buf.data());
+    EXPECT_EQ(i == 2 ? RandomPage(2) : RepetitivePage(i), buf) << "page " << i;
+  }
+
+  // Scenario: the mapping table survives a restart, and so does the free extent page 8 leaves behind.
+  dm->WritePage(8, RandomPage(8).data());
+  allocated = dm->GetAllocatedBytes();
+  dm->ShutDown();
+  delete dm;
+  dm = new CompressedDiskManager("test.db", IOBackendType::IO_URING);
+  for (int i = 0; i < 9; i++) {
+    dm->ReadPage(i, buf.data());
+    EXPECT_EQ(i == 2 ? RandomPage(2) : i == 8 ? RandomPage(8) : RepetitivePage(i), buf) << "page " << i;
+  }
+  dm->WritePage(9, RepetitivePage(8).data());
+  EXPECT_EQ(allocated, dm->GetAllocatedBytes());
+  dm->ReadPage(9, buf.data());
+  EXPECT_EQ(RepetitivePage(8), buf);
+  dm->ShutDown();
+  delete dm;
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, NoShutDownTest) {
+  std::vector<char> buf(PAGE_SIZE);
+  auto *dm = new CompressedDiskManager("test.db");
+  for (int i = 0; i < 4; i++) {
+    dm->WritePage(i, RepetitivePage(i).data());
+  }
+
+  // Scenario: page 1 moves and page 4 takes the extent it left behind. Neither change waits for ShutDown() to reach
+  // the mapping table, so a manager opened after a crash still finds every page.
+  dm->WritePage(1, RandomPage(1).data());
+  dm->WritePage(4, RepetitivePage(4).data());
+  uint64_t allocated = dm->GetAllocatedBytes();
+  auto *reopened = new CompressedDiskManager("test.db");
+  for (int i = 0; i < 5; i++) {
+    reopened->ReadPage(i, buf.data());
+    EXPECT_EQ(i == 1 ? RandomPage(1) : RepetitivePage(i), buf) << "page " << i;
+  }
+  EXPECT_EQ(allocated, reopened->GetAllocatedBytes());
+  delete reopened;
+
+  // Scenario: a page rewritten in place with a different compressed size carries that size in its extent, so the
+  // mapping table needs no change and the page still reads back after a crash.
+  const std::vector<char> zeros(PAGE_SIZE, 0);
+  dm->WritePage(3, zeros.data());
+  EXPECT_EQ(allocated, dm->GetAllocatedBytes());
+  reopened = new CompressedDiskManager("test.db");
+  reopened->ReadPage(3, buf.data());
+  EXPECT_EQ(zeros, buf);
+  delete reopened;
+  delete dm;
+
+  // Scenario: the records are compacted into the table when it is loaded, and the compacted table loads the same.
+  dm = new CompressedDiskManager("test.db");
+  delete dm;
+  dm = new CompressedDiskManager("test.db");
+  for (int i = 0; i < 5; i++) {
+    dm->ReadPage(i, buf.data());
+    EXPECT_EQ(i == 1 ? RandomPage(1) : i == 3 ? zeros : RepetitivePage(i), buf) << "page " << i;
+  }
+  dm->ShutDown();
+  delete dm;
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, CorruptPageTest) {
+  std::vector<char> buf(PAGE_SIZE);
+  auto *dm = new CompressedDiskManager("test.db");
+  dm->WritePage(0, RepetitivePage(0).data());
+
+  // Scenario: a compressed page whose extent was overwritten fails to read instead of reading as zeros.
+  {
+    std::fstream db("test.db", std::ios::binary | std::ios::in | std::ios::out);
+    auto garbage = RandomPage(0);
+    db.write(garbage.data(), COMPRESSED_EXTENT_UNIT);
+  }
+  EXPECT_THROW(dm->ReadPage(0, buf.data()), Exception);
+  dm->ShutDown();
+  delete dm;
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, BrokenPageMapTest) {
+  std::vector<char> buf(PAGE_SIZE);
+  auto *dm = new CompressedDiskManager("test.db");
+  dm->WritePage(0, RepetitivePage(0).data());
+  dm->ShutDown();
+  delete dm;
+
+  // Scenario: a truncated mapping table is refused and left as it is, not replaced by an empty one.
+  std::string map_bytes;
+  {
+    std::ifstream map("test.pmap", std::ios::binary);
+    map_bytes.assign(std::istreambuf_iterator<char>(map), std::istreambuf_iterator<char>());
+    std::ofstream truncated("test.pmap", std::ios::binary | std::ios::trunc);
+    truncated.write(map_bytes.data(), 12);
+  }
+  EXPECT_THROW(CompressedDiskManager("test.db"), Exception);
+  {
+    std::ifstream map("test.pmap", std::ios::binary);
+    EXPECT_EQ(map_bytes.substr(0, 12), std::string(std::istreambuf_iterator<char>(map), {}));
+  }
+
+  // Scenario: a database file without its mapping table is refused instead of reading as zeros.
+  remove("test.pmap");
+  EXPECT_THROW(CompressedDiskManager("test.db"), Exception);
+
+  // Scenario: the restored table opens again.
+  {
+    std::ofstream map("test.pmap", std::ios::binary);
+    map.write(map_bytes.data(), map_bytes.size());
+  }
+  dm = new CompressedDiskManager("test.db");
+  dm->ReadPage(0, buf.data());
+  EXPECT_EQ(RepetitivePage(0), buf);
+  dm->ShutDown();
+  delete dm;
+}
+
+// NOLINTNEXTLINE
+TEST_F(CompressedDiskManagerTest, BufferPoolTest) {
+  const size_t buffer_pool_size = 10;
+  auto *dm = new CompressedDiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(buffer_pool_size, dm);
+
+  // Scenario: the buffer pool writes back and reads in pages through the compression layer without noticing.
+  page_id_t page_id_temp;
+  for (size_t i = 0; i < buffer_pool_size * 4; ++i) {
+    auto *page = bpm->NewPage(&page_id_temp);
+    ASSERT_NE(nullptr, page);
+    snprintf(page->GetData(), PAGE_SIZE, "page %d", page_id_temp);
+    EXPECT_EQ(true, bpm->UnpinPage(page_id_temp, true));
+  }
+  bpm->FlushAllPages();
+  for (int i = 0; i < static_cast<int>(buffer_pool_size * 4); ++i) {
+    auto *page = bpm->FetchPage(i);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ("page " + std::to_string(i), std::string(page->GetData()));
+    EXPECT_EQ(true, bpm->UnpinPage(i, false));
+  }
+  EXPECT_EQ(buffer_pool_size * 4, dm->GetNumCompressedPages());
+
+  dm->ShutDown();
+  delete bpm;
+  delete dm;
+}
+
+}  // namespace bustub
@@ -0,0 +1,116 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// disk_manager_benchmark_test.cpp
+//
+// Identification: test/storage/disk_manager_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <future>  // NOLINT
+#include <random>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "storage/disk/disk_manager.h"
+
+namespace bustub {
+
+namespace {
+
+const char *BackendName(IOBackendType type) {
+  switch (type) {
+    case IOBackendType::FSTREAM:
+      return "fstream";
+    case IOBackendType::THREAD_POOL:
+      return "thread_pool";
+    case IOBackendType::IO_URING:
+      return "io_uring";
+  }
+  return "unknown";
+}
+
+}  // namespace
+
+// Random 4 KiB read IOPS and sequential write throughput for every page I/O path. Asynchronous backends keep
+// queue_depth requests in flight; the fstream path is synchronous. The file is small enough to stay in the page cache,
+// so this measures the software overhead of each path rather than the device.
+// NOLINTNEXTLINE
+TEST(DiskManagerBenchmarkTest, DISABLED_BackendThroughput) {
+  const std::string db_file = "disk_bench.db";
+  const int num_pages = 2048;
+  const int num_reads = 8192;
+  const size_t queue_depth = 32;
+
+  for (auto type : {IOBackendType::FSTREAM, IOBackendType::THREAD_POOL, IOBackendType::IO_URING}) {
+    remove(db_file.c_str());
+    remove("disk_bench.log");
+    DiskManager dm(db_file, type, queue_depth);
+
+    std::vector<char> pages(static_cast<size_t>(queue_depth) * PAGE_SIZE);
+    for (size_t i = 0; i < pages.size(); i++) {
+      pages[i] = static_cast<char>(i * 31);
+    }
+
+    // Sequential writes.
+    std::deque<std::future<void>> pending;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_pages; i++) {
+      if (pending.size() == queue_depth) {
+        pending.front().get();
+        pending.pop_front();
+      }
+      pending.push_back(dm.WritePageAsync(i, &pages[(i % queue_depth) * PAGE_SIZE]));
+    }
+    while (!pending.empty()) {
+      pending.front().get();
+      pending.pop_front();
+    }
+    double write_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Random reads.
+    std::mt19937 rng(0);
+    std::uniform_int_distribution<page_id_t> dist(0, num_pages - 1);
+    std::vector<page_id_t> read_ids(queue_depth);
+    start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_reads; i++) {
+      if (pending.size() == queue_depth) {
+        pending.front().get();
+        pending.pop_front();
+      }
+      size_t slot = i % queue_depth;
+      read_ids[slot] = dist(rng);
+      pending.push_back(dm.ReadPageAsync(read_ids[slot], &pages[slot * PAGE_SIZE]));
+    }
+    while (!pending.empty()) {
+      pending.front().get();
+      pending.pop_front();
+    }
+    double read_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Spot check that the last batch of reads returned what was written.
+    for (size_t slot = 0; slot < queue_depth; slot++) {
+      size_t written_slot = read_ids[slot] % queue_depth;
+      for (size_t b = 0; b < PAGE_SIZE; b += 512) {
+        ASSERT_EQ(static_cast<char>((written_slot * PAGE_SIZE + b) * 31), pages[slot * PAGE_SIZE + b]);
+      }
+    }
+
+    printf("[disk] %-11s (ran as %-11s)  write MiB/s=%9.1f  random read IOPS=%10.0f\n", BackendName(type),
+           BackendName(dm.GetIOBackendType()), num_pages * (PAGE_SIZE / 1048576.0) / write_seconds,
+           num_reads / read_seconds);
+    dm.ShutDown();
+  }
+  remove(db_file.c_str());
+  remove("disk_bench.log");
+}
+
+}  // namespace bustub
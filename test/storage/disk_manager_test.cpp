@@ -10,7 +10,10 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include <array>
 #include <cstring>
+#include <future>  // NOLINT
+#include <vector>
 
 #include "common/exception.h"
 #include "gtest/gtest.h"
@@ -52,9 +55,58 @@ TEST_F(DiskManagerTest, ReadWritePageTest) {
   dm.ReadPage(5, buf);
   EXPECT_EQ(std::memcmp(buf, data, sizeof(buf)), 0);
 
+  // Reads past the end of the file come back zeroed.
+  std::memset(buf, 'x', sizeof(buf));
+  dm.ReadPage(20, buf);
+  char zeros[PAGE_SIZE] = {0};
+  EXPECT_EQ(std::memcmp(buf, zeros, PAGE_SIZE), 0);
+
   dm.ShutDown();
 }
 
+// NOLINTNEXTLINE
+TEST_F(DiskManagerTest, AsyncBackendReadWritePageTest) {
+  for (auto backend : {IOBackendType::THREAD_POOL, IOBackendType::IO_URING}) {
+    remove("test.db");
+    std::string db_file("test.db");
+    auto dm = DiskManager(db_file, backend, 8);
+
+    // Many writes in flight at once, each page filled with its own id.
+    const int num_pages = 32;
+    std::vector<std::array<char, PAGE_SIZE>> pages(num_pages);
+    std::vector<std::future<void>> pending;
+    for (int i = 0; i < num_pages; i++) {
+      pages[i].fill(static_cast<char>('a' + i % 26));
+      pending.push_back(dm.WritePageAsync(i, pages[i].data()));
+    }
+    for (auto &f : pending) {
+      f.get();
+    }
+    EXPECT_EQ(num_pages, dm.GetNumWrites());
+
+    pending.clear();
+    std::vector<std::array<char, PAGE_SIZE>> bufs(num_pages);
+    for (int i = num_pages - 1; i >= 0; i--) {
+      pending.push_back(dm.ReadPageAsync(i, bufs[i].data()));
+    }
+    for (auto &f : pending) {
+      f.get();
+    }
+    for (int i = 0; i < num_pages; i++) {
+      EXPECT_EQ(std::memcmp(bufs[i].data(), pages[i].data(), PAGE_SIZE), 0);
+    }
+
+    // Reads past the end of the file come back zeroed.
+    char buf[PAGE_SIZE];
+    std::memset(buf, 'x', sizeof(buf));
+    dm.ReadPage(num_pages + 10, buf);
+    char zeros[PAGE_SIZE] = {0};
+    EXPECT_EQ(std::memcmp(buf, zeros, PAGE_SIZE), 0);
+
+    dm.ShutDown();
+  }
+}
+
 // NOLINTNEXTLINE
 TEST_F(DiskManagerTest, ReadWriteLogTest) {
   char buf[16] = {0};
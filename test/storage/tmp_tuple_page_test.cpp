@@ -19,7 +19,7 @@
 namespace bustub {
 
 // NOLINTNEXTLINE
-TEST(TmpTuplePageTest, DISABLED_BasicTest) {
+TEST(TmpTuplePageTest, BasicTest) {
   // There are many ways to do this assignment, and this is only one of them.
   // If you don't like the TmpTuplePage idea, please feel free to delete this test case entirely.
   // You will get full credit as long as you are correctly using a linear probe hash table.
@@ -46,6 +46,25 @@ TEST(TmpTuplePageTest, DISABLED_BasicTest) {
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + sizeof(page_id_t) + sizeof(lsn_t)), PAGE_SIZE - 8);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 8), 4);
   ASSERT_EQ(*reinterpret_cast<uint32_t *>(data + PAGE_SIZE - 4), 123);
+  ASSERT_EQ(page_id, tmp_tuple.GetPageId());
+  ASSERT_EQ(PAGE_SIZE - 8, tmp_tuple.GetOffset());
+
+  // Fill the page; every tuple takes 8 bytes after the 12 byte header.
+  int num_tuples = 1;
+  for (int32_t i = 124; page.Insert(Tuple({ValueFactory::GetIntegerValue(i)}, &schema), &tmp_tuple); i++) {
+    num_tuples++;
+  }
+  ASSERT_EQ((PAGE_SIZE - 12) / 8, num_tuples);
+
+  Tuple read_tuple;
+  page.Get(TmpTuple(page_id, PAGE_SIZE - 8), &read_tuple);
+  ASSERT_EQ(123, read_tuple.GetValue(&schema, 0).GetAs<int32_t>());
+  std::vector<Tuple> tuples;
+  page.GetTuples(&tuples);
+  ASSERT_EQ(num_tuples, tuples.size());
+  for (int i = 0; i < num_tuples; i++) {
+    ASSERT_EQ(123 + num_tuples - 1 - i, tuples[i].GetValue(&schema, 0).GetAs<int32_t>());
+  }
 }
 
 }  // namespace bustub
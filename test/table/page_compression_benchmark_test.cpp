@@ -0,0 +1,142 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// page_compression_benchmark_test.cpp
+//
+// Identification: test/table/page_compression_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/disk/compressed_disk_manager.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Loads a table with repetitive columns (a serial id, a status out of four strings, a category out of eight and a
+// small quantity) through plain and compressed disk managers, then scans it repeatedly from a cold buffer pool.
+// Finally updates every quantity and writes the table pages back in runs of consecutive pages, the way the background
+// writer coalesces dirty pages. Reports the bytes written for the load, the scan throughput and the write throughput.
+// NOLINTNEXTLINE
+TEST(PageCompressionBenchmarkTest, DISABLED_RepetitiveTable) {
+  const uint32_t num_rows = 20000;
+  const size_t load_pool_size = 1024;
+  const size_t scan_pool_size = 32;
+  const int num_scans = 3;
+  const size_t write_run_pages = 16;
+  const std::vector<std::string> statuses{"shipped", "pending", "delivered", "returned"};
+  Schema schema({Column("id", TypeId::INTEGER), Column("status", TypeId::VARCHAR, 16),
+                 Column("category", TypeId::INTEGER), Column("quantity", TypeId::INTEGER)});
+
+  for (bool compressed : {false, true}) {
+    const std::string db_name = "compression_bench.db";
+    remove(db_name.c_str());
+    remove("compression_bench.pmap");
+    std::unique_ptr<DiskManager> disk_manager;
+    if (compressed) {
+      disk_manager = std::make_unique<CompressedDiskManager>(db_name);
+    } else {
+      disk_manager = std::make_unique<DiskManager>(db_name);
+    }
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+    Transaction *txn = txn_mgr->Begin();
+
+    page_id_t first_page_id;
+    {
+      BufferPoolManagerInstance bpm(load_pool_size, disk_manager.get());
+      TableHeap table(&bpm, lock_manager.get(), nullptr, txn);
+      first_page_id = table.GetFirstPageId();
+      std::mt19937 rng(0);
+      std::uniform_int_distribution<int> quantity(1, 5);
+      RID rid;
+      for (uint32_t i = 0; i < num_rows; i++) {
+        Tuple tuple({ValueFactory::GetIntegerValue(static_cast<int32_t>(i)),
+                     ValueFactory::GetVarcharValue(statuses[i % statuses.size()]),
+                     ValueFactory::GetIntegerValue(static_cast<int32_t>(i % 8)),
+                     ValueFactory::GetIntegerValue(quantity(rng))},
+                    &schema);
+        ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn));
+      }
+      bpm.FlushAllPages();
+    }
+    uint64_t bytes_written = disk_manager->GetNumBytesWritten();
+
+    double total_seconds = 0;
+    for (int scan = 0; scan < num_scans; scan++) {
+      BufferPoolManagerInstance bpm(scan_pool_size, disk_manager.get());
+      TableHeap table(&bpm, lock_manager.get(), nullptr, first_page_id);
+      auto start = std::chrono::steady_clock::now();
+      uint32_t rows = 0;
+      for (auto it = table.Begin(txn); it != table.End(); ++it) {
+        rows++;
+      }
+      total_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      ASSERT_EQ(num_rows, rows);
+    }
+
+    size_t pages_written = 0;
+    double write_seconds = 0;
+    {
+      BufferPoolManagerInstance bpm(load_pool_size, disk_manager.get());
+      TableHeap table(&bpm, lock_manager.get(), nullptr, first_page_id);
+      std::mt19937 rng(1);
+      std::uniform_int_distribution<int> quantity(1, 5);
+      for (auto it = table.Begin(txn); it != table.End(); ++it) {
+        Tuple tuple({it->GetValue(&schema, 0), it->GetValue(&schema, 1), it->GetValue(&schema, 2),
+                     ValueFactory::GetIntegerValue(quantity(rng))},
+                    &schema);
+        ASSERT_TRUE(table.UpdateTuple(tuple, it->GetRid(), txn));
+      }
+
+      std::vector<page_id_t> page_ids;
+      for (page_id_t page_id = first_page_id; page_id != INVALID_PAGE_ID; page_id = table.GetNextPageId(page_id)) {
+        page_ids.push_back(page_id);
+      }
+      std::vector<char> run(write_run_pages * PAGE_SIZE);
+      for (size_t start = 0; start < page_ids.size();) {
+        size_t length = 0;
+        while (start + length < page_ids.size() && length < write_run_pages &&
+               page_ids[start + length] == page_ids[start] + static_cast<page_id_t>(length)) {
+          Page *page = bpm.FetchPage(page_ids[start + length]);
+          ASSERT_NE(nullptr, page);
+          memcpy(&run[length * PAGE_SIZE], page->GetData(), PAGE_SIZE);
+          bpm.UnpinPage(page_ids[start + length], false);
+          length++;
+        }
+        auto write_start = std::chrono::steady_clock::now();
+        disk_manager->WritePages(page_ids[start], run.data(), length);
+        write_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - write_start).count();
+        pages_written += length;
+        start += length;
+      }
+    }
+
+    printf("[compression] %-10s  bytes written=%10lu  rows/sec=%12.0f  pages written/sec=%10.0f\n",
+           compressed ? "compressed" : "plain", static_cast<unsigned long>(bytes_written),  // NOLINT
+           num_rows * num_scans / total_seconds, pages_written / write_seconds);
+
+    txn_mgr->Commit(txn);
+    delete txn;
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+    remove("compression_bench.log");
+    remove("compression_bench.pmap");
+  }
+}
+
+}  // namespace bustub
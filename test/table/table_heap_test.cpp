@@ -0,0 +1,319 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_heap_test.cpp
+//
+// Identification: test/table/table_heap_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "common/exception.h"
+#include "concurrency/transaction.h"
+#include "execution/morsel_queue.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FreeSpaceMapTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(40, 'x'))}, &schema);
+  };
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *table = new TableHeap(bpm, lock_manager, nullptr, transaction);
+
+  // Scenario: appending fills the pages in order.
+  const int num_tuples = 5000;
+  std::vector<RID> rids;
+  std::set<page_id_t> pages;
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(make_tuple(i), &rid, transaction));
+    rids.push_back(rid);
+    pages.insert(rid.GetPageId());
+  }
+  ASSERT_GT(pages.size(), 3);
+
+  // Scenario: deleting every tuple of the second page records its space in the free space map.
+  page_id_t second_page_id = *std::next(pages.begin());
+  int num_deleted = 0;
+  for (const auto &rid : rids) {
+    if (rid.GetPageId() == second_page_id) {
+      ASSERT_TRUE(table->MarkDelete(rid, transaction));
+      table->ApplyDelete(rid, transaction);
+      num_deleted++;
+    }
+  }
+
+  // Scenario: a heap opened on the same table shares the map. Inserting as many tuples as were deleted fills the space
+  // left on the last page and on the second page, without appending a page.
+  auto *reopened = new TableHeap(bpm, lock_manager, nullptr, table->GetFirstPageId());
+  int num_on_second_page = 0;
+  for (int i = 0; i < num_deleted; ++i) {
+    RID rid;
+    ASSERT_TRUE(reopened->InsertTuple(make_tuple(num_tuples + i), &rid, transaction));
+    EXPECT_EQ(1, pages.count(rid.GetPageId()));
+    num_on_second_page += rid.GetPageId() == second_page_id ? 1 : 0;
+  }
+  EXPECT_GT(num_on_second_page, 0);
+
+  // Scenario: once the space left over is used up, inserts append again. Less than a page was left over.
+  int num_inserted = num_tuples;
+  RID rid;
+  do {
+    ASSERT_TRUE(table->InsertTuple(make_tuple(num_inserted), &rid, transaction));
+    num_inserted++;
+  } while (pages.count(rid.GetPageId()) == 1 && num_inserted < num_tuples + 2 * num_deleted);
+  EXPECT_EQ(0, pages.count(rid.GetPageId()));
+  EXPECT_LT(num_inserted, num_tuples + 2 * num_deleted);
+
+  int num_scanned = 0;
+  for (auto it = table->Begin(transaction); it != table->End(); ++it) {
+    num_scanned++;
+  }
+  EXPECT_EQ(num_inserted, num_scanned);
+
+  // Scenario: the free space map lists the page chain, which is what read-ahead prefetches.
+  std::vector<page_id_t> chain;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;
+       page_id = table->GetNextPageId(page_id)) {
+    chain.push_back(page_id);
+  }
+  auto next_pages = reopened->GetNextPagesFn();
+  std::vector<page_id_t> listed{chain[0]};
+  while (true) {
+    std::vector<page_id_t> page_ids;
+    next_pages(listed.back(), 3, &page_ids);
+    ASSERT_LE(page_ids.size(), 3);
+    listed.insert(listed.end(), page_ids.begin(), page_ids.end());
+    if (page_ids.size() < 3) {
+      break;
+    }
+  }
+  EXPECT_EQ(chain, listed);
+
+  // Scenario: a parallel scan lists its morsels from the map too. The table does not fit in the pool, yet listing it
+  // reads no more than the map page and the last table page.
+  ASSERT_GT(chain.size(), 50);
+  uint64_t num_misses = bpm->GetNumFetchMisses();
+  MorselQueue morsels(reopened);
+  EXPECT_LE(bpm->GetNumFetchMisses() - num_misses, 2);
+  std::vector<page_id_t> claimed;
+  std::vector<page_id_t> morsel;
+  while (morsels.Next(&morsel)) {
+    claimed.insert(claimed.end(), morsel.begin(), morsel.end());
+  }
+  EXPECT_EQ(chain, claimed);
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete reopened;
+  delete table;
+  delete lock_manager;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, FormatVersionTest) {
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(10, disk_manager);
+  auto *lock_manager = new LockManager();
+
+  // Scenario: a table page of the format before the free space map, holding one tuple, is refused.
+  page_id_t page_id;
+  Page *page = bpm->NewPage(&page_id);
+  ASSERT_NE(nullptr, page);
+  uint32_t old_header[] = {static_cast<uint32_t>(page_id), 0, static_cast<uint32_t>(INVALID_PAGE_ID),
+                           static_cast<uint32_t>(INVALID_PAGE_ID), PAGE_SIZE - 16, 1, PAGE_SIZE - 16, 16};
+  memcpy(page->GetData(), old_header, sizeof(old_header));
+  EXPECT_TRUE(bpm->UnpinPage(page_id, true));
+  EXPECT_THROW(TableHeap(bpm, lock_manager, nullptr, page_id), Exception);
+
+  // Scenario: a page of the current format is opened.
+  auto *transaction = new Transaction(0);
+  TableHeap table(bpm, lock_manager, nullptr, transaction);
+  EXPECT_NO_THROW(TableHeap(bpm, lock_manager, nullptr, table.GetFirstPageId()));
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete transaction;
+  delete lock_manager;
+  delete bpm;
+  delete disk_manager;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, BulkInsertTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50 + 1, 'x'))},
+                 &schema);
+  };
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *table = new TableHeap(bpm, lock_manager, nullptr, transaction);
+
+  // Scenario: a bulk insert spans many pages and returns the rids in order.
+  const int num_tuples = 5000;
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < num_tuples; ++i) {
+    tuples.push_back(make_tuple(i));
+  }
+  std::vector<RID> rids;
+  ASSERT_TRUE(table->InsertTuples(tuples, &rids, transaction));
+  ASSERT_EQ(num_tuples, rids.size());
+  EXPECT_EQ(num_tuples, transaction->GetWriteSet()->size());
+  std::set<page_id_t> pages;
+  for (int i = 0; i < num_tuples; ++i) {
+    Tuple tuple;
+    ASSERT_TRUE(table->GetTuple(rids[i], &tuple, transaction));
+    EXPECT_EQ(i, tuple.GetValue(&schema, 0).GetAs<int32_t>());
+    pages.insert(rids[i].GetPageId());
+  }
+  EXPECT_GT(pages.size(), 10);
+
+  // Scenario: a second bulk insert first fills the space freed on an earlier page.
+  page_id_t first_page_id = rids[0].GetPageId();
+  std::vector<Tuple> refill;
+  for (int i = 0; i < num_tuples && rids[i].GetPageId() == first_page_id; ++i) {
+    ASSERT_TRUE(table->MarkDelete(rids[i], transaction));
+    table->ApplyDelete(rids[i], transaction);
+    refill.push_back(make_tuple(num_tuples + i));
+  }
+  std::vector<RID> refill_rids;
+  ASSERT_TRUE(table->InsertTuples(refill, &refill_rids, transaction));
+  for (const auto &rid : refill_rids) {
+    EXPECT_EQ(1, pages.count(rid.GetPageId()));
+  }
+
+  // Scenario: a tuple too large for any page fails the whole insert.
+  std::vector<Tuple> too_large{
+      Tuple({ValueFactory::GetIntegerValue(0), ValueFactory::GetVarcharValue(std::string(PAGE_SIZE, 'x'))}, &schema)};
+  std::vector<RID> no_rids;
+  EXPECT_FALSE(table->InsertTuples(too_large, &no_rids, transaction));
+  EXPECT_TRUE(no_rids.empty());
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete lock_manager;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+// NOLINTNEXTLINE
+TEST(TableHeapTest, TupleViewTest) {
+  Schema schema({Column("a", TypeId::INTEGER), Column("b", TypeId::VARCHAR, 64)});
+  auto make_tuple = [&](int i) {
+    return Tuple({ValueFactory::GetIntegerValue(i), ValueFactory::GetVarcharValue(std::string(i % 50 + 1, 'x'))},
+                 &schema);
+  };
+
+  auto *transaction = new Transaction(0);
+  auto *disk_manager = new DiskManager("test.db");
+  auto *bpm = new BufferPoolManagerInstance(50, disk_manager);
+  auto *lock_manager = new LockManager();
+  auto *table = new TableHeap(bpm, lock_manager, nullptr, transaction);
+
+  const int num_tuples = 2000;
+  std::vector<RID> rids;
+  for (int i = 0; i < num_tuples; ++i) {
+    RID rid;
+    ASSERT_TRUE(table->InsertTuple(make_tuple(i), &rid, transaction));
+    rids.push_back(rid);
+  }
+  ASSERT_TRUE(table->MarkDelete(rids[1], transaction));
+  table->ApplyDelete(rids[1], transaction);
+
+  // Scenario: lookups through one guard see the same tuples as GetTuple, and keep the page of the last one pinned.
+  {
+    TablePageGuard guard;
+    for (int i = 0; i < num_tuples; ++i) {
+      TupleView view;
+      if (i == 1) {
+        EXPECT_FALSE(table->GetTupleView(rids[i], &guard, &view, transaction));
+        continue;
+      }
+      ASSERT_TRUE(table->GetTupleView(rids[i], &guard, &view, transaction));
+      EXPECT_EQ(rids[i].GetPageId(), guard.GetPageId());
+      EXPECT_EQ(rids[i], view.GetRid());
+      Tuple tuple;
+      ASSERT_TRUE(table->GetTuple(rids[i], &tuple, transaction));
+      ASSERT_EQ(tuple.GetLength(), view.GetLength());
+      EXPECT_EQ(0, memcmp(tuple.GetData(), view.GetData(), tuple.GetLength()));
+      EXPECT_EQ(i, view.GetValue(&schema, 0).GetAs<int32_t>());
+      EXPECT_FALSE(view.AsTuple().IsAllocated());
+    }
+  }
+
+  // Scenario: page views cover every live tuple in order, and materialized tuples outlive the guard.
+  std::vector<Tuple> materialized;
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    TablePageGuard guard;
+    std::vector<TupleView> views;
+    page_id = table->GetPageTupleViews(page_id, &guard, &views, transaction);
+    for (const auto &view : views) {
+      materialized.push_back(view.Materialize());
+    }
+  }
+  std::vector<Tuple> scanned;
+  for (auto it = table->Begin(transaction); it != table->End(); ++it) {
+    scanned.push_back(*it);
+  }
+  ASSERT_EQ(num_tuples - 1, materialized.size());
+  ASSERT_EQ(scanned.size(), materialized.size());
+  for (size_t i = 0; i < scanned.size(); ++i) {
+    EXPECT_TRUE(materialized[i].IsAllocated());
+    EXPECT_EQ(scanned[i].GetRid(), materialized[i].GetRid());
+    ASSERT_EQ(scanned[i].GetLength(), materialized[i].GetLength());
+    EXPECT_EQ(0, memcmp(scanned[i].GetData(), materialized[i].GetData(), scanned[i].GetLength()));
+  }
+
+  // Scenario: every page was released, so the whole pool can be pinned again.
+  for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+    page_id_t next_page_id = table->GetNextPageId(page_id);
+    auto *page = bpm->FetchPage(page_id);
+    ASSERT_NE(nullptr, page);
+    EXPECT_EQ(1, page->GetPinCount());
+    bpm->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+
+  disk_manager->ShutDown();
+  remove("test.db");
+  remove("test.log");
+  delete table;
+  delete lock_manager;
+  delete bpm;
+  delete disk_manager;
+  delete transaction;
+}
+
+}  // namespace bustub
@@ -0,0 +1,128 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_insert_benchmark_test.cpp
+//
+// Identification: test/table/table_insert_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <algorithm>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "concurrency/transaction_manager.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace bustub {
+
+// Appends rows to one table until it holds 10k, 100k and 1M rows, timing the last batch of inserts before each size.
+// With the free space map an insert goes straight to the page with room, so the rate must not drop as the table
+// grows, unlike walking the page chain, which costs one page fetch per page of the table.
+// NOLINTNEXTLINE
+TEST(TableInsertBenchmarkTest, DISABLED_InsertThroughputByTableSize) {
+  const std::string db_name = "insert_bench.db";
+  const size_t buffer_pool_size = 1024;
+  const uint32_t batch_size = 10000;
+  Schema schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::INTEGER), Column("colC", TypeId::INTEGER),
+                 Column("colD", TypeId::INTEGER)});
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  TableHeap table(bpm.get(), lock_manager.get(), nullptr, txn);
+  txn_mgr->Commit(txn);
+  delete txn;
+
+  uint32_t num_rows = 0;
+  double first_rate = 0;
+  for (uint32_t table_size : {10000, 100000, 1000000}) {
+    double batch_seconds = 0;
+    while (num_rows < table_size) {
+      txn = txn_mgr->Begin();
+      auto start = std::chrono::steady_clock::now();
+      RID rid;
+      for (uint32_t i = 0; i < batch_size; i++, num_rows++) {
+        auto value = static_cast<int32_t>(num_rows);
+        Tuple tuple({ValueFactory::GetIntegerValue(value), ValueFactory::GetIntegerValue(value % 10),
+                     ValueFactory::GetIntegerValue(value % 10000), ValueFactory::GetIntegerValue(value * 7)},
+                    &schema);
+        ASSERT_TRUE(table.InsertTuple(tuple, &rid, txn));
+      }
+      batch_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      txn_mgr->Commit(txn);
+      delete txn;
+    }
+    double rate = batch_size / batch_seconds;
+    first_rate = first_rate == 0 ? rate : first_rate;
+    printf("[insert] table rows=%8u  inserts/sec=%12.0f  (%.2fx the rate at 10k rows)\n", num_rows, rate,
+           rate / first_rate);
+  }
+
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("insert_bench.log");
+}
+
+// Inserts the same rows into fresh tables one tuple at a time and in batches, which fill a page per latch acquisition.
+// NOLINTNEXTLINE
+TEST(TableInsertBenchmarkTest, DISABLED_BulkVersusSingleInsert) {
+  const std::string db_name = "bulk_insert_bench.db";
+  const size_t buffer_pool_size = 1024;
+  const uint32_t num_rows = 200000;
+  Schema schema({Column("colA", TypeId::INTEGER), Column("colB", TypeId::INTEGER), Column("colC", TypeId::INTEGER),
+                 Column("colD", TypeId::INTEGER)});
+  std::vector<Tuple> tuples;
+  tuples.reserve(num_rows);
+  for (uint32_t i = 0; i < num_rows; i++) {
+    auto value = static_cast<int32_t>(i);
+    tuples.emplace_back(std::vector<Value>{ValueFactory::GetIntegerValue(value),
+                                           ValueFactory::GetIntegerValue(value % 10),
+                                           ValueFactory::GetIntegerValue(value % 10000),
+                                           ValueFactory::GetIntegerValue(value * 7)},
+                        &schema);
+  }
+
+  for (uint32_t batch_size : {1, 16, 128, 1024}) {
+    auto disk_manager = std::make_unique<DiskManager>(db_name);
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(buffer_pool_size, disk_manager.get());
+    auto lock_manager = std::make_unique<LockManager>();
+    auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+    Transaction *txn = txn_mgr->Begin();
+    TableHeap table(bpm.get(), lock_manager.get(), nullptr, txn);
+
+    auto start = std::chrono::steady_clock::now();
+    RID rid;
+    std::vector<RID> rids;
+    for (uint32_t i = 0; i < num_rows; i += batch_size) {
+      if (batch_size == 1) {
+        ASSERT_TRUE(table.InsertTuple(tuples[i], &rid, txn));
+        continue;
+      }
+      std::vector<Tuple> batch(tuples.begin() + i, tuples.begin() + std::min(num_rows, i + batch_size));
+      ASSERT_TRUE(table.InsertTuples(batch, &rids, txn));
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    ASSERT_EQ(num_rows, txn->GetWriteSet()->size());
+    printf("[insert] batch size=%5u  rows/sec=%12.0f\n", batch_size, num_rows / seconds);
+
+    txn_mgr->Commit(txn);
+    delete txn;
+    disk_manager->ShutDown();
+    remove(db_name.c_str());
+    remove("bulk_insert_bench.log");
+  }
+}
+
+}  // namespace bustub
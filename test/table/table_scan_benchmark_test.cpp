@@ -0,0 +1,82 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// table_scan_benchmark_test.cpp
+//
+// Identification: test/table/table_scan_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <memory>
+#include <string>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/executor_context.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+
+namespace bustub {
+
+// Full scans of a table that is several times larger than the buffer pool, starting from a cold pool every time, with
+// and without read-ahead. Every scan must see every row.
+// NOLINTNEXTLINE
+TEST(TableScanBenchmarkTest, DISABLED_ColdPoolScan) {
+  const std::string db_name = "scan_bench.db";
+  const uint32_t num_rows = 20000;
+  const size_t load_pool_size = 1024;
+  const size_t scan_pool_size = 32;
+  const int num_scans = 3;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name, IOBackendType::IO_URING);
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+
+  // Load the table through a pool that holds all of it, then write it out.
+  page_id_t first_page_id;
+  {
+    auto bpm = std::make_unique<BufferPoolManagerInstance>(load_pool_size, disk_manager.get());
+    auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+    auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+    TableGenerator gen{exec_ctx.get()};
+    first_page_id = gen.GenerateTest1Table("scan_bench", num_rows)->table_->GetFirstPageId();
+    bpm->FlushAllPages();
+  }
+
+  for (bool read_ahead : {false, true}) {
+    enable_read_ahead = read_ahead;
+    double total_seconds = 0;
+    uint64_t num_prefetches = 0;
+    for (int scan = 0; scan < num_scans; scan++) {
+      BufferPoolManagerInstance bpm(scan_pool_size, disk_manager.get());
+      TableHeap table(&bpm, lock_manager.get(), nullptr, first_page_id);
+      auto start = std::chrono::steady_clock::now();
+      uint32_t rows = 0;
+      for (auto it = table.Begin(txn); it != table.End(); ++it) {
+        rows++;
+      }
+      total_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+      num_prefetches += bpm.GetNumPrefetches();
+      ASSERT_EQ(num_rows, rows);
+    }
+    printf("[scan] read_ahead=%-3s  rows/sec=%12.0f  prefetched pages/scan=%6lu\n", read_ahead ? "on" : "off",
+           num_rows * num_scans / total_seconds, static_cast<unsigned long>(num_prefetches / num_scans));  // NOLINT
+  }
+  enable_read_ahead = true;
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("scan_bench.log");
+}
+
+}  // namespace bustub
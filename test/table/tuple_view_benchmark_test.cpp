@@ -0,0 +1,138 @@
+//===----------------------------------------------------------------------===//
+//
+//                         BusTub
+//
+// tuple_view_benchmark_test.cpp
+//
+// Identification: test/table/tuple_view_benchmark_test.cpp
+//
+// Copyright (c) 2015-2021, Carnegie Mellon University Database Group
+//
+//===----------------------------------------------------------------------===//
+
+#include <atomic>
+#include <chrono>  // NOLINT
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager_instance.h"
+#include "catalog/catalog.h"
+#include "catalog/table_generator.h"
+#include "concurrency/transaction_manager.h"
+#include "execution/execution_engine.h"
+#include "execution/executor_context.h"
+#include "execution/expressions/column_value_expression.h"
+#include "execution/expressions/comparison_expression.h"
+#include "execution/expressions/constant_value_expression.h"
+#include "execution/plans/seq_scan_plan.h"
+#include "gtest/gtest.h"
+#include "storage/table/table_heap.h"
+#include "type/value_factory.h"
+
+namespace {
+
+/** The number of calls to the global operator new in this process */
+std::atomic<uint64_t> num_allocations{0};
+
+}  // namespace
+
+void *operator new(std::size_t size) {
+  num_allocations.fetch_add(1, std::memory_order_relaxed);
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr) {
+    throw std::bad_alloc();
+  }
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t size) noexcept { std::free(ptr); }
+
+namespace bustub {
+
+// Scans of a 100000-row table that fits in the buffer pool, reading colA of every row: through the table iterator,
+// which copies every tuple out of its page, and through page views, which read the tuples in place. Then a sequential
+// scan executor with colC > colD (about 5% of the rows) as predicate and colA as output. Reports the allocations per
+// scanned tuple and the scan throughput of each.
+// NOLINTNEXTLINE
+TEST(TupleViewBenchmarkTest, DISABLED_ScanAllocations) {
+  const std::string db_name = "tuple_view_bench.db";
+  const uint32_t num_rows = 100000;
+  const size_t pool_size = 2048;
+  const int num_scans = 5;
+
+  auto disk_manager = std::make_unique<DiskManager>(db_name);
+  auto bpm = std::make_unique<BufferPoolManagerInstance>(pool_size, disk_manager.get());
+  auto lock_manager = std::make_unique<LockManager>();
+  auto txn_mgr = std::make_unique<TransactionManager>(lock_manager.get(), nullptr);
+  auto catalog = std::make_unique<Catalog>(bpm.get(), lock_manager.get(), nullptr);
+  Transaction *txn = txn_mgr->Begin();
+  auto exec_ctx = std::make_unique<ExecutorContext>(txn, catalog.get(), bpm.get(), txn_mgr.get(), lock_manager.get());
+  TableGenerator gen{exec_ctx.get()};
+  TableInfo *table_info = gen.GenerateTest1Table("view_bench", num_rows);
+  TableHeap *table = table_info->table_.get();
+  const Schema &schema = table_info->schema_;
+  uint32_t col_a_idx = schema.GetColIdx("colA");
+
+  // Runs num_scans scans and reports them; scan returns the sum of colA over the table.
+  auto run = [&](const char *name, auto &&scan) {
+    int64_t sum = 0;
+    uint64_t allocations_before = num_allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < num_scans; i++) {
+      sum += scan();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double allocations = static_cast<double>(num_allocations.load() - allocations_before);
+    printf("[tuple view] %-22s allocations/tuple=%5.2f  rows/sec=%12.0f\n", name,
+           allocations / (num_rows * num_scans), num_rows * num_scans / seconds);
+    return sum;
+  };
+
+  int64_t iterator_sum = run("table iterator", [&] {
+    int64_t sum = 0;
+    for (auto it = table->Begin(txn); it != table->End(); ++it) {
+      sum += it->GetValue(&schema, col_a_idx).GetAs<int32_t>();
+    }
+    return sum;
+  });
+  std::vector<TupleView> views;
+  int64_t view_sum = run("page views", [&] {
+    int64_t sum = 0;
+    for (page_id_t page_id = table->GetFirstPageId(); page_id != INVALID_PAGE_ID;) {
+      TablePageGuard guard;
+      views.clear();
+      page_id = table->GetPageTupleViews(page_id, &guard, &views, txn);
+      for (const auto &view : views) {
+        sum += view.GetValue(&schema, col_a_idx).GetAs<int32_t>();
+      }
+    }
+    return sum;
+  });
+  EXPECT_EQ(iterator_sum, view_sum);
+
+  ColumnValueExpression col_a{0, col_a_idx, TypeId::INTEGER};
+  ColumnValueExpression col_c{0, schema.GetColIdx("colC"), TypeId::INTEGER};
+  ColumnValueExpression col_d{0, schema.GetColIdx("colD"), TypeId::INTEGER};
+  ComparisonExpression predicate{&col_c, &col_d, ComparisonType::GreaterThan};
+  Schema out_schema{{Column("colA", TypeId::INTEGER, &col_a)}};
+  SeqScanPlanNode scan_plan{&out_schema, &predicate, table_info->oid_};
+  ExecutionEngine engine{bpm.get(), txn_mgr.get(), catalog.get()};
+  run("seq scan executor", [&] {
+    engine.Execute(&scan_plan, nullptr, txn, exec_ctx.get());
+    return 0;
+  });
+
+  txn_mgr->Commit(txn);
+  delete txn;
+  disk_manager->ShutDown();
+  remove(db_name.c_str());
+  remove("tuple_view_bench.log");
+}
+
+}  // namespace bustub